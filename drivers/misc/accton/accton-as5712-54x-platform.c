@@ -35,6 +35,7 @@
 #include <linux/platform_device.h>
 #include <linux/hwmon.h>
 #include <linux/hwmon-sysfs.h>
+#include <linux/cumulus-cpld-mux.h>
 
 #include "platform-defs.h"
 #include "accton-as5712-54x-cpld.h"
@@ -1570,55 +1571,53 @@ static int port_eeprom_mux_i2c_reg_write(uint8_t reg, u8 val)
 	return rv;
 }
 
-static int port_eeprom_mux_deselect_chan(struct i2c_mux_core *muxc, u32 chan)
+static int port_eeprom_mux_write(void *priv, u32 reg, u32 val)
 {
-	/* Since we can only access one SFP EEPROM at a time,
-	   we can do a clear at both CPLD registers, just to be safe. */
-	port_eeprom_mux_i2c_reg_write(CPLD_PORT1_24_I2C_SELECT_REG, 0xff);
-	port_eeprom_mux_i2c_reg_write(CPLD_PORT25_54_I2C_SELECT_REG, 0xff);
-
-	return 0;
+	return port_eeprom_mux_i2c_reg_write(reg, val);
 }
 
-static int port_eeprom_mux_select_chan(struct i2c_mux_core *muxc, u32 chan)
-{
-	int val = 0xff;
-	u32 mux_reg = 0;
-
-	if (chan < EEPROM_MUX_PORT_RANGE1_SFP) {
-		mux_reg = CPLD_PORT1_24_I2C_SELECT_REG;
-		val = chan;
-	} else if (chan < EEPROM_MUX_PORT_RANGE_QSFP) {
-		mux_reg = CPLD_PORT25_54_I2C_SELECT_REG;
-		val = chan - EEPROM_MUX_PORT_RANGE1_SFP;
-		/*
-		 * Reorder the QSFP ports to match the silkscreen.
-		 * The first and last QSFP are okay, but the other four
-		 * need to be shuffled.
-		 */
-		switch (val) {
-			case 25:       // port 50 => port 51
-				val = 26;
-				break;
-			case 26:       // port 51 => port 53
-				val = 28;
-				break;
-			case 27:       // port 52 => port 50
-				val = 25;
-				break;
-			case 28:       // port 53 => port 52
-				val = 27;
-				break;
-		}
-	} else {
-		pr_err("invalid mux channel number %u\n", chan);
-		return -EINVAL;
-	}
+/*
+ * Reorder the QSFP ports to match the silkscreen.  The first and last
+ * QSFP are okay, but the other four need to be shuffled:
+ * port 50 => 51, port 51 => 53, port 52 => 50, port 53 => 52.
+ */
+static const u8 port25_54_remap[] = {
+	0,  1,  2,  3,  4,  5,  6,  7,  8,  9,
+	10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+	20, 21, 22, 23, 24, 26, 28, 25, 27, 29,
+};
 
-	port_eeprom_mux_i2c_reg_write(mux_reg, val);
+/*
+ * The port selection is left in place after a transfer, so repeated
+ * accesses to the same module cost no CPLD writes.  None of the other
+ * I801 devices share the module addresses (0x50/0x51).
+ */
+static const struct cumulus_cpld_mux_group port_eeprom_mux_groups[] = {
+	{
+		.reg = CPLD_PORT1_24_I2C_SELECT_REG,
+		.first_chan = 0,
+		.num_chans = EEPROM_MUX_PORT_RANGE1_SFP,
+		.base_val = 0,
+		.idle_val = 0xff,
+	},
+	{
+		.reg = CPLD_PORT25_54_I2C_SELECT_REG,
+		.first_chan = EEPROM_MUX_PORT_RANGE1_SFP,
+		.num_chans = EEPROM_MUX_PORT_RANGE_QSFP -
+			     EEPROM_MUX_PORT_RANGE1_SFP,
+		.remap = port25_54_remap,
+		.idle_val = 0xff,
+	},
+};
 
-	return 0;
-}
+static const struct cumulus_cpld_mux_desc port_eeprom_mux_desc = {
+	.name = "port eeprom",
+	.num_chans = EEPROM_MUX_TOTAL_PORTS,
+	.first_bus = AS5712_I2C_PORT_EEPROM_BUS_0,
+	.groups = port_eeprom_mux_groups,
+	.num_groups = ARRAY_SIZE(port_eeprom_mux_groups),
+	.write = port_eeprom_mux_write,
+};
 
 /* Platform device for the port EEPROM mux device */
 static struct platform_device *port_eeprom_mux_dev;
@@ -1679,7 +1678,7 @@ static struct __init i2c_board_info *alloc_port_i2c_board_info(int port) {
 
 		sff8436_data->byte_len = 256;
 		sff8436_data->flags = SFF_8436_FLAG_IRUGO;
-		sff8436_data->page_size = 1;
+		sff8436_data->page_size = QSFP_PAGE_SIZE;
 		sff8436_data->eeprom_data = eeprom_data;
 		board_info->platform_data = sff8436_data;
 		strcpy(board_info->type, "sff8436");
@@ -1691,7 +1690,7 @@ static struct __init i2c_board_info *alloc_port_i2c_board_info(int port) {
 
 		at24_data->byte_len = 512;
 		at24_data->flags = AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG;
-		at24_data->page_size = 1;
+		at24_data->page_size = SFP_PAGE_SIZE;
 		at24_data->eeprom_data = eeprom_data;
 		board_info->platform_data = at24_data;
 		strcpy(board_info->type, "24c04");
@@ -1741,8 +1740,8 @@ static void free_port_eeprom_mux_data(void)
 			kfree(board_info);
 		}
 	}
-	if (muxc)
-		i2c_mux_del_adapters(muxc);
+	cumulus_cpld_mux_del(muxc);
+	muxc = NULL;
 }
 
 /**
@@ -1761,7 +1760,6 @@ static int __init accton_as5712_54x_port_eeprom_mux_init(void)
 {
 	int ret = 0;
 	int i;
-	int nr;
 	struct i2c_adapter *parent;
 	extern struct i2c_adapter *i801_adapter;
 
@@ -1785,28 +1783,20 @@ static int __init accton_as5712_54x_port_eeprom_mux_init(void)
 		goto mux_err_device_add;
 	}
 
-	muxc = i2c_mux_alloc(parent, &port_eeprom_mux_dev->dev,
-			     EEPROM_MUX_TOTAL_PORTS, 0, 0,
-			     port_eeprom_mux_select_chan,
-			     port_eeprom_mux_deselect_chan);
-	if (!muxc) {
-		pr_err("i2c_mux_alloc() failed for %u muxes.\n",
-		       EEPROM_MUX_TOTAL_PORTS);
-		ret = -ENOMEM;
+	/* This also clears the mux, in case it points to a SFP EEPROM */
+	muxc = cumulus_cpld_mux_add(&port_eeprom_mux_dev->dev, parent,
+				    &port_eeprom_mux_desc);
+	if (IS_ERR(muxc)) {
+		pr_err("Creating the port EEPROM mux failed.\n");
+		ret = PTR_ERR(muxc);
+		muxc = NULL;
 		goto mux_err_device_add;
 	}
 
-	nr = AS5712_I2C_PORT_EEPROM_BUS_0;
-	for (i = 0; i < EEPROM_MUX_TOTAL_PORTS; i++, nr++) {
+	for (i = 0; i < EEPROM_MUX_TOTAL_PORTS; i++) {
 		struct i2c_board_info *board_info;
 		struct i2c_client *client;
 
-		ret = i2c_mux_add_adapter(muxc, nr, i, 0);
-		if (ret) {
-			pr_err("i2c_mux_add_adapter() failed for channel %u.\n",i);
-			goto mux_err_i2c_add_mux;
-		}
-
 		board_info = alloc_port_i2c_board_info(i + 1);
 		if (!board_info) {
 			pr_err("Failed to allocate i2c board info for channel %u.\n", i);
@@ -1873,10 +1863,6 @@ static int __init accton_as5712_54x_platform_init(void)
 		goto err_eeprom_mux_init;
 	}
 
-	/* Clear the mux, in case it points to a SFP EEPROM by default */
-	port_eeprom_mux_i2c_reg_write(CPLD_PORT1_24_I2C_SELECT_REG, 0xff);
-	port_eeprom_mux_i2c_reg_write(CPLD_PORT25_54_I2C_SELECT_REG, 0xff);
-
 	pr_info(DRIVER_NAME": version "DRIVER_VERSION" successfully loaded\n");
 	return 0;
 
@@ -35,6 +35,7 @@
 #include <linux/platform_device.h>
 #include <linux/hwmon.h>
 #include <linux/hwmon-sysfs.h>
+#include <linux/cumulus-cpld-mux.h>
 
 #include "platform-defs.h"
 #include "accton-as6712-32x-cpld.h"
@@ -1442,42 +1443,42 @@ static int port_eeprom_mux_i2c_reg_write(uint8_t reg, u8 val)
  */
 #define PORT_EEPROM_MUX_INVALID_CHANNEL (0xDEADBEEF)
 
-static int port_eeprom_mux_deselect_chan(struct i2c_mux_core *muxc, u32 chan)
+static int port_eeprom_mux_write(void *priv, u32 reg, u32 val)
 {
-        u32 mux_reg = 0;
-
-        if (chan < EEPROM_MUX_PORT_RANGE1_QSFP) {
-                mux_reg = CPLD_PORT1_16_I2C_SELECT_REG;
-        } else if (chan < EEPROM_MUX_PORT_RANGE2_QSFP) {
-                mux_reg = CPLD_PORT17_32_I2C_SELECT_REG;
-        } else {
-                pr_err("invalid mux channel number %u\n", chan);
-                return -EINVAL;
-        }
-
-        port_eeprom_mux_i2c_reg_write(mux_reg, 0xff);
-        return 0;
+	return port_eeprom_mux_i2c_reg_write(reg, val);
 }
 
-static int port_eeprom_mux_select_chan(struct i2c_mux_core *muxc, u32 chan)
-{
-	int val;
-	u32 mux_reg = 0;
-
-	if (chan < EEPROM_MUX_PORT_RANGE1_QSFP) {
-		mux_reg = CPLD_PORT1_16_I2C_SELECT_REG;
-		val = chan;
-	} else if (chan < EEPROM_MUX_PORT_RANGE2_QSFP) {
-		mux_reg = CPLD_PORT17_32_I2C_SELECT_REG;
-		val = chan - EEPROM_MUX_PORT_RANGE1_QSFP;
-	} else {
-		pr_err("invalid mux channel number %u\n", chan);
-		return -EINVAL;
-	}
+/*
+ * The port selection is left in place after a transfer, so repeated
+ * accesses to the same module cost no CPLD writes.  None of the other
+ * I801 devices share the module address (0x50).
+ */
+static const struct cumulus_cpld_mux_group port_eeprom_mux_groups[] = {
+	{
+		.reg = CPLD_PORT1_16_I2C_SELECT_REG,
+		.first_chan = 0,
+		.num_chans = EEPROM_MUX_PORT_RANGE1_QSFP,
+		.base_val = 0,
+		.idle_val = 0xff,
+	},
+	{
+		.reg = CPLD_PORT17_32_I2C_SELECT_REG,
+		.first_chan = EEPROM_MUX_PORT_RANGE1_QSFP,
+		.num_chans = EEPROM_MUX_PORT_RANGE2_QSFP -
+			     EEPROM_MUX_PORT_RANGE1_QSFP,
+		.base_val = 0,
+		.idle_val = 0xff,
+	},
+};
 
-	port_eeprom_mux_i2c_reg_write(mux_reg, val);
-	return 0;
-}
+static const struct cumulus_cpld_mux_desc port_eeprom_mux_desc = {
+	.name = "port eeprom",
+	.num_chans = EEPROM_MUX_TOTAL_PORTS,
+	.first_bus = AS6712_I2C_PORT_EEPROM_BUS_0,
+	.groups = port_eeprom_mux_groups,
+	.num_groups = ARRAY_SIZE(port_eeprom_mux_groups),
+	.write = port_eeprom_mux_write,
+};
 
 /* Platform device for the port EEPROM mux device */
 static struct platform_device *port_eeprom_mux_dev;
@@ -1530,7 +1531,7 @@ static struct __init i2c_board_info *alloc_port_i2c_board_info(int port) {
 	
 	sff8436_data->byte_len = 256;
 	sff8436_data->flags = SFF_8436_FLAG_IRUGO;
-	sff8436_data->page_size = 1;
+	sff8436_data->page_size = QSFP_PAGE_SIZE;
 	sff8436_data->eeprom_data = eeprom_data;
 	board_info->platform_data = sff8436_data;
 	strcpy(board_info->type, "sff8436");
@@ -1572,8 +1573,8 @@ static void free_port_eeprom_mux_data(void)
 			kfree(board_info);
 		}
 	}
-	if (muxc)
-		i2c_mux_del_adapters(muxc);
+	cumulus_cpld_mux_del(muxc);
+	muxc = NULL;
 }
 
 /**
@@ -1592,7 +1593,6 @@ static int __init accton_as6712_32x_port_eeprom_mux_init(void)
 {
 	int ret = 0;
 	int i;
-	int nr;
 	struct i2c_adapter *parent;
 
 	parent = i2c_get_adapter(i801_bus_num);
@@ -1614,29 +1614,20 @@ static int __init accton_as6712_32x_port_eeprom_mux_init(void)
 		goto mux_err_device_add;
 	}
 
-	muxc = i2c_mux_alloc(parent, &port_eeprom_mux_dev->dev,
-			     EEPROM_MUX_TOTAL_PORTS, 0, 0,
-			     port_eeprom_mux_select_chan, 
-                             port_eeprom_mux_deselect_chan);
-	if (!muxc) {
-		pr_err("i2c_mux_alloc() failed for %u muxes.\n",
-		       EEPROM_MUX_TOTAL_PORTS);
-		ret = -ENOMEM;
+	/* This also clears the mux, in case it points to a QSFP EEPROM */
+	muxc = cumulus_cpld_mux_add(&port_eeprom_mux_dev->dev, parent,
+				    &port_eeprom_mux_desc);
+	if (IS_ERR(muxc)) {
+		pr_err("Creating the port EEPROM mux failed.\n");
+		ret = PTR_ERR(muxc);
+		muxc = NULL;
 		goto mux_err_device_add;
 	}
 
-	nr = AS6712_I2C_PORT_EEPROM_BUS_0;
-	for (i = 0; i < EEPROM_MUX_TOTAL_PORTS; i++, nr++) {
+	for (i = 0; i < EEPROM_MUX_TOTAL_PORTS; i++) {
 		struct i2c_board_info *board_info;
 		struct i2c_client *client;
 
-		ret = i2c_mux_add_adapter(muxc, nr, i, 0);
-		if (ret) {
-			pr_err("i2c_mux_add_adapter() failed for channel %u.\n", i);
-			ret = -ENOMEM;
-			goto mux_err_i2c_add_mux;
-		}
-
 		board_info = alloc_port_i2c_board_info(i + 1);
 		if (!board_info) {
 			pr_err("Failed to allocate i2c board info for channel %u.\n", i);
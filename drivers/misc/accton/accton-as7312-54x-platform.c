@@ -415,7 +415,7 @@ static struct i2c_board_info *alloc_qsfp_board_info(int port)
 
 	sff8436_data->byte_len = 256;
 	sff8436_data->flags = SFF_8436_FLAG_IRUGO;
-	sff8436_data->page_size = 1;
+	sff8436_data->page_size = QSFP_PAGE_SIZE;
 	sff8436_data->eeprom_data = eeprom_data;
 
 	strcpy(board_info->type, "sff8436");
@@ -500,7 +500,7 @@ static struct i2c_board_info *alloc_sfp_board_info(int port)
 
 	at24_data->byte_len = 512;
 	at24_data->flags = AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG;
-	at24_data->page_size = 1;
+	at24_data->page_size = SFP_PAGE_SIZE;
 	at24_data->eeprom_data = eeprom_data;
 
 	strcpy(board_info->type, "24c04");
@@ -40,13 +40,14 @@
 #include <linux/pci.h>
 
 #include <linux/cumulus-platform.h>
+#include <linux/cumulus-ports.h>
 #include "accton-minipack-platform.h"
 #include "platform-defs.h"
 #include "platform-bitfield.h"
 
 #define DRIVER_NAME	"accton_minipack_platform"
 #define FPGA_DRIVER     "minipack_io_fpga"
-#define DRIVER_VERSION	"1.0"
+#define DRIVER_VERSION	"1.1"
 
 #define PCI_DEVICE_ID_FACEBOOK_FPGA 0x0011
 #define PCI_VENDOR_ID_FACEBOOK 0x1d9b
@@ -253,11 +254,11 @@ static int fpga_write_reg(struct device *dev,
  * For muxes, we specify the bus number for each port,
  * and set the deselect_on_exit but (see comment above).
  *
- * For EEPROMs, including ones in the QSFP28 transceivers,
- * we specify the label, I2C address, size, and some flags.
- * All done in the magic mk*_eeprom() macros.  The label is
+ * For EEPROMs we specify the label, I2C address, size, and some
+ * flags.  All done in the magic mk*_eeprom() macros.  The label is
  * the string that ends up in /sys/class/eeprom_dev/eepromN/label,
- * which we use to identify them at user level.
+ * which we use to identify them at user level.  The QSFP28 port
+ * eeproms are built from i2c_port_ranges[] instead, see below.
  */
 
 mk_pca9548(mux1,  MP_I2C_MUX1_BUS0,  1);
@@ -278,135 +279,6 @@ mk_pca9548(mux15, MP_I2C_MUX15_BUS0, 1);
 mk_pca9548(mux16, MP_I2C_MUX16_BUS0, 1);
 mk_pca9548(mux17, MP_I2C_MUX17_BUS0, 1);
 
-mk_qsfp_port_eeprom(port1,  50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port2,  50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port3,  50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port4,  50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port5,  50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port6,  50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port7,  50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port8,  50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port9,  50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port10, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port11, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port12, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port13, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port14, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port15, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port16, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port17, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port18, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port19, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port20, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port21, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port22, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port23, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port24, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port25, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port26, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port27, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port28, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port29, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port30, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port31, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port32, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port33, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port34, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port35, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port36, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port37, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port38, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port39, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port40, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port41, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port42, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port43, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port44, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port45, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port46, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port47, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port48, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port49, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port50, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port51, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port52, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port53, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port54, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port55, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port56, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port57, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port58, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port59, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port60, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port61, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port62, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port63, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port64, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port65, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port66, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port67, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port68, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port69, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port70, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port71, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port72, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port73, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port74, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port75, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port76, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port77, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port78, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port79, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port80, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port81, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port82, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port83, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port84, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port85, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port86, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port87, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port88, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port89, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port90, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port91, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port92, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port93, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port94, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port95, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port96, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port97, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port98, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port99, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port100, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port101, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port102, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port103, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port104, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port105, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port106, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port107, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port108, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port109, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port110, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port111, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port112, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port113, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port114, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port115, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port116, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port117, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port118, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port119, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port120, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port121, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port122, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port123, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port124, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port125, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port126, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port127, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port128, 50, 256, SFF_8436_FLAG_IRUGO);
-
 mk_eeprom(board, 57, 8192, AT24_FLAG_ADDR16 | AT24_FLAG_IRUGO);
 mk_eeprom(pim1,  56, 8192, AT24_FLAG_ADDR16 | AT24_FLAG_IRUGO);
 mk_eeprom(pim2,  56, 8192, AT24_FLAG_ADDR16 | AT24_FLAG_IRUGO);
@@ -448,168 +320,56 @@ static struct platform_i2c_device_info i2c_devices[] = {
 	mk_i2cdev(MP_I2C_MUX1_BUS7, "pca9548", 0x71, &mux16_platform_data),
 	mk_i2cdev(MP_I2C_MUX1_BUS7, "pca9548", 0x72, &mux17_platform_data),
 	mk_i2cdev(MP_I2C_MUX1_BUS7, "24c64",   0x56, &pim8_56_at24),
+};
+
+/*
+ * The QSFP28 port eeproms, built at load time, see cumulus-ports.c.
+ * Each one is labeled "portN".  A PIM has 16 ports behind two
+ * PCA9548s, the second mux of the PIM holding the first eight ports,
+ * and each mux serves its ports in reverse order of channel pairs.
+ */
+static const u8 mp_port_bus_order[] = { 6, 7, 4, 5, 2, 3, 0, 1 };
+
+#define mp_port_eeproms(_first, _mux) \
+	{ \
+		.first = (_first), \
+		.count = 8, \
+		.bus = MP_I2C_MUX##_mux##_BUS0, \
+		.bus_order = mp_port_bus_order, \
+		.addr = 0x50, \
+		.type = CUMULUS_PORT_EEPROM_QSFP, \
+		.size = 256, \
+		.eeprom_flags = SFF_8436_FLAG_IRUGO, \
+	}
+
+static const struct cumulus_port_range i2c_port_ranges[] = {
+	mp_port_eeproms(1, 3),
+	mp_port_eeproms(9, 2),
+	mp_port_eeproms(17, 5),
+	mp_port_eeproms(25, 4),
+	mp_port_eeproms(33, 7),
+	mp_port_eeproms(41, 6),
+	mp_port_eeproms(49, 9),
+	mp_port_eeproms(57, 8),
+	mp_port_eeproms(65, 11),
+	mp_port_eeproms(73, 10),
+	mp_port_eeproms(81, 13),
+	mp_port_eeproms(89, 12),
+	mp_port_eeproms(97, 15),
+	mp_port_eeproms(105, 14),
+	mp_port_eeproms(113, 17),
+	mp_port_eeproms(121, 16),
+};
 
-	/* devices on pca9548 2 */
-	mk_i2cdev(MP_I2C_MUX2_BUS1, "sff8436", 0x50, &port16_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX2_BUS0, "sff8436", 0x50, &port15_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX2_BUS3, "sff8436", 0x50, &port14_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX2_BUS2, "sff8436", 0x50, &port13_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX2_BUS5, "sff8436", 0x50, &port12_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX2_BUS4, "sff8436", 0x50, &port11_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX2_BUS7, "sff8436", 0x50, &port10_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX2_BUS6, "sff8436", 0x50, &port9_50_sff8436),
-
-	/* devices on pca9548 3 */
-	mk_i2cdev(MP_I2C_MUX3_BUS1, "sff8436", 0x50, &port8_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX3_BUS0, "sff8436", 0x50, &port7_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX3_BUS3, "sff8436", 0x50, &port6_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX3_BUS2, "sff8436", 0x50, &port5_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX3_BUS5, "sff8436", 0x50, &port4_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX3_BUS4, "sff8436", 0x50, &port3_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX3_BUS7, "sff8436", 0x50, &port2_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX3_BUS6, "sff8436", 0x50, &port1_50_sff8436),
-
-	/* devices on pca9548 4 */
-	mk_i2cdev(MP_I2C_MUX4_BUS1, "sff8436", 0x50, &port32_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX4_BUS0, "sff8436", 0x50, &port31_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX4_BUS3, "sff8436", 0x50, &port30_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX4_BUS2, "sff8436", 0x50, &port29_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX4_BUS5, "sff8436", 0x50, &port28_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX4_BUS4, "sff8436", 0x50, &port27_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX4_BUS7, "sff8436", 0x50, &port26_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX4_BUS6, "sff8436", 0x50, &port25_50_sff8436),
-
-	/* devices on pca9548 5 */
-	mk_i2cdev(MP_I2C_MUX5_BUS1, "sff8436", 0x50, &port24_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX5_BUS0, "sff8436", 0x50, &port23_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX5_BUS3, "sff8436", 0x50, &port22_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX5_BUS2, "sff8436", 0x50, &port21_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX5_BUS5, "sff8436", 0x50, &port20_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX5_BUS4, "sff8436", 0x50, &port19_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX5_BUS7, "sff8436", 0x50, &port18_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX5_BUS6, "sff8436", 0x50, &port17_50_sff8436),
-
-	/* devices on pca9548 6 */
-	mk_i2cdev(MP_I2C_MUX6_BUS1, "sff8436", 0x50, &port48_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX6_BUS0, "sff8436", 0x50, &port47_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX6_BUS3, "sff8436", 0x50, &port46_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX6_BUS2, "sff8436", 0x50, &port45_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX6_BUS5, "sff8436", 0x50, &port44_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX6_BUS4, "sff8436", 0x50, &port43_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX6_BUS7, "sff8436", 0x50, &port42_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX6_BUS6, "sff8436", 0x50, &port41_50_sff8436),
-
-	/* devices on pca9548 7 */
-	mk_i2cdev(MP_I2C_MUX7_BUS1, "sff8436", 0x50, &port40_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX7_BUS0, "sff8436", 0x50, &port39_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX7_BUS3, "sff8436", 0x50, &port38_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX7_BUS2, "sff8436", 0x50, &port37_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX7_BUS5, "sff8436", 0x50, &port36_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX7_BUS4, "sff8436", 0x50, &port35_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX7_BUS7, "sff8436", 0x50, &port34_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX7_BUS6, "sff8436", 0x50, &port33_50_sff8436),
-
-	/* devices on pca9548 8 */
-	mk_i2cdev(MP_I2C_MUX8_BUS1, "sff8436", 0x50, &port64_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX8_BUS0, "sff8436", 0x50, &port63_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX8_BUS3, "sff8436", 0x50, &port62_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX8_BUS2, "sff8436", 0x50, &port61_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX8_BUS5, "sff8436", 0x50, &port60_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX8_BUS4, "sff8436", 0x50, &port59_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX8_BUS7, "sff8436", 0x50, &port58_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX8_BUS6, "sff8436", 0x50, &port57_50_sff8436),
-
-	/* devices on pca9548 9 */
-	mk_i2cdev(MP_I2C_MUX9_BUS1, "sff8436", 0x50, &port56_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX9_BUS0, "sff8436", 0x50, &port55_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX9_BUS3, "sff8436", 0x50, &port54_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX9_BUS2, "sff8436", 0x50, &port53_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX9_BUS5, "sff8436", 0x50, &port52_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX9_BUS4, "sff8436", 0x50, &port51_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX9_BUS7, "sff8436", 0x50, &port50_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX9_BUS6, "sff8436", 0x50, &port49_50_sff8436),
-
-	/* devices on pca9548 10 */
-	mk_i2cdev(MP_I2C_MUX10_BUS1, "sff8436", 0x50, &port80_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX10_BUS0, "sff8436", 0x50, &port79_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX10_BUS3, "sff8436", 0x50, &port78_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX10_BUS2, "sff8436", 0x50, &port77_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX10_BUS5, "sff8436", 0x50, &port76_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX10_BUS4, "sff8436", 0x50, &port75_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX10_BUS7, "sff8436", 0x50, &port74_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX10_BUS6, "sff8436", 0x50, &port73_50_sff8436),
-
-	/* devices on pca9548 11 */
-	mk_i2cdev(MP_I2C_MUX11_BUS1, "sff8436", 0x50, &port72_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX11_BUS0, "sff8436", 0x50, &port71_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX11_BUS3, "sff8436", 0x50, &port70_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX11_BUS2, "sff8436", 0x50, &port69_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX11_BUS5, "sff8436", 0x50, &port68_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX11_BUS4, "sff8436", 0x50, &port67_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX11_BUS7, "sff8436", 0x50, &port66_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX11_BUS6, "sff8436", 0x50, &port65_50_sff8436),
-
-	/* devices on pca9548 12 */
-	mk_i2cdev(MP_I2C_MUX12_BUS1, "sff8436", 0x50, &port96_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX12_BUS0, "sff8436", 0x50, &port95_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX12_BUS3, "sff8436", 0x50, &port94_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX12_BUS2, "sff8436", 0x50, &port93_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX12_BUS5, "sff8436", 0x50, &port92_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX12_BUS4, "sff8436", 0x50, &port91_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX12_BUS7, "sff8436", 0x50, &port90_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX12_BUS6, "sff8436", 0x50, &port89_50_sff8436),
-
-	/* devices on pca9548 13 */
-	mk_i2cdev(MP_I2C_MUX13_BUS1, "sff8436", 0x50, &port88_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX13_BUS0, "sff8436", 0x50, &port87_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX13_BUS3, "sff8436", 0x50, &port86_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX13_BUS2, "sff8436", 0x50, &port85_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX13_BUS5, "sff8436", 0x50, &port84_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX13_BUS4, "sff8436", 0x50, &port83_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX13_BUS7, "sff8436", 0x50, &port82_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX13_BUS6, "sff8436", 0x50, &port81_50_sff8436),
-
-	/* devices on pca9548 14 */
-	mk_i2cdev(MP_I2C_MUX14_BUS1, "sff8436", 0x50, &port112_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX14_BUS0, "sff8436", 0x50, &port111_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX14_BUS3, "sff8436", 0x50, &port110_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX14_BUS2, "sff8436", 0x50, &port109_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX14_BUS5, "sff8436", 0x50, &port108_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX14_BUS4, "sff8436", 0x50, &port107_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX14_BUS7, "sff8436", 0x50, &port106_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX14_BUS6, "sff8436", 0x50, &port105_50_sff8436),
-
-	/* devices on pca9548 15 */
-	mk_i2cdev(MP_I2C_MUX15_BUS1, "sff8436", 0x50, &port104_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX15_BUS0, "sff8436", 0x50, &port103_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX15_BUS3, "sff8436", 0x50, &port102_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX15_BUS2, "sff8436", 0x50, &port101_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX15_BUS5, "sff8436", 0x50, &port100_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX15_BUS4, "sff8436", 0x50, &port99_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX15_BUS7, "sff8436", 0x50, &port98_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX15_BUS6, "sff8436", 0x50, &port97_50_sff8436),
-
-	/* devices on pca9548 16 */
-	mk_i2cdev(MP_I2C_MUX16_BUS1, "sff8436", 0x50, &port128_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX16_BUS0, "sff8436", 0x50, &port127_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX16_BUS3, "sff8436", 0x50, &port126_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX16_BUS2, "sff8436", 0x50, &port125_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX16_BUS5, "sff8436", 0x50, &port124_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX16_BUS4, "sff8436", 0x50, &port123_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX16_BUS7, "sff8436", 0x50, &port122_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX16_BUS6, "sff8436", 0x50, &port121_50_sff8436),
-
-	/* devices on pca9548 17 */
-	mk_i2cdev(MP_I2C_MUX17_BUS1, "sff8436", 0x50, &port120_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX17_BUS0, "sff8436", 0x50, &port119_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX17_BUS3, "sff8436", 0x50, &port118_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX17_BUS2, "sff8436", 0x50, &port117_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX17_BUS5, "sff8436", 0x50, &port116_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX17_BUS4, "sff8436", 0x50, &port115_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX17_BUS7, "sff8436", 0x50, &port114_50_sff8436),
-	mk_i2cdev(MP_I2C_MUX17_BUS6, "sff8436", 0x50, &port113_50_sff8436),
+static const struct cumulus_ports_desc i2c_ports_desc = {
+	.name = DRIVER_NAME,
+	.ranges = i2c_port_ranges,
+	.num_ranges = ARRAY_SIZE(i2c_port_ranges),
 };
 
+/* Port eeprom devices from i2c_port_ranges[] */
+static struct cumulus_ports *i2c_ports;
+
 static const char * const led_status_values[] = {
 	"off",
 	"on",
@@ -724,397 +484,74 @@ mk_bf_rw32(fpga, pim6_led_control, PIM6_LED_CONTROL, 4,  3, NULL, 0);
 mk_bf_rw32(fpga, pim7_led_control, PIM7_LED_CONTROL, 4,  3, NULL, 0);
 mk_bf_rw32(fpga, pim8_led_control, PIM8_LED_CONTROL, 4,  3, NULL, 0);
 
-mk_bf_rw32(fpga, pim1_port1_led_status,      PIM1_PORT1_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim1_port1_led_flash,       PIM1_PORT1_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim1_port1_led_profile,     PIM1_PORT1_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim1_port2_led_status,      PIM1_PORT2_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim1_port2_led_flash,       PIM1_PORT2_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim1_port2_led_profile,     PIM1_PORT2_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim1_port3_led_status,      PIM1_PORT3_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim1_port3_led_flash,       PIM1_PORT3_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim1_port3_led_profile,     PIM1_PORT3_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim1_port4_led_status,      PIM1_PORT4_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim1_port4_led_flash,       PIM1_PORT4_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim1_port4_led_profile,     PIM1_PORT4_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim1_port5_led_status,      PIM1_PORT5_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim1_port5_led_flash,       PIM1_PORT5_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim1_port5_led_profile,     PIM1_PORT5_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim1_port6_led_status,      PIM1_PORT6_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim1_port6_led_flash,       PIM1_PORT6_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim1_port6_led_profile,     PIM1_PORT6_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim1_port7_led_status,      PIM1_PORT7_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim1_port7_led_flash,       PIM1_PORT7_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim1_port7_led_profile,     PIM1_PORT7_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim1_port8_led_status,      PIM1_PORT8_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim1_port8_led_flash,       PIM1_PORT8_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim1_port8_led_profile,     PIM1_PORT8_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim1_port9_led_status,      PIM1_PORT9_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim1_port9_led_flash,       PIM1_PORT9_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim1_port9_led_profile,     PIM1_PORT9_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim1_port10_led_status,     PIM1_PORT10_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim1_port10_led_flash,      PIM1_PORT10_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim1_port10_led_profile,    PIM1_PORT10_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim1_port11_led_status,     PIM1_PORT11_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim1_port11_led_flash,      PIM1_PORT11_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim1_port11_led_profile,    PIM1_PORT11_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim1_port12_led_status,     PIM1_PORT12_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim1_port12_led_flash,      PIM1_PORT12_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim1_port12_led_profile,    PIM1_PORT12_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim1_port13_led_status,     PIM1_PORT13_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim1_port13_led_flash,      PIM1_PORT13_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim1_port13_led_profile,    PIM1_PORT13_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim1_port14_led_status,     PIM1_PORT14_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim1_port14_led_flash,      PIM1_PORT14_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim1_port14_led_profile,    PIM1_PORT14_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim1_port15_led_status,     PIM1_PORT15_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim1_port15_led_flash,      PIM1_PORT15_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim1_port15_led_profile,    PIM1_PORT15_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim1_port16_led_status,     PIM1_PORT16_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim1_port16_led_flash,      PIM1_PORT16_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim1_port16_led_profile,    PIM1_PORT16_LED_CONTROL, 2,  3, led_profile_values, 0);
-
-mk_bf_rw32(fpga, pim2_port1_led_status,      PIM2_PORT1_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim2_port1_led_flash,       PIM2_PORT1_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim2_port1_led_profile,     PIM2_PORT1_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim2_port2_led_status,      PIM2_PORT2_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim2_port2_led_flash,       PIM2_PORT2_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim2_port2_led_profile,     PIM2_PORT2_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim2_port3_led_status,      PIM2_PORT3_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim2_port3_led_flash,       PIM2_PORT3_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim2_port3_led_profile,     PIM2_PORT3_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim2_port4_led_status,      PIM2_PORT4_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim2_port4_led_flash,       PIM2_PORT4_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim2_port4_led_profile,     PIM2_PORT4_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim2_port5_led_status,      PIM2_PORT5_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim2_port5_led_flash,       PIM2_PORT5_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim2_port5_led_profile,     PIM2_PORT5_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim2_port6_led_status,      PIM2_PORT6_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim2_port6_led_flash,       PIM2_PORT6_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim2_port6_led_profile,     PIM2_PORT6_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim2_port7_led_status,      PIM2_PORT7_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim2_port7_led_flash,       PIM2_PORT7_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim2_port7_led_profile,     PIM2_PORT7_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim2_port8_led_status,      PIM2_PORT8_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim2_port8_led_flash,       PIM2_PORT8_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim2_port8_led_profile,     PIM2_PORT8_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim2_port9_led_status,      PIM2_PORT9_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim2_port9_led_flash,       PIM2_PORT9_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim2_port9_led_profile,     PIM2_PORT9_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim2_port10_led_status,     PIM2_PORT10_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim2_port10_led_flash,      PIM2_PORT10_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim2_port10_led_profile,    PIM2_PORT10_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim2_port11_led_status,     PIM2_PORT11_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim2_port11_led_flash,      PIM2_PORT11_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim2_port11_led_profile,    PIM2_PORT11_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim2_port12_led_status,     PIM2_PORT12_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim2_port12_led_flash,      PIM2_PORT12_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim2_port12_led_profile,    PIM2_PORT12_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim2_port13_led_status,     PIM2_PORT13_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim2_port13_led_flash,      PIM2_PORT13_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim2_port13_led_profile,    PIM2_PORT13_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim2_port14_led_status,     PIM2_PORT14_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim2_port14_led_flash,      PIM2_PORT14_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim2_port14_led_profile,    PIM2_PORT14_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim2_port15_led_status,     PIM2_PORT15_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim2_port15_led_flash,      PIM2_PORT15_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim2_port15_led_profile,    PIM2_PORT15_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim2_port16_led_status,     PIM2_PORT16_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim2_port16_led_flash,      PIM2_PORT16_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim2_port16_led_profile,    PIM2_PORT16_LED_CONTROL, 2,  3, led_profile_values, 0);
-
-mk_bf_rw32(fpga, pim3_port1_led_status,      PIM3_PORT1_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim3_port1_led_flash,       PIM3_PORT1_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim3_port1_led_profile,     PIM3_PORT1_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim3_port2_led_status,      PIM3_PORT2_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim3_port2_led_flash,       PIM3_PORT2_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim3_port2_led_profile,     PIM3_PORT2_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim3_port3_led_status,      PIM3_PORT3_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim3_port3_led_flash,       PIM3_PORT3_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim3_port3_led_profile,     PIM3_PORT3_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim3_port4_led_status,      PIM3_PORT4_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim3_port4_led_flash,       PIM3_PORT4_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim3_port4_led_profile,     PIM3_PORT4_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim3_port5_led_status,      PIM3_PORT5_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim3_port5_led_flash,       PIM3_PORT5_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim3_port5_led_profile,     PIM3_PORT5_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim3_port6_led_status,      PIM3_PORT6_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim3_port6_led_flash,       PIM3_PORT6_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim3_port6_led_profile,     PIM3_PORT6_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim3_port7_led_status,      PIM3_PORT7_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim3_port7_led_flash,       PIM3_PORT7_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim3_port7_led_profile,     PIM3_PORT7_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim3_port8_led_status,      PIM3_PORT8_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim3_port8_led_flash,       PIM3_PORT8_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim3_port8_led_profile,     PIM3_PORT8_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim3_port9_led_status,      PIM3_PORT9_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim3_port9_led_flash,       PIM3_PORT9_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim3_port9_led_profile,     PIM3_PORT9_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim3_port10_led_status,     PIM3_PORT10_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim3_port10_led_flash,      PIM3_PORT10_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim3_port10_led_profile,    PIM3_PORT10_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim3_port11_led_status,     PIM3_PORT11_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim3_port11_led_flash,      PIM3_PORT11_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim3_port11_led_profile,    PIM3_PORT11_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim3_port12_led_status,     PIM3_PORT12_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim3_port12_led_flash,      PIM3_PORT12_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim3_port12_led_profile,    PIM3_PORT12_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim3_port13_led_status,     PIM3_PORT13_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim3_port13_led_flash,      PIM3_PORT13_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim3_port13_led_profile,    PIM3_PORT13_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim3_port14_led_status,     PIM3_PORT14_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim3_port14_led_flash,      PIM3_PORT14_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim3_port14_led_profile,    PIM3_PORT14_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim3_port15_led_status,     PIM3_PORT15_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim3_port15_led_flash,      PIM3_PORT15_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim3_port15_led_profile,    PIM3_PORT15_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim3_port16_led_status,     PIM3_PORT16_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim3_port16_led_flash,      PIM3_PORT16_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim3_port16_led_profile,    PIM3_PORT16_LED_CONTROL, 2,  3, led_profile_values, 0);
-
-mk_bf_rw32(fpga, pim4_port1_led_status,      PIM4_PORT1_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim4_port1_led_flash,       PIM4_PORT1_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim4_port1_led_profile,     PIM4_PORT1_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim4_port2_led_status,      PIM4_PORT2_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim4_port2_led_flash,       PIM4_PORT2_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim4_port2_led_profile,     PIM4_PORT2_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim4_port3_led_status,      PIM4_PORT3_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim4_port3_led_flash,       PIM4_PORT3_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim4_port3_led_profile,     PIM4_PORT3_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim4_port4_led_status,      PIM4_PORT4_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim4_port4_led_flash,       PIM4_PORT4_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim4_port4_led_profile,     PIM4_PORT4_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim4_port5_led_status,      PIM4_PORT5_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim4_port5_led_flash,       PIM4_PORT5_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim4_port5_led_profile,     PIM4_PORT5_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim4_port6_led_status,      PIM4_PORT6_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim4_port6_led_flash,       PIM4_PORT6_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim4_port6_led_profile,     PIM4_PORT6_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim4_port7_led_status,      PIM4_PORT7_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim4_port7_led_flash,       PIM4_PORT7_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim4_port7_led_profile,     PIM4_PORT7_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim4_port8_led_status,      PIM4_PORT8_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim4_port8_led_flash,       PIM4_PORT8_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim4_port8_led_profile,     PIM4_PORT8_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim4_port9_led_status,      PIM4_PORT9_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim4_port9_led_flash,       PIM4_PORT9_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim4_port9_led_profile,     PIM4_PORT9_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim4_port10_led_status,     PIM4_PORT10_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim4_port10_led_flash,      PIM4_PORT10_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim4_port10_led_profile,    PIM4_PORT10_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim4_port11_led_status,     PIM4_PORT11_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim4_port11_led_flash,      PIM4_PORT11_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim4_port11_led_profile,    PIM4_PORT11_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim4_port12_led_status,     PIM4_PORT12_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim4_port12_led_flash,      PIM4_PORT12_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim4_port12_led_profile,    PIM4_PORT12_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim4_port13_led_status,     PIM4_PORT13_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim4_port13_led_flash,      PIM4_PORT13_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim4_port13_led_profile,    PIM4_PORT13_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim4_port14_led_status,     PIM4_PORT14_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim4_port14_led_flash,      PIM4_PORT14_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim4_port14_led_profile,    PIM4_PORT14_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim4_port15_led_status,     PIM4_PORT15_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim4_port15_led_flash,      PIM4_PORT15_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim4_port15_led_profile,    PIM4_PORT15_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim4_port16_led_status,     PIM4_PORT16_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim4_port16_led_flash,      PIM4_PORT16_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim4_port16_led_profile,    PIM4_PORT16_LED_CONTROL, 2,  3, led_profile_values, 0);
-
-mk_bf_rw32(fpga, pim5_port1_led_status,      PIM5_PORT1_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim5_port1_led_flash,       PIM5_PORT1_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim5_port1_led_profile,     PIM5_PORT1_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim5_port2_led_status,      PIM5_PORT2_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim5_port2_led_flash,       PIM5_PORT2_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim5_port2_led_profile,     PIM5_PORT2_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim5_port3_led_status,      PIM5_PORT3_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim5_port3_led_flash,       PIM5_PORT3_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim5_port3_led_profile,     PIM5_PORT3_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim5_port4_led_status,      PIM5_PORT4_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim5_port4_led_flash,       PIM5_PORT4_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim5_port4_led_profile,     PIM5_PORT4_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim5_port5_led_status,      PIM5_PORT5_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim5_port5_led_flash,       PIM5_PORT5_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim5_port5_led_profile,     PIM5_PORT5_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim5_port6_led_status,      PIM5_PORT6_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim5_port6_led_flash,       PIM5_PORT6_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim5_port6_led_profile,     PIM5_PORT6_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim5_port7_led_status,      PIM5_PORT7_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim5_port7_led_flash,       PIM5_PORT7_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim5_port7_led_profile,     PIM5_PORT7_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim5_port8_led_status,      PIM5_PORT8_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim5_port8_led_flash,       PIM5_PORT8_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim5_port8_led_profile,     PIM5_PORT8_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim5_port9_led_status,      PIM5_PORT9_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim5_port9_led_flash,       PIM5_PORT9_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim5_port9_led_profile,     PIM5_PORT9_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim5_port10_led_status,     PIM5_PORT10_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim5_port10_led_flash,      PIM5_PORT10_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim5_port10_led_profile,    PIM5_PORT10_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim5_port11_led_status,     PIM5_PORT11_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim5_port11_led_flash,      PIM5_PORT11_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim5_port11_led_profile,    PIM5_PORT11_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim5_port12_led_status,     PIM5_PORT12_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim5_port12_led_flash,      PIM5_PORT12_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim5_port12_led_profile,    PIM5_PORT12_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim5_port13_led_status,     PIM5_PORT13_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim5_port13_led_flash,      PIM5_PORT13_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim5_port13_led_profile,    PIM5_PORT13_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim5_port14_led_status,     PIM5_PORT14_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim5_port14_led_flash,      PIM5_PORT14_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim5_port14_led_profile,    PIM5_PORT14_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim5_port15_led_status,     PIM5_PORT15_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim5_port15_led_flash,      PIM5_PORT15_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim5_port15_led_profile,    PIM5_PORT15_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim5_port16_led_status,     PIM5_PORT16_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim5_port16_led_flash,      PIM5_PORT16_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim5_port16_led_profile,    PIM5_PORT16_LED_CONTROL, 2,  3, led_profile_values, 0);
-
-mk_bf_rw32(fpga, pim6_port1_led_status,      PIM6_PORT1_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim6_port1_led_flash,       PIM6_PORT1_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim6_port1_led_profile,     PIM6_PORT1_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim6_port2_led_status,      PIM6_PORT2_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim6_port2_led_flash,       PIM6_PORT2_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim6_port2_led_profile,     PIM6_PORT2_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim6_port3_led_status,      PIM6_PORT3_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim6_port3_led_flash,       PIM6_PORT3_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim6_port3_led_profile,     PIM6_PORT3_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim6_port4_led_status,      PIM6_PORT4_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim6_port4_led_flash,       PIM6_PORT4_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim6_port4_led_profile,     PIM6_PORT4_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim6_port5_led_status,      PIM6_PORT5_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim6_port5_led_flash,       PIM6_PORT5_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim6_port5_led_profile,     PIM6_PORT5_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim6_port6_led_status,      PIM6_PORT6_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim6_port6_led_flash,       PIM6_PORT6_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim6_port6_led_profile,     PIM6_PORT6_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim6_port7_led_status,      PIM6_PORT7_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim6_port7_led_flash,       PIM6_PORT7_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim6_port7_led_profile,     PIM6_PORT7_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim6_port8_led_status,      PIM6_PORT8_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim6_port8_led_flash,       PIM6_PORT8_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim6_port8_led_profile,     PIM6_PORT8_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim6_port9_led_status,      PIM6_PORT9_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim6_port9_led_flash,       PIM6_PORT9_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim6_port9_led_profile,     PIM6_PORT9_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim6_port10_led_status,     PIM6_PORT10_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim6_port10_led_flash,      PIM6_PORT10_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim6_port10_led_profile,    PIM6_PORT10_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim6_port11_led_status,     PIM6_PORT11_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim6_port11_led_flash,      PIM6_PORT11_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim6_port11_led_profile,    PIM6_PORT11_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim6_port12_led_status,     PIM6_PORT12_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim6_port12_led_flash,      PIM6_PORT12_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim6_port12_led_profile,    PIM6_PORT12_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim6_port13_led_status,     PIM6_PORT13_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim6_port13_led_flash,      PIM6_PORT13_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim6_port13_led_profile,    PIM6_PORT13_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim6_port14_led_status,     PIM6_PORT14_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim6_port14_led_flash,      PIM6_PORT14_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim6_port14_led_profile,    PIM6_PORT14_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim6_port15_led_status,     PIM6_PORT15_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim6_port15_led_flash,      PIM6_PORT15_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim6_port15_led_profile,    PIM6_PORT15_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim6_port16_led_status,     PIM6_PORT16_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim6_port16_led_flash,      PIM6_PORT16_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim6_port16_led_profile,    PIM6_PORT16_LED_CONTROL, 2,  3, led_profile_values, 0);
-
-mk_bf_rw32(fpga, pim7_port1_led_status,      PIM7_PORT1_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim7_port1_led_flash,       PIM7_PORT1_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim7_port1_led_profile,     PIM7_PORT1_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim7_port2_led_status,      PIM7_PORT2_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim7_port2_led_flash,       PIM7_PORT2_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim7_port2_led_profile,     PIM7_PORT2_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim7_port3_led_status,      PIM7_PORT3_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim7_port3_led_flash,       PIM7_PORT3_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim7_port3_led_profile,     PIM7_PORT3_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim7_port4_led_status,      PIM7_PORT4_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim7_port4_led_flash,       PIM7_PORT4_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim7_port4_led_profile,     PIM7_PORT4_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim7_port5_led_status,      PIM7_PORT5_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim7_port5_led_flash,       PIM7_PORT5_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim7_port5_led_profile,     PIM7_PORT5_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim7_port6_led_status,      PIM7_PORT6_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim7_port6_led_flash,       PIM7_PORT6_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim7_port6_led_profile,     PIM7_PORT6_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim7_port7_led_status,      PIM7_PORT7_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim7_port7_led_flash,       PIM7_PORT7_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim7_port7_led_profile,     PIM7_PORT7_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim7_port8_led_status,      PIM7_PORT8_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim7_port8_led_flash,       PIM7_PORT8_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim7_port8_led_profile,     PIM7_PORT8_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim7_port9_led_status,      PIM7_PORT9_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim7_port9_led_flash,       PIM7_PORT9_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim7_port9_led_profile,     PIM7_PORT9_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim7_port10_led_status,     PIM7_PORT10_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim7_port10_led_flash,      PIM7_PORT10_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim7_port10_led_profile,    PIM7_PORT10_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim7_port11_led_status,     PIM7_PORT11_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim7_port11_led_flash,      PIM7_PORT11_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim7_port11_led_profile,    PIM7_PORT11_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim7_port12_led_status,     PIM7_PORT12_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim7_port12_led_flash,      PIM7_PORT12_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim7_port12_led_profile,    PIM7_PORT12_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim7_port13_led_status,     PIM7_PORT13_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim7_port13_led_flash,      PIM7_PORT13_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim7_port13_led_profile,    PIM7_PORT13_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim7_port14_led_status,     PIM7_PORT14_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim7_port14_led_flash,      PIM7_PORT14_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim7_port14_led_profile,    PIM7_PORT14_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim7_port15_led_status,     PIM7_PORT15_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim7_port15_led_flash,      PIM7_PORT15_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim7_port15_led_profile,    PIM7_PORT15_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim7_port16_led_status,     PIM7_PORT16_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim7_port16_led_flash,      PIM7_PORT16_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim7_port16_led_profile,    PIM7_PORT16_LED_CONTROL, 2,  3, led_profile_values, 0);
-
-mk_bf_rw32(fpga, pim8_port1_led_status,      PIM8_PORT1_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim8_port1_led_flash,       PIM8_PORT1_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim8_port1_led_profile,     PIM8_PORT1_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim8_port2_led_status,      PIM8_PORT2_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim8_port2_led_flash,       PIM8_PORT2_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim8_port2_led_profile,     PIM8_PORT2_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim8_port3_led_status,      PIM8_PORT3_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim8_port3_led_flash,       PIM8_PORT3_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim8_port3_led_profile,     PIM8_PORT3_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim8_port4_led_status,      PIM8_PORT4_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim8_port4_led_flash,       PIM8_PORT4_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim8_port4_led_profile,     PIM8_PORT4_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim8_port5_led_status,      PIM8_PORT5_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim8_port5_led_flash,       PIM8_PORT5_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim8_port5_led_profile,     PIM8_PORT5_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim8_port6_led_status,      PIM8_PORT6_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim8_port6_led_flash,       PIM8_PORT6_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim8_port6_led_profile,     PIM8_PORT6_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim8_port7_led_status,      PIM8_PORT7_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim8_port7_led_flash,       PIM8_PORT7_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim8_port7_led_profile,     PIM8_PORT7_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim8_port8_led_status,      PIM8_PORT8_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim8_port8_led_flash,       PIM8_PORT8_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim8_port8_led_profile,     PIM8_PORT8_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim8_port9_led_status,      PIM8_PORT9_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim8_port9_led_flash,       PIM8_PORT9_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim8_port9_led_profile,     PIM8_PORT9_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim8_port10_led_status,     PIM8_PORT10_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim8_port10_led_flash,      PIM8_PORT10_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim8_port10_led_profile,    PIM8_PORT10_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim8_port11_led_status,     PIM8_PORT11_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim8_port11_led_flash,      PIM8_PORT11_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim8_port11_led_profile,    PIM8_PORT11_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim8_port12_led_status,     PIM8_PORT12_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim8_port12_led_flash,      PIM8_PORT12_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim8_port12_led_profile,    PIM8_PORT12_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim8_port13_led_status,     PIM8_PORT13_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim8_port13_led_flash,      PIM8_PORT13_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim8_port13_led_profile,    PIM8_PORT13_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim8_port14_led_status,     PIM8_PORT14_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim8_port14_led_flash,      PIM8_PORT14_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim8_port14_led_profile,    PIM8_PORT14_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim8_port15_led_status,     PIM8_PORT15_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim8_port15_led_flash,      PIM8_PORT15_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim8_port15_led_profile,    PIM8_PORT15_LED_CONTROL, 2,  3, led_profile_values, 0);
-mk_bf_rw32(fpga, pim8_port16_led_status,     PIM8_PORT16_LED_CONTROL, 0,  1, led_status_values, 0);
-mk_bf_rw32(fpga, pim8_port16_led_flash,      PIM8_PORT16_LED_CONTROL, 1,  1, led_flash_values, 0);
-mk_bf_rw32(fpga, pim8_port16_led_profile,    PIM8_PORT16_LED_CONTROL, 2,  3, led_profile_values, 0);
+/*
+ * Front panel port LEDs, built at probe time, see cumulus-ports.c.
+ * Each port has a 32-bit LED control register in its PIM block,
+ * exposed as pimN_portM_led_{status,flash,profile} with M counting
+ * from 1 on every PIM.
+ */
+#define mp_port_led_field(_name, _pim, _shift, _width, _values) \
+	{ \
+		.name = _name, \
+		.values = _values, \
+		.reg = PIM##_pim##_PORT1_LED_CONTROL, \
+		.shift = (_shift), \
+		.width = (_width), \
+		.num_values = BF_NUM_VALUES(_values), \
+		.mode = 0644, \
+	}
+
+#define mp_port_led_fields(_pim) \
+	static const struct cumulus_port_field pim##_pim##_led_fields[] = { \
+		mp_port_led_field("led_status", _pim, 0, 1, \
+				  led_status_values), \
+		mp_port_led_field("led_flash", _pim, 1, 1, \
+				  led_flash_values), \
+		mp_port_led_field("led_profile", _pim, 2, 3, \
+				  led_profile_values), \
+	}
+
+mp_port_led_fields(1);
+mp_port_led_fields(2);
+mp_port_led_fields(3);
+mp_port_led_fields(4);
+mp_port_led_fields(5);
+mp_port_led_fields(6);
+mp_port_led_fields(7);
+mp_port_led_fields(8);
+
+#define mp_port_leds(_pim) \
+	{ \
+		.first = 16 * ((_pim) - 1) + 1, \
+		.count = 16, \
+		.reg_stride = 4, \
+		.fields = pim##_pim##_led_fields, \
+		.num_fields = ARRAY_SIZE(pim##_pim##_led_fields), \
+		.attr_prefix = "pim" #_pim "_", \
+		.attr_first = 1, \
+	}
+
+static const struct cumulus_port_range fpga_port_ranges[] = {
+	mp_port_leds(1),
+	mp_port_leds(2),
+	mp_port_leds(3),
+	mp_port_leds(4),
+	mp_port_leds(5),
+	mp_port_leds(6),
+	mp_port_leds(7),
+	mp_port_leds(8),
+};
+
+static const struct cumulus_ports_desc fpga_ports_desc = {
+	.name = FPGA_DRIVER,
+	.ranges = fpga_port_ranges,
+	.num_ranges = ARRAY_SIZE(fpga_port_ranges),
+	.read = fpga_read_reg,
+	.write = fpga_write_reg,
+};
+
+/* Port LED attributes from fpga_port_ranges[] */
+static struct cumulus_ports *fpga_ports;
 
 static struct attribute *fpga_attrs[] = {
 	&fpga_device_id.attr,
@@ -1195,390 +632,6 @@ static struct attribute *fpga_attrs[] = {
 	&fpga_pim6_led_control.attr,
 	&fpga_pim7_led_control.attr,
 	&fpga_pim8_led_control.attr,
-	&fpga_pim1_port1_led_status.attr,
-	&fpga_pim1_port1_led_flash.attr,
-	&fpga_pim1_port1_led_profile.attr,
-	&fpga_pim1_port2_led_status.attr,
-	&fpga_pim1_port2_led_flash.attr,
-	&fpga_pim1_port2_led_profile.attr,
-	&fpga_pim1_port3_led_status.attr,
-	&fpga_pim1_port3_led_flash.attr,
-	&fpga_pim1_port3_led_profile.attr,
-	&fpga_pim1_port4_led_status.attr,
-	&fpga_pim1_port4_led_flash.attr,
-	&fpga_pim1_port4_led_profile.attr,
-	&fpga_pim1_port5_led_status.attr,
-	&fpga_pim1_port5_led_flash.attr,
-	&fpga_pim1_port5_led_profile.attr,
-	&fpga_pim1_port6_led_status.attr,
-	&fpga_pim1_port6_led_flash.attr,
-	&fpga_pim1_port6_led_profile.attr,
-	&fpga_pim1_port7_led_status.attr,
-	&fpga_pim1_port7_led_flash.attr,
-	&fpga_pim1_port7_led_profile.attr,
-	&fpga_pim1_port8_led_status.attr,
-	&fpga_pim1_port8_led_flash.attr,
-	&fpga_pim1_port8_led_profile.attr,
-	&fpga_pim1_port9_led_status.attr,
-	&fpga_pim1_port9_led_flash.attr,
-	&fpga_pim1_port9_led_profile.attr,
-	&fpga_pim1_port10_led_status.attr,
-	&fpga_pim1_port10_led_flash.attr,
-	&fpga_pim1_port10_led_profile.attr,
-	&fpga_pim1_port11_led_status.attr,
-	&fpga_pim1_port11_led_flash.attr,
-	&fpga_pim1_port11_led_profile.attr,
-	&fpga_pim1_port12_led_status.attr,
-	&fpga_pim1_port12_led_flash.attr,
-	&fpga_pim1_port12_led_profile.attr,
-	&fpga_pim1_port13_led_status.attr,
-	&fpga_pim1_port13_led_flash.attr,
-	&fpga_pim1_port13_led_profile.attr,
-	&fpga_pim1_port14_led_status.attr,
-	&fpga_pim1_port14_led_flash.attr,
-	&fpga_pim1_port14_led_profile.attr,
-	&fpga_pim1_port15_led_status.attr,
-	&fpga_pim1_port15_led_flash.attr,
-	&fpga_pim1_port15_led_profile.attr,
-	&fpga_pim1_port16_led_status.attr,
-	&fpga_pim1_port16_led_flash.attr,
-	&fpga_pim1_port16_led_profile.attr,
-	&fpga_pim2_port1_led_status.attr,
-	&fpga_pim2_port1_led_flash.attr,
-	&fpga_pim2_port1_led_profile.attr,
-	&fpga_pim2_port2_led_status.attr,
-	&fpga_pim2_port2_led_flash.attr,
-	&fpga_pim2_port2_led_profile.attr,
-	&fpga_pim2_port3_led_status.attr,
-	&fpga_pim2_port3_led_flash.attr,
-	&fpga_pim2_port3_led_profile.attr,
-	&fpga_pim2_port4_led_status.attr,
-	&fpga_pim2_port4_led_flash.attr,
-	&fpga_pim2_port4_led_profile.attr,
-	&fpga_pim2_port5_led_status.attr,
-	&fpga_pim2_port5_led_flash.attr,
-	&fpga_pim2_port5_led_profile.attr,
-	&fpga_pim2_port6_led_status.attr,
-	&fpga_pim2_port6_led_flash.attr,
-	&fpga_pim2_port6_led_profile.attr,
-	&fpga_pim2_port7_led_status.attr,
-	&fpga_pim2_port7_led_flash.attr,
-	&fpga_pim2_port7_led_profile.attr,
-	&fpga_pim2_port8_led_status.attr,
-	&fpga_pim2_port8_led_flash.attr,
-	&fpga_pim2_port8_led_profile.attr,
-	&fpga_pim2_port9_led_status.attr,
-	&fpga_pim2_port9_led_flash.attr,
-	&fpga_pim2_port9_led_profile.attr,
-	&fpga_pim2_port10_led_status.attr,
-	&fpga_pim2_port10_led_flash.attr,
-	&fpga_pim2_port10_led_profile.attr,
-	&fpga_pim2_port11_led_status.attr,
-	&fpga_pim2_port11_led_flash.attr,
-	&fpga_pim2_port11_led_profile.attr,
-	&fpga_pim2_port12_led_status.attr,
-	&fpga_pim2_port12_led_flash.attr,
-	&fpga_pim2_port12_led_profile.attr,
-	&fpga_pim2_port13_led_status.attr,
-	&fpga_pim2_port13_led_flash.attr,
-	&fpga_pim2_port13_led_profile.attr,
-	&fpga_pim2_port14_led_status.attr,
-	&fpga_pim2_port14_led_flash.attr,
-	&fpga_pim2_port14_led_profile.attr,
-	&fpga_pim2_port15_led_status.attr,
-	&fpga_pim2_port15_led_flash.attr,
-	&fpga_pim2_port15_led_profile.attr,
-	&fpga_pim2_port16_led_status.attr,
-	&fpga_pim2_port16_led_flash.attr,
-	&fpga_pim2_port16_led_profile.attr,
-	&fpga_pim3_port1_led_status.attr,
-	&fpga_pim3_port1_led_flash.attr,
-	&fpga_pim3_port1_led_profile.attr,
-	&fpga_pim3_port2_led_status.attr,
-	&fpga_pim3_port2_led_flash.attr,
-	&fpga_pim3_port2_led_profile.attr,
-	&fpga_pim3_port3_led_status.attr,
-	&fpga_pim3_port3_led_flash.attr,
-	&fpga_pim3_port3_led_profile.attr,
-	&fpga_pim3_port4_led_status.attr,
-	&fpga_pim3_port4_led_flash.attr,
-	&fpga_pim3_port4_led_profile.attr,
-	&fpga_pim3_port5_led_status.attr,
-	&fpga_pim3_port5_led_flash.attr,
-	&fpga_pim3_port5_led_profile.attr,
-	&fpga_pim3_port6_led_status.attr,
-	&fpga_pim3_port6_led_flash.attr,
-	&fpga_pim3_port6_led_profile.attr,
-	&fpga_pim3_port7_led_status.attr,
-	&fpga_pim3_port7_led_flash.attr,
-	&fpga_pim3_port7_led_profile.attr,
-	&fpga_pim3_port8_led_status.attr,
-	&fpga_pim3_port8_led_flash.attr,
-	&fpga_pim3_port8_led_profile.attr,
-	&fpga_pim3_port9_led_status.attr,
-	&fpga_pim3_port9_led_flash.attr,
-	&fpga_pim3_port9_led_profile.attr,
-	&fpga_pim3_port10_led_status.attr,
-	&fpga_pim3_port10_led_flash.attr,
-	&fpga_pim3_port10_led_profile.attr,
-	&fpga_pim3_port11_led_status.attr,
-	&fpga_pim3_port11_led_flash.attr,
-	&fpga_pim3_port11_led_profile.attr,
-	&fpga_pim3_port12_led_status.attr,
-	&fpga_pim3_port12_led_flash.attr,
-	&fpga_pim3_port12_led_profile.attr,
-	&fpga_pim3_port13_led_status.attr,
-	&fpga_pim3_port13_led_flash.attr,
-	&fpga_pim3_port13_led_profile.attr,
-	&fpga_pim3_port14_led_status.attr,
-	&fpga_pim3_port14_led_flash.attr,
-	&fpga_pim3_port14_led_profile.attr,
-	&fpga_pim3_port15_led_status.attr,
-	&fpga_pim3_port15_led_flash.attr,
-	&fpga_pim3_port15_led_profile.attr,
-	&fpga_pim3_port16_led_status.attr,
-	&fpga_pim3_port16_led_flash.attr,
-	&fpga_pim3_port16_led_profile.attr,
-	&fpga_pim4_port1_led_status.attr,
-	&fpga_pim4_port1_led_flash.attr,
-	&fpga_pim4_port1_led_profile.attr,
-	&fpga_pim4_port2_led_status.attr,
-	&fpga_pim4_port2_led_flash.attr,
-	&fpga_pim4_port2_led_profile.attr,
-	&fpga_pim4_port3_led_status.attr,
-	&fpga_pim4_port3_led_flash.attr,
-	&fpga_pim4_port3_led_profile.attr,
-	&fpga_pim4_port4_led_status.attr,
-	&fpga_pim4_port4_led_flash.attr,
-	&fpga_pim4_port4_led_profile.attr,
-	&fpga_pim4_port5_led_status.attr,
-	&fpga_pim4_port5_led_flash.attr,
-	&fpga_pim4_port5_led_profile.attr,
-	&fpga_pim4_port6_led_status.attr,
-	&fpga_pim4_port6_led_flash.attr,
-	&fpga_pim4_port6_led_profile.attr,
-	&fpga_pim4_port7_led_status.attr,
-	&fpga_pim4_port7_led_flash.attr,
-	&fpga_pim4_port7_led_profile.attr,
-	&fpga_pim4_port8_led_status.attr,
-	&fpga_pim4_port8_led_flash.attr,
-	&fpga_pim4_port8_led_profile.attr,
-	&fpga_pim4_port9_led_status.attr,
-	&fpga_pim4_port9_led_flash.attr,
-	&fpga_pim4_port9_led_profile.attr,
-	&fpga_pim4_port10_led_status.attr,
-	&fpga_pim4_port10_led_flash.attr,
-	&fpga_pim4_port10_led_profile.attr,
-	&fpga_pim4_port11_led_status.attr,
-	&fpga_pim4_port11_led_flash.attr,
-	&fpga_pim4_port11_led_profile.attr,
-	&fpga_pim4_port12_led_status.attr,
-	&fpga_pim4_port12_led_flash.attr,
-	&fpga_pim4_port12_led_profile.attr,
-	&fpga_pim4_port13_led_status.attr,
-	&fpga_pim4_port13_led_flash.attr,
-	&fpga_pim4_port13_led_profile.attr,
-	&fpga_pim4_port14_led_status.attr,
-	&fpga_pim4_port14_led_flash.attr,
-	&fpga_pim4_port14_led_profile.attr,
-	&fpga_pim4_port15_led_status.attr,
-	&fpga_pim4_port15_led_flash.attr,
-	&fpga_pim4_port15_led_profile.attr,
-	&fpga_pim4_port16_led_status.attr,
-	&fpga_pim4_port16_led_flash.attr,
-	&fpga_pim4_port16_led_profile.attr,
-	&fpga_pim5_port1_led_status.attr,
-	&fpga_pim5_port1_led_flash.attr,
-	&fpga_pim5_port1_led_profile.attr,
-	&fpga_pim5_port2_led_status.attr,
-	&fpga_pim5_port2_led_flash.attr,
-	&fpga_pim5_port2_led_profile.attr,
-	&fpga_pim5_port3_led_status.attr,
-	&fpga_pim5_port3_led_flash.attr,
-	&fpga_pim5_port3_led_profile.attr,
-	&fpga_pim5_port4_led_status.attr,
-	&fpga_pim5_port4_led_flash.attr,
-	&fpga_pim5_port4_led_profile.attr,
-	&fpga_pim5_port5_led_status.attr,
-	&fpga_pim5_port5_led_flash.attr,
-	&fpga_pim5_port5_led_profile.attr,
-	&fpga_pim5_port6_led_status.attr,
-	&fpga_pim5_port6_led_flash.attr,
-	&fpga_pim5_port6_led_profile.attr,
-	&fpga_pim5_port7_led_status.attr,
-	&fpga_pim5_port7_led_flash.attr,
-	&fpga_pim5_port7_led_profile.attr,
-	&fpga_pim5_port8_led_status.attr,
-	&fpga_pim5_port8_led_flash.attr,
-	&fpga_pim5_port8_led_profile.attr,
-	&fpga_pim5_port9_led_status.attr,
-	&fpga_pim5_port9_led_flash.attr,
-	&fpga_pim5_port9_led_profile.attr,
-	&fpga_pim5_port10_led_status.attr,
-	&fpga_pim5_port10_led_flash.attr,
-	&fpga_pim5_port10_led_profile.attr,
-	&fpga_pim5_port11_led_status.attr,
-	&fpga_pim5_port11_led_flash.attr,
-	&fpga_pim5_port11_led_profile.attr,
-	&fpga_pim5_port12_led_status.attr,
-	&fpga_pim5_port12_led_flash.attr,
-	&fpga_pim5_port12_led_profile.attr,
-	&fpga_pim5_port13_led_status.attr,
-	&fpga_pim5_port13_led_flash.attr,
-	&fpga_pim5_port13_led_profile.attr,
-	&fpga_pim5_port14_led_status.attr,
-	&fpga_pim5_port14_led_flash.attr,
-	&fpga_pim5_port14_led_profile.attr,
-	&fpga_pim5_port15_led_status.attr,
-	&fpga_pim5_port15_led_flash.attr,
-	&fpga_pim5_port15_led_profile.attr,
-	&fpga_pim5_port16_led_status.attr,
-	&fpga_pim5_port16_led_flash.attr,
-	&fpga_pim5_port16_led_profile.attr,
-	&fpga_pim6_port1_led_status.attr,
-	&fpga_pim6_port1_led_flash.attr,
-	&fpga_pim6_port1_led_profile.attr,
-	&fpga_pim6_port2_led_status.attr,
-	&fpga_pim6_port2_led_flash.attr,
-	&fpga_pim6_port2_led_profile.attr,
-	&fpga_pim6_port3_led_status.attr,
-	&fpga_pim6_port3_led_flash.attr,
-	&fpga_pim6_port3_led_profile.attr,
-	&fpga_pim6_port4_led_status.attr,
-	&fpga_pim6_port4_led_flash.attr,
-	&fpga_pim6_port4_led_profile.attr,
-	&fpga_pim6_port5_led_status.attr,
-	&fpga_pim6_port5_led_flash.attr,
-	&fpga_pim6_port5_led_profile.attr,
-	&fpga_pim6_port6_led_status.attr,
-	&fpga_pim6_port6_led_flash.attr,
-	&fpga_pim6_port6_led_profile.attr,
-	&fpga_pim6_port7_led_status.attr,
-	&fpga_pim6_port7_led_flash.attr,
-	&fpga_pim6_port7_led_profile.attr,
-	&fpga_pim6_port8_led_status.attr,
-	&fpga_pim6_port8_led_flash.attr,
-	&fpga_pim6_port8_led_profile.attr,
-	&fpga_pim6_port9_led_status.attr,
-	&fpga_pim6_port9_led_flash.attr,
-	&fpga_pim6_port9_led_profile.attr,
-	&fpga_pim6_port10_led_status.attr,
-	&fpga_pim6_port10_led_flash.attr,
-	&fpga_pim6_port10_led_profile.attr,
-	&fpga_pim6_port11_led_status.attr,
-	&fpga_pim6_port11_led_flash.attr,
-	&fpga_pim6_port11_led_profile.attr,
-	&fpga_pim6_port12_led_status.attr,
-	&fpga_pim6_port12_led_flash.attr,
-	&fpga_pim6_port12_led_profile.attr,
-	&fpga_pim6_port13_led_status.attr,
-	&fpga_pim6_port13_led_flash.attr,
-	&fpga_pim6_port13_led_profile.attr,
-	&fpga_pim6_port14_led_status.attr,
-	&fpga_pim6_port14_led_flash.attr,
-	&fpga_pim6_port14_led_profile.attr,
-	&fpga_pim6_port15_led_status.attr,
-	&fpga_pim6_port15_led_flash.attr,
-	&fpga_pim6_port15_led_profile.attr,
-	&fpga_pim6_port16_led_status.attr,
-	&fpga_pim6_port16_led_flash.attr,
-	&fpga_pim6_port16_led_profile.attr,
-	&fpga_pim7_port1_led_status.attr,
-	&fpga_pim7_port1_led_flash.attr,
-	&fpga_pim7_port1_led_profile.attr,
-	&fpga_pim7_port2_led_status.attr,
-	&fpga_pim7_port2_led_flash.attr,
-	&fpga_pim7_port2_led_profile.attr,
-	&fpga_pim7_port3_led_status.attr,
-	&fpga_pim7_port3_led_flash.attr,
-	&fpga_pim7_port3_led_profile.attr,
-	&fpga_pim7_port4_led_status.attr,
-	&fpga_pim7_port4_led_flash.attr,
-	&fpga_pim7_port4_led_profile.attr,
-	&fpga_pim7_port5_led_status.attr,
-	&fpga_pim7_port5_led_flash.attr,
-	&fpga_pim7_port5_led_profile.attr,
-	&fpga_pim7_port6_led_status.attr,
-	&fpga_pim7_port6_led_flash.attr,
-	&fpga_pim7_port6_led_profile.attr,
-	&fpga_pim7_port7_led_status.attr,
-	&fpga_pim7_port7_led_flash.attr,
-	&fpga_pim7_port7_led_profile.attr,
-	&fpga_pim7_port8_led_status.attr,
-	&fpga_pim7_port8_led_flash.attr,
-	&fpga_pim7_port8_led_profile.attr,
-	&fpga_pim7_port9_led_status.attr,
-	&fpga_pim7_port9_led_flash.attr,
-	&fpga_pim7_port9_led_profile.attr,
-	&fpga_pim7_port10_led_status.attr,
-	&fpga_pim7_port10_led_flash.attr,
-	&fpga_pim7_port10_led_profile.attr,
-	&fpga_pim7_port11_led_status.attr,
-	&fpga_pim7_port11_led_flash.attr,
-	&fpga_pim7_port11_led_profile.attr,
-	&fpga_pim7_port12_led_status.attr,
-	&fpga_pim7_port12_led_flash.attr,
-	&fpga_pim7_port12_led_profile.attr,
-	&fpga_pim7_port13_led_status.attr,
-	&fpga_pim7_port13_led_flash.attr,
-	&fpga_pim7_port13_led_profile.attr,
-	&fpga_pim7_port14_led_status.attr,
-	&fpga_pim7_port14_led_flash.attr,
-	&fpga_pim7_port14_led_profile.attr,
-	&fpga_pim7_port15_led_status.attr,
-	&fpga_pim7_port15_led_flash.attr,
-	&fpga_pim7_port15_led_profile.attr,
-	&fpga_pim7_port16_led_status.attr,
-	&fpga_pim7_port16_led_flash.attr,
-	&fpga_pim7_port16_led_profile.attr,
-	&fpga_pim8_port1_led_status.attr,
-	&fpga_pim8_port1_led_flash.attr,
-	&fpga_pim8_port1_led_profile.attr,
-	&fpga_pim8_port2_led_status.attr,
-	&fpga_pim8_port2_led_flash.attr,
-	&fpga_pim8_port2_led_profile.attr,
-	&fpga_pim8_port3_led_status.attr,
-	&fpga_pim8_port3_led_flash.attr,
-	&fpga_pim8_port3_led_profile.attr,
-	&fpga_pim8_port4_led_status.attr,
-	&fpga_pim8_port4_led_flash.attr,
-	&fpga_pim8_port4_led_profile.attr,
-	&fpga_pim8_port5_led_status.attr,
-	&fpga_pim8_port5_led_flash.attr,
-	&fpga_pim8_port5_led_profile.attr,
-	&fpga_pim8_port6_led_status.attr,
-	&fpga_pim8_port6_led_flash.attr,
-	&fpga_pim8_port6_led_profile.attr,
-	&fpga_pim8_port7_led_status.attr,
-	&fpga_pim8_port7_led_flash.attr,
-	&fpga_pim8_port7_led_profile.attr,
-	&fpga_pim8_port8_led_status.attr,
-	&fpga_pim8_port8_led_flash.attr,
-	&fpga_pim8_port8_led_profile.attr,
-	&fpga_pim8_port9_led_status.attr,
-	&fpga_pim8_port9_led_flash.attr,
-	&fpga_pim8_port9_led_profile.attr,
-	&fpga_pim8_port10_led_status.attr,
-	&fpga_pim8_port10_led_flash.attr,
-	&fpga_pim8_port10_led_profile.attr,
-	&fpga_pim8_port11_led_status.attr,
-	&fpga_pim8_port11_led_flash.attr,
-	&fpga_pim8_port11_led_profile.attr,
-	&fpga_pim8_port12_led_status.attr,
-	&fpga_pim8_port12_led_flash.attr,
-	&fpga_pim8_port12_led_profile.attr,
-	&fpga_pim8_port13_led_status.attr,
-	&fpga_pim8_port13_led_flash.attr,
-	&fpga_pim8_port13_led_profile.attr,
-	&fpga_pim8_port14_led_status.attr,
-	&fpga_pim8_port14_led_flash.attr,
-	&fpga_pim8_port14_led_profile.attr,
-	&fpga_pim8_port15_led_status.attr,
-	&fpga_pim8_port15_led_flash.attr,
-	&fpga_pim8_port15_led_profile.attr,
-	&fpga_pim8_port16_led_status.attr,
-	&fpga_pim8_port16_led_flash.attr,
-	&fpga_pim8_port16_led_profile.attr,
 	NULL,
 };
 
@@ -1672,6 +725,16 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 		goto exit;
 	}
 
+	fpga_ports = cumulus_ports_add(&pdev->dev, &fpga_ports_desc);
+	if (IS_ERR(fpga_ports)) {
+		err = PTR_ERR(fpga_ports);
+		fpga_ports = NULL;
+		pr_err("port LED attributes failed for FPGA driver\n");
+		sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
+		pci_disable_device(pdev);
+		goto exit;
+	}
+
 	dev_dbg(&pdev->dev, "FPGA driver loaded\n");
 
 exit:
@@ -1686,6 +749,8 @@ static void fpga_remove(struct pci_dev *pdev)
 	struct fpga_priv *priv;
 
 	priv = dev_get_drvdata(&pdev->dev);
+	cumulus_ports_del(fpga_ports);
+	fpga_ports = NULL;
 	sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
 	devm_iounmap(&pdev->dev, priv->pbar);
 	fpga_dev_release(priv);
@@ -1728,18 +793,28 @@ static void fpga_exit(void)
 }
 
 /* I2C Initialization */
-static void i2c_exit(void)
+static void i2c_del_devices(struct platform_i2c_device_info *devs, int num)
 {
 	int i;
 
-	for (i = ARRAY_SIZE(i2c_devices); --i >= 0;) {
-		struct i2c_client *c = i2c_devices[i].client;
+	for (i = num; --i >= 0;) {
+		struct i2c_client *c = devs[i].client;
 
 		if (c) {
-			i2c_devices[i].client = NULL;
+			devs[i].client = NULL;
 			i2c_unregister_device(c);
 		}
 	}
+}
+
+static void i2c_exit(void)
+{
+	if (i2c_ports) {
+		i2c_del_devices(i2c_ports->devices, i2c_ports->num_devices);
+		cumulus_ports_del(i2c_ports);
+		i2c_ports = NULL;
+	}
+	i2c_del_devices(i2c_devices, ARRAY_SIZE(i2c_devices));
 	pr_info("I2C driver unloaded\n");
 }
 
@@ -1747,10 +822,29 @@ static void i2c_exit(void)
  * Utility functions for I2C
  */
 
+static int i2c_add_devices(struct platform_i2c_device_info *devs, int num,
+			   int cp2112_bus)
+{
+	int i;
+
+	for (i = 0; i < num; i++) {
+		int bus = devs[i].bus;
+		struct i2c_client *client;
+
+		if (bus == MP_I2C_CP2112_BUS)
+			bus = cp2112_bus;
+		client = cumulus_i2c_add_client(bus, &devs[i].board_info);
+		if (IS_ERR(client))
+			return PTR_ERR(client);
+		devs[i].client = client;
+	}
+
+	return 0;
+}
+
 static int i2c_init(void)
 {
 	int cp2112_bus;
-	int i;
 	int ret;
 
 	cp2112_bus = cumulus_i2c_find_adapter("CP2112 SMBus Bridge");
@@ -1760,19 +854,24 @@ static int i2c_init(void)
 		goto err_exit;
 	}
 
-	for (i = 0; i < ARRAY_SIZE(i2c_devices); i++) {
-		int bus = i2c_devices[i].bus;
-		struct i2c_client *client;
+	ret = i2c_add_devices(i2c_devices, ARRAY_SIZE(i2c_devices),
+			      cp2112_bus);
+	if (ret)
+		goto err_exit;
 
-		if (bus == MP_I2C_CP2112_BUS)
-			bus = cp2112_bus;
-		client = cumulus_i2c_add_client(bus, &i2c_devices[i].board_info);
-		if (IS_ERR(client)) {
-			ret = PTR_ERR(client);
-			goto err_exit;
-		}
-		i2c_devices[i].client = client;
+	/* The port eeproms hang off the PIM muxes added above */
+	i2c_ports = cumulus_ports_add(NULL, &i2c_ports_desc);
+	if (IS_ERR(i2c_ports)) {
+		ret = PTR_ERR(i2c_ports);
+		i2c_ports = NULL;
+		goto err_exit;
 	}
+
+	ret = i2c_add_devices(i2c_ports->devices, i2c_ports->num_devices,
+			      cp2112_bus);
+	if (ret)
+		goto err_exit;
+
 	pr_debug("I2C driver loaded\n");
 	return 0;
 err_exit:
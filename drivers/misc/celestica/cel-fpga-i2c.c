@@ -24,13 +24,12 @@
 
 #include <linux/io.h>
 #include <linux/i2c.h>
-#include <linux/i2c-mux.h>
 #include <linux/interrupt.h>
 #include <linux/delay.h>
 
 #include "cel-fpga-i2c.h"
 
-#define DRIVER_VERSION "1.0"
+#define DRIVER_VERSION "1.1"
 
 /* The CEL_FPGA_I2C_X offsets are relative to the start of each FPGA core */
 
@@ -55,15 +54,68 @@
 #define CSR_MIF                     0x02
 #define CSR_RXAK                    0x01
 
+#define CEL_FPGA_I2C_SLOW_FREQ      100000
+
 struct cel_fpga_i2c {
 	struct device     *dev;
 	void __iomem      *base;
-	struct mutex       lock;
 	struct i2c_adapter adap;
-	u32                clk_freq;
+	u32                clk_freq; /* SCL frequency the core runs at */
 	u32                timeout;
+	u32                bus_freq; /* SCL frequency set explicitly, or 0 */
+	bool               slow; /* downshifted to 100 kHz after a failure */
 };
 
+static int cel_fpga_i2c_freq_div(u32 freq)
+{
+	switch (freq) {
+	case 50000:
+		return FPGA_I2C_50KHZ;
+	case 100000:
+		return FPGA_I2C_100KHZ;
+	case 200000:
+		return FPGA_I2C_200KHZ;
+	case 400000:
+		return FPGA_I2C_400KHZ;
+	}
+	return -EINVAL;
+}
+
+/*
+ * The divider is left as the FPGA came up, at the rate the platform
+ * passes in clock_khz, until a platform passes bus_freq or the bus_freq
+ * attribute is written, so faster rates are opt-in.  A core that fails
+ * at a faster rate is downshifted to 100 kHz until the rate is set
+ * again.
+ */
+static u32 cel_fpga_i2c_cur_freq(struct cel_fpga_i2c *i2c)
+{
+	if (i2c->bus_freq > CEL_FPGA_I2C_SLOW_FREQ && i2c->slow)
+		return CEL_FPGA_I2C_SLOW_FREQ;
+	return i2c->bus_freq;
+}
+
+static void cel_fpga_i2c_set_freq(struct cel_fpga_i2c *i2c, u32 freq)
+{
+	if (i2c->clk_freq == freq)
+		return;
+	iowrite32(cel_fpga_i2c_freq_div(freq),
+		  i2c->base + CEL_FPGA_I2C_FREQ_DIV);
+	i2c->clk_freq = freq;
+}
+
+static bool cel_fpga_i2c_downshift(struct cel_fpga_i2c *i2c)
+{
+	if (i2c->clk_freq <= CEL_FPGA_I2C_SLOW_FREQ)
+		return false;
+
+	i2c->slow = true;
+	dev_warn(i2c->dev, "transfer failed at %u Hz, using %u Hz\n",
+		 i2c->clk_freq, CEL_FPGA_I2C_SLOW_FREQ);
+	cel_fpga_i2c_set_freq(i2c, CEL_FPGA_I2C_SLOW_FREQ);
+	return true;
+}
+
 static inline void cel_fpga_set_mux_reg(struct cel_fpga_i2c *i2c, int channel)
 {
 	iowrite32(channel & 0x3F, i2c->base + CEL_FPGA_I2C_PORT_ID);
@@ -238,72 +290,226 @@ static int cel_fpga_i2c_read(struct cel_fpga_i2c *i2c, int addr,
 	return length;
 }
 
-static int cel_fpga_i2c_xfer(struct i2c_adapter *adap, struct i2c_msg *msgs,
-			 int num)
+/*
+ * Wait for the bus to go idle before starting a transfer, and release it
+ * with a stop afterwards.  Both allow up to 1s and run the 9-clock fixup
+ * if a slave is holding the bus.
+ */
+static int cel_fpga_i2c_start(struct cel_fpga_i2c *i2c)
 {
-	struct i2c_msg *pmsg;
-        int ret = 0;
-        int i;
 	unsigned long orig_jiffies = jiffies;
-        struct cel_fpga_i2c *i2c = i2c_get_adapdata(adap);
-        u8 status;
-        bool recv_len;
+	u8 status;
 
-        /* Clear arbitration */
-        iowrite32(0, i2c->base + CEL_FPGA_I2C_SR);
+	/* Clear arbitration */
+	iowrite32(0, i2c->base + CEL_FPGA_I2C_SR);
 	/* Start with MEN */
-        iowrite32(CCR_MEN, i2c->base + CEL_FPGA_I2C_CR);
+	iowrite32(CCR_MEN, i2c->base + CEL_FPGA_I2C_CR);
 
-        /* Allow bus up to 1s to become not busy */
-        while (ioread32(i2c->base + CEL_FPGA_I2C_SR) & CSR_MBB) {
-                if (signal_pending(current)) {
-                        iowrite32(0, i2c->base + CEL_FPGA_I2C_CR);
+	while (ioread32(i2c->base + CEL_FPGA_I2C_SR) & CSR_MBB) {
+		if (signal_pending(current)) {
+			iowrite32(0, i2c->base + CEL_FPGA_I2C_CR);
 			return -EINTR;
-                }
-                if (time_after(jiffies, orig_jiffies + HZ)) {
-                        status = ioread32(i2c->base + CEL_FPGA_I2C_SR);
+		}
+		if (time_after(jiffies, orig_jiffies + HZ)) {
+			status = ioread32(i2c->base + CEL_FPGA_I2C_SR);
 			if ((status & (CSR_MCF | CSR_MBB | CSR_RXAK)) != 0) {
-                                iowrite32(status & ~CSR_MAL,
-                                         i2c->base + CEL_FPGA_I2C_SR);
+				iowrite32(status & ~CSR_MAL,
+					  i2c->base + CEL_FPGA_I2C_SR);
 				cel_fpga_i2c_fixup(i2c);
-                        }
-                        return -EIO;
-                }
-                schedule();
+			}
+			return -EIO;
+		}
+		schedule();
 	}
 
-        for (i = 0; ret >= 0 && i < num; i++) {
-                pmsg = &msgs[i];
-                if (pmsg->flags & I2C_M_RD) {
-                        recv_len = pmsg->flags & I2C_M_RECV_LEN;
-                        ret = cel_fpga_i2c_read(i2c, pmsg->addr, pmsg->buf,
-                                                pmsg->len, i, recv_len);
-                        if (recv_len && ret > 0)
-                                pmsg->len = ret;
-                } else {
-                        ret = cel_fpga_i2c_write(i2c, pmsg->addr, pmsg->buf,
-                                                 pmsg->len, i);
-                }
-        }
-
-        /* initiate stop */
-        iowrite32(CCR_MEN, i2c->base + CEL_FPGA_I2C_CR);
-        orig_jiffies = jiffies;
-        /* Wait until STOP is seen, allow up to 1 s */
-        while (ioread32(i2c->base + CEL_FPGA_I2C_SR) & CSR_MBB) {
-                if (time_after(jiffies, orig_jiffies + HZ)) {
-                        status = ioread32(i2c->base + CEL_FPGA_I2C_SR);
-                        if ((status & (CSR_MCF | CSR_MBB | CSR_RXAK)) != 0) {
-                                iowrite32(status & ~CSR_MAL,
-                                         i2c->base + CEL_FPGA_I2C_SR);
-                                cel_fpga_i2c_fixup(i2c);
-                        }
-                        return -EIO;
-                }
-                cond_resched();
-        }
-
-        return (ret < 0) ? ret : num;
+	return 0;
+}
+
+static int cel_fpga_i2c_stop(struct cel_fpga_i2c *i2c)
+{
+	unsigned long orig_jiffies = jiffies;
+	u8 status;
+
+	/* initiate stop */
+	iowrite32(CCR_MEN, i2c->base + CEL_FPGA_I2C_CR);
+	while (ioread32(i2c->base + CEL_FPGA_I2C_SR) & CSR_MBB) {
+		if (time_after(jiffies, orig_jiffies + HZ)) {
+			status = ioread32(i2c->base + CEL_FPGA_I2C_SR);
+			if ((status & (CSR_MCF | CSR_MBB | CSR_RXAK)) != 0) {
+				iowrite32(status & ~CSR_MAL,
+					  i2c->base + CEL_FPGA_I2C_SR);
+				cel_fpga_i2c_fixup(i2c);
+			}
+			return -EIO;
+		}
+		cond_resched();
+	}
+
+	return 0;
+}
+
+static int cel_fpga_i2c_do_xfer(struct cel_fpga_i2c *i2c,
+				struct i2c_msg *msgs, int num)
+{
+	struct i2c_msg *pmsg;
+	bool recv_len;
+	int ret;
+	int i;
+
+	ret = cel_fpga_i2c_start(i2c);
+	if (ret)
+		return ret;
+
+	for (i = 0; ret >= 0 && i < num; i++) {
+		pmsg = &msgs[i];
+		if (pmsg->flags & I2C_M_RD) {
+			recv_len = pmsg->flags & I2C_M_RECV_LEN;
+			ret = cel_fpga_i2c_read(i2c, pmsg->addr, pmsg->buf,
+						pmsg->len, i, recv_len);
+			if (recv_len && ret > 0)
+				pmsg->len = ret;
+		} else {
+			ret = cel_fpga_i2c_write(i2c, pmsg->addr, pmsg->buf,
+						 pmsg->len, i);
+		}
+	}
+
+	if (cel_fpga_i2c_stop(i2c))
+		return -EIO;
+
+	return (ret < 0) ? ret : num;
+}
+
+/*
+ * A failed transfer may have written part of its data before it gave
+ * up, so only transfers that read are replayed: every write must be
+ * followed by a read, i.e. only set the register pointer.
+ */
+static bool cel_fpga_i2c_can_retry(struct i2c_msg *msgs, int num)
+{
+	int i;
+
+	for (i = 0; i < num; i++)
+		if (!(msgs[i].flags & I2C_M_RD) &&
+		    (i == num - 1 || !(msgs[i + 1].flags & I2C_M_RD)))
+			return false;
+	return true;
+}
+
+static int cel_fpga_i2c_xfer(struct i2c_adapter *adap, struct i2c_msg *msgs,
+			 int num)
+{
+	struct cel_fpga_i2c *i2c = i2c_get_adapdata(adap);
+	int ret;
+
+	if (i2c->bus_freq)
+		cel_fpga_i2c_set_freq(i2c, cel_fpga_i2c_cur_freq(i2c));
+	ret = cel_fpga_i2c_do_xfer(i2c, msgs, num);
+
+	/* downshift to 100 kHz, retry once if the transfer only read */
+	if ((ret == -ETIMEDOUT || ret == -EIO) && cel_fpga_i2c_downshift(i2c) &&
+	    cel_fpga_i2c_can_retry(msgs, num))
+		ret = cel_fpga_i2c_do_xfer(i2c, msgs, num);
+
+	return ret;
+}
+
+/*
+ * Register style SMBus transfer: write wlen bytes (the command byte and
+ * any data), then optionally restart and read rlen bytes, all within a
+ * single bus-idle wait and stop.
+ */
+static int cel_fpga_i2c_smbus_do(struct cel_fpga_i2c *i2c, u16 addr,
+				 u8 *wbuf, int wlen, u8 *rbuf, int rlen)
+{
+	int ret;
+
+	ret = cel_fpga_i2c_start(i2c);
+	if (ret)
+		return ret;
+
+	if (wlen)
+		ret = cel_fpga_i2c_write(i2c, addr, wbuf, wlen, 0);
+	if (ret >= 0 && rlen)
+		ret = cel_fpga_i2c_read(i2c, addr, rbuf, rlen, wlen, false);
+
+	if (cel_fpga_i2c_stop(i2c))
+		return -EIO;
+
+	return (ret < 0) ? ret : 0;
+}
+
+static int cel_fpga_i2c_smbus_xfer(struct i2c_adapter *adap, u16 addr,
+				   unsigned short flags, char read_write,
+				   u8 command, int size,
+				   union i2c_smbus_data *data)
+{
+	struct cel_fpga_i2c *i2c = i2c_get_adapdata(adap);
+	u8 buf[I2C_SMBUS_BLOCK_MAX + 1];
+	bool rd = read_write == I2C_SMBUS_READ;
+	u8 *rbuf = NULL;
+	int wlen = 1, rlen = 0;
+	int ret;
+
+	/* anything else is left to the i2c core emulation */
+	if (flags & I2C_CLIENT_PEC)
+		return -EOPNOTSUPP;
+
+	buf[0] = command;
+	switch (size) {
+	case I2C_SMBUS_BYTE:
+		if (rd) {
+			wlen = 0;
+			rbuf = &data->byte;
+			rlen = 1;
+		}
+		break;
+	case I2C_SMBUS_BYTE_DATA:
+		if (rd) {
+			rbuf = &data->byte;
+			rlen = 1;
+		} else {
+			buf[1] = data->byte;
+			wlen = 2;
+		}
+		break;
+	case I2C_SMBUS_WORD_DATA:
+		if (rd) {
+			rbuf = &buf[1];
+			rlen = 2;
+		} else {
+			buf[1] = data->word & 0xff;
+			buf[2] = data->word >> 8;
+			wlen = 3;
+		}
+		break;
+	case I2C_SMBUS_I2C_BLOCK_DATA:
+		if (data->block[0] == 0 ||
+		    data->block[0] > I2C_SMBUS_BLOCK_MAX)
+			return -EINVAL;
+		if (rd) {
+			rbuf = &data->block[1];
+			rlen = data->block[0];
+		} else {
+			memcpy(&buf[1], &data->block[1], data->block[0]);
+			wlen = data->block[0] + 1;
+		}
+		break;
+	default:
+		return -EOPNOTSUPP;
+	}
+
+	cel_fpga_i2c_set_freq(i2c, cel_fpga_i2c_cur_freq(i2c));
+	ret = cel_fpga_i2c_smbus_do(i2c, addr, buf, wlen, rbuf, rlen);
+	/* as above, only a read is replayed */
+	if ((ret == -ETIMEDOUT || ret == -EIO) &&
+	    cel_fpga_i2c_downshift(i2c) && rd)
+		ret = cel_fpga_i2c_smbus_do(i2c, addr, buf, wlen, rbuf, rlen);
+
+	if (!ret && rd && size == I2C_SMBUS_WORD_DATA)
+		data->word = buf[1] | (buf[2] << 8);
+
+	return ret;
 }
 
 static u32 cel_fpga_i2c_functionality(struct i2c_adapter *adap)
@@ -313,6 +519,7 @@ static u32 cel_fpga_i2c_functionality(struct i2c_adapter *adap)
 
 static const struct i2c_algorithm cel_fpga_i2c_algorithm = {
 	.master_xfer = cel_fpga_i2c_xfer,
+	.smbus_xfer = cel_fpga_i2c_smbus_xfer,
 	.functionality = cel_fpga_i2c_functionality,
 };
 
@@ -325,33 +532,61 @@ static struct i2c_adapter cel_fpga_i2c_adapter = {
 };
 
 
-/*
-static int cel_fpga_i2c_bus_setup(struct cel_fpga_i2c *i2c, u32 clock)
+/* sysfs attributes for bus speed selection */
+
+static ssize_t bus_freq_show(struct device *dev,
+			     struct device_attribute *dattr,
+			     char *buf)
 {
-	switch (clock) {
-	case FPGA_I2C_50KHZ:
-		i2c->clk_freq = 50000l;
-		break;
-	case FPGA_I2C_100KHZ:
-		i2c->clk_freq = 100000l;
-		break;
-	case FPGA_I2C_200KHZ:
-		i2c->clk_freq = 200000l;
-		break;
-	case FPGA_I2C_400KHZ:
-		i2c->clk_freq = 400000l;
-		break;
-	default:
-		dev_err(i2c->dev, "error: unsupported bus speed.\n");
+	struct cel_fpga_i2c *i2c = dev_get_drvdata(dev);
+
+	return sprintf(buf, "%u\n", i2c->bus_freq ? : i2c->clk_freq);
+}
+
+static ssize_t bus_freq_store(struct device *dev,
+			      struct device_attribute *dattr,
+			      const char *buf, size_t count)
+{
+	struct cel_fpga_i2c *i2c = dev_get_drvdata(dev);
+	u32 freq;
+	int ret;
+
+	ret = kstrtou32(buf, 0, &freq);
+	if (ret)
+		return ret;
+	if (cel_fpga_i2c_freq_div(freq) < 0)
 		return -EINVAL;
-	}
 
-	pr_info("IOWRITE32 #24; clock = %d\n", clock);
-	iowrite32(clock, i2c->base + CEL_FPGA_I2C_FREQ_DIV);
+	/* a new speed gives the bus another chance */
+	i2c_lock_bus(&i2c->adap, I2C_LOCK_ROOT_ADAPTER);
+	i2c->bus_freq = freq;
+	i2c->slow = false;
+	i2c_unlock_bus(&i2c->adap, I2C_LOCK_ROOT_ADAPTER);
 
-	return 0;
+	return count;
+}
+static DEVICE_ATTR_RW(bus_freq);
+
+static ssize_t downshifted_show(struct device *dev,
+				struct device_attribute *dattr,
+				char *buf)
+{
+	struct cel_fpga_i2c *i2c = dev_get_drvdata(dev);
+
+	return sprintf(buf, "%d\n", READ_ONCE(i2c->slow));
 }
-*/
+static DEVICE_ATTR_RO(downshifted);
+
+static struct attribute *cel_fpga_i2c_attrs[] = {
+	&dev_attr_bus_freq.attr,
+	&dev_attr_downshifted.attr,
+	NULL,
+};
+
+static const struct attribute_group cel_fpga_i2c_attr_group = {
+	.attrs = cel_fpga_i2c_attrs,
+};
+
 static int cel_fpga_i2c_probe(struct platform_device *pdev)
 {
 	struct cel_fpga_i2c *i2c;
@@ -371,12 +606,20 @@ static int cel_fpga_i2c_probe(struct platform_device *pdev)
 	if (IS_ERR(i2c->base))
 		return PTR_ERR(i2c->base);
 
-	mutex_init(&i2c->lock);
+	i2c->dev = &pdev->dev;
+
+	i2c->clk_freq = CEL_FPGA_I2C_SLOW_FREQ;
+	i2c->timeout = HZ;
 
 	platdata = dev_get_platdata(&pdev->dev);
-	if (platdata) {
+	if (platdata && platdata->clock_khz)
 		i2c->clk_freq = platdata->clock_khz;
-		i2c->timeout = HZ;
+	if (platdata && platdata->bus_freq) {
+		if (cel_fpga_i2c_freq_div(platdata->bus_freq) < 0)
+			dev_warn(&pdev->dev, "unsupported bus speed %u Hz\n",
+				 platdata->bus_freq);
+		else
+			i2c->bus_freq = platdata->bus_freq;
 	}
 
 	/* hook up driver to tree */
@@ -399,6 +642,13 @@ static int cel_fpga_i2c_probe(struct platform_device *pdev)
 		return ret;
 	}
 
+	ret = sysfs_create_group(&pdev->dev.kobj, &cel_fpga_i2c_attr_group);
+	if (ret) {
+		dev_err(&pdev->dev, "sysfs_create_group failed\n");
+		i2c_del_adapter(&i2c->adap);
+		return ret;
+	}
+
 	return 0;
 };
 
@@ -408,6 +658,7 @@ static int cel_fpga_i2c_remove(struct platform_device *pdev)
 
 	i2c = platform_get_drvdata(pdev);
 
+	sysfs_remove_group(&pdev->dev.kobj, &cel_fpga_i2c_attr_group);
 	i2c_del_adapter(&i2c->adap);
 
 	dev_set_drvdata(&pdev->dev, NULL);
@@ -52,6 +52,7 @@ struct fpga_i2c_platform_data {
         u32 reg_shift; /* register offset shift value */
         u32 reg_io_width; /* register io read/write width */
         u32 clock_khz; /* input clock in kHz */
+        u32 bus_freq; /* SCL frequency in Hz, 0 keeps the FPGA divider */
         u8 num_devices; /* number of devices in the devices list */
         struct fpga_i2c_device_info *devices; /* devs connected to the bus */
 };
@@ -40,24 +40,39 @@ static struct cel_xp_bus_mux_info que_bus_mux_info[] = {
 		.io_base = CPLD_SW2_REG_I2C_PORT_ID,
 		.first_port_num = 1,
 		.num_ports = 18,
+		.present_reg = {
+			CPLD_SW2_REG_SFP_1_8_ABS,
+			CPLD_SW2_REG_SFP_9_16_ABS,
+			CPLD_SW2_REG_SFP_17_18_ABS,
+		},
 	},
 	{
 		.bus = CL_I2C_CPLD_MUX_2,
 		.io_base = CPLD_SW3_REG_I2C_PORT_ID,
 		.first_port_num = 19,
 		.num_ports = 18,
+		.present_reg = {
+			CPLD_SW3_REG_SFP_19_26_ABS,
+			CPLD_SW3_REG_SFP_27_34_ABS,
+			CPLD_SW3_REG_SFP_35_36_ABS,
+		},
 	},
 	{
 		.bus = CL_I2C_CPLD_MUX_3,
 		.io_base = CPLD_SW4_REG_I2C_PORT_ID,
 		.first_port_num = 37,
 		.num_ports = 12,
+		.present_reg = {
+			CPLD_SW4_REG_SFP_37_44_ABS,
+			CPLD_SW4_REG_SFP_45_48_ABS,
+		},
 	},
 	{
 		.bus = CL_I2C_CPLD_MUX_4,
 		.io_base = CPLD_SW1_REG_I2C_PORT_ID,
 		.first_port_num = 49,
 		.num_ports = 6,
+		.present_reg = { CPLD_SW1_REG_ZQSFP_1_6_ABS },
 	},
 };
 
@@ -273,9 +288,10 @@ exit:
 	return ret;
 }
 
-int create_i2c_mux(int index, int bus, int first_port_num, int num_ports)
+int create_i2c_mux(int index, int bus, int first_port_num, int num_ports,
+		    const u16 *present_reg)
 {
-	struct cpld_mux_data mux_data;
+	struct cpld_mux_data mux_data = { 0 };
 	struct platform_device *device;
 	struct i2c_adapter *parent_adapter;
 	int ret = 0;
@@ -284,6 +300,7 @@ int create_i2c_mux(int index, int bus, int first_port_num, int num_ports)
 	mux_data.mux_base_id = bus;
 	mux_data.mux_base_port_num = first_port_num;
 	mux_data.mux_num_ports = num_ports;
+	memcpy(mux_data.present_reg, present_reg, sizeof(mux_data.present_reg));
 
 	parent_adapter = get_adapter(bus);
 	if (!parent_adapter) {
@@ -388,7 +405,8 @@ static int __init cel_questone_mux_init(void)
 	for (i = 0; i < ARRAY_SIZE(que_bus_mux_info); i++) {
 		ret = create_i2c_mux(i, que_bus_mux_info[i].bus,
 				     que_bus_mux_info[i].first_port_num,
-				     que_bus_mux_info[i].num_ports);
+				     que_bus_mux_info[i].num_ports,
+				     que_bus_mux_info[i].present_reg);
 		if (ret)
 			goto err_exit2;
 	}
@@ -42,13 +42,16 @@
 #include <linux/platform_data/pca954x.h>
 
 #include <linux/cumulus-platform.h>
+#include <linux/cumulus-presence.h>
+#include <linux/cumulus-port-eeprom.h>
+#include <linux/cumulus-ports.h>
 #include "platform-defs.h"
 #include "platform-bitfield.h"
 #include "cel-fpga-i2c.h"
 #include "cel-sea2que2.h"
 
 #define DRIVER_NAME	"cel_questone2_fpga"
-#define DRIVER_VERSION	"2.0"
+#define DRIVER_VERSION	"2.1"
 
 #define NUM_FPGA_BUSSES		     10
 #define NUM_CPLD_DEVICES	     2
@@ -161,10 +164,10 @@ enum {
  * For muxes, we specify the starting bus number for the block of ports, using
  * the magic mk_pca954*() macros.
  *
- * For eeproms, including ones in the sff transceivers, we specify the label,
- * i2c address, size, and some flags, all done in mk*_eeprom() macros.	The
- * label is the string that ends up in /sys/class/eeprom_dev/eepromN/label,
- * which we use to identify them at the user level.
+ * The port eeproms are built at probe time from fpga_port_ranges[], see
+ * cumulus-ports.c.  Each one is labeled "portN", the string that ends up in
+ * /sys/class/eeprom_dev/eepromN/label, which we use to identify the eeprom
+ * at the user level.
  *
  */
 
@@ -177,64 +180,6 @@ mk_pca9548(fpga_ch10_5, FPGA_I2C_CH10_MUX5_BUS0, 1);
 
 mk_pca9548(fpga_ch2_0, FPGA_I2C_CH2_MUX0_BUS0, 1);
 
-mk_port_eeprom(port1,  50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port2,  50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port3,  50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port4,  50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port5,  50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port6,  50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port7,  50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port8,  50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port9,  50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port10, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port11, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port12, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port13, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port14, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port15, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port16, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port17, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port18, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port19, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port20, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port21, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port22, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port23, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port24, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port25, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port26, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port27, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port28, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port29, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port30, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port31, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port32, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port33, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port34, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port35, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port36, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port37, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port38, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port39, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port40, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port41, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port42, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port43, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port44, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port45, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port46, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port47, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port48, 50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-
-mk_qsfp_port_eeprom(port49, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port50, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port51, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port52, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port53, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port54, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port55, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port56, 50, 256, SFF_8436_FLAG_IRUGO);
-
 /*
  * i2c device tables
  *
@@ -249,7 +194,8 @@ mk_qsfp_port_eeprom(port56, 50, 256, SFF_8436_FLAG_IRUGO);
  * devices on those busses.
  *
  * The fpga_i2c_devices[] table has all the devices exposed on the fpga i2c
- * busses.
+ * busses, except for the port eeproms, which cumulus_ports_add() builds from
+ * fpga_port_ranges[].
  *
  */
 
@@ -268,74 +214,12 @@ static struct platform_i2c_device_info fpga_i2c_busses[] = {
 
 static struct platform_i2c_device_info fpga_i2c_devices[] = {
 	mk_i2cdev(FPGA_I2C_CH10, "pca9548", 0x72, &fpga_ch10_0_platform_data),
-	mk_i2cdev(FPGA_I2C_CH10_MUX0_BUS0, "24c04", 0x50, &port1_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX0_BUS1, "24c04", 0x50, &port2_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX0_BUS2, "24c04", 0x50, &port3_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX0_BUS3, "24c04", 0x50, &port4_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX0_BUS4, "24c04", 0x50, &port5_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX0_BUS5, "24c04", 0x50, &port6_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX0_BUS6, "24c04", 0x50, &port7_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX0_BUS7, "24c04", 0x50, &port8_50_at24),
-
 	mk_i2cdev(FPGA_I2C_CH10, "pca9548", 0x73, &fpga_ch10_1_platform_data),
-	mk_i2cdev(FPGA_I2C_CH10_MUX1_BUS0, "24c04", 0x50, &port9_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX1_BUS1, "24c04", 0x50, &port10_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX1_BUS2, "24c04", 0x50, &port11_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX1_BUS3, "24c04", 0x50, &port12_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX1_BUS4, "24c04", 0x50, &port13_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX1_BUS5, "24c04", 0x50, &port14_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX1_BUS6, "24c04", 0x50, &port15_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX1_BUS7, "24c04", 0x50, &port16_50_at24),
-
 	mk_i2cdev(FPGA_I2C_CH10, "pca9548", 0x74, &fpga_ch10_2_platform_data),
-	mk_i2cdev(FPGA_I2C_CH10_MUX2_BUS0, "24c04", 0x50, &port17_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX2_BUS1, "24c04", 0x50, &port18_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX2_BUS2, "24c04", 0x50, &port19_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX2_BUS3, "24c04", 0x50, &port20_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX2_BUS4, "24c04", 0x50, &port21_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX2_BUS5, "24c04", 0x50, &port22_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX2_BUS6, "24c04", 0x50, &port23_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX2_BUS7, "24c04", 0x50, &port24_50_at24),
-
 	mk_i2cdev(FPGA_I2C_CH10, "pca9548", 0x75, &fpga_ch10_3_platform_data),
-	mk_i2cdev(FPGA_I2C_CH10_MUX3_BUS0, "24c04", 0x50, &port25_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX3_BUS1, "24c04", 0x50, &port26_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX3_BUS2, "24c04", 0x50, &port27_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX3_BUS3, "24c04", 0x50, &port28_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX3_BUS4, "24c04", 0x50, &port29_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX3_BUS5, "24c04", 0x50, &port30_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX3_BUS6, "24c04", 0x50, &port31_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX3_BUS7, "24c04", 0x50, &port32_50_at24),
-
 	mk_i2cdev(FPGA_I2C_CH10, "pca9548", 0x76, &fpga_ch10_4_platform_data),
-	mk_i2cdev(FPGA_I2C_CH10_MUX4_BUS0, "24c04", 0x50, &port33_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX4_BUS1, "24c04", 0x50, &port34_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX4_BUS2, "24c04", 0x50, &port35_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX4_BUS3, "24c04", 0x50, &port36_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX4_BUS4, "24c04", 0x50, &port37_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX4_BUS5, "24c04", 0x50, &port38_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX4_BUS6, "24c04", 0x50, &port39_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX4_BUS7, "24c04", 0x50, &port40_50_at24),
-
 	mk_i2cdev(FPGA_I2C_CH10, "pca9548", 0x77, &fpga_ch10_5_platform_data),
-	mk_i2cdev(FPGA_I2C_CH10_MUX5_BUS0, "24c04", 0x50, &port41_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX5_BUS1, "24c04", 0x50, &port42_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX5_BUS2, "24c04", 0x50, &port43_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX5_BUS3, "24c04", 0x50, &port44_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX5_BUS4, "24c04", 0x50, &port45_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX5_BUS5, "24c04", 0x50, &port46_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX5_BUS6, "24c04", 0x50, &port47_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX5_BUS7, "24c04", 0x50, &port48_50_at24),
-
 	mk_i2cdev(FPGA_I2C_CH2, "pca9548", 0x74, &fpga_ch2_0_platform_data),
-	mk_i2cdev(FPGA_I2C_CH2_MUX0_BUS0, "sff8436", 0x50, &port53_50_sff8436),
-	mk_i2cdev(FPGA_I2C_CH2_MUX0_BUS1, "sff8436", 0x50, &port54_50_sff8436),
-	mk_i2cdev(FPGA_I2C_CH2_MUX0_BUS2, "sff8436", 0x50, &port55_50_sff8436),
-	mk_i2cdev(FPGA_I2C_CH2_MUX0_BUS3, "sff8436", 0x50, &port56_50_sff8436),
-	mk_i2cdev(FPGA_I2C_CH2_MUX0_BUS4, "sff8436", 0x50, &port49_50_sff8436),
-	mk_i2cdev(FPGA_I2C_CH2_MUX0_BUS5, "sff8436", 0x50, &port50_50_sff8436),
-	mk_i2cdev(FPGA_I2C_CH2_MUX0_BUS6, "sff8436", 0x50, &port51_50_sff8436),
-	mk_i2cdev(FPGA_I2C_CH2_MUX0_BUS7, "sff8436", 0x50, &port52_50_sff8436),
 
 	mk_i2cdev(FPGA_I2C_CH3, "cel_questone2_cpld", 0x30, NULL),
 	mk_i2cdev(FPGA_I2C_CH3, "cel_questone2_cpld", 0x31, NULL),
@@ -375,6 +259,8 @@ struct fpga_priv {
 	u8 __iomem *fpga_pbar;	 /* Port registers PCI Base Address Register */
 	struct pci_dev *pci_dev;
 	struct fpga_desc *hw;	 /* descriptor virt base addr */
+	struct cumulus_presence *presence; /* front panel module presence */
+	struct cumulus_port_eeprom *port_eeprom; /* cached port EEPROMs */
 };
 
 /* Accessor functions for reading and writing the Misc registers */
@@ -446,178 +332,114 @@ static int fpga_write_reg(struct device *dev,
 	return 0;
 }
 
-#define fpga_bt_ro(_name, _reg, _field, _values, _flags) \
-	mk_bf_ro(fpga, _name, _reg, _field##_BIT, 1, _values, _flags)
-
-#define fpga_bt_rw(_name, _reg, _field, _values, _flags) \
-	mk_bf_rw(fpga, _name, _reg, _field##_BIT, 1, _values, _flags)
-
-#define fpga_sfp_port(_port) \
-	fpga_bt_rw(port##_port##_tx_disable, \
-	   CEL_SEA2QUE2_PORT_CTRL_REG + (16 * ((_port) - 1)), \
-	   CEL_SEA2QUE2_PORT_CTRL_TX_DIS, NULL, 0); \
-	fpga_bt_ro(port##_port##_tx_fault, \
-	   CEL_SEA2QUE2_PORT_STAT_REG + (16 * ((_port) - 1)), \
-	   CEL_SEA2QUE2_PORT_STAT_TXFAULT, NULL, 0); \
-	fpga_bt_ro(port##_port##_rx_los, \
-	   CEL_SEA2QUE2_PORT_STAT_REG + (16 * ((_port) - 1)), \
-	   CEL_SEA2QUE2_PORT_STAT_RXLOS, NULL, 0); \
-	fpga_bt_ro(port##_port##_present, \
-	   CEL_SEA2QUE2_PORT_STAT_REG + (16 * ((_port) - 1)), \
-	   CEL_SEA2QUE2_PORT_STAT_MODABS, NULL, BF_COMPLEMENT)
-
-#define fpga_qsfp_port(_port) \
-	fpga_bt_rw(port##_port##_lpmode, \
-	   CEL_SEA2QUE2_PORT_CTRL_REG + (16 * ((_port) - 1)), \
-	   CEL_SEA2QUE2_PORT_CTRL_LPMOD, NULL, 0); \
-	fpga_bt_ro(port##_port##_interrupt, \
-	   CEL_SEA2QUE2_PORT_STAT_REG + (16 * ((_port) - 1)), \
-	   CEL_SEA2QUE2_PORT_STAT_IRQ, NULL, BF_COMPLEMENT); \
-	fpga_bt_rw(port##_port##_reset, \
-	   CEL_SEA2QUE2_PORT_CTRL_REG + (16 * ((_port) - 1)), \
-	   CEL_SEA2QUE2_PORT_CTRL_RST, NULL, BF_COMPLEMENT); \
-	fpga_bt_ro(port##_port##_present, \
-	   CEL_SEA2QUE2_PORT_STAT_REG + (16 * ((_port) - 1)), \
-	   CEL_SEA2QUE2_PORT_STAT_PRESENT, NULL, BF_COMPLEMENT)
-
-#define fpga_sfp_port_attrs(_num) \
-	&fpga_port##_num##_tx_disable.attr, \
-	&fpga_port##_num##_tx_fault.attr, \
-	&fpga_port##_num##_rx_los.attr, \
-	&fpga_port##_num##_present.attr
-
-#define fpga_qsfp_port_attrs(_num) \
-	&fpga_port##_num##_lpmode.attr, \
-	&fpga_port##_num##_interrupt.attr, \
-	&fpga_port##_num##_reset.attr, \
-	&fpga_port##_num##_present.attr
-
-/* plumb all of the front panel port signals */
-
-fpga_sfp_port(1);
-fpga_sfp_port(2);
-fpga_sfp_port(3);
-fpga_sfp_port(4);
-fpga_sfp_port(5);
-fpga_sfp_port(6);
-fpga_sfp_port(7);
-fpga_sfp_port(8);
-fpga_sfp_port(9);
-fpga_sfp_port(10);
-fpga_sfp_port(11);
-fpga_sfp_port(12);
-fpga_sfp_port(13);
-fpga_sfp_port(14);
-fpga_sfp_port(15);
-fpga_sfp_port(16);
-fpga_sfp_port(17);
-fpga_sfp_port(18);
-fpga_sfp_port(19);
-fpga_sfp_port(20);
-fpga_sfp_port(21);
-fpga_sfp_port(22);
-fpga_sfp_port(23);
-fpga_sfp_port(24);
-fpga_sfp_port(25);
-fpga_sfp_port(26);
-fpga_sfp_port(27);
-fpga_sfp_port(28);
-fpga_sfp_port(29);
-fpga_sfp_port(30);
-fpga_sfp_port(31);
-fpga_sfp_port(32);
-fpga_sfp_port(33);
-fpga_sfp_port(34);
-fpga_sfp_port(35);
-fpga_sfp_port(36);
-fpga_sfp_port(37);
-fpga_sfp_port(38);
-fpga_sfp_port(39);
-fpga_sfp_port(40);
-fpga_sfp_port(41);
-fpga_sfp_port(42);
-fpga_sfp_port(43);
-fpga_sfp_port(44);
-fpga_sfp_port(45);
-fpga_sfp_port(46);
-fpga_sfp_port(47);
-fpga_sfp_port(48);
-
-fpga_qsfp_port(49);
-fpga_qsfp_port(50);
-fpga_qsfp_port(51);
-fpga_qsfp_port(52);
-fpga_qsfp_port(53);
-fpga_qsfp_port(54);
-fpga_qsfp_port(55);
-fpga_qsfp_port(56);
-
-static struct attribute *fpga_attrs[] = {
-	fpga_sfp_port_attrs(1),
-	fpga_sfp_port_attrs(2),
-	fpga_sfp_port_attrs(3),
-	fpga_sfp_port_attrs(4),
-	fpga_sfp_port_attrs(5),
-	fpga_sfp_port_attrs(6),
-	fpga_sfp_port_attrs(7),
-	fpga_sfp_port_attrs(8),
-	fpga_sfp_port_attrs(9),
-	fpga_sfp_port_attrs(10),
-	fpga_sfp_port_attrs(11),
-	fpga_sfp_port_attrs(12),
-	fpga_sfp_port_attrs(13),
-	fpga_sfp_port_attrs(14),
-	fpga_sfp_port_attrs(15),
-	fpga_sfp_port_attrs(16),
-	fpga_sfp_port_attrs(17),
-	fpga_sfp_port_attrs(18),
-	fpga_sfp_port_attrs(19),
-	fpga_sfp_port_attrs(20),
-	fpga_sfp_port_attrs(21),
-	fpga_sfp_port_attrs(22),
-	fpga_sfp_port_attrs(23),
-	fpga_sfp_port_attrs(24),
-	fpga_sfp_port_attrs(25),
-	fpga_sfp_port_attrs(26),
-	fpga_sfp_port_attrs(27),
-	fpga_sfp_port_attrs(28),
-	fpga_sfp_port_attrs(29),
-	fpga_sfp_port_attrs(30),
-	fpga_sfp_port_attrs(31),
-	fpga_sfp_port_attrs(32),
-	fpga_sfp_port_attrs(33),
-	fpga_sfp_port_attrs(34),
-	fpga_sfp_port_attrs(35),
-	fpga_sfp_port_attrs(36),
-	fpga_sfp_port_attrs(37),
-	fpga_sfp_port_attrs(38),
-	fpga_sfp_port_attrs(39),
-	fpga_sfp_port_attrs(40),
-	fpga_sfp_port_attrs(41),
-	fpga_sfp_port_attrs(42),
-	fpga_sfp_port_attrs(43),
-	fpga_sfp_port_attrs(44),
-	fpga_sfp_port_attrs(45),
-	fpga_sfp_port_attrs(46),
-	fpga_sfp_port_attrs(47),
-	fpga_sfp_port_attrs(48),
-
-	fpga_qsfp_port_attrs(49),
-	fpga_qsfp_port_attrs(50),
-	fpga_qsfp_port_attrs(51),
-	fpga_qsfp_port_attrs(52),
-	fpga_qsfp_port_attrs(53),
-	fpga_qsfp_port_attrs(54),
-	fpga_qsfp_port_attrs(55),
-	fpga_qsfp_port_attrs(56),
+/*
+ * Front panel port signals and eeproms, built at probe time, see
+ * cumulus-ports.c.  Every port has a 16 byte register block.  The SFP28
+ * eeproms sit behind the six CH10 PCA9548s in port order.  The QSFP28
+ * PCA9548 on CH2 serves ports 53-56 on channels 0-3 and ports 49-52 on
+ * channels 4-7.
+ */
+#define FPGA_PORT_REG(_reg, _num)	((_reg) + 16 * ((_num) - 1))
+
+#define fpga_port_field(_name, _reg, _num, _field, _mode, _flags) \
+	{ \
+		.name = _name, \
+		.reg = FPGA_PORT_REG(_reg, _num), \
+		.shift = _field##_BIT, \
+		.width = 1, \
+		.flags = _flags, \
+		.mode = _mode, \
+	}
 
-	NULL,
+static const struct cumulus_port_field fpga_sfp_fields[] = {
+	fpga_port_field("tx_disable", CEL_SEA2QUE2_PORT_CTRL_REG,
+			FIRST_SFP_PORT, CEL_SEA2QUE2_PORT_CTRL_TX_DIS, 0644, 0),
+	fpga_port_field("tx_fault", CEL_SEA2QUE2_PORT_STAT_REG,
+			FIRST_SFP_PORT, CEL_SEA2QUE2_PORT_STAT_TXFAULT, 0444, 0),
+	fpga_port_field("rx_los", CEL_SEA2QUE2_PORT_STAT_REG,
+			FIRST_SFP_PORT, CEL_SEA2QUE2_PORT_STAT_RXLOS, 0444, 0),
+	fpga_port_field("present", CEL_SEA2QUE2_PORT_STAT_REG,
+			FIRST_SFP_PORT, CEL_SEA2QUE2_PORT_STAT_MODABS, 0444,
+			BF_COMPLEMENT),
 };
 
-static struct attribute_group fpga_attr_group = {
-	.attrs = fpga_attrs,
+static const struct cumulus_port_field fpga_qsfp_fields[] = {
+	fpga_port_field("lpmode", CEL_SEA2QUE2_PORT_CTRL_REG,
+			FIRST_QSFP_PORT, CEL_SEA2QUE2_PORT_CTRL_LPMOD, 0644, 0),
+	fpga_port_field("interrupt", CEL_SEA2QUE2_PORT_STAT_REG,
+			FIRST_QSFP_PORT, CEL_SEA2QUE2_PORT_STAT_IRQ, 0444,
+			BF_COMPLEMENT),
+	fpga_port_field("reset", CEL_SEA2QUE2_PORT_CTRL_REG,
+			FIRST_QSFP_PORT, CEL_SEA2QUE2_PORT_CTRL_RST, 0644,
+			BF_COMPLEMENT),
+	fpga_port_field("present", CEL_SEA2QUE2_PORT_STAT_REG,
+			FIRST_QSFP_PORT, CEL_SEA2QUE2_PORT_STAT_PRESENT, 0444,
+			BF_COMPLEMENT),
 };
 
+static const u8 fpga_qsfp_bus_order[] = { 4, 5, 6, 7, 0, 1, 2, 3 };
+
+static const struct cumulus_port_range fpga_port_ranges[] = {
+	{
+		.first = FIRST_SFP_PORT,
+		.count = NUM_SFP_PORTS,
+		.bus = FPGA_I2C_CH10_MUX0_BUS0,
+		.addr = 0x50,
+		.type = CUMULUS_PORT_EEPROM_SFP,
+		.eeprom_flags = AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG,
+		.reg_stride = 16,
+		.fields = fpga_sfp_fields,
+		.num_fields = ARRAY_SIZE(fpga_sfp_fields),
+	},
+	{
+		.first = FIRST_QSFP_PORT,
+		.count = NUM_QSFP_PORTS,
+		.bus = FPGA_I2C_CH2_MUX0_BUS0,
+		.bus_order = fpga_qsfp_bus_order,
+		.addr = 0x50,
+		.type = CUMULUS_PORT_EEPROM_QSFP,
+		.eeprom_flags = SFF_8436_FLAG_IRUGO,
+		.reg_stride = 16,
+		.fields = fpga_qsfp_fields,
+		.num_fields = ARRAY_SIZE(fpga_qsfp_fields),
+	},
+};
+
+static const struct cumulus_ports_desc fpga_ports_desc = {
+	.name = DRIVER_NAME,
+	.ranges = fpga_port_ranges,
+	.num_ranges = ARRAY_SIZE(fpga_port_ranges),
+	.read = fpga_read_reg,
+	.write = fpga_write_reg,
+};
+
+/* Port attributes, eeprom devices and port table from fpga_port_ranges[] */
+static struct cumulus_ports *fpga_ports;
+
+/*
+ * Presence sampling callback, see cumulus-presence.c.  SFP ports
+ * report MODABS and QSFP ports PRESENT, both active low.
+ */
+static int fpga_presence_read(void *data, unsigned long *present)
+{
+	struct fpga_priv *priv = data;
+	u32 stat;
+	int bit;
+	int i;
+
+	for (i = 0; i < NUM_SFP_PORTS + NUM_QSFP_PORTS; i++) {
+		stat = readl(priv->fpga_pbar + CEL_SEA2QUE2_PORT_STAT_REG +
+			     16 * i);
+		bit = i < NUM_SFP_PORTS ?
+			CEL_SEA2QUE2_PORT_STAT_MODABS_BIT :
+			CEL_SEA2QUE2_PORT_STAT_PRESENT_BIT;
+		if (!(stat & BIT(bit)))
+			__set_bit(i, present);
+	}
+
+	return 0;
+}
+
 /* FPGA Init */
 
 static int fpga_dev_init(struct fpga_priv *priv)
@@ -654,6 +476,8 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *devid)
 	struct resource *cres;
 	struct fpga_i2c_platform_data *fipd;
 	struct platform_device *platdev;
+	struct cumulus_presence_desc desc;
+	struct cumulus_port_eeprom_desc eeprom_desc;
 	unsigned long start, len;
 	int i, ch, index;
 	int err;
@@ -737,10 +561,13 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *devid)
 		goto fail;
 	}
 
-	/* Create sysfs group for the port registers in the FPGA */
-	err = sysfs_create_group(&pdev->dev.kobj, &fpga_attr_group);
-	if (err) {
-		pr_err(DRIVER_NAME ": sysfs_fpga_attr_group failed for FPGA port registers\n");
+	/* Create the port attributes, eeprom devices and port table */
+	fpga_ports = cumulus_ports_add(&pdev->dev, &fpga_ports_desc);
+	if (IS_ERR(fpga_ports)) {
+		err = PTR_ERR(fpga_ports);
+		fpga_ports = NULL;
+		pr_err(DRIVER_NAME ": failed to create FPGA port attributes\n");
+		sysfs_remove_group(&pdev->dev.kobj, &misc_attr_group);
 		devm_iounmap(&pdev->dev, priv->misc_pbar);
 		devm_iounmap(&pdev->dev, priv->fpga_pbar);
 		fpga_dev_release(priv);
@@ -804,7 +631,8 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *devid)
 			       ch);
 			err = -ENOMEM;
 			sysfs_remove_group(&pdev->dev.kobj, &misc_attr_group);
-			sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
+			cumulus_ports_del(fpga_ports);
+			fpga_ports = NULL;
 			devm_iounmap(&pdev->dev, priv->misc_pbar);
 			devm_iounmap(&pdev->dev, priv->fpga_pbar);
 			fpga_dev_release(priv);
@@ -818,7 +646,8 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *devid)
 			pr_err(DRIVER_NAME ": failed to add resources for fpga i2c ch%d\n",
 			       ch);
 			sysfs_remove_group(&pdev->dev.kobj, &misc_attr_group);
-			sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
+			cumulus_ports_del(fpga_ports);
+			fpga_ports = NULL;
 			devm_iounmap(&pdev->dev, priv->misc_pbar);
 			devm_iounmap(&pdev->dev, priv->fpga_pbar);
 			fpga_dev_release(priv);
@@ -840,7 +669,8 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *devid)
 			pr_err(DRIVER_NAME ": add data failed for fpga i2c ch%d\n",
 			       ch);
 			sysfs_remove_group(&pdev->dev.kobj, &misc_attr_group);
-			sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
+			cumulus_ports_del(fpga_ports);
+			fpga_ports = NULL;
 			devm_iounmap(&pdev->dev, priv->misc_pbar);
 			devm_iounmap(&pdev->dev, priv->fpga_pbar);
 			fpga_dev_release(priv);
@@ -854,7 +684,8 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *devid)
 			pr_err(DRIVER_NAME ": failed to add device for fpga i2c ch%d\n",
 			       ch);
 			sysfs_remove_group(&pdev->dev.kobj, &misc_attr_group);
-			sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
+			cumulus_ports_del(fpga_ports);
+			fpga_ports = NULL;
 			devm_iounmap(&pdev->dev, priv->misc_pbar);
 			devm_iounmap(&pdev->dev, priv->fpga_pbar);
 			fpga_dev_release(priv);
@@ -863,6 +694,35 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *devid)
 			goto fail;
 		}
 	}
+
+	/* Publish the presence of all ports as one pollable bitmap */
+	desc.name = DRIVER_NAME;
+	desc.num_ports = NUM_SFP_PORTS + NUM_QSFP_PORTS;
+	desc.poll_ms = 0;
+	desc.read = fpga_presence_read;
+	desc.priv = priv;
+	priv->presence = cumulus_presence_add(&pdev->dev, &desc);
+	if (IS_ERR(priv->presence)) {
+		dev_warn(&pdev->dev, "presence sampling unavailable (%ld)\n",
+			 PTR_ERR(priv->presence));
+		priv->presence = NULL;
+	}
+
+	/* Serve the static optics EEPROM bytes from memory */
+	if (priv->presence) {
+		eeprom_desc.name = DRIVER_NAME;
+		eeprom_desc.ports = fpga_ports->eeproms;
+		eeprom_desc.num_ports = fpga_ports->num_ports;
+		eeprom_desc.presence = priv->presence;
+		priv->port_eeprom = cumulus_port_eeprom_add(&pdev->dev,
+							    &eeprom_desc);
+		if (IS_ERR(priv->port_eeprom)) {
+			dev_warn(&pdev->dev,
+				 "port EEPROM cache unavailable (%ld)\n",
+				 PTR_ERR(priv->port_eeprom));
+			priv->port_eeprom = NULL;
+		}
+	}
 	pr_debug(DRIVER_NAME ": fpga driver loaded\n");
 
 fail:
@@ -874,8 +734,11 @@ static void fpga_remove(struct pci_dev *pdev)
 	struct fpga_priv *priv;
 
 	priv = dev_get_drvdata(&pdev->dev);
+	cumulus_port_eeprom_del(priv->port_eeprom);
+	cumulus_presence_del(priv->presence);
 	sysfs_remove_group(&pdev->dev.kobj, &misc_attr_group);
-	sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
+	cumulus_ports_del(fpga_ports);
+	fpga_ports = NULL;
 	devm_iounmap(&pdev->dev, priv->misc_pbar);
 	devm_iounmap(&pdev->dev, priv->fpga_pbar);
 	fpga_dev_release(priv);
@@ -933,6 +796,20 @@ static int fpga_init(void)
 			   "cel_questone2_cpld") == 0)
 			cpld_devices[count++] = client;
 	}
+
+	/* The port eeproms hang off the muxes added above */
+	for (i = 0; fpga_ports && i < fpga_ports->num_devices; i++) {
+		struct platform_i2c_device_info *info = &fpga_ports->devices[i];
+
+		client = cumulus_i2c_add_client(info->bus, &info->board_info);
+		if (IS_ERR(client)) {
+			ret = PTR_ERR(client);
+			pr_err(DRIVER_NAME ": add port eeprom failed for bus %d: %d\n",
+			       info->bus, ret);
+			goto err_exit;
+		}
+		info->client = client;
+	}
 	pr_info(DRIVER_NAME ": FPGA driver registered\n");
 	return 0;
 
@@ -946,7 +823,14 @@ static void fpga_exit(void)
 	int i;
 	struct i2c_client *c;
 
-	/* unregister the FPGA i2c clients */
+	/* unregister the port eeproms, then the other FPGA i2c clients */
+	for (i = fpga_ports ? fpga_ports->num_devices : 0; --i >= 0;) {
+		c = fpga_ports->devices[i].client;
+		if (c) {
+			fpga_ports->devices[i].client = NULL;
+			i2c_unregister_device(c);
+		}
+	}
 	for (i = ARRAY_SIZE(fpga_i2c_devices); --i >= 0;) {
 		c = fpga_i2c_devices[i].client;
 		if (c)
@@ -29,6 +29,7 @@
 
 #include "cel-redstone-xp-b-cpld.h"
 #include "cel-xp-b-muxpld.h"
+#include "platform-defs.h"
 
 #define DRIVER_NAME	"cel_red_xpb_muxpld"
 #define DRIVER_VERSION	"1.0"
@@ -166,7 +167,7 @@ static struct i2c_board_info *alloc_sfp_board_info(int port)
 
 	at24_data->byte_len = 512;
 	at24_data->flags = AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG;
-	at24_data->page_size = 1;
+	at24_data->page_size = SFP_PAGE_SIZE;
 	at24_data->eeprom_data = eeprom_data;
 
 	strcpy(board_info->type, "24c04");
@@ -211,7 +212,7 @@ static struct i2c_board_info *alloc_qsfp_board_info(int port)
 
 	sff8436_data->byte_len = 256;
 	sff8436_data->flags = SFF_8436_FLAG_IRUGO;
-	sff8436_data->page_size = 1;
+	sff8436_data->page_size = QSFP_PAGE_SIZE;
 	sff8436_data->eeprom_data = eeprom_data;
 
 	strcpy(board_info->type, "sff8436");
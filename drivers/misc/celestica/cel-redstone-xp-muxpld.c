@@ -33,6 +33,7 @@
 #include "cel-xp-platform.h"
 #include "cel-redstone-xp-cpld.h"
 #include "cel-xp-muxpld.h"
+#include "platform-defs.h"
 
 #define DRIVER_NAME	"cel_redstone_xp_cpld_muxpld"
 #define DRIVER_VERSION	"1.1"
@@ -44,6 +45,7 @@ struct cel_redstone_xp_bus_mux_info {
 	u32 io_base;
 	int first_port_num;
 	int num_ports;
+	u16 present_reg[CPLD_MUX_MAX_PRESENT_REGS];
 };
 
 static struct cel_redstone_xp_bus_mux_info red_xp_bus_mux_info[] = {
@@ -52,24 +54,39 @@ static struct cel_redstone_xp_bus_mux_info red_xp_bus_mux_info[] = {
 		.io_base = CPLD2_REG_I2C_PORT_ID_OFFSET,
 		.first_port_num = 1,
 		.num_ports = 18,
+		.present_reg = {
+			CPLD2_SFP_1_8_PRESENT_REGISTER,
+			CPLD2_SFP_9_16_PRESENT_REGISTER,
+			CPLD2_SFP_17_18_PRESENT_REGISTER,
+		},
 	},
 	{
 		.bus = RXP_I2C_CPLD_MUX_2,
 		.io_base = CPLD3_REG_I2C_PORT_ID_OFFSET,
 		.first_port_num = 19,
 		.num_ports = 18,
+		.present_reg = {
+			CPLD3_SFP_19_26_PRESENT_REGISTER,
+			CPLD3_SFP_27_34_PRESENT_REGISTER,
+			CPLD3_SFP_35_36_PRESENT_REGISTER,
+		},
 	},
 	{
 		.bus = RXP_I2C_CPLD_MUX_3,
 		.io_base = CPLD4_REG_I2C_PORT_ID_OFFSET,
 		.first_port_num = 49,
 		.num_ports = 6,
+		.present_reg = { CPLD4_QSFP_PRESENT_REGISTER },
 	},
 	{
 		.bus = RXP_I2C_CPLD_MUX_4,
 		.io_base = CPLD5_REG_I2C_PORT_ID_OFFSET,
 		.first_port_num = 37,
 		.num_ports = 12,
+		.present_reg = {
+			CPLD5_SFP_37_44_PRESENT_REGISTER,
+			CPLD5_SFP_45_48_PRESENT_REGISTER,
+		},
 	},
 };
 
@@ -178,7 +195,7 @@ static struct i2c_board_info *alloc_sfp_board_info(int port) {
 
 	at24_data->byte_len = 512;
 	at24_data->flags = AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG;
-	at24_data->page_size = 1;
+	at24_data->page_size = SFP_PAGE_SIZE;
 	at24_data->eeprom_data = eeprom_data;
 
 	strcpy(board_info->type, "24c04");
@@ -226,7 +243,7 @@ static struct i2c_board_info *alloc_qsfp_board_info(int port) {
 
 	sff8436_data->byte_len = 256;
 	sff8436_data->flags = SFF_8436_FLAG_IRUGO;
-	sff8436_data->page_size = 1;
+	sff8436_data->page_size = QSFP_PAGE_SIZE;
 	sff8436_data->eeprom_data = eeprom_data;
 
 	strcpy(board_info->type, "sff8436");
@@ -292,9 +309,10 @@ exit:
 	return ret;
 }
 
-int create_i2c_mux(int index, int bus, int first_port_num, int num_ports)
+int create_i2c_mux(int index, int bus, int first_port_num, int num_ports,
+		    const u16 *present_reg)
 {
-	struct cpld_mux_data mux_data;
+	struct cpld_mux_data mux_data = { 0 };
 	struct platform_device *device;
 	struct i2c_adapter *parent_adapter;
 	int ret = 0;
@@ -303,6 +321,7 @@ int create_i2c_mux(int index, int bus, int first_port_num, int num_ports)
 	mux_data.mux_base_id = bus;
 	mux_data.mux_base_port_num = first_port_num;
 	mux_data.mux_num_ports = num_ports;
+	memcpy(mux_data.present_reg, present_reg, sizeof(mux_data.present_reg));
 
 	parent_adapter = get_adapter(bus);
 	if (!parent_adapter) {
@@ -405,7 +424,8 @@ static int __init cel_redstone_xp_cpld_mux_init(void)
 	for (i = 0; i < ARRAY_SIZE(red_xp_bus_mux_info); i++) {
 		ret = create_i2c_mux(i, red_xp_bus_mux_info[i].bus,
 		                     red_xp_bus_mux_info[i].first_port_num,
-		                     red_xp_bus_mux_info[i].num_ports);
+		                     red_xp_bus_mux_info[i].num_ports,
+		                     red_xp_bus_mux_info[i].present_reg);
 		if (ret) {
 			goto err_exit2;
 		}
@@ -35,6 +35,7 @@
 #include "cel-xp-platform.h"
 #include "cel-seastone-cpld.h"
 #include "cel-xp-muxpld.h"
+#include "platform-defs.h"
 
 #define DRIVER_NAME	"cel_seastone_muxpld"
 #define DRIVER_VERSION	"1.0"
@@ -47,18 +48,30 @@ static struct cel_xp_bus_mux_info sea_bus_mux_info[] = {
 		.io_base = CPLD2_REG_I2C_PORT_ID_OFFSET,
 		.first_port_num = 1,
 		.num_ports = 10,
+		.present_reg = {
+			CPLD2_REG_QSFP_1_8_ABSENT_OFFSET,
+			CPLD2_REG_QSFP_9_10_ABSENT_OFFSET,
+		},
 	},
 	{
 		.bus = RXP_I2C_CPLD_MUX_2,
 		.io_base = CPLD3_REG_I2C_PORT_ID_OFFSET,
 		.first_port_num = 11,
 		.num_ports = 11,
+		.present_reg = {
+			CPLD3_REG_QSFP_11_18_ABSENT_OFFSET,
+			CPLD3_REG_QSFP_19_21_ABSENT_OFFSET,
+		},
 	},
 	{
 		.bus = RXP_I2C_CPLD_MUX_3,
 		.io_base = CPLD5_REG_I2C_PORT_ID_OFFSET,
 		.first_port_num = 22,
 		.num_ports = 11,
+		.present_reg = {
+			CPLD5_REG_QSFP_22_29_ABSENT_OFFSET,
+			CPLD5_REG_QSFP_30_32_ABSENT_OFFSET,
+		},
 	},
 };
 
@@ -146,7 +159,7 @@ static struct i2c_board_info *alloc_qsfp_board_info(int port) {
 
 	sff8436_data->byte_len = 256;
 	sff8436_data->flags = SFF_8436_FLAG_IRUGO;
-	sff8436_data->page_size = 1;
+	sff8436_data->page_size = QSFP_PAGE_SIZE;
 	sff8436_data->eeprom_data = eeprom_data;
 
 	strcpy(board_info->type, "sff8436");
@@ -212,9 +225,10 @@ exit:
 	return ret;
 }
 
-int create_i2c_mux(int index, int bus, int first_port_num, int num_ports)
+int create_i2c_mux(int index, int bus, int first_port_num, int num_ports,
+		    const u16 *present_reg)
 {
-	struct cpld_mux_data mux_data;
+	struct cpld_mux_data mux_data = { 0 };
 	struct platform_device *device;
 	struct i2c_adapter *parent_adapter;
 	int ret = 0;
@@ -223,6 +237,7 @@ int create_i2c_mux(int index, int bus, int first_port_num, int num_ports)
 	mux_data.mux_base_id = bus;
 	mux_data.mux_base_port_num = first_port_num;
 	mux_data.mux_num_ports = num_ports;
+	memcpy(mux_data.present_reg, present_reg, sizeof(mux_data.present_reg));
 
 	parent_adapter = get_adapter(bus);
 	if (!parent_adapter) {
@@ -315,7 +330,8 @@ static int __init cel_seastone_cpld_mux_init(void)
 	for (i = 0; i < ARRAY_SIZE(sea_bus_mux_info); i++) {
 		ret = create_i2c_mux(i, sea_bus_mux_info[i].bus,
 		                     sea_bus_mux_info[i].first_port_num,
-		                     sea_bus_mux_info[i].num_ports);
+		                     sea_bus_mux_info[i].num_ports,
+		                     sea_bus_mux_info[i].present_reg);
 		if (ret) {
 			goto err_exit2;
 		}
@@ -27,6 +27,7 @@
 
 #include "cel-smallstone-xp-b-cpld.h"
 #include "cel-xp-b-muxpld.h"
+#include "platform-defs.h"
 
 #define DRIVER_NAME	"cel_smallstone_xp_b_muxpld"
 #define DRIVER_VERSION	"1.0"
@@ -131,7 +132,7 @@ static struct i2c_board_info *alloc_qsfp_board_info(int port)
 
 	sff8436_data->byte_len = 512;
 	sff8436_data->flags = SFF_8436_FLAG_IRUGO;
-	sff8436_data->page_size = 1;
+	sff8436_data->page_size = QSFP_PAGE_SIZE;
 	sff8436_data->eeprom_data = eeprom_data;
 
 	strcpy(board_info->type, "sff8436");
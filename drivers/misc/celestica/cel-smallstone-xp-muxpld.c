@@ -33,9 +33,10 @@
 #include "cel-xp-platform.h"
 #include "cel-smallstone-xp-cpld.h"
 #include "cel-xp-muxpld.h"
+#include "platform-defs.h"
 
 #define DRIVER_NAME	"cel_smallstone_xp_muxpld"
-#define DRIVER_VERSION	"1.0"
+#define DRIVER_VERSION	"1.1"
 
 static struct platform_driver cel_smallstone_xp_cpld_mux_driver;
 
@@ -45,12 +46,20 @@ static struct cel_xp_bus_mux_info small_xp_bus_mux_info[] = {
 		.io_base = CPLD2_REG_I2C_PORT_ID_OFFSET,
 		.first_port_num = 1,
 		.num_ports = 16,
+		.present_reg = {
+			CPLD2_REG_QSFP_1_8_ABSENT_OFFSET,
+			CPLD2_REG_QSFP_9_16_ABSENT_OFFSET,
+		},
 	},
 	{
 		.bus = RXP_I2C_CPLD_MUX_2,
 		.io_base = CPLD3_REG_I2C_PORT_ID_OFFSET,
 		.first_port_num = 17,
 		.num_ports = 16,
+		.present_reg = {
+			CPLD3_REG_QSFP_17_24_ABSENT_OFFSET,
+			CPLD3_REG_QSFP_25_32_ABSENT_OFFSET,
+		},
 	},
 };
 
@@ -141,7 +150,7 @@ static struct i2c_board_info *alloc_qsfp_board_info(int port) {
 
 	sff8436_data->byte_len = 512;
 	sff8436_data->flags = SFF_8436_FLAG_IRUGO;
-	sff8436_data->page_size = 1;
+	sff8436_data->page_size = QSFP_PAGE_SIZE;
 	sff8436_data->eeprom_data = eeprom_data;
 
 	strcpy(board_info->type, "sff8436");
@@ -207,9 +216,10 @@ exit:
 	return ret;
 }
 
-int create_i2c_mux(int index, int bus, int first_port_num, int num_ports)
+int create_i2c_mux(int index, int bus, int first_port_num, int num_ports,
+		    const u16 *present_reg)
 {
-	struct cpld_mux_data mux_data;
+	struct cpld_mux_data mux_data = { 0 };
 	struct platform_device *device;
 	struct i2c_adapter *parent_adapter;
 	int ret = 0;
@@ -218,6 +228,7 @@ int create_i2c_mux(int index, int bus, int first_port_num, int num_ports)
 	mux_data.mux_base_id = bus;
 	mux_data.mux_base_port_num = first_port_num;
 	mux_data.mux_num_ports = num_ports;
+	memcpy(mux_data.present_reg, present_reg, sizeof(mux_data.present_reg));
 
 	parent_adapter = get_adapter(bus);
 	if (!parent_adapter) {
@@ -310,7 +321,8 @@ static int __init cel_smallstone_xp_cpld_mux_init(void)
 	for (i = 0; i < ARRAY_SIZE(small_xp_bus_mux_info); i++) {
 		ret = create_i2c_mux(i, small_xp_bus_mux_info[i].bus,
 		                     small_xp_bus_mux_info[i].first_port_num,
-		                     small_xp_bus_mux_info[i].num_ports);
+		                     small_xp_bus_mux_info[i].num_ports,
+		                     small_xp_bus_mux_info[i].present_reg);
 		if (ret) {
 			goto err_exit2;
 		}
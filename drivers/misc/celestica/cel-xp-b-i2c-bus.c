@@ -27,6 +27,7 @@
 #include <linux/i2c-mux.h>
 #include <linux/interrupt.h>
 #include <linux/delay.h>
+#include <linux/cumulus-cpld-mux.h>
 
 #include "cel-xp-b-muxpld.h"
 
@@ -240,23 +241,21 @@ static int cel_cpld_i2c_read(struct cel_cpld_i2c *i2c, int addr,
 	return length;
 }
 
-static int cel_cpld_xfer(struct i2c_adapter *adap, struct i2c_msg *msgs,
-			 int num)
+/*
+ * Wait for the bus to go idle before starting a transfer, and release it
+ * with a stop afterwards.  Both allow up to 1s and run the 9-clock fixup
+ * if a slave is holding the bus.
+ */
+static int cel_cpld_i2c_start(struct cel_cpld_i2c *i2c)
 {
-	struct i2c_msg *pmsg;
-	int ret = 0;
-	int i;
 	unsigned long orig_jiffies = jiffies;
-	struct cel_cpld_i2c *i2c = i2c_get_adapdata(adap);
 	u8 status;
-	bool recv_len;
 
 	/* Clear arbitration */
 	iowrite8(0, i2c->m_base + CEL_CPLD_I2C_SR);
 	/* Start with MEN */
 	iowrite8(CCR_MEN, i2c->m_base + CEL_CPLD_I2C_CR);
 
-	/* Allow bus up to 1s to become not busy */
 	while (ioread8(i2c->m_base + CEL_CPLD_I2C_SR) & CSR_MBB) {
 		if (signal_pending(current)) {
 			iowrite8(0, i2c->m_base + CEL_CPLD_I2C_CR);
@@ -274,24 +273,16 @@ static int cel_cpld_xfer(struct i2c_adapter *adap, struct i2c_msg *msgs,
 		schedule();
 	}
 
-	for (i = 0; ret >= 0 && i < num; i++) {
-		pmsg = &msgs[i];
-		if (pmsg->flags & I2C_M_RD) {
-			recv_len = pmsg->flags & I2C_M_RECV_LEN;
-			ret = cel_cpld_i2c_read(i2c, pmsg->addr, pmsg->buf,
-						pmsg->len, i, recv_len);
-			if (recv_len && ret > 0)
-				pmsg->len = ret;
-		} else {
-			ret = cel_cpld_i2c_write(i2c, pmsg->addr, pmsg->buf,
-						 pmsg->len, i);
-		}
-	}
+	return 0;
+}
+
+static int cel_cpld_i2c_stop(struct cel_cpld_i2c *i2c)
+{
+	unsigned long orig_jiffies = jiffies;
+	u8 status;
 
 	/* initiate stop */
 	iowrite8(CCR_MEN, i2c->m_base + CEL_CPLD_I2C_CR);
-	orig_jiffies = jiffies;
-	/* Wait until STOP is seen, allow up to 1 s */
 	while (ioread8(i2c->m_base + CEL_CPLD_I2C_SR) & CSR_MBB) {
 		if (time_after(jiffies, orig_jiffies + HZ)) {
 			status = ioread8(i2c->m_base + CEL_CPLD_I2C_SR);
@@ -305,9 +296,126 @@ static int cel_cpld_xfer(struct i2c_adapter *adap, struct i2c_msg *msgs,
 		cond_resched();
 	}
 
+	return 0;
+}
+
+static int cel_cpld_xfer(struct i2c_adapter *adap, struct i2c_msg *msgs,
+			 int num)
+{
+	struct i2c_msg *pmsg;
+	int ret;
+	int i;
+	struct cel_cpld_i2c *i2c = i2c_get_adapdata(adap);
+	bool recv_len;
+
+	ret = cel_cpld_i2c_start(i2c);
+	if (ret)
+		return ret;
+
+	for (i = 0; ret >= 0 && i < num; i++) {
+		pmsg = &msgs[i];
+		if (pmsg->flags & I2C_M_RD) {
+			recv_len = pmsg->flags & I2C_M_RECV_LEN;
+			ret = cel_cpld_i2c_read(i2c, pmsg->addr, pmsg->buf,
+						pmsg->len, i, recv_len);
+			if (recv_len && ret > 0)
+				pmsg->len = ret;
+		} else {
+			ret = cel_cpld_i2c_write(i2c, pmsg->addr, pmsg->buf,
+						 pmsg->len, i);
+		}
+	}
+
+	if (cel_cpld_i2c_stop(i2c))
+		return -EIO;
+
 	return (ret < 0) ? ret : num;
 }
 
+/*
+ * Native SMBus transfers.  The CPLD drivers behind this master mostly do
+ * single register reads, so drive the controller directly instead of
+ * going through the i2c core message emulation.  Anything not handled
+ * here returns -EOPNOTSUPP and falls back to that emulation.
+ */
+static int cel_cpld_smbus_xfer(struct i2c_adapter *adap, u16 addr,
+			       unsigned short flags, char read_write,
+			       u8 command, int size,
+			       union i2c_smbus_data *data)
+{
+	struct cel_cpld_i2c *i2c = i2c_get_adapdata(adap);
+	u8 buf[I2C_SMBUS_BLOCK_MAX + 1];
+	bool rd = read_write == I2C_SMBUS_READ;
+	u8 *rbuf = NULL;
+	int wlen = 1, rlen = 0;
+	int ret;
+
+	if (flags & I2C_CLIENT_PEC)
+		return -EOPNOTSUPP;
+
+	buf[0] = command;
+	switch (size) {
+	case I2C_SMBUS_BYTE:
+		if (rd) {
+			wlen = 0;
+			rbuf = &data->byte;
+			rlen = 1;
+		}
+		break;
+	case I2C_SMBUS_BYTE_DATA:
+		if (rd) {
+			rbuf = &data->byte;
+			rlen = 1;
+		} else {
+			buf[1] = data->byte;
+			wlen = 2;
+		}
+		break;
+	case I2C_SMBUS_WORD_DATA:
+		if (rd) {
+			rbuf = &buf[1];
+			rlen = 2;
+		} else {
+			buf[1] = data->word & 0xff;
+			buf[2] = data->word >> 8;
+			wlen = 3;
+		}
+		break;
+	case I2C_SMBUS_I2C_BLOCK_DATA:
+		if (data->block[0] == 0 ||
+		    data->block[0] > I2C_SMBUS_BLOCK_MAX)
+			return -EINVAL;
+		if (rd) {
+			rbuf = &data->block[1];
+			rlen = data->block[0];
+		} else {
+			memcpy(&buf[1], &data->block[1], data->block[0]);
+			wlen = data->block[0] + 1;
+		}
+		break;
+	default:
+		return -EOPNOTSUPP;
+	}
+
+	ret = cel_cpld_i2c_start(i2c);
+	if (ret)
+		return ret;
+
+	if (wlen)
+		ret = cel_cpld_i2c_write(i2c, addr, buf, wlen, 0);
+	if (ret >= 0 && rlen)
+		ret = cel_cpld_i2c_read(i2c, addr, rbuf, rlen, wlen, false);
+
+	if (cel_cpld_i2c_stop(i2c))
+		return -EIO;
+	if (ret < 0)
+		return ret;
+
+	if (rd && size == I2C_SMBUS_WORD_DATA)
+		data->word = buf[1] | (buf[2] << 8);
+	return 0;
+}
+
 static u32 cel_cpld_functionality(struct i2c_adapter *adap)
 {
 	return I2C_FUNC_I2C | I2C_FUNC_SMBUS_EMUL;
@@ -315,6 +423,7 @@ static u32 cel_cpld_functionality(struct i2c_adapter *adap)
 
 static const struct i2c_algorithm cel_cpld_algo = {
 	.master_xfer = cel_cpld_xfer,
+	.smbus_xfer = cel_cpld_smbus_xfer,
 	.functionality = cel_cpld_functionality,
 };
 
@@ -433,31 +542,9 @@ static struct platform_driver cel_cpld_i2c_bus_driver = {
 
 #define INVALID_CHANNEL		(0xFF)
 
-struct cel_cpld_vadapter {
-	struct i2c_adapter *m_adapter;  /* virtual i2c adapter struct */
-	u32                 m_channel;  /* MUX channel */
-	struct llist_node   m_llnode;
-};
-
-struct cel_cpld_i2c_mux {
-	struct device       *m_dev;           /* for debug and error output */
-	struct llist_head    m_vadapter_list; /* list of virtual i2c adapters */
-	struct cel_cpld_i2c *m_i2c_bus;       /* parent I2C master device */
-	u8                   m_last_channel;  /* last channel selected    */
-	u32                  m_mux_id;        /* mux ID */
-	int                  m_num_ports;     /* number of ports on this mux */
-};
-
-static int cel_cpld_i2c_mux_select_chan(struct i2c_mux_core *muxc,
-					u32 channel)
+static int cel_cpld_i2c_mux_write(void *priv, u32 reg, u32 val)
 {
-	struct cel_cpld_i2c_mux *mux =  i2c_mux_priv(muxc);
-
-	if (channel != mux->m_last_channel) {
-		cel_cpld_set_mux_reg(mux->m_i2c_bus, channel);
-		mux->m_last_channel = channel;
-	}
-
+	cel_cpld_set_mux_reg(priv, val);
 	return 0;
 }
 
@@ -469,11 +556,10 @@ static int cel_cpld_i2c_mux_probe(struct platform_device *client)
 {
 	struct i2c_adapter  *adap = to_i2c_adapter(client->dev.parent);
 	struct cel_cpld_i2c *i2c = i2c_get_adapdata(adap);
-	struct cel_cpld_i2c_mux *mux;
+	struct cumulus_cpld_mux_desc desc = { 0 };
+	struct cumulus_cpld_mux_group *group;
 	struct cpld_mux_data *mux_data;
-	struct i2c_mux_core *muxc = NULL;
-	int rc = -ENODEV;
-	int i;
+	struct i2c_mux_core *muxc;
 
 	if (!client->dev.platform_data) {
 		pr_err(BUS_DRV_NAME "mux: no platform data\n");
@@ -481,68 +567,39 @@ static int cel_cpld_i2c_mux_probe(struct platform_device *client)
 	}
 	mux_data = client->dev.platform_data;
 
-	mux = kmalloc(sizeof(*mux), GFP_KERNEL);
-	if (!mux) {
-		rc = -ENOMEM;
-		goto err_exit;
-	}
-	mux->m_dev = &client->dev;
-	mux->m_i2c_bus = i2c;
-	mux->m_mux_id = adap->nr;
-	mux->m_last_channel = INVALID_CHANNEL;
-	mux->m_num_ports = mux_data->mux_num_ports;
-	muxc = i2c_mux_alloc(adap,
-			     &client->dev,
-			     mux_data->mux_num_ports,
-			     0,
-			     0,
-			     cel_cpld_i2c_mux_select_chan,
-			     NULL);
-
-	if (!muxc) {
-	  pr_err(BUS_DRV_NAME "i2c_mux_alloc() failed .\n");
-	  rc = -ENOMEM;
-	  goto err_exit;
-	}
+	group = devm_kzalloc(&client->dev, sizeof(*group), GFP_KERNEL);
+	if (!group)
+		return -ENOMEM;
 
-	muxc->priv = mux;
-	platform_set_drvdata(client, muxc);
-
-	for (i = 0; i < mux_data->mux_num_ports; i++) {
-		int bus;
-		int channel;
-
-		channel = mux_data->mux_base_port_num + i;
-		bus =  mux_data->mux_ports_base_bus + channel;
-		rc = i2c_mux_add_adapter(muxc, bus, channel, 0);
-		if (rc) {
-			pr_err(BUS_DRV_NAME
-			       "failed to register multiplexed adapter %u\n",
-			       bus);
-			goto dealloc_exit;
-		}
+	/* The port stays selected between transfers. */
+	group->first_chan = 0;
+	group->num_chans = mux_data->mux_num_ports;
+	group->base_val = mux_data->mux_base_port_num;
+	group->idle_val = INVALID_CHANNEL;
+
+	desc.name = dev_name(&client->dev);
+	desc.num_chans = mux_data->mux_num_ports;
+	desc.first_bus = mux_data->mux_ports_base_bus +
+			 mux_data->mux_base_port_num;
+	desc.groups = group;
+	desc.num_groups = 1;
+	desc.write = cel_cpld_i2c_mux_write;
+	desc.priv = i2c;
+
+	muxc = cumulus_cpld_mux_add(&client->dev, adap, &desc);
+	if (IS_ERR(muxc)) {
+		pr_err(BUS_DRV_NAME
+		       "failed to register multiplexed adapters: %ld\n",
+		       PTR_ERR(muxc));
+		return PTR_ERR(muxc);
 	}
-	dev_set_drvdata(&client->dev, mux);
 
 	return 0;
-
-dealloc_exit:
-	i2c_mux_del_adapters(muxc);
-	i2c_put_adapter(muxc->parent);
-err_exit:
-	return rc;
 }
 
 static int cel_cpld_i2c_mux_remove(struct platform_device *client)
 {
-	struct i2c_mux_core *muxc = platform_get_drvdata(client);
-
-	if (muxc) {
-		kfree(muxc->priv);
-		i2c_mux_del_adapters(muxc);
-		i2c_put_adapter(muxc->parent);
-	}
-
+	cumulus_cpld_mux_del(platform_get_drvdata(client));
 	return 0;
 }
 
@@ -30,6 +30,7 @@
 #include <linux/i2c-mux.h>
 #include <linux/interrupt.h>
 #include <linux/delay.h>
+#include <linux/cumulus-cpld-mux.h>
 
 #include "cel-xp-platform.h"
 #include "cel-xp-muxpld.h"
@@ -113,7 +114,7 @@ static int cel_cpld_wait(struct cel_cpld_i2c *i2c)
 		/* Clear master error with the master reset. */
 		iowrite8(~CSR_MASTER_RESET_L,
 		       i2c->m_base + CEL_CPLD_I2C_CSR);
-		udelay(3000);
+		usleep_range(3000, 3500);
 		iowrite8(CSR_MASTER_RESET_L,
 		       i2c->m_base + CEL_CPLD_I2C_CSR);
 		rc = rc ? rc : -EIO;
@@ -271,6 +272,65 @@ static int cel_cpld_xfer(struct i2c_adapter *adap, struct i2c_msg *msgs, int num
 	return (ret < 0) ? ret : num;
 }
 
+/*
+ * Native SMBus transfers.  The register offset maps directly onto the
+ * command byte of the CPLD master, so byte, word and I2C block accesses
+ * are issued without building messages.  Anything else returns
+ * -EOPNOTSUPP and falls back to the i2c core emulation.
+ */
+static int cel_cpld_smbus_xfer(struct i2c_adapter *adap, u16 addr,
+			       unsigned short flags, char read_write,
+			       u8 command, int size,
+			       union i2c_smbus_data *data)
+{
+	struct cel_cpld_i2c *i2c = i2c_get_adapdata(adap);
+	bool rd = read_write == I2C_SMBUS_READ;
+	u8 buf[2];
+	int ret;
+
+	if (flags & I2C_CLIENT_PEC)
+		return -EOPNOTSUPP;
+	if (size != I2C_SMBUS_BYTE_DATA &&
+	    size != I2C_SMBUS_WORD_DATA &&
+	    size != I2C_SMBUS_I2C_BLOCK_DATA)
+		return -EOPNOTSUPP;
+
+	/* Only wait if a previous command is somehow still running */
+	if (ioread8(i2c->m_base + CEL_CPLD_I2C_CSR) & CSR_BUSY) {
+		ret = cel_cpld_wait(i2c);
+		if (ret)
+			return ret;
+	}
+
+	switch (size) {
+	case I2C_SMBUS_BYTE_DATA:
+		if (rd)
+			return cel_cpld_i2c_read(i2c, addr, command,
+						 &data->byte, 1);
+		return cel_cpld_i2c_write(i2c, addr, command, &data->byte, 1);
+	case I2C_SMBUS_WORD_DATA:
+		if (rd) {
+			ret = cel_cpld_i2c_read(i2c, addr, command, buf, 2);
+			if (!ret)
+				data->word = buf[0] | (buf[1] << 8);
+			return ret;
+		}
+		buf[0] = data->word & 0xff;
+		buf[1] = data->word >> 8;
+		return cel_cpld_i2c_write(i2c, addr, command, buf, 2);
+	default:
+		if (data->block[0] == 0 ||
+		    data->block[0] > I2C_SMBUS_BLOCK_MAX)
+			return -EINVAL;
+		if (rd)
+			return cel_cpld_i2c_read(i2c, addr, command,
+						 &data->block[1],
+						 data->block[0]);
+		return cel_cpld_i2c_write(i2c, addr, command,
+					  &data->block[1], data->block[0]);
+	}
+}
+
 static u32 cel_cpld_functionality(struct i2c_adapter *adap)
 {
 	return I2C_FUNC_I2C | I2C_FUNC_SMBUS_EMUL;
@@ -278,6 +338,7 @@ static u32 cel_cpld_functionality(struct i2c_adapter *adap)
 
 static const struct i2c_algorithm cel_cpld_algo = {
 	.master_xfer = cel_cpld_xfer,
+	.smbus_xfer = cel_cpld_smbus_xfer,
 	.functionality = cel_cpld_functionality,
 };
 
@@ -300,7 +361,7 @@ static void cel_cpld_i2c_bus_setup(struct cel_cpld_i2c *i2c, u32 clock)
 
 	/* Reset the I2C master logic */
 	iowrite8(~CSR_MASTER_RESET_L, i2c->m_base + CEL_CPLD_I2C_CSR);
-	udelay(3000);
+	usleep_range(3000, 3500);
 	iowrite8(CSR_MASTER_RESET_L, i2c->m_base + CEL_CPLD_I2C_CSR);
 
 }
@@ -382,41 +443,38 @@ static struct platform_driver cel_cpld_i2c_bus_driver = {
 
 #define INVALID_CHANNEL		(0xFF)
 
-struct cel_cpld_vadapter {
-	struct i2c_adapter *m_adapter;  /* virtual i2c adapter struct */
-	u32                 m_channel;  /* MUX channel */
-	struct llist_node   m_llnode;
-};
-
 struct cel_cpld_i2c_mux {
-	struct llist_head    m_vadapter_list; /* list of virtual i2c adapters */
 	struct cel_cpld_i2c *m_i2c_bus;       /* parent I2C master device */
-	u8                   m_last_channel;  /* last channel selected    */
-	u32                  m_mux_id;        /* mux ID */
-	int                  m_num_ports;     /* number of ports on this mux */
+	struct i2c_mux_core *m_muxc;
+	struct cumulus_cpld_mux_group m_group;
+	void __iomem        *m_present_reg[CPLD_MUX_MAX_PRESENT_REGS];
+	int                  m_num_present_regs;
 };
 
-static int cel_cpld_i2c_mux_select_chan(struct i2c_mux_core *muxc, u32 channel)
+static int cel_cpld_i2c_mux_write(void *priv, u32 reg, u32 val)
 {
-	struct cel_cpld_i2c_mux *mux = i2c_mux_priv(muxc);
-
-	if (channel != mux->m_last_channel) {
-		cel_cpld_set_mux_reg(mux->m_i2c_bus, channel);
-		mux->m_last_channel = channel;
-	}
+	struct cel_cpld_i2c_mux *mux = priv;
 
+	cel_cpld_set_mux_reg(mux->m_i2c_bus, val);
 	return 0;
 }
 
-static int cel_cpld_i2c_mux_deselect_chan(struct i2c_mux_core *muxc, u32 channel)
+/*
+ * An empty cage makes the master raise CSR_MASTER_ERROR only after the
+ * bus timeout, and recovering from that costs a master reset.  Report
+ * the module present bits so absent ports fail right away.
+ */
+static int cel_cpld_i2c_mux_read_present(void *priv, unsigned long *present)
 {
-	struct cel_cpld_i2c_mux *mux = i2c_mux_priv(muxc);
+	struct cel_cpld_i2c_mux *mux = priv;
+	int i;
 
-	cel_cpld_set_mux_reg(mux->m_i2c_bus, INVALID_CHANNEL);
-	mux->m_last_channel = INVALID_CHANNEL;
+	/* at most CPLD_MUX_MAX_PRESENT_REGS * 8 ports, one long is plenty */
+	for (i = 0; i < mux->m_num_present_regs; i++)
+		present[0] |= (unsigned long)(u8)~ioread8(mux->m_present_reg[i])
+			      << (i * 8);
 
 	return 0;
-
 }
 
 /*
@@ -427,10 +485,10 @@ static int cel_cpld_i2c_mux_probe(struct platform_device *client)
 {
 	struct i2c_adapter  *adap = to_i2c_adapter(client->dev.parent);
 	struct cel_cpld_i2c *i2c = i2c_get_adapdata(adap);
+	struct cumulus_cpld_mux_desc desc = { 0 };
 	struct cel_cpld_i2c_mux *mux;
 	struct cpld_mux_data *mux_data;
-	struct i2c_mux_core *muxc = NULL;
-	int rc = -ENODEV;
+	int rc;
 	int i;
 
 	if (!client->dev.platform_data) {
@@ -439,50 +497,55 @@ static int cel_cpld_i2c_mux_probe(struct platform_device *client)
 	}
 	mux_data = client->dev.platform_data;
 
-	mux = kmalloc(sizeof(struct cel_cpld_i2c_mux), GFP_KERNEL);
-	if (!mux) {
-		rc = -ENOMEM;
-		goto err_exit;
-	}
+	mux = kzalloc(sizeof(struct cel_cpld_i2c_mux), GFP_KERNEL);
+	if (!mux)
+		return -ENOMEM;
 	mux->m_i2c_bus = i2c;
-	mux->m_mux_id = adap->nr;
-	mux->m_last_channel = INVALID_CHANNEL;
-	mux->m_num_ports = mux_data->mux_num_ports;
-
-	muxc = i2c_mux_alloc(adap,
-			     &client->dev,
-			     mux_data->mux_num_ports,
-			     0,
-			     0,
-			     cel_cpld_i2c_mux_select_chan,
-			     cel_cpld_i2c_mux_deselect_chan);
-	if (!muxc) {
-		rc = -ENOMEM;
-		goto err_exit;
-	}
-	muxc->priv = mux;
-	platform_set_drvdata(client, muxc);
-
-	for (i = 0; i < mux_data->mux_num_ports; i++) {
-		int bus;
-		int channel;
-
-		channel = mux_data->mux_base_port_num + i;
-		bus = RXP_I2C_CPLD_MUX_FIRST_PORT + channel;
-		if (i2c_mux_add_adapter(muxc, bus, channel, 0)) {
-		     pr_err("failed to register multiplexed adapter %u\n", bus);
-		     rc = -ENODEV;
-		     goto dealloc_exit;
+
+	for (i = 0; i < CPLD_MUX_MAX_PRESENT_REGS; i++) {
+		if (!mux_data->present_reg[i])
+			break;
+		mux->m_present_reg[i] = ioport_map(mux_data->present_reg[i], 1);
+		if (!mux->m_present_reg[i]) {
+			rc = -ENOMEM;
+			goto err_exit;
 		}
+		mux->m_num_present_regs++;
+	}
+
+	/*
+	 * The PORT_ID register selects the port directly; the bus master
+	 * behind it serves nothing but these ports, so the last port is
+	 * left selected between transfers.
+	 */
+	mux->m_group.first_chan = 0;
+	mux->m_group.num_chans = mux_data->mux_num_ports;
+	mux->m_group.base_val = mux_data->mux_base_port_num;
+	mux->m_group.idle_val = INVALID_CHANNEL;
+
+	desc.name = dev_name(&client->dev);
+	desc.num_chans = mux_data->mux_num_ports;
+	desc.first_bus = RXP_I2C_CPLD_MUX_FIRST_PORT +
+			 mux_data->mux_base_port_num;
+	desc.groups = &mux->m_group;
+	desc.num_groups = 1;
+	desc.write = cel_cpld_i2c_mux_write;
+	if (mux->m_num_present_regs)
+		desc.read_present = cel_cpld_i2c_mux_read_present;
+	desc.priv = mux;
+
+	mux->m_muxc = cumulus_cpld_mux_add(&client->dev, adap, &desc);
+	if (IS_ERR(mux->m_muxc)) {
+		rc = PTR_ERR(mux->m_muxc);
+		pr_err("failed to register multiplexed adapters: %d\n", rc);
+		goto err_exit;
 	}
-	dev_set_drvdata(&client->dev, mux);
 
 	return 0;
 
-dealloc_exit:
-	i2c_mux_del_adapters(muxc);
-	i2c_put_adapter(muxc->parent);
 err_exit:
+	for (i = 0; i < mux->m_num_present_regs; i++)
+		ioport_unmap(mux->m_present_reg[i]);
 	kfree(mux);
 	return rc;
 }
@@ -490,12 +553,17 @@ err_exit:
 static int cel_cpld_i2c_mux_remove(struct platform_device *client)
 {
 	struct i2c_mux_core *muxc = platform_get_drvdata(client);
+	struct cel_cpld_i2c_mux *mux;
+	int i;
 
-	if(muxc) {
-		kfree(muxc->priv);
-		i2c_mux_del_adapters(muxc);
-		i2c_put_adapter(muxc->parent);
-	}
+	if (!muxc)
+		return 0;
+
+	mux = cumulus_cpld_mux_priv(muxc);
+	cumulus_cpld_mux_del(muxc);
+	for (i = 0; i < mux->m_num_present_regs; i++)
+		ioport_unmap(mux->m_present_reg[i]);
+	kfree(mux);
 
 	return 0;
 }
@@ -1,11 +1,18 @@
 
 
 
+/*
+ * Module present registers are I/O ports holding eight ports each,
+ * active low, the first register covering the mux's first port.
+ */
+#define CPLD_MUX_MAX_PRESENT_REGS	4
+
 struct cel_xp_bus_mux_info {
 	int bus;
 	u32 io_base;
 	int first_port_num;
 	int num_ports;
+	u16 present_reg[CPLD_MUX_MAX_PRESENT_REGS];
 };
 
 struct cpld_bus_data {
@@ -20,4 +27,9 @@ struct cpld_mux_data {
 	int mux_base_port_num;
 	int mux_num_ports;
 	int mux_base_id;
+	/*
+	 * Optional: when present_reg[0] is set, transfers to a port whose
+	 * module is absent fail with -ENXIO without touching the master.
+	 */
+	u16 present_reg[CPLD_MUX_MAX_PRESENT_REGS];
 };
@@ -0,0 +1,338 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Table driven CPLD register I2C mux.
+ *
+ * Copyright (C) 2020 Cumulus Networks, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * https://www.gnu.org/licenses/gpl-2.0-standalone.html
+ */
+
+/**
+ * Most platforms steer the SFP/QSFP EEPROM buses by writing a channel
+ * number into one or more CPLD registers.  This module implements that
+ * once: the platform describes its select registers with a
+ * cumulus_cpld_mux_desc and gets back an i2c_mux_core with
+ *
+ * - per-channel select value remapping,
+ * - select caching, so back-to-back accesses to the same channel cost
+ *   no register writes,
+ * - a deselect policy (lazy by default, or after every transfer),
+ * - optional module presence gating with a cached present bitmap,
+ * - per-mux statistics in sysfs under mux_stats/.
+ *
+ * This module is not a device driver.
+ */
+
+#include <linux/module.h>
+#include <linux/slab.h>
+#include <linux/jiffies.h>
+#include <linux/bitmap.h>
+#include <linux/cumulus-cpld-mux.h>
+
+#define CUMULUS_CPLD_MUX_MODULE_VERSION "1.0"
+
+#define CPLD_MUX_NO_CHAN	(-1)
+
+static unsigned int present_cache_ms = 100;
+module_param(present_cache_ms, uint, 0644);
+MODULE_PARM_DESC(present_cache_ms,
+		 "Lifetime of the cached module present bitmap in ms (default 100)");
+
+struct cpld_mux_stats {
+	unsigned long selects;
+	unsigned long cache_hits;
+	unsigned long reg_writes;
+	unsigned long errors;
+	unsigned long absent;
+};
+
+struct cpld_mux {
+	struct cumulus_cpld_mux_desc desc;
+	const struct cumulus_cpld_mux_group *cur_group;
+	int cur_chan;
+	struct cpld_mux_stats stats;
+	bool present_valid;
+	unsigned long present_stamp;
+	unsigned long present[];
+};
+
+static int cpld_mux_write(struct cpld_mux *mux, u32 reg, u32 val)
+{
+	int ret;
+
+	mux->stats.reg_writes++;
+	if (mux->desc.write)
+		ret = mux->desc.write(mux->desc.priv, reg, val);
+	else
+		ret = i2c_smbus_write_byte_data(mux->desc.client, reg, val);
+
+	return ret < 0 ? ret : 0;
+}
+
+static const struct cumulus_cpld_mux_group *
+cpld_mux_find_group(struct cpld_mux *mux, u32 chan)
+{
+	const struct cumulus_cpld_mux_group *grp;
+	int i;
+
+	for (i = 0, grp = mux->desc.groups; i < mux->desc.num_groups;
+	     i++, grp++)
+		if (chan >= grp->first_chan &&
+		    chan < grp->first_chan + grp->num_chans)
+			return grp;
+
+	return NULL;
+}
+
+/* Disconnect every channel, e.g. after a failed select. */
+static int cpld_mux_idle(struct cpld_mux *mux)
+{
+	const struct cumulus_cpld_mux_group *grp;
+	int ret = 0;
+	int i;
+
+	for (i = 0, grp = mux->desc.groups; i < mux->desc.num_groups;
+	     i++, grp++) {
+		int rv = cpld_mux_write(mux, grp->reg, grp->idle_val);
+
+		if (rv && !ret)
+			ret = rv;
+	}
+	mux->cur_group = NULL;
+	mux->cur_chan = CPLD_MUX_NO_CHAN;
+
+	return ret;
+}
+
+static bool cpld_mux_present(struct cpld_mux *mux, u32 chan)
+{
+	if (!mux->desc.read_present)
+		return true;
+
+	if (!mux->present_valid ||
+	    time_after(jiffies, mux->present_stamp +
+		       msecs_to_jiffies(present_cache_ms))) {
+		bitmap_zero(mux->present, mux->desc.num_chans);
+		if (mux->desc.read_present(mux->desc.priv, mux->present)) {
+			/* cannot tell, so let the transfer find out */
+			mux->present_valid = false;
+			return true;
+		}
+		mux->present_stamp = jiffies;
+		mux->present_valid = true;
+	}
+
+	return test_bit(chan, mux->present);
+}
+
+static int cpld_mux_select_chan(struct i2c_mux_core *muxc, u32 chan)
+{
+	struct cpld_mux *mux = i2c_mux_priv(muxc);
+	const struct cumulus_cpld_mux_group *grp;
+	int idx;
+	int ret;
+
+	mux->stats.selects++;
+
+	if (!cpld_mux_present(mux, chan)) {
+		mux->stats.absent++;
+		return -ENXIO;
+	}
+
+	if (mux->cur_chan == (int)chan) {
+		mux->stats.cache_hits++;
+		return 0;
+	}
+
+	grp = cpld_mux_find_group(mux, chan);
+	if (!grp)
+		return -EINVAL;
+
+	/* Only one register group may drive the bus at a time. */
+	if (mux->cur_group && mux->cur_group != grp) {
+		ret = cpld_mux_write(mux, mux->cur_group->reg,
+				     mux->cur_group->idle_val);
+		if (ret)
+			goto err_idle;
+	}
+
+	idx = chan - grp->first_chan;
+	ret = cpld_mux_write(mux, grp->reg,
+			     grp->remap ? grp->remap[idx] : grp->base_val + idx);
+	if (ret)
+		goto err_idle;
+
+	mux->cur_group = grp;
+	mux->cur_chan = chan;
+	return 0;
+
+err_idle:
+	mux->stats.errors++;
+	cpld_mux_idle(mux);
+	return ret;
+}
+
+static int cpld_mux_deselect_chan(struct i2c_mux_core *muxc, u32 chan)
+{
+	struct cpld_mux *mux = i2c_mux_priv(muxc);
+	const struct cumulus_cpld_mux_group *grp = mux->cur_group;
+
+	if (!grp)
+		return 0;
+
+	mux->cur_group = NULL;
+	mux->cur_chan = CPLD_MUX_NO_CHAN;
+	return cpld_mux_write(mux, grp->reg, grp->idle_val);
+}
+
+#define CPLD_MUX_STAT_ATTR(_name)					\
+static ssize_t _name##_show(struct device *dev,				\
+			    struct device_attribute *dattr,		\
+			    char *buf)					\
+{									\
+	struct i2c_mux_core *muxc = dev_get_drvdata(dev);		\
+	struct cpld_mux *mux = i2c_mux_priv(muxc);			\
+									\
+	return sprintf(buf, "%lu\n", READ_ONCE(mux->stats._name));	\
+}									\
+static DEVICE_ATTR_RO(_name)
+
+CPLD_MUX_STAT_ATTR(selects);
+CPLD_MUX_STAT_ATTR(cache_hits);
+CPLD_MUX_STAT_ATTR(reg_writes);
+CPLD_MUX_STAT_ATTR(errors);
+CPLD_MUX_STAT_ATTR(absent);
+
+static struct attribute *cpld_mux_stat_attrs[] = {
+	&dev_attr_selects.attr,
+	&dev_attr_cache_hits.attr,
+	&dev_attr_reg_writes.attr,
+	&dev_attr_errors.attr,
+	&dev_attr_absent.attr,
+	NULL,
+};
+
+static const struct attribute_group cpld_mux_stat_group = {
+	.name = "mux_stats",
+	.attrs = cpld_mux_stat_attrs,
+};
+
+/**
+ * cumulus_cpld_mux_add() - create a CPLD register I2C mux
+ * @dev: device owning the mux; its driver data is set to the mux core
+ * @parent: adapter the multiplexed channels hang off
+ * @desc: mux description
+ *
+ * Deselects every channel, which also verifies that the CPLD is
+ * reachable, then registers one adapter per channel.  Returns the mux
+ * core or an ERR_PTR() on failure.
+ */
+struct i2c_mux_core *
+cumulus_cpld_mux_add(struct device *dev, struct i2c_adapter *parent,
+		     const struct cumulus_cpld_mux_desc *desc)
+{
+	const struct cumulus_cpld_mux_group *grp;
+	struct i2c_mux_core *muxc;
+	struct cpld_mux *mux;
+	int ret;
+	int i;
+
+	if (!desc->num_chans || !desc->num_groups ||
+	    (!desc->write && !desc->client))
+		return ERR_PTR(-EINVAL);
+
+	for (i = 0, grp = desc->groups; i < desc->num_groups; i++, grp++)
+		if (grp->first_chan < 0 ||
+		    grp->first_chan + grp->num_chans > desc->num_chans)
+			return ERR_PTR(-EINVAL);
+
+	muxc = i2c_mux_alloc(parent, dev, desc->num_chans,
+			     sizeof(*mux) +
+			     BITS_TO_LONGS(desc->num_chans) * sizeof(long),
+			     desc->mux_flags, cpld_mux_select_chan,
+			     (desc->flags & CPLD_MUX_DESELECT_IDLE) ?
+			     cpld_mux_deselect_chan : NULL);
+	if (!muxc)
+		return ERR_PTR(-ENOMEM);
+
+	mux = i2c_mux_priv(muxc);
+	mux->desc = *desc;
+
+	ret = cpld_mux_idle(mux);
+	if (ret) {
+		dev_warn(dev, "%s: cannot write mux select register\n",
+			 desc->name);
+		return ERR_PTR(-ENODEV);
+	}
+
+	dev_set_drvdata(dev, muxc);
+
+	for (i = 0; i < desc->num_chans; i++) {
+		ret = i2c_mux_add_adapter(muxc,
+					  desc->first_bus ?
+					  desc->first_bus + i : 0,
+					  i, 0);
+		if (ret)
+			goto err_del;
+	}
+
+	ret = sysfs_create_group(&dev->kobj, &cpld_mux_stat_group);
+	if (ret)
+		goto err_del;
+
+	dev_info(dev, "registered %d multiplexed busses for I2C mux %s\n",
+		 i, desc->name);
+
+	return muxc;
+
+err_del:
+	i2c_mux_del_adapters(muxc);
+	dev_set_drvdata(dev, NULL);
+	return ERR_PTR(ret);
+}
+EXPORT_SYMBOL_GPL(cumulus_cpld_mux_add);
+
+/**
+ * cumulus_cpld_mux_del() - tear down a mux from cumulus_cpld_mux_add()
+ * @muxc: the mux core
+ *
+ * Removes the channel adapters and leaves every channel deselected.
+ */
+void cumulus_cpld_mux_del(struct i2c_mux_core *muxc)
+{
+	struct cpld_mux *mux;
+
+	if (IS_ERR_OR_NULL(muxc))
+		return;
+
+	mux = i2c_mux_priv(muxc);
+	sysfs_remove_group(&muxc->dev->kobj, &cpld_mux_stat_group);
+	i2c_mux_del_adapters(muxc);
+	cpld_mux_idle(mux);
+}
+EXPORT_SYMBOL_GPL(cumulus_cpld_mux_del);
+
+/**
+ * cumulus_cpld_mux_priv() - return the @priv cookie of a mux description
+ * @muxc: the mux core
+ */
+void *cumulus_cpld_mux_priv(struct i2c_mux_core *muxc)
+{
+	struct cpld_mux *mux = i2c_mux_priv(muxc);
+
+	return mux->desc.priv;
+}
+EXPORT_SYMBOL_GPL(cumulus_cpld_mux_priv);
+
+MODULE_DESCRIPTION("Cumulus CPLD Register I2C Mux Library");
+MODULE_LICENSE("GPL");
+MODULE_VERSION(CUMULUS_CPLD_MUX_MODULE_VERSION);
@@ -0,0 +1,383 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Parallel optics DOM poller.
+ *
+ * Copyright (C) 2020 Cumulus Networks, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * https://www.gnu.org/licenses/gpl-2.0-standalone.html
+ */
+
+/**
+ * Reading DOM data one port EEPROM file at a time serializes the
+ * whole chassis, even when the ports hang off many independent i2c
+ * masters.  This module scans the present ports of a platform with
+ * one worker per root adapter, so that masters run in parallel and a
+ * full scan takes about as long as the slowest bus.  Only the DOM
+ * byte ranges are read.
+ *
+ * The result of the last scan is published as a packed array of
+ * struct cumulus_dom_record behind a struct cumulus_dom_header in the
+ * binary attribute dom/records, and sysfs_notify() is called on it
+ * after every scan.  dom/poll_ms sets the scan period; 0, the default
+ * unless the poll_ms module parameter says otherwise, stops scanning.
+ *
+ * This module is not a device driver.
+ */
+
+#include <linux/module.h>
+#include <linux/slab.h>
+#include <linux/mm.h>
+#include <linux/mutex.h>
+#include <linux/ktime.h>
+#include <linux/workqueue.h>
+#include <linux/i2c.h>
+#include <linux/cumulus-dom.h>
+
+#define CUMULUS_DOM_MODULE_VERSION "1.1"
+
+#define DOM_MIN_POLL_MS		100
+
+static unsigned int poll_ms;
+module_param(poll_ms, uint, 0444);
+MODULE_PARM_DESC(poll_ms,
+		 "Default DOM scan period in ms, 0 to start stopped (default 0)");
+
+/* DOM byte range of each port type */
+static const struct {
+	u8 addr;
+	u8 off;
+	u8 len;
+} dom_ranges[] = {
+	[CUMULUS_PORT_EEPROM_SFP]  = { 0x51, 96, 24 },
+	[CUMULUS_PORT_EEPROM_QSFP] = { 0x50, 22, 36 },
+	[CUMULUS_PORT_EEPROM_CMIS] = { 0x50, 14, 12 },
+};
+
+struct dom_root {
+	struct work_struct work;
+	struct cumulus_dom *dom;
+	struct i2c_adapter *adap;
+	int index;
+};
+
+struct cumulus_dom {
+	struct device *dev;
+	struct cumulus_dom_desc desc;
+	struct workqueue_struct *wq;
+	struct delayed_work scan_work;
+	struct mutex lock;
+	unsigned int poll_ms;
+	u32 seq;
+	struct dom_root *roots;
+	int *port_root;
+	struct i2c_adapter **port_adap;
+	size_t size;
+	void *buf;		/* published snapshot */
+	void *next;		/* snapshot being built */
+	struct bin_attribute records_attr;
+	struct device_attribute poll_ms_attr;
+	struct bin_attribute *bin_attrs[2];
+	struct attribute *attrs[2];
+	struct attribute_group group;
+};
+
+static inline struct cumulus_dom_record *dom_records(void *snap)
+{
+	return snap + sizeof(struct cumulus_dom_header);
+}
+
+static void dom_read_port(struct cumulus_dom *dom, int i)
+{
+	struct cumulus_dom_record *rec = &dom_records(dom->next)[i];
+	u8 type = dom->desc.ports[i].type;
+	int ret;
+
+	rec->timestamp_ns = ktime_get_real_ns();
+	ret = cumulus_port_eeprom_raw_read(dom->port_adap[i],
+					   dom_ranges[type].addr,
+					   dom_ranges[type].off,
+					   rec->data, dom_ranges[type].len);
+	if (ret) {
+		rec->error = ret;
+		return;
+	}
+	rec->data_len = dom_ranges[type].len;
+	rec->flags |= CUMULUS_DOM_VALID;
+}
+
+/* Read, in port order, every port that hangs off one root adapter. */
+static void dom_root_work(struct work_struct *work)
+{
+	struct dom_root *root = container_of(work, struct dom_root, work);
+	struct cumulus_dom *dom = root->dom;
+	int i;
+
+	for (i = 0; i < dom->desc.num_ports; i++)
+		if (dom->port_root[i] == root->index)
+			dom_read_port(dom, i);
+}
+
+static void dom_scan(struct cumulus_dom *dom)
+{
+	struct cumulus_dom_header *hdr = dom->next;
+	struct cumulus_dom_record *rec = dom_records(dom->next);
+	struct i2c_adapter *adap, *top;
+	int num_roots = 0;
+	u64 start;
+	void *tmp;
+	int i, r;
+
+	start = ktime_get_ns();
+
+	/* Group the present ports by root adapter */
+	for (i = 0; i < dom->desc.num_ports; i++) {
+		memset(&rec[i], 0, sizeof(rec[i]));
+		rec[i].port = dom->desc.ports[i].number ? : i + 1;
+		rec[i].type = dom->desc.ports[i].type;
+		dom->port_root[i] = -1;
+		dom->port_adap[i] = NULL;
+
+		if (!cumulus_presence_valid(dom->desc.presence)) {
+			rec[i].error = -EAGAIN;
+			continue;
+		}
+		if (!cumulus_presence_test(dom->desc.presence, i))
+			continue;
+		rec[i].flags = CUMULUS_DOM_PRESENT;
+
+		adap = i2c_get_adapter(dom->desc.ports[i].bus);
+		if (!adap) {
+			rec[i].error = -ENODEV;
+			continue;
+		}
+		dom->port_adap[i] = adap;
+
+		top = i2c_root_adapter(&adap->dev);
+		if (!top)
+			top = adap;
+		for (r = 0; r < num_roots; r++)
+			if (dom->roots[r].adap == top)
+				break;
+		if (r == num_roots)
+			dom->roots[num_roots++].adap = top;
+		dom->port_root[i] = r;
+	}
+
+	for (r = 0; r < num_roots; r++)
+		queue_work(dom->wq, &dom->roots[r].work);
+	flush_workqueue(dom->wq);
+
+	for (i = 0; i < dom->desc.num_ports; i++)
+		if (dom->port_adap[i])
+			i2c_put_adapter(dom->port_adap[i]);
+
+	hdr->magic = CUMULUS_DOM_MAGIC;
+	hdr->version = CUMULUS_DOM_VERSION;
+	hdr->record_size = sizeof(*rec);
+	hdr->num_ports = dom->desc.num_ports;
+	hdr->seq = ++dom->seq;
+	hdr->scan_ns = ktime_get_real_ns();
+	hdr->scan_us = div_u64(ktime_get_ns() - start, NSEC_PER_USEC);
+	hdr->num_roots = num_roots;
+
+	mutex_lock(&dom->lock);
+	tmp = dom->buf;
+	dom->buf = dom->next;
+	dom->next = tmp;
+	mutex_unlock(&dom->lock);
+
+	sysfs_notify(&dom->dev->kobj, dom->group.name,
+		     dom->records_attr.attr.name);
+}
+
+static void dom_scan_work(struct work_struct *work)
+{
+	struct cumulus_dom *dom =
+		container_of(to_delayed_work(work), struct cumulus_dom,
+			     scan_work);
+	unsigned int ms;
+
+	dom_scan(dom);
+
+	ms = READ_ONCE(dom->poll_ms);
+	if (ms)
+		queue_delayed_work(system_long_wq, &dom->scan_work,
+				   msecs_to_jiffies(ms));
+}
+
+static ssize_t records_read(struct file *filp, struct kobject *kobj,
+			    struct bin_attribute *attr, char *buf,
+			    loff_t off, size_t count)
+{
+	struct cumulus_dom *dom = attr->private;
+	ssize_t ret;
+
+	mutex_lock(&dom->lock);
+	ret = memory_read_from_buffer(buf, count, &off, dom->buf, dom->size);
+	mutex_unlock(&dom->lock);
+
+	return ret;
+}
+
+static ssize_t poll_ms_show(struct device *dev,
+			    struct device_attribute *dattr,
+			    char *buf)
+{
+	struct cumulus_dom *dom =
+		container_of(dattr, struct cumulus_dom, poll_ms_attr);
+
+	return sprintf(buf, "%u\n", READ_ONCE(dom->poll_ms));
+}
+
+static ssize_t poll_ms_store(struct device *dev,
+			     struct device_attribute *dattr,
+			     const char *buf, size_t count)
+{
+	struct cumulus_dom *dom =
+		container_of(dattr, struct cumulus_dom, poll_ms_attr);
+	unsigned int ms;
+	int ret;
+
+	ret = kstrtouint(buf, 0, &ms);
+	if (ret)
+		return ret;
+	if (ms && ms < DOM_MIN_POLL_MS)
+		return -EINVAL;
+
+	WRITE_ONCE(dom->poll_ms, ms);
+	if (ms)
+		mod_delayed_work(system_long_wq, &dom->scan_work, 0);
+	else
+		cancel_delayed_work_sync(&dom->scan_work);
+
+	return count;
+}
+
+static void dom_free(struct cumulus_dom *dom)
+{
+	if (dom->wq)
+		destroy_workqueue(dom->wq);
+	kvfree(dom->buf);
+	kvfree(dom->next);
+	kfree(dom->port_adap);
+	kfree(dom->port_root);
+	kfree(dom->roots);
+	kfree(dom);
+}
+
+/**
+ * cumulus_dom_add() - create a DOM poller
+ * @dev: device the dom/ attribute group is created under
+ * @desc: port table and presence source
+ *
+ * Returns the poller or an ERR_PTR() on failure.
+ */
+struct cumulus_dom *cumulus_dom_add(struct device *dev,
+				    const struct cumulus_dom_desc *desc)
+{
+	struct cumulus_dom *dom;
+	int n = desc->num_ports;
+	int ret;
+	int i;
+
+	if (n <= 0 || IS_ERR_OR_NULL(desc->presence))
+		return ERR_PTR(-EINVAL);
+
+	for (i = 0; i < n; i++)
+		if (desc->ports[i].type >= ARRAY_SIZE(dom_ranges))
+			return ERR_PTR(-EINVAL);
+
+	dom = kzalloc(sizeof(*dom), GFP_KERNEL);
+	if (!dom)
+		return ERR_PTR(-ENOMEM);
+
+	dom->dev = dev;
+	dom->desc = *desc;
+	dom->poll_ms = poll_ms;
+	if (dom->poll_ms && dom->poll_ms < DOM_MIN_POLL_MS)
+		dom->poll_ms = DOM_MIN_POLL_MS;
+	mutex_init(&dom->lock);
+	INIT_DELAYED_WORK(&dom->scan_work, dom_scan_work);
+
+	dom->size = sizeof(struct cumulus_dom_header) +
+		n * sizeof(struct cumulus_dom_record);
+	dom->buf = kvzalloc(dom->size, GFP_KERNEL);
+	dom->next = kvzalloc(dom->size, GFP_KERNEL);
+	dom->roots = kcalloc(n, sizeof(*dom->roots), GFP_KERNEL);
+	dom->port_root = kcalloc(n, sizeof(*dom->port_root), GFP_KERNEL);
+	dom->port_adap = kcalloc(n, sizeof(*dom->port_adap), GFP_KERNEL);
+	dom->wq = alloc_workqueue("%s_dom", WQ_UNBOUND, 0, dev_name(dev));
+	if (!dom->buf || !dom->next || !dom->roots || !dom->port_root ||
+	    !dom->port_adap || !dom->wq) {
+		ret = -ENOMEM;
+		goto err_free;
+	}
+
+	for (i = 0; i < n; i++) {
+		INIT_WORK(&dom->roots[i].work, dom_root_work);
+		dom->roots[i].dom = dom;
+		dom->roots[i].index = i;
+	}
+
+	sysfs_bin_attr_init(&dom->records_attr);
+	dom->records_attr.attr.name = "records";
+	dom->records_attr.attr.mode = 0444;
+	dom->records_attr.size = dom->size;
+	dom->records_attr.read = records_read;
+	dom->records_attr.private = dom;
+
+	sysfs_attr_init(&dom->poll_ms_attr.attr);
+	dom->poll_ms_attr.attr.name = "poll_ms";
+	dom->poll_ms_attr.attr.mode = 0644;
+	dom->poll_ms_attr.show = poll_ms_show;
+	dom->poll_ms_attr.store = poll_ms_store;
+
+	dom->bin_attrs[0] = &dom->records_attr;
+	dom->attrs[0] = &dom->poll_ms_attr.attr;
+	dom->group.name = "dom";
+	dom->group.attrs = dom->attrs;
+	dom->group.bin_attrs = dom->bin_attrs;
+
+	ret = sysfs_create_group(&dev->kobj, &dom->group);
+	if (ret)
+		goto err_free;
+
+	if (dom->poll_ms)
+		queue_delayed_work(system_long_wq, &dom->scan_work, 0);
+
+	return dom;
+
+err_free:
+	dom_free(dom);
+	return ERR_PTR(ret);
+}
+EXPORT_SYMBOL_GPL(cumulus_dom_add);
+
+/**
+ * cumulus_dom_del() - stop and free a poller from cumulus_dom_add()
+ * @dom: the poller, NULL or an ERR_PTR()
+ */
+void cumulus_dom_del(struct cumulus_dom *dom)
+{
+	if (IS_ERR_OR_NULL(dom))
+		return;
+
+	sysfs_remove_group(&dom->dev->kobj, &dom->group);
+	WRITE_ONCE(dom->poll_ms, 0);
+	cancel_delayed_work_sync(&dom->scan_work);
+	dom_free(dom);
+}
+EXPORT_SYMBOL_GPL(cumulus_dom_del);
+
+MODULE_DESCRIPTION("Cumulus Parallel Optics DOM Poller");
+MODULE_LICENSE("GPL");
+MODULE_VERSION(CUMULUS_DOM_MODULE_VERSION);
@@ -0,0 +1,312 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Shared interrupt demultiplexer for FPGA hosted i2c-ocores channels.
+ *
+ * Copyright (C) 2020 Cumulus Networks, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * https://www.gnu.org/licenses/gpl-2.0-standalone.html
+ */
+
+/**
+ * The switch FPGAs raise the interrupts of all their i2c-ocores
+ * channels on one PCIe interrupt, so the channels used to be set up
+ * in polling mode, each transfer spinning on its status register.
+ * This module owns the shared interrupt and provides one interrupt
+ * per channel through an irq_chip of its own:
+ *
+ * - the handler reads the status register of every unmasked channel
+ *   and runs the interrupt of each one with its interrupt flag set,
+ *   then scans again until no unmasked channel has the flag set, since
+ *   a channel flagging while others are handled raises no new MSI,
+ * - masking a channel only stops the handler from looking at it,
+ *   i2c-ocores acknowledges the flag itself.
+ *
+ * PCI FPGA drivers set everything up with cumulus_ocores_irq_pci_add().
+ * Drivers pass the per-channel interrupt to i2c-ocores as an IRQ
+ * resource, or fall back to polling when none is available.  The
+ * channels keep polling unless the module is loaded with disable=0.
+ *
+ * This module is not a device driver.
+ */
+
+#include <linux/module.h>
+#include <linux/slab.h>
+#include <linux/io.h>
+#include <linux/pci.h>
+#include <linux/bitops.h>
+#include <linux/interrupt.h>
+#include <linux/irq.h>
+#include <linux/irqdomain.h>
+#include <linux/cumulus-ocores-irq.h>
+
+#define CUMULUS_OCORES_IRQ_MODULE_VERSION "1.2"
+
+/* i2c-ocores status register and its interrupt flag */
+#define OCORES_STATUS		4
+#define OCORES_STAT_IF		BIT(0)
+
+/* status scans per interrupt before giving up on a stuck flag */
+#define OCORES_IRQ_MAX_SCANS	16
+
+static bool disable = true;
+module_param(disable, bool, 0444);
+MODULE_PARM_DESC(disable,
+		 "Leave the ocores channels polling (default true)");
+
+struct cumulus_ocores_irq {
+	struct cumulus_ocores_irq_desc desc;
+	struct device *dev;
+	struct irq_domain *domain;
+	unsigned long enabled;
+	struct pci_dev *pdev;	/* owns the vectors and mapping, or NULL */
+};
+
+static void ocores_irq_mask(struct irq_data *d)
+{
+	struct cumulus_ocores_irq *oi = irq_data_get_irq_chip_data(d);
+
+	clear_bit(irqd_to_hwirq(d), &oi->enabled);
+}
+
+static void ocores_irq_unmask(struct irq_data *d)
+{
+	struct cumulus_ocores_irq *oi = irq_data_get_irq_chip_data(d);
+
+	set_bit(irqd_to_hwirq(d), &oi->enabled);
+}
+
+static struct irq_chip ocores_irq_chip = {
+	.name		= "ocores-irq",
+	.irq_mask	= ocores_irq_mask,
+	.irq_unmask	= ocores_irq_unmask,
+};
+
+static int ocores_irq_domain_map(struct irq_domain *d, unsigned int virq,
+				 irq_hw_number_t hw)
+{
+	irq_set_chip_data(virq, d->host_data);
+	irq_set_chip_and_handler(virq, &ocores_irq_chip, handle_simple_irq);
+	irq_set_noprobe(virq);
+
+	return 0;
+}
+
+static const struct irq_domain_ops ocores_irq_domain_ops = {
+	.map	= ocores_irq_domain_map,
+	.xlate	= irq_domain_xlate_onecell,
+};
+
+static unsigned long ocores_irq_pending(struct cumulus_ocores_irq *oi)
+{
+	unsigned long enabled = READ_ONCE(oi->enabled);
+	unsigned long pending = 0;
+	void __iomem *sr;
+	unsigned int ch;
+
+	for_each_set_bit(ch, &enabled, oi->desc.num_channels) {
+		sr = oi->desc.regs + ch * oi->desc.stride +
+			(OCORES_STATUS << oi->desc.reg_shift);
+		if (ioread8(sr) & OCORES_STAT_IF)
+			__set_bit(ch, &pending);
+	}
+
+	return pending;
+}
+
+static irqreturn_t ocores_irq_demux(int irq, void *data)
+{
+	struct cumulus_ocores_irq *oi = data;
+	unsigned long pending;
+	unsigned int ch;
+	int scans;
+
+	for (scans = 0; scans < OCORES_IRQ_MAX_SCANS; scans++) {
+		pending = ocores_irq_pending(oi);
+		if (!pending)
+			break;
+		for_each_set_bit(ch, &pending, oi->desc.num_channels)
+			generic_handle_irq(irq_find_mapping(oi->domain, ch));
+	}
+
+	if (scans == OCORES_IRQ_MAX_SCANS)
+		dev_warn_ratelimited(oi->dev, "%s: interrupt flags stuck\n",
+				     oi->desc.name);
+
+	return scans ? IRQ_HANDLED : IRQ_NONE;
+}
+
+/**
+ * cumulus_ocores_irq_add() - take over the shared ocores interrupt
+ * @dev: device owning the interrupt
+ * @desc: interrupt and channel register layout, copied
+ *
+ * Returns the demultiplexer or an ERR_PTR() on failure, including when
+ * interrupts are disabled by the module parameter.
+ */
+struct cumulus_ocores_irq *
+cumulus_ocores_irq_add(struct device *dev,
+		       const struct cumulus_ocores_irq_desc *desc)
+{
+	struct cumulus_ocores_irq *oi;
+	int ret;
+
+	if (disable)
+		return ERR_PTR(-EOPNOTSUPP);
+
+	if (desc->irq <= 0 || !desc->regs || !desc->num_channels ||
+	    desc->num_channels > BITS_PER_LONG)
+		return ERR_PTR(-EINVAL);
+
+	oi = kzalloc(sizeof(*oi), GFP_KERNEL);
+	if (!oi)
+		return ERR_PTR(-ENOMEM);
+
+	oi->desc = *desc;
+	oi->dev = dev;
+
+	oi->domain = irq_domain_add_linear(NULL, desc->num_channels,
+					   &ocores_irq_domain_ops, oi);
+	if (!oi->domain) {
+		ret = -ENOMEM;
+		goto err_free;
+	}
+
+	ret = request_irq(desc->irq, ocores_irq_demux, IRQF_SHARED,
+			  desc->name, oi);
+	if (ret)
+		goto err_domain;
+
+	dev_info(dev, "%s: %u i2c channels on irq %d\n",
+		 desc->name, desc->num_channels, desc->irq);
+
+	return oi;
+
+err_domain:
+	irq_domain_remove(oi->domain);
+err_free:
+	kfree(oi);
+	return ERR_PTR(ret);
+}
+EXPORT_SYMBOL_GPL(cumulus_ocores_irq_add);
+
+/**
+ * cumulus_ocores_irq_pci_add() - take over the ocores interrupt of a PCI FPGA
+ * @pdev: FPGA PCI device
+ * @start: bus address of the register block of channel 0
+ * @desc: channel layout, @desc->irq and @desc->regs are filled in here
+ *
+ * Allocates one MSI vector, or INTx, and maps the channel registers.
+ * Every channel raises the same interrupt, so one vector is enough
+ * whatever the MSI vector map registers of the FPGA hold.
+ *
+ * Returns the demultiplexer or an ERR_PTR() when the channels have to
+ * poll, which is logged.  cumulus_ocores_irq_del() releases the vector
+ * and the mapping.
+ */
+struct cumulus_ocores_irq *
+cumulus_ocores_irq_pci_add(struct pci_dev *pdev, resource_size_t start,
+			   const struct cumulus_ocores_irq_desc *desc)
+{
+	struct cumulus_ocores_irq_desc d = *desc;
+	struct cumulus_ocores_irq *oi;
+	int ret;
+
+	if (disable) {
+		ret = -EOPNOTSUPP;
+		goto err;
+	}
+
+	pci_set_master(pdev);
+	ret = pci_alloc_irq_vectors(pdev, 1, 1, PCI_IRQ_MSI | PCI_IRQ_LEGACY);
+	if (ret < 0)
+		goto err;
+
+	d.irq = pci_irq_vector(pdev, 0);
+	d.regs = ioremap(start, d.num_channels * d.stride);
+	if (!d.regs) {
+		ret = -ENOMEM;
+		goto err_vectors;
+	}
+
+	oi = cumulus_ocores_irq_add(&pdev->dev, &d);
+	if (IS_ERR(oi)) {
+		ret = PTR_ERR(oi);
+		goto err_unmap;
+	}
+	oi->pdev = pdev;
+
+	return oi;
+
+err_unmap:
+	iounmap(d.regs);
+err_vectors:
+	pci_free_irq_vectors(pdev);
+err:
+	dev_info(&pdev->dev, "%s: i2c channels polling (%d)\n", d.name, ret);
+	return ERR_PTR(ret);
+}
+EXPORT_SYMBOL_GPL(cumulus_ocores_irq_pci_add);
+
+/**
+ * cumulus_ocores_irq_del() - release the shared ocores interrupt
+ * @oi: demultiplexer, NULL or an ERR_PTR()
+ *
+ * The i2c-ocores devices using the channel interrupts must have been
+ * unregistered.  Also frees the vector and mapping set up by
+ * cumulus_ocores_irq_pci_add().
+ */
+void cumulus_ocores_irq_del(struct cumulus_ocores_irq *oi)
+{
+	unsigned int ch;
+
+	if (IS_ERR_OR_NULL(oi))
+		return;
+
+	free_irq(oi->desc.irq, oi);
+	for (ch = 0; ch < oi->desc.num_channels; ch++)
+		irq_dispose_mapping(irq_find_mapping(oi->domain, ch));
+	irq_domain_remove(oi->domain);
+	if (oi->pdev) {
+		iounmap(oi->desc.regs);
+		pci_free_irq_vectors(oi->pdev);
+	}
+	kfree(oi);
+}
+EXPORT_SYMBOL_GPL(cumulus_ocores_irq_del);
+
+/**
+ * cumulus_ocores_irq_get() - return the interrupt of one channel
+ * @oi: demultiplexer, may be NULL or an ERR_PTR()
+ * @channel: zero based channel, the register block at @channel * stride
+ *
+ * Returns the Linux interrupt number, or a negative errno when the
+ * channel has to be polled.
+ */
+int cumulus_ocores_irq_get(struct cumulus_ocores_irq *oi,
+			   unsigned int channel)
+{
+	unsigned int virq;
+
+	if (IS_ERR_OR_NULL(oi))
+		return -ENODEV;
+	if (channel >= oi->desc.num_channels)
+		return -EINVAL;
+
+	virq = irq_create_mapping(oi->domain, channel);
+
+	return virq ? virq : -ENOMEM;
+}
+EXPORT_SYMBOL_GPL(cumulus_ocores_irq_get);
+
+MODULE_DESCRIPTION("Cumulus FPGA ocores Interrupt Library");
+MODULE_LICENSE("GPL");
+MODULE_VERSION(CUMULUS_OCORES_IRQ_MODULE_VERSION);
@@ -161,7 +161,7 @@ EXPORT_SYMBOL_GPL(cumulus_gpio_map_show);
 ssize_t cumulus_bf_show(struct device *dev,
 			struct device_attribute *dattr,
 			char *buf,
-			struct bf *bif,
+			const struct bf *bif,
 			bf_read_func *read)
 {
 	int nregs = (bif->shift + bif->width + 7) / 8;
@@ -182,7 +182,7 @@ ssize_t cumulus_bf_show(struct device *dev,
 		val = (val ^ mask) + 1;
 	}
 
-	if (bif->values)
+	if (bif->values && (!bif->num_values || val < bif->num_values))
 		return sprintf(buf, "%s\n", bif->values[val]);
 	if (bif->width < 2 || bif->flags & BF_DECIMAL)
 		return sprintf(buf, "%s%u\n", sign, val);
@@ -208,7 +208,7 @@ ssize_t cumulus_bf_store(struct device *dev,
 			 struct device_attribute *dattr,
 			 const char *buf,
 			 size_t size,
-			 struct bf *bif,
+			 const struct bf *bif,
 			 bf_read_func *read,
 			 bf_write_func *write)
 {
@@ -216,6 +216,7 @@ ssize_t cumulus_bf_store(struct device *dev,
 	u32 mask = BF_MASK(bif->width);
 	u32 newval;
 	u32 oldval = 0;
+	u32 last;
 	int ret;
 
 	if (bif->values) {
@@ -226,10 +227,12 @@ ssize_t cumulus_bf_store(struct device *dev,
 		#endif
 		if (sscanf(buf, "%19s", str) != 1)
 			return -EINVAL;
+		last = bif->num_values ?
+			min_t(u32, bif->num_values - 1, mask) : mask;
 		for (newval = 0;; newval++) {
 			if (strcmp(str, bif->values[newval]) == 0)
 				break;
-			if (newval == mask)
+			if (newval >= last)
 				return -EINVAL;
 		}
 	} else {
@@ -277,136 +280,31 @@ ssize_t cumulus_bf_store(struct device *dev,
 }
 EXPORT_SYMBOL_GPL(cumulus_bf_store);
 
-/**
- * @brief Return the value of a sysfs attribute
- *
- * @param dev The device which is being read
- * @param dattr The attribute being shown
- * @param buf A buffer into which the attribute value will be placed
- * @param bif A description of the attribute being accessed
- * @param read A function used for reading the device
- *
- * @return ssize_t The number of bytes written into buf, or negative value
- *                 for an error
+/*
+ * Shared show and store functions of the struct bf_attribute fields
+ * made by mk_bf_ro(), mk_bf_rw() and their 32-bit aliases.
  */
-ssize_t cumulus_bf_show32(struct device *dev,
-			  struct device_attribute *dattr,
-			  char *buf,
-			  struct bf *bif,
-			  bf_read_func *read)
+ssize_t cumulus_bf_attr_show(struct device *dev,
+			     struct device_attribute *dattr,
+			     char *buf)
 {
-	int nregs = (bif->shift + bif->width + 7) / 8;
-	u32 mask = BF_MASK(bif->width);
-	u32 val;
-	char *sign = "";
-	int ret;
-
-	ret = (*read)(dev, bif->reg32, nregs, &val);
-	if (ret)
-		return ret;
-
-	val = val >> bif->shift & mask;
-	if (bif->flags & BF_COMPLEMENT)
-		val ^= mask;
-	if (bif->flags & BF_SIGNED && val & (mask ^ mask >> 1)) {
-		sign = "-";
-		val = (val ^ mask) + 1;
-	}
+	struct bf_attribute *bfa = to_bf_attribute(dattr);
 
-	if (bif->values)
-		return sprintf(buf, "%s\n", bif->values[val]);
-	if (bif->width < 2 || bif->flags & BF_DECIMAL)
-		return sprintf(buf, "%s%u\n", sign, val);
-	return sprintf(buf, "%s0x%0*x\n", sign, (bif->width + 3) / 4, val);
+	return cumulus_bf_show(dev, dattr, buf, bfa->bf, bfa->read);
 }
-EXPORT_SYMBOL_GPL(cumulus_bf_show32);
+EXPORT_SYMBOL_GPL(cumulus_bf_attr_show);
 
-/**
- * @brief Write the specified sysfs attribute to a device
- *
- * @param dev The device which is being written
- * @param dattr The attribute being written
- * @param buf The value to write to the device
- * @param size The number of bytes in buf
- * @param bif A description of the attribute being accessed
- * @param read A function used for reading the device
- * @param write A function used for writing to the device
- *
- * @return ssize_t The number of bytes in buf which were processed, or a
- *                 negative value on error
- */
-ssize_t cumulus_bf_store32(struct device *dev,
-			   struct device_attribute *dattr,
-			   const char *buf,
-			   size_t size,
-			   struct bf *bif,
-			   bf_read_func *read,
-			   bf_write_func *write)
+ssize_t cumulus_bf_attr_store(struct device *dev,
+			      struct device_attribute *dattr,
+			      const char *buf,
+			      size_t size)
 {
-	int nregs = (bif->shift + bif->width + 7) / 8;
-	u32 mask = BF_MASK(bif->width);
-	u32 newval;
-	u32 oldval = 0;
-	int ret;
-
-	if (bif->values) {
-		char str[PLATFORM_LED_COLOR_NAME_SIZE];
-
-		#if PLATFORM_LED_COLOR_NAME_SIZE != 20
-		#error PLATFORM_LED_COLOR_NAME_SIZE is supposed to be 20
-		#endif
-		if (sscanf(buf, "%19s", str) != 1)
-			return -EINVAL;
-		for (newval = 0;; newval++) {
-			if (strcmp(str, bif->values[newval]) == 0)
-				break;
-			if (newval == mask)
-				return -EINVAL;
-		}
-	} else {
-		/* make sure the new value fits in bif->width bits */
-		if (bif->flags & BF_SIGNED) {
-			s32 max = mask >> 1;
-			s32 min = -(mask ^ mask >> 1);
-			s32 v;
-
-			ret = kstrtos32(buf, 0, &v);
-			if (ret)
-				return ret;
-			if (v < min || v > max)
-				return -EINVAL;
-			newval = v & mask;
-		} else {
-			ret = kstrtou32(buf, 0, &newval);
-			if (ret)
-				return ret;
-			if (newval > mask)
-				return -EINVAL;
-		}
-	}
-
-	if (bif->flags & BF_COMPLEMENT)
-		newval ^= mask;
-	newval <<= bif->shift;
-
-	/*
-	 * If we're not writing whole registers, then read
-	 * the old value and fill in the unmodified bits.
-	 */
-	if (bif->shift != 0 || bif->width % 8 != 0) {
-		ret = (*read)(dev, bif->reg32, nregs, &oldval);
-		if (ret)
-			return ret;
-	}
-	newval |= oldval & ~(mask << bif->shift);
-
-	ret = (*write)(dev, bif->reg32, nregs, newval);
-	if (ret)
-		return ret;
+	struct bf_attribute *bfa = to_bf_attribute(dattr);
 
-	return size;
+	return cumulus_bf_store(dev, dattr, buf, size, bfa->bf,
+				bfa->read, bfa->write);
 }
-EXPORT_SYMBOL_GPL(cumulus_bf_store32);
+EXPORT_SYMBOL_GPL(cumulus_bf_attr_store);
 
 /**
  * @brief Read registers on an I2C device
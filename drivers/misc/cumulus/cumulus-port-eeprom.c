@@ -0,0 +1,633 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Cached front panel port EEPROM access.
+ *
+ * Copyright (C) 2020 Cumulus Networks, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * https://www.gnu.org/licenses/gpl-2.0-standalone.html
+ */
+
+/**
+ * Inventory and LLDP tooling reads the identification bytes of every
+ * optic over and over, each time across a slow multiplexed i2c bus,
+ * although those bytes cannot change while the module stays plugged
+ * in.  This module exposes one read-only binary attribute per port
+ * under port_eeprom/ with the same layout as the at24 or sff_8436
+ * device of the port, and
+ *
+ * - reads each static region (serial ID, thresholds) once after the
+ *   module is inserted and serves it from memory afterwards,
+ * - always reads the dynamic regions (diagnostics, flags, control)
+ *   from the module,
+ * - drops the cached regions of a port on every presence edge
+ *   reported by cumulus-presence,
+ * - fails reads of empty ports without touching the bus, and of
+ *   every port with -EAGAIN while presence is still unknown.
+ *
+ * CMIS (QSFP-DD, OSFP) ports get a writable file with the lower page
+ * followed by every upper page of every bank, so tools address banked
+ * pages by file offset instead of writing bytes 126-127 themselves.
+ * Other clients of the module (a paging sff8436 client, i2c-dev) can
+ * move bytes 126-127 at any time, so every banked access reads them
+ * back and selects the page with the adapter segment locked, in one
+ * sequence with the access itself.  The select write is skipped when
+ * the module already has the page selected.
+ *
+ * This module is not a device driver.
+ */
+
+#include <linux/module.h>
+#include <linux/slab.h>
+#include <linux/mm.h>
+#include <linux/mutex.h>
+#include <linux/bitops.h>
+#include <linux/delay.h>
+#include <linux/i2c.h>
+#include <linux/cumulus-port-eeprom.h>
+
+#define CUMULUS_PORT_EEPROM_MODULE_VERSION "1.3"
+
+#define PORT_EEPROM_MAX_SIZE	512
+#define QSFP_PAGE_SELECT_REG	127
+
+#define CMIS_FLAT_MEM_REG	2
+#define CMIS_FLAT_MEM		BIT(7)
+#define CMIS_BANK_SELECT_REG	126
+#define CMIS_PAGE_LEN		128
+#define CMIS_NUM_PAGES		256
+#define CMIS_FIRST_BANKED_PAGE	0x10
+#define CMIS_MAX_BANKS		4
+#define CMIS_WRITE_MAX		8	/* longest write a module must accept */
+#define CMIS_WRITE_TIMEOUT_MS	100	/* modules NACK while committing */
+
+static unsigned int cmis_banks = 1;
+module_param(cmis_banks, uint, 0444);
+MODULE_PARM_DESC(cmis_banks,
+		 "Number of banks exposed for CMIS ports, 1 to 4 (default 1)");
+
+/* region flags */
+#define PORT_EEPROM_CACHED	BIT(0)	/* static while the module is in */
+#define PORT_EEPROM_PAGE0	BIT(1)	/* only while page 00h is selected */
+
+struct port_eeprom_region {
+	u16 start;
+	u16 len;
+	u8 addr;
+	u8 dev_off;
+	u8 flags;
+};
+
+struct port_eeprom_layout {
+	const struct port_eeprom_region *regions;
+	int num_regions;
+	size_t size;
+	bool paged;	/* CMIS upper pages follow the regions */
+};
+
+/* SFF-8472 */
+static const struct port_eeprom_region sfp_regions[] = {
+	/* A0h serial ID and vendor area */
+	{ 0,   256, 0x50, 0,  PORT_EEPROM_CACHED },
+	/* A2h alarm and warning thresholds, calibration constants */
+	{ 256, 96,  0x51, 0,  PORT_EEPROM_CACHED },
+	/* A2h diagnostics, status and control, user EEPROM */
+	{ 352, 160, 0x51, 96, 0 },
+};
+
+/* SFF-8436 / SFF-8636 */
+static const struct port_eeprom_region qsfp_regions[] = {
+	/* lower page: clear-on-read flags, monitors, control */
+	{ 0,   128, 0x50, 0,   0 },
+	/* upper page 00h serial ID */
+	{ 128, 128, 0x50, 128, PORT_EEPROM_CACHED | PORT_EEPROM_PAGE0 },
+};
+
+/* CMIS, upper pages are handled by port_eeprom_cmis_xfer() */
+static const struct port_eeprom_region cmis_regions[] = {
+	/* lower page: flags, monitors, control, bank and page select */
+	{ 0,   128, 0x50, 0,   0 },
+};
+
+static const struct port_eeprom_layout port_eeprom_layouts[] = {
+	[CUMULUS_PORT_EEPROM_SFP] = {
+		.regions = sfp_regions,
+		.num_regions = ARRAY_SIZE(sfp_regions),
+		.size = 512,
+	},
+	[CUMULUS_PORT_EEPROM_QSFP] = {
+		.regions = qsfp_regions,
+		.num_regions = ARRAY_SIZE(qsfp_regions),
+		.size = 256,
+	},
+	[CUMULUS_PORT_EEPROM_CMIS] = {
+		.regions = cmis_regions,
+		.num_regions = ARRAY_SIZE(cmis_regions),
+		.paged = true,
+	},
+};
+
+struct port_eeprom_port {
+	struct cumulus_port_eeprom *pe;
+	int index;
+	int bus;
+	const struct port_eeprom_layout *layout;
+	struct mutex lock;
+	unsigned long valid;	/* one bit per cached region */
+	int flat;		/* CMIS flat memory module, -1 if unknown */
+	struct bin_attribute attr;
+	char name[16];
+	u8 data[PORT_EEPROM_MAX_SIZE];
+};
+
+struct cumulus_port_eeprom {
+	struct device *dev;
+	const char *name;
+	struct cumulus_presence *presence;
+	struct notifier_block nb;
+	struct attribute_group group;
+	struct bin_attribute **bin_attrs;
+	int num_ports;
+	struct port_eeprom_port *ports;
+};
+
+/*
+ * The __port_eeprom_ helpers expect the adapter segment to be locked
+ * with i2c_lock_bus(), so that a page select and the accesses that
+ * depend on it cannot be split by another client of the module.
+ */
+static int __port_eeprom_read(struct i2c_adapter *adap, u8 addr,
+			      unsigned int off, u8 *buf, size_t len)
+{
+	union i2c_smbus_data data;
+	size_t n;
+	int ret;
+
+	while (len) {
+		n = min_t(size_t, len, I2C_SMBUS_BLOCK_MAX);
+		data.block[0] = n;
+		ret = __i2c_smbus_xfer(adap, addr, 0, I2C_SMBUS_READ, off,
+				       I2C_SMBUS_I2C_BLOCK_DATA, &data);
+		if (ret < 0)
+			return ret;
+		memcpy(buf, &data.block[1], n);
+		buf += n;
+		off += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+static int __port_eeprom_write(struct i2c_adapter *adap, u8 addr,
+			       unsigned int off, const u8 *buf, size_t len)
+{
+	union i2c_smbus_data data;
+	unsigned long timeout;
+	size_t n;
+	int ret;
+
+	while (len) {
+		n = min_t(size_t, len, CMIS_WRITE_MAX);
+		data.block[0] = n;
+		memcpy(&data.block[1], buf, n);
+		timeout = jiffies + msecs_to_jiffies(CMIS_WRITE_TIMEOUT_MS);
+		for (;;) {
+			ret = __i2c_smbus_xfer(adap, addr, 0, I2C_SMBUS_WRITE,
+					       off, I2C_SMBUS_I2C_BLOCK_DATA,
+					       &data);
+			if (!ret || time_after(jiffies, timeout))
+				break;
+			usleep_range(1000, 1500);
+		}
+		if (ret < 0)
+			return ret;
+		buf += n;
+		off += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+/**
+ * cumulus_port_eeprom_raw_read() - read module EEPROM bytes, uncached
+ * @adap: adapter of the port
+ * @addr: 0x50 or 0x51
+ * @off: offset within the 256 byte device
+ * @buf: destination
+ * @len: number of bytes, @off + @len must not exceed 256
+ */
+int cumulus_port_eeprom_raw_read(struct i2c_adapter *adap, u8 addr,
+				 unsigned int off, u8 *buf, size_t len)
+{
+	int ret;
+
+	i2c_lock_bus(adap, I2C_LOCK_SEGMENT);
+	ret = __port_eeprom_read(adap, addr, off, buf, len);
+	i2c_unlock_bus(adap, I2C_LOCK_SEGMENT);
+
+	return ret;
+}
+EXPORT_SYMBOL_GPL(cumulus_port_eeprom_raw_read);
+
+static int port_eeprom_raw_write(struct i2c_adapter *adap, u8 addr,
+				 unsigned int off, const u8 *buf, size_t len)
+{
+	int ret;
+
+	i2c_lock_bus(adap, I2C_LOCK_SEGMENT);
+	ret = __port_eeprom_write(adap, addr, off, buf, len);
+	i2c_unlock_bus(adap, I2C_LOCK_SEGMENT);
+
+	return ret;
+}
+
+/* Forget everything learned from the module, called on presence edges */
+static void port_eeprom_forget(struct port_eeprom_port *port)
+{
+	port->valid = 0;
+	port->flat = -1;
+}
+
+static int __port_eeprom_cmis_flat(struct port_eeprom_port *port,
+				   struct i2c_adapter *adap)
+{
+	u8 val;
+	int ret;
+
+	if (port->flat < 0) {
+		ret = __port_eeprom_read(adap, 0x50, CMIS_FLAT_MEM_REG,
+					 &val, 1);
+		if (ret)
+			return ret;
+		port->flat = !!(val & CMIS_FLAT_MEM);
+	}
+
+	return port->flat;
+}
+
+/*
+ * Make bank/page the selected upper page.  The selection is read back
+ * every time, since other clients of the module may have changed it,
+ * and only written when it differs.  Bank select does not apply to
+ * pages 00h-0Fh, so any bank will do for them.  Both bytes go out in
+ * one write as CMIS asks.
+ */
+static int __port_eeprom_cmis_select(struct i2c_adapter *adap,
+				     int bank, int page)
+{
+	u8 sel[2];
+	int ret;
+
+	if (page < CMIS_FIRST_BANKED_PAGE)
+		bank = 0;
+
+	ret = __port_eeprom_read(adap, 0x50, CMIS_BANK_SELECT_REG,
+				 sel, sizeof(sel));
+	if (ret)
+		return ret;
+	if (sel[1] == page && (!bank || sel[0] == bank))
+		return 0;
+
+	sel[0] = bank;
+	sel[1] = page;
+	return __port_eeprom_write(adap, 0x50, CMIS_BANK_SELECT_REG,
+				   sel, sizeof(sel));
+}
+
+/*
+ * Access part of one upper page.  @pos is the file offset, at least
+ * CMIS_PAGE_LEN, and @len must not cross a page.  The select and the
+ * access run with the segment locked.
+ */
+static int port_eeprom_cmis_xfer(struct port_eeprom_port *port,
+				 struct i2c_adapter *adap, unsigned int pos,
+				 u8 *buf, size_t len, bool write)
+{
+	unsigned int idx = (pos - CMIS_PAGE_LEN) / CMIS_PAGE_LEN;
+	unsigned int off = CMIS_PAGE_LEN + pos % CMIS_PAGE_LEN;
+	int ret;
+
+	i2c_lock_bus(adap, I2C_LOCK_SEGMENT);
+
+	ret = __port_eeprom_cmis_flat(port, adap);
+	if (ret < 0)
+		goto out;
+	if (ret) {
+		/* flat memory modules only have upper page 00h */
+		ret = idx ? -EINVAL : 0;
+	} else {
+		ret = __port_eeprom_cmis_select(adap, idx / CMIS_NUM_PAGES,
+						idx % CMIS_NUM_PAGES);
+	}
+	if (ret)
+		goto out;
+
+	if (write)
+		ret = __port_eeprom_write(adap, 0x50, off, buf, len);
+	else
+		ret = __port_eeprom_read(adap, 0x50, off, buf, len);
+
+out:
+	i2c_unlock_bus(adap, I2C_LOCK_SEGMENT);
+	return ret;
+}
+
+/*
+ * Read a static region into the port cache.  Returns -EAGAIN when the
+ * region cannot be cached right now, e.g. a QSFP with another upper
+ * page selected, in which case the caller reads it live.  The page
+ * check and the read run with the segment locked, so another client
+ * of the module cannot select a different page in between.
+ */
+static int port_eeprom_fill(struct port_eeprom_port *port,
+			    struct i2c_adapter *adap,
+			    const struct port_eeprom_region *r)
+{
+	u8 page;
+	int ret;
+
+	i2c_lock_bus(adap, I2C_LOCK_SEGMENT);
+
+	if (r->flags & PORT_EEPROM_PAGE0) {
+		ret = __port_eeprom_read(adap, r->addr, QSFP_PAGE_SELECT_REG,
+					 &page, 1);
+		if (ret)
+			goto out;
+		if (page) {
+			ret = -EAGAIN;
+			goto out;
+		}
+	}
+
+	ret = __port_eeprom_read(adap, r->addr, r->dev_off,
+				 port->data + r->start, r->len);
+
+out:
+	i2c_unlock_bus(adap, I2C_LOCK_SEGMENT);
+	return ret;
+}
+
+static int port_eeprom_fetch(struct port_eeprom_port *port,
+			     struct i2c_adapter *adap,
+			     const struct port_eeprom_region *r,
+			     unsigned int pos, u8 *buf, size_t len)
+{
+	int idx = r - port->layout->regions;
+	int ret;
+
+	if (r->flags & PORT_EEPROM_CACHED) {
+		if (!test_bit(idx, &port->valid)) {
+			ret = port_eeprom_fill(port, adap, r);
+			if (!ret)
+				__set_bit(idx, &port->valid);
+			else if (ret != -EAGAIN)
+				return ret;
+		}
+		if (test_bit(idx, &port->valid)) {
+			memcpy(buf, port->data + pos, len);
+			return 0;
+		}
+	}
+
+	return cumulus_port_eeprom_raw_read(adap, r->addr,
+					    r->dev_off + (pos - r->start),
+					    buf, len);
+}
+
+static ssize_t port_eeprom_read(struct file *filp, struct kobject *kobj,
+				struct bin_attribute *attr, char *buf,
+				loff_t off, size_t count)
+{
+	struct port_eeprom_port *port = attr->private;
+	const struct port_eeprom_layout *layout = port->layout;
+	const struct port_eeprom_region *r;
+	struct i2c_adapter *adap;
+	unsigned int pos;
+	size_t done = 0;
+	size_t len;
+	int ret = 0;
+
+	if (!cumulus_presence_valid(port->pe->presence))
+		return -EAGAIN;
+	if (!cumulus_presence_test(port->pe->presence, port->index))
+		return -ENXIO;
+
+	adap = i2c_get_adapter(port->bus);
+	if (!adap)
+		return -ENODEV;
+
+	mutex_lock(&port->lock);
+	while (done < count) {
+		pos = off + done;
+		if (layout->paged && pos >= CMIS_PAGE_LEN) {
+			len = min_t(size_t, count - done,
+				    CMIS_PAGE_LEN - pos % CMIS_PAGE_LEN);
+			ret = port_eeprom_cmis_xfer(port, adap, pos,
+						    buf + done, len, false);
+			if (ret)
+				break;
+			done += len;
+			continue;
+		}
+		for (r = layout->regions;
+		     pos >= r->start + r->len; r++)
+			;
+		len = min_t(size_t, count - done, r->start + r->len - pos);
+		ret = port_eeprom_fetch(port, adap, r, pos, buf + done, len);
+		if (ret)
+			break;
+		done += len;
+	}
+	mutex_unlock(&port->lock);
+
+	i2c_put_adapter(adap);
+
+	return done ? done : ret;
+}
+
+/* Only CMIS ports are writable */
+static ssize_t port_eeprom_write(struct file *filp, struct kobject *kobj,
+				 struct bin_attribute *attr, char *buf,
+				 loff_t off, size_t count)
+{
+	struct port_eeprom_port *port = attr->private;
+	struct i2c_adapter *adap;
+	unsigned int pos;
+	size_t done = 0;
+	size_t len;
+	int ret = 0;
+
+	if (!cumulus_presence_valid(port->pe->presence))
+		return -EAGAIN;
+	if (!cumulus_presence_test(port->pe->presence, port->index))
+		return -ENXIO;
+
+	adap = i2c_get_adapter(port->bus);
+	if (!adap)
+		return -ENODEV;
+
+	mutex_lock(&port->lock);
+	while (done < count) {
+		pos = off + done;
+		len = min_t(size_t, count - done,
+			    CMIS_PAGE_LEN - pos % CMIS_PAGE_LEN);
+		if (pos >= CMIS_PAGE_LEN) {
+			ret = port_eeprom_cmis_xfer(port, adap, pos,
+						    buf + done, len, true);
+		} else {
+			ret = port_eeprom_raw_write(adap, 0x50, pos,
+						    buf + done, len);
+		}
+		if (ret)
+			break;
+		done += len;
+	}
+	mutex_unlock(&port->lock);
+
+	i2c_put_adapter(adap);
+
+	return done ? done : ret;
+}
+
+static int port_eeprom_presence_event(struct notifier_block *nb,
+				      unsigned long action, void *data)
+{
+	struct cumulus_port_eeprom *pe =
+		container_of(nb, struct cumulus_port_eeprom, nb);
+	struct cumulus_presence_event *ev = data;
+	struct port_eeprom_port *port;
+	int i;
+
+	for_each_set_bit(i, ev->changed, min(ev->num_ports, pe->num_ports)) {
+		port = &pe->ports[i];
+		mutex_lock(&port->lock);
+		port_eeprom_forget(port);
+		mutex_unlock(&port->lock);
+	}
+
+	return NOTIFY_OK;
+}
+
+/**
+ * cumulus_port_eeprom_add() - create cached port EEPROM attributes
+ * @dev: device the port_eeprom/ attribute group is created under
+ * @desc: port table and presence source
+ *
+ * Returns the cache or an ERR_PTR() on failure.
+ */
+struct cumulus_port_eeprom *
+cumulus_port_eeprom_add(struct device *dev,
+			const struct cumulus_port_eeprom_desc *desc)
+{
+	struct cumulus_port_eeprom *pe;
+	struct port_eeprom_port *port;
+	unsigned int banks;
+	int ret;
+	int i;
+
+	if (desc->num_ports <= 0 || IS_ERR_OR_NULL(desc->presence))
+		return ERR_PTR(-EINVAL);
+
+	for (i = 0; i < desc->num_ports; i++)
+		if (desc->ports[i].type >= ARRAY_SIZE(port_eeprom_layouts))
+			return ERR_PTR(-EINVAL);
+
+	pe = kzalloc(sizeof(*pe), GFP_KERNEL);
+	if (!pe)
+		return ERR_PTR(-ENOMEM);
+
+	pe->ports = kvcalloc(desc->num_ports, sizeof(*pe->ports), GFP_KERNEL);
+	pe->bin_attrs = kcalloc(desc->num_ports + 1, sizeof(*pe->bin_attrs),
+				GFP_KERNEL);
+	if (!pe->ports || !pe->bin_attrs) {
+		ret = -ENOMEM;
+		goto err_free;
+	}
+
+	pe->dev = dev;
+	pe->name = desc->name;
+	pe->presence = desc->presence;
+	pe->num_ports = desc->num_ports;
+	banks = clamp_t(unsigned int, cmis_banks, 1, CMIS_MAX_BANKS);
+
+	for (i = 0; i < desc->num_ports; i++) {
+		port = &pe->ports[i];
+		port->pe = pe;
+		port->index = i;
+		port->bus = desc->ports[i].bus;
+		port->layout = &port_eeprom_layouts[desc->ports[i].type];
+		mutex_init(&port->lock);
+		port_eeprom_forget(port);
+
+		snprintf(port->name, sizeof(port->name), "port%d",
+			 desc->ports[i].number ? : i + 1);
+		sysfs_bin_attr_init(&port->attr);
+		port->attr.attr.name = port->name;
+		port->attr.attr.mode = 0444;
+		port->attr.size = port->layout->size;
+		port->attr.read = port_eeprom_read;
+		if (port->layout->paged) {
+			port->attr.attr.mode = 0644;
+			port->attr.size = CUMULUS_PORT_EEPROM_CMIS_OFFSET(banks, 0);
+			port->attr.write = port_eeprom_write;
+		}
+		port->attr.private = port;
+		pe->bin_attrs[i] = &port->attr;
+	}
+
+	pe->group.name = "port_eeprom";
+	pe->group.bin_attrs = pe->bin_attrs;
+
+	pe->nb.notifier_call = port_eeprom_presence_event;
+	ret = cumulus_presence_register_notifier(pe->presence, &pe->nb);
+	if (ret)
+		goto err_free;
+
+	ret = sysfs_create_group(&dev->kobj, &pe->group);
+	if (ret) {
+		cumulus_presence_unregister_notifier(pe->presence, &pe->nb);
+		goto err_free;
+	}
+
+	return pe;
+
+err_free:
+	kfree(pe->bin_attrs);
+	kvfree(pe->ports);
+	kfree(pe);
+	return ERR_PTR(ret);
+}
+EXPORT_SYMBOL_GPL(cumulus_port_eeprom_add);
+
+/**
+ * cumulus_port_eeprom_del() - remove a cache from cumulus_port_eeprom_add()
+ * @pe: the cache, NULL or an ERR_PTR()
+ *
+ * Must be called before the presence object is deleted.
+ */
+void cumulus_port_eeprom_del(struct cumulus_port_eeprom *pe)
+{
+	if (IS_ERR_OR_NULL(pe))
+		return;
+
+	sysfs_remove_group(&pe->dev->kobj, &pe->group);
+	cumulus_presence_unregister_notifier(pe->presence, &pe->nb);
+	kfree(pe->bin_attrs);
+	kvfree(pe->ports);
+	kfree(pe);
+}
+EXPORT_SYMBOL_GPL(cumulus_port_eeprom_del);
+
+MODULE_DESCRIPTION("Cumulus Cached Port EEPROM Library");
+MODULE_LICENSE("GPL");
+MODULE_VERSION(CUMULUS_PORT_EEPROM_MODULE_VERSION);
@@ -0,0 +1,304 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Table driven front panel port attributes and EEPROM devices.
+ *
+ * Copyright (C) 2020 Cumulus Networks, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * https://www.gnu.org/licenses/gpl-2.0-standalone.html
+ */
+
+/**
+ * Platform drivers used to spell out every port: one mk_port_eeprom()
+ * and one i2c device table entry per port, and one fpga_sfp_port() or
+ * similar macro per port expanding to a struct bf, a show and a store
+ * function for each of its attributes.  That is several hundred lines
+ * and a few hundred functions per 100 port box, all identical but for
+ * the port number.
+ *
+ * This module builds the same things at probe time from a few port
+ * ranges: the "portN_<field>" attributes as struct bf_attribute, the
+ * EEPROM platform data and i2c board info, and the port table used by
+ * cumulus-dom.c and cumulus-port-eeprom.c.  The sysfs names, EEPROM
+ * labels and drivers do not change.
+ *
+ * This module is not a device driver.
+ */
+
+#include <linux/module.h>
+#include <linux/slab.h>
+#include <linux/platform_data/at24.h>
+#include <linux/platform_data/sff-8436.h>
+#include <linux/cumulus-ports.h>
+
+#include "platform-defs.h"
+
+#define CUMULUS_PORTS_MODULE_VERSION "1.1"
+
+#define PORT_NAME_LEN		32
+
+struct port_attr {
+	struct bf_attribute bfa;
+	struct bf bf;
+	char name[PORT_NAME_LEN];
+};
+
+struct port_eeprom {
+	char label[PORT_NAME_LEN];
+	struct eeprom_platform_data eeprom;
+	union {
+		struct at24_platform_data at24;
+		struct sff_8436_platform_data sff8436;
+	};
+};
+
+struct ports_priv {
+	struct cumulus_ports ports;
+	struct cumulus_ports_desc desc;
+	struct device *dev;
+	struct port_eeprom *pdata;
+	struct port_attr *attrs;
+	struct attribute **attr_list;
+	struct attribute_group group;
+	bool group_created;
+};
+
+static int ports_check_range(const struct cumulus_ports_desc *desc,
+			     const struct cumulus_port_range *r)
+{
+	int i;
+
+	if (!r->first || !r->count)
+		return -EINVAL;
+	if (r->addr && r->type != CUMULUS_PORT_EEPROM_SFP &&
+	    r->type != CUMULUS_PORT_EEPROM_QSFP)
+		return -EINVAL;
+	if (r->num_fields && (!r->fields || !desc->read))
+		return -EINVAL;
+
+	for (i = 0; i < r->num_fields; i++) {
+		if (!r->fields[i].name || !r->fields[i].width ||
+		    r->fields[i].shift + r->fields[i].width > 32)
+			return -EINVAL;
+		if (r->fields[i].mode & 0222 && !desc->write)
+			return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int ports_bus(const struct cumulus_port_range *r, int i)
+{
+	return r->bus + (r->bus_order ? r->bus_order[i] : i);
+}
+
+static void ports_init_eeprom(struct ports_priv *priv,
+			      const struct cumulus_port_range *r,
+			      int port, int i, int d)
+{
+	struct platform_i2c_device_info *info = &priv->ports.devices[d];
+	struct i2c_board_info *bi = &info->board_info;
+	struct port_eeprom *pe = &priv->pdata[d];
+
+	snprintf(pe->label, sizeof(pe->label), "port%d", port);
+	pe->eeprom.label = pe->label;
+
+	info->bus = ports_bus(r, i);
+	bi->addr = r->addr;
+	if (r->type == CUMULUS_PORT_EEPROM_SFP) {
+		strlcpy(bi->type, "24c04", sizeof(bi->type));
+		pe->at24.byte_len = r->size ? r->size : SFP_DATA_BYTE_LEN;
+		pe->at24.flags = r->eeprom_flags;
+		pe->at24.page_size = r->page_size ? : SFP_PAGE_SIZE;
+		pe->at24.eeprom_data = &pe->eeprom;
+		bi->platform_data = &pe->at24;
+	} else {
+		strlcpy(bi->type, "sff8436", sizeof(bi->type));
+		pe->sff8436.byte_len = r->size ? r->size : 256;
+		pe->sff8436.flags = r->eeprom_flags;
+		pe->sff8436.page_size = r->page_size ? : QSFP_PAGE_SIZE;
+		pe->sff8436.eeprom_data = &pe->eeprom;
+		bi->platform_data = &pe->sff8436;
+	}
+}
+
+static void ports_init_attr(struct ports_priv *priv,
+			    const struct cumulus_port_range *r,
+			    const struct cumulus_port_field *f,
+			    int port, int i, struct port_attr *pa)
+{
+	struct bf_attribute *bfa = &pa->bfa;
+
+	if (r->attr_first)
+		port = r->attr_first + i;
+	snprintf(pa->name, sizeof(pa->name), "%sport%d_%s",
+		 r->attr_prefix ? r->attr_prefix : "", port, f->name);
+
+	pa->bf.values = f->values;
+	pa->bf.reg = f->reg + i * r->reg_stride;
+	pa->bf.shift = f->shift;
+	pa->bf.width = f->width;
+	pa->bf.flags = f->flags;
+	pa->bf.num_values = f->num_values;
+
+	bfa->bf = &pa->bf;
+	bfa->read = priv->desc.read;
+	bfa->write = priv->desc.write;
+
+	sysfs_attr_init(&bfa->attr);
+	bfa->attr.name = pa->name;
+	bfa->attr.mode = f->mode;
+	bfa->dattr.show = cumulus_bf_attr_show;
+	if (f->mode & 0222)
+		bfa->dattr.store = cumulus_bf_attr_store;
+}
+
+static void ports_free(struct ports_priv *priv)
+{
+	kfree(priv->attr_list);
+	kfree(priv->attrs);
+	kfree(priv->pdata);
+	kfree(priv->ports.devices);
+	kfree(priv->ports.eeproms);
+	kfree(priv);
+}
+
+/**
+ * cumulus_ports_add() - build the port attributes and EEPROM devices
+ * @dev: device whose kobject gets the port attributes and whose
+ *	 register accessors serve them, may be NULL if no range has
+ *	 fields
+ * @desc: port ranges, copied; the field and value tables are not and
+ *	  must outlive the returned object
+ *
+ * Returns the generated tables or an ERR_PTR() on failure.
+ */
+struct cumulus_ports *cumulus_ports_add(struct device *dev,
+					const struct cumulus_ports_desc *desc)
+{
+	const struct cumulus_port_range *r;
+	struct cumulus_port_eeprom_port *ep;
+	struct ports_priv *priv;
+	int num_ports = 0;
+	int num_devices = 0;
+	int num_attrs = 0;
+	int port, i, j, a, d, ret;
+
+	if (!desc->name || !desc->ranges || desc->num_ranges <= 0)
+		return ERR_PTR(-EINVAL);
+
+	for (i = 0; i < desc->num_ranges; i++) {
+		r = &desc->ranges[i];
+		ret = ports_check_range(desc, r);
+		if (ret) {
+			pr_err("%s: bad port range %d\n", desc->name, i);
+			return ERR_PTR(ret);
+		}
+		num_ports += r->count;
+		if (r->addr)
+			num_devices += r->count;
+		num_attrs += r->count * r->num_fields;
+	}
+	if (num_attrs && !dev)
+		return ERR_PTR(-EINVAL);
+
+	priv = kzalloc(sizeof(*priv), GFP_KERNEL);
+	if (!priv)
+		return ERR_PTR(-ENOMEM);
+
+	priv->desc = *desc;
+	priv->dev = dev;
+	priv->ports.eeproms = kcalloc(num_ports, sizeof(*priv->ports.eeproms),
+				      GFP_KERNEL);
+	priv->ports.devices = kcalloc(num_devices,
+				      sizeof(*priv->ports.devices),
+				      GFP_KERNEL);
+	priv->pdata = kcalloc(num_devices, sizeof(*priv->pdata), GFP_KERNEL);
+	priv->attrs = kcalloc(num_attrs, sizeof(*priv->attrs), GFP_KERNEL);
+	priv->attr_list = kcalloc(num_attrs + 1, sizeof(*priv->attr_list),
+				  GFP_KERNEL);
+	if (!priv->ports.eeproms || !priv->ports.devices || !priv->pdata ||
+	    !priv->attrs || !priv->attr_list) {
+		ret = -ENOMEM;
+		goto err_free;
+	}
+
+	ep = priv->ports.eeproms;
+	a = 0;
+	d = 0;
+	for (i = 0; i < desc->num_ranges; i++) {
+		r = &desc->ranges[i];
+		for (port = r->first; port < r->first + r->count; port++) {
+			ep->bus = ports_bus(r, port - r->first);
+			ep->type = r->type;
+			ep->number = port;
+			ep++;
+
+			if (r->addr)
+				ports_init_eeprom(priv, r, port,
+						  port - r->first, d++);
+
+			for (j = 0; j < r->num_fields; j++, a++) {
+				ports_init_attr(priv, r, &r->fields[j], port,
+						port - r->first,
+						&priv->attrs[a]);
+				priv->attr_list[a] = &priv->attrs[a].bfa.attr;
+			}
+		}
+	}
+	priv->ports.num_ports = num_ports;
+	priv->ports.num_devices = num_devices;
+
+	if (num_attrs) {
+		priv->group.attrs = priv->attr_list;
+		ret = sysfs_create_group(&dev->kobj, &priv->group);
+		if (ret) {
+			pr_err("%s: cannot create port attributes (%d)\n",
+			       desc->name, ret);
+			goto err_free;
+		}
+		priv->group_created = true;
+	}
+
+	pr_info("%s: %d ports, %d EEPROMs, %d attributes\n",
+		desc->name, num_ports, num_devices, num_attrs);
+
+	return &priv->ports;
+
+err_free:
+	ports_free(priv);
+	return ERR_PTR(ret);
+}
+EXPORT_SYMBOL_GPL(cumulus_ports_add);
+
+/**
+ * cumulus_ports_del() - remove the port attributes and free the tables
+ * @ports: object from cumulus_ports_add(), NULL or an ERR_PTR()
+ *
+ * The caller must have unregistered the EEPROM clients first.
+ */
+void cumulus_ports_del(struct cumulus_ports *ports)
+{
+	struct ports_priv *priv;
+
+	if (IS_ERR_OR_NULL(ports))
+		return;
+
+	priv = container_of(ports, struct ports_priv, ports);
+	if (priv->group_created)
+		sysfs_remove_group(&priv->dev->kobj, &priv->group);
+	ports_free(priv);
+}
+EXPORT_SYMBOL_GPL(cumulus_ports_del);
+
+MODULE_DESCRIPTION("Cumulus Platform Port Table Library");
+MODULE_LICENSE("GPL");
+MODULE_VERSION(CUMULUS_PORTS_MODULE_VERSION);
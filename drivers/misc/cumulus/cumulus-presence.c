@@ -0,0 +1,379 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Polled front panel port presence bitmap.
+ *
+ * Copyright (C) 2020 Cumulus Networks, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * https://www.gnu.org/licenses/gpl-2.0-standalone.html
+ */
+
+/**
+ * Port daemons used to poll a present attribute per port, each one a
+ * CPLD or FPGA access.  This module samples all of the presence
+ * registers of a device from a delayed work item instead, keeps the
+ * result in a bitmap and publishes it under presence/ in sysfs:
+ *
+ * - present:  hex bitmap, bit 0 is the first port.  sysfs_notify() is
+ *             called on every change, so userspace can poll() it and
+ *             read it once per insertion or removal.  Reads fail with
+ *             -EAGAIN until the first sample succeeds.
+ * - poll_ms:  sample period, 0 stops sampling.
+ * - changes:  number of changes seen.
+ *
+ * In-kernel users can test a port or register a notifier that is
+ * called with the set of changed ports.  Presence is unknown, not
+ * absent, until a sample has been read; cumulus_presence_valid() tells
+ * the two apart.
+ *
+ * This module is not a device driver.
+ */
+
+#include <linux/module.h>
+#include <linux/slab.h>
+#include <linux/mutex.h>
+#include <linux/bitmap.h>
+#include <linux/workqueue.h>
+#include <linux/cumulus-presence.h>
+
+#define CUMULUS_PRESENCE_MODULE_VERSION "1.2"
+
+#define PRESENCE_MIN_POLL_MS	10
+
+static unsigned int poll_ms = 500;
+module_param(poll_ms, uint, 0444);
+MODULE_PARM_DESC(poll_ms,
+		 "Default port presence sample period in ms (default 500)");
+
+struct cumulus_presence {
+	struct cumulus_presence_desc desc;
+	struct device *dev;
+	struct delayed_work work;
+	struct mutex lock;
+	struct blocking_notifier_head notifier;
+	unsigned int poll_ms;
+	unsigned long changes;
+	unsigned long errors;
+	bool seeded;
+	struct device_attribute present_attr;
+	struct device_attribute poll_ms_attr;
+	struct device_attribute changes_attr;
+	struct attribute *attrs[4];
+	struct attribute_group group;
+	unsigned long *present;
+	unsigned long *sample;
+	unsigned long *changed;
+	unsigned long bits[];
+};
+
+/*
+ * Runs from the work item only, apart from the first sample taken
+ * before the work item is queued, so @sample and @changed need no
+ * locking.  @lock keeps readers from seeing a half copied @present.
+ *
+ * The first successful sample only seeds @present: the modules that
+ * were plugged in before sampling started are not changes.  @seeded
+ * is set with release semantics after @present is filled in, so a
+ * lockless reader that sees it set also sees the bitmap.
+ */
+static void presence_sample(struct cumulus_presence *pres)
+{
+	struct cumulus_presence_event ev;
+	int n = pres->desc.num_ports;
+	int ret;
+
+	bitmap_zero(pres->sample, n);
+	ret = pres->desc.read(pres->desc.priv, pres->sample);
+	if (ret) {
+		pres->errors++;
+		dev_warn_ratelimited(pres->dev,
+				     "%s: presence read failed (%d)\n",
+				     pres->desc.name, ret);
+		return;
+	}
+
+	if (!pres->seeded) {
+		mutex_lock(&pres->lock);
+		bitmap_copy(pres->present, pres->sample, n);
+		smp_store_release(&pres->seeded, true);
+		mutex_unlock(&pres->lock);
+		sysfs_notify(&pres->dev->kobj, pres->group.name,
+			     pres->present_attr.attr.name);
+		return;
+	}
+
+	bitmap_xor(pres->changed, pres->present, pres->sample, n);
+	if (bitmap_empty(pres->changed, n))
+		return;
+
+	mutex_lock(&pres->lock);
+	bitmap_copy(pres->present, pres->sample, n);
+	pres->changes++;
+	mutex_unlock(&pres->lock);
+
+	ev.present = pres->present;
+	ev.changed = pres->changed;
+	ev.num_ports = n;
+	blocking_notifier_call_chain(&pres->notifier,
+				     CUMULUS_PRESENCE_CHANGED, &ev);
+
+	sysfs_notify(&pres->dev->kobj, pres->group.name,
+		     pres->present_attr.attr.name);
+}
+
+static void presence_work(struct work_struct *work)
+{
+	struct cumulus_presence *pres =
+		container_of(to_delayed_work(work), struct cumulus_presence,
+			     work);
+	unsigned int ms;
+
+	presence_sample(pres);
+
+	ms = READ_ONCE(pres->poll_ms);
+	if (ms)
+		queue_delayed_work(system_power_efficient_wq, &pres->work,
+				   msecs_to_jiffies(ms));
+}
+
+static ssize_t present_show(struct device *dev,
+			    struct device_attribute *dattr,
+			    char *buf)
+{
+	struct cumulus_presence *pres =
+		container_of(dattr, struct cumulus_presence, present_attr);
+	ssize_t len;
+
+	mutex_lock(&pres->lock);
+	if (pres->seeded)
+		len = sprintf(buf, "%*pb\n", pres->desc.num_ports,
+			      pres->present);
+	else
+		len = -EAGAIN;
+	mutex_unlock(&pres->lock);
+
+	return len;
+}
+
+static ssize_t poll_ms_show(struct device *dev,
+			    struct device_attribute *dattr,
+			    char *buf)
+{
+	struct cumulus_presence *pres =
+		container_of(dattr, struct cumulus_presence, poll_ms_attr);
+
+	return sprintf(buf, "%u\n", READ_ONCE(pres->poll_ms));
+}
+
+static ssize_t poll_ms_store(struct device *dev,
+			     struct device_attribute *dattr,
+			     const char *buf, size_t count)
+{
+	struct cumulus_presence *pres =
+		container_of(dattr, struct cumulus_presence, poll_ms_attr);
+	unsigned int ms;
+	int ret;
+
+	ret = kstrtouint(buf, 0, &ms);
+	if (ret)
+		return ret;
+	if (ms && ms < PRESENCE_MIN_POLL_MS)
+		return -EINVAL;
+
+	WRITE_ONCE(pres->poll_ms, ms);
+	if (ms)
+		mod_delayed_work(system_power_efficient_wq, &pres->work, 0);
+	else
+		cancel_delayed_work_sync(&pres->work);
+
+	return count;
+}
+
+static ssize_t changes_show(struct device *dev,
+			    struct device_attribute *dattr,
+			    char *buf)
+{
+	struct cumulus_presence *pres =
+		container_of(dattr, struct cumulus_presence, changes_attr);
+
+	return sprintf(buf, "%lu\n", READ_ONCE(pres->changes));
+}
+
+/*
+ * The attributes live in the presence object, not in static storage,
+ * so that show and store can find it without the device driver data.
+ */
+static void presence_init_attr(struct device_attribute *dattr,
+			       const char *name, umode_t mode,
+			       ssize_t (*show)(struct device *,
+					       struct device_attribute *,
+					       char *),
+			       ssize_t (*store)(struct device *,
+						struct device_attribute *,
+						const char *, size_t))
+{
+	sysfs_attr_init(&dattr->attr);
+	dattr->attr.name = name;
+	dattr->attr.mode = mode;
+	dattr->show = show;
+	dattr->store = store;
+}
+
+/**
+ * cumulus_presence_add() - start sampling port presence
+ * @dev: device the presence/ attribute group is created under
+ * @desc: presence source description, copied
+ *
+ * Takes a first sample synchronously, then samples every poll_ms.
+ * If that first read fails, presence stays unknown until a later
+ * sample succeeds.  Returns the presence object or
+ * an ERR_PTR() on failure.
+ */
+struct cumulus_presence *
+cumulus_presence_add(struct device *dev,
+		     const struct cumulus_presence_desc *desc)
+{
+	struct cumulus_presence *pres;
+	size_t nlongs;
+	int ret;
+
+	if (desc->num_ports <= 0 || !desc->read)
+		return ERR_PTR(-EINVAL);
+
+	nlongs = BITS_TO_LONGS(desc->num_ports);
+	pres = kzalloc(sizeof(*pres) + 3 * nlongs * sizeof(long), GFP_KERNEL);
+	if (!pres)
+		return ERR_PTR(-ENOMEM);
+
+	pres->desc = *desc;
+	pres->dev = dev;
+	pres->poll_ms = desc->poll_ms ? desc->poll_ms : poll_ms;
+	if (pres->poll_ms < PRESENCE_MIN_POLL_MS)
+		pres->poll_ms = PRESENCE_MIN_POLL_MS;
+	pres->present = pres->bits;
+	pres->sample = pres->bits + nlongs;
+	pres->changed = pres->bits + 2 * nlongs;
+	mutex_init(&pres->lock);
+	BLOCKING_INIT_NOTIFIER_HEAD(&pres->notifier);
+	INIT_DELAYED_WORK(&pres->work, presence_work);
+
+	presence_init_attr(&pres->present_attr, "present", 0444,
+			   present_show, NULL);
+	presence_init_attr(&pres->poll_ms_attr, "poll_ms", 0644,
+			   poll_ms_show, poll_ms_store);
+	presence_init_attr(&pres->changes_attr, "changes", 0444,
+			   changes_show, NULL);
+	pres->attrs[0] = &pres->present_attr.attr;
+	pres->attrs[1] = &pres->poll_ms_attr.attr;
+	pres->attrs[2] = &pres->changes_attr.attr;
+	pres->group.name = "presence";
+	pres->group.attrs = pres->attrs;
+
+	presence_sample(pres);
+	if (!pres->seeded)
+		dev_warn(dev, "%s: presence unknown until a read succeeds\n",
+			 desc->name);
+
+	ret = sysfs_create_group(&dev->kobj, &pres->group);
+	if (ret) {
+		kfree(pres);
+		return ERR_PTR(ret);
+	}
+
+	queue_delayed_work(system_power_efficient_wq, &pres->work,
+			   msecs_to_jiffies(pres->poll_ms));
+
+	dev_info(dev, "%s: sampling presence of %d ports every %u ms\n",
+		 desc->name, desc->num_ports, pres->poll_ms);
+
+	return pres;
+}
+EXPORT_SYMBOL_GPL(cumulus_presence_add);
+
+/**
+ * cumulus_presence_del() - stop sampling and free a presence object
+ * @pres: object from cumulus_presence_add(), NULL or an ERR_PTR()
+ */
+void cumulus_presence_del(struct cumulus_presence *pres)
+{
+	if (IS_ERR_OR_NULL(pres))
+		return;
+
+	sysfs_remove_group(&pres->dev->kobj, &pres->group);
+	WRITE_ONCE(pres->poll_ms, 0);
+	cancel_delayed_work_sync(&pres->work);
+	kfree(pres);
+}
+EXPORT_SYMBOL_GPL(cumulus_presence_del);
+
+/**
+ * cumulus_presence_valid() - tell whether presence has been sampled
+ * @pres: presence object, may be NULL or an ERR_PTR()
+ *
+ * Returns false until the first successful read.  Until then
+ * cumulus_presence_test() reports every port absent, which callers
+ * must not take as an empty cage.  Without a presence object the
+ * state is always valid.
+ */
+bool cumulus_presence_valid(struct cumulus_presence *pres)
+{
+	if (IS_ERR_OR_NULL(pres))
+		return true;
+
+	return smp_load_acquire(&pres->seeded);
+}
+EXPORT_SYMBOL_GPL(cumulus_presence_valid);
+
+/**
+ * cumulus_presence_test() - return the last sampled state of a port
+ * @pres: presence object, may be NULL or an ERR_PTR()
+ * @port: zero based port number
+ *
+ * Without a presence object every port is reported present, so
+ * callers can gate on the result unconditionally.  Ports are reported
+ * absent while cumulus_presence_valid() is false.
+ */
+bool cumulus_presence_test(struct cumulus_presence *pres, int port)
+{
+	if (IS_ERR_OR_NULL(pres))
+		return true;
+	if (port < 0 || port >= pres->desc.num_ports)
+		return false;
+	if (!cumulus_presence_valid(pres))
+		return false;
+
+	return test_bit(port, pres->present);
+}
+EXPORT_SYMBOL_GPL(cumulus_presence_test);
+
+/**
+ * cumulus_presence_register_notifier() - get told about presence changes
+ * @pres: presence object
+ * @nb: notifier, called from process context with
+ *	CUMULUS_PRESENCE_CHANGED and a struct cumulus_presence_event
+ */
+int cumulus_presence_register_notifier(struct cumulus_presence *pres,
+				       struct notifier_block *nb)
+{
+	return blocking_notifier_chain_register(&pres->notifier, nb);
+}
+EXPORT_SYMBOL_GPL(cumulus_presence_register_notifier);
+
+int cumulus_presence_unregister_notifier(struct cumulus_presence *pres,
+					 struct notifier_block *nb)
+{
+	return blocking_notifier_chain_unregister(&pres->notifier, nb);
+}
+EXPORT_SYMBOL_GPL(cumulus_presence_unregister_notifier);
+
+MODULE_DESCRIPTION("Cumulus Port Presence Sampling Library");
+MODULE_LICENSE("GPL");
+MODULE_VERSION(CUMULUS_PRESENCE_MODULE_VERSION);
@@ -0,0 +1,316 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Platform temperature sources as thermal zones.
+ *
+ * Copyright (C) 2020 Cumulus Networks, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * https://www.gnu.org/licenses/gpl-2.0-standalone.html
+ */
+
+/**
+ * Our temperatures come from SMF mailboxes, CPLD attached sensors, the
+ * switch ASIC and vhwmon, none of which are described by device tree,
+ * and userspace used to poll each of them.  This module registers any
+ * such source as a thermal zone from a small description: a get_temp
+ * callback, in the style of thermal_zone_of_device_ops, a trip table
+ * and optionally the type of the cooling devices to bind.  The kernel
+ * governors can then drive fan PWM outputs directly.
+ *
+ * Crossing a hot trip is logged once, and again when the zone is back
+ * below the trip by its hysteresis, so zones without a cooling device
+ * still report overheating.
+ *
+ * Trip temperatures are writable through the thermal zone sysfs
+ * attributes when the kernel is built with
+ * CONFIG_THERMAL_WRITABLE_TRIPS.
+ *
+ * This module is not a device driver.
+ */
+
+#include <linux/module.h>
+#include <linux/slab.h>
+#include <linux/bitops.h>
+#include <linux/string.h>
+#include <linux/cumulus-thermal.h>
+
+#define CUMULUS_THERMAL_MODULE_VERSION "1.1"
+
+#define THERMAL_MIN_POLL_MS	100
+
+static unsigned int poll_ms = 2000;
+module_param(poll_ms, uint, 0444);
+MODULE_PARM_DESC(poll_ms,
+		 "Default thermal zone sample period in ms (default 2000)");
+
+struct cumulus_thermal {
+	struct cumulus_thermal_desc desc;
+	struct device *dev;
+	struct thermal_zone_device *tzd;
+	struct thermal_zone_params tzp;
+	char type[THERMAL_NAME_LENGTH];
+	char cdev_type[THERMAL_NAME_LENGTH];
+	unsigned long hot;	/* hot trips crossed, one bit per trip */
+	struct cumulus_thermal_trip trips[];
+};
+
+static int ct_get_temp(struct thermal_zone_device *tzd, int *temp)
+{
+	struct cumulus_thermal *ct = tzd->devdata;
+	struct cumulus_thermal_trip *trip;
+	int ret, i;
+
+	ret = ct->desc.ops->get_temp(ct->desc.priv, temp);
+	if (ret || !ct->hot)
+		return ret;
+
+	for_each_set_bit(i, &ct->hot, ct->desc.num_trips) {
+		trip = &ct->trips[i];
+		if (*temp < READ_ONCE(trip->temp) - READ_ONCE(trip->hyst)) {
+			clear_bit(i, &ct->hot);
+			dev_info(ct->dev, "%s: %d mC, below hot trip %d\n",
+				 ct->type, *temp, i);
+		}
+	}
+
+	return 0;
+}
+
+/* Called by the thermal core while a hot or critical trip is crossed */
+static int ct_notify(struct thermal_zone_device *tzd, int trip,
+		     enum thermal_trip_type type)
+{
+	struct cumulus_thermal *ct = tzd->devdata;
+
+	if (type == THERMAL_TRIP_HOT && !test_and_set_bit(trip, &ct->hot))
+		dev_crit(ct->dev, "%s: %d mC, above hot trip %d at %d mC\n",
+			 ct->type, tzd->temperature, trip,
+			 READ_ONCE(ct->trips[trip].temp));
+
+	return 0;
+}
+
+static int ct_get_trend(struct thermal_zone_device *tzd, int trip,
+			enum thermal_trend *trend)
+{
+	struct cumulus_thermal *ct = tzd->devdata;
+
+	if (!ct->desc.ops->get_trend)
+		return -ENODEV;
+
+	return ct->desc.ops->get_trend(ct->desc.priv, trip, trend);
+}
+
+static int ct_get_trip_type(struct thermal_zone_device *tzd, int trip,
+			    enum thermal_trip_type *type)
+{
+	struct cumulus_thermal *ct = tzd->devdata;
+
+	*type = ct->trips[trip].type;
+	return 0;
+}
+
+static int ct_get_trip_temp(struct thermal_zone_device *tzd, int trip,
+			    int *temp)
+{
+	struct cumulus_thermal *ct = tzd->devdata;
+
+	*temp = READ_ONCE(ct->trips[trip].temp);
+	return 0;
+}
+
+static int ct_set_trip_temp(struct thermal_zone_device *tzd, int trip,
+			    int temp)
+{
+	struct cumulus_thermal *ct = tzd->devdata;
+
+	WRITE_ONCE(ct->trips[trip].temp, temp);
+	return 0;
+}
+
+static int ct_get_trip_hyst(struct thermal_zone_device *tzd, int trip,
+			    int *hyst)
+{
+	struct cumulus_thermal *ct = tzd->devdata;
+
+	*hyst = READ_ONCE(ct->trips[trip].hyst);
+	return 0;
+}
+
+static int ct_set_trip_hyst(struct thermal_zone_device *tzd, int trip,
+			    int hyst)
+{
+	struct cumulus_thermal *ct = tzd->devdata;
+
+	WRITE_ONCE(ct->trips[trip].hyst, hyst);
+	return 0;
+}
+
+static bool ct_match_cdev(struct cumulus_thermal *ct,
+			  struct thermal_cooling_device *cdev)
+{
+	return ct->cdev_type[0] && !strcmp(cdev->type, ct->cdev_type);
+}
+
+static int ct_bind(struct thermal_zone_device *tzd,
+		   struct thermal_cooling_device *cdev)
+{
+	struct cumulus_thermal *ct = tzd->devdata;
+	unsigned long lower, upper;
+	int i, ret;
+
+	if (!ct_match_cdev(ct, cdev))
+		return 0;
+
+	for (i = 0; i < ct->desc.num_trips; i++) {
+		lower = ct->trips[i].lower;
+		upper = ct->trips[i].upper;
+		if (!upper)
+			lower = upper = THERMAL_NO_LIMIT;
+
+		ret = thermal_zone_bind_cooling_device(tzd, i, cdev,
+						       upper, lower,
+						       THERMAL_WEIGHT_DEFAULT);
+		if (ret) {
+			dev_err(ct->dev, "%s: cannot bind %s to trip %d (%d)\n",
+				ct->type, cdev->type, i, ret);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+static int ct_unbind(struct thermal_zone_device *tzd,
+		     struct thermal_cooling_device *cdev)
+{
+	struct cumulus_thermal *ct = tzd->devdata;
+	int i;
+
+	if (!ct_match_cdev(ct, cdev))
+		return 0;
+
+	for (i = 0; i < ct->desc.num_trips; i++)
+		thermal_zone_unbind_cooling_device(tzd, i, cdev);
+
+	return 0;
+}
+
+static struct thermal_zone_device_ops ct_ops = {
+	.bind		= ct_bind,
+	.unbind		= ct_unbind,
+	.get_temp	= ct_get_temp,
+	.get_trend	= ct_get_trend,
+	.get_trip_type	= ct_get_trip_type,
+	.get_trip_temp	= ct_get_trip_temp,
+	.set_trip_temp	= ct_set_trip_temp,
+	.get_trip_hyst	= ct_get_trip_hyst,
+	.set_trip_hyst	= ct_set_trip_hyst,
+	.notify		= ct_notify,
+};
+
+/**
+ * cumulus_thermal_add() - register a temperature source as a thermal zone
+ * @dev: device owning the source, used for log messages
+ * @desc: zone description, copied along with its trips
+ *
+ * Returns the thermal zone object or an ERR_PTR() on failure.
+ */
+struct cumulus_thermal *
+cumulus_thermal_add(struct device *dev,
+		    const struct cumulus_thermal_desc *desc)
+{
+	struct cumulus_thermal *ct;
+	unsigned int ms;
+	int mask, i;
+
+	if (!desc->type || !desc->ops || !desc->ops->get_temp ||
+	    desc->num_trips < 0 || desc->num_trips > THERMAL_MAX_TRIPS ||
+	    (desc->num_trips && !desc->trips))
+		return ERR_PTR(-EINVAL);
+
+	ct = kzalloc(struct_size(ct, trips, desc->num_trips), GFP_KERNEL);
+	if (!ct)
+		return ERR_PTR(-ENOMEM);
+
+	ct->desc = *desc;
+	ct->dev = dev;
+	strlcpy(ct->type, desc->type, sizeof(ct->type));
+	if (desc->cdev_type)
+		strlcpy(ct->cdev_type, desc->cdev_type, sizeof(ct->cdev_type));
+	if (desc->governor)
+		strlcpy(ct->tzp.governor_name, desc->governor,
+			sizeof(ct->tzp.governor_name));
+	ct->tzp.no_hwmon = true;
+
+	/* Critical trips stay read-only, the rest can be tuned */
+	mask = 0;
+	for (i = 0; i < desc->num_trips; i++) {
+		ct->trips[i] = desc->trips[i];
+		if (ct->trips[i].type != THERMAL_TRIP_CRITICAL)
+			mask |= BIT(i);
+	}
+
+	ms = desc->poll_ms ? desc->poll_ms : poll_ms;
+	if (ms < THERMAL_MIN_POLL_MS)
+		ms = THERMAL_MIN_POLL_MS;
+
+	ct->tzd = thermal_zone_device_register(ct->type, desc->num_trips, mask,
+					       ct, &ct_ops, &ct->tzp, ms, ms);
+	if (IS_ERR(ct->tzd)) {
+		int ret = PTR_ERR(ct->tzd);
+
+		dev_err(dev, "%s: cannot register thermal zone (%d)\n",
+			ct->type, ret);
+		kfree(ct);
+		return ERR_PTR(ret);
+	}
+
+	dev_info(dev, "%s: thermal zone with %d trips, sampled every %u ms\n",
+		 ct->type, desc->num_trips, ms);
+
+	return ct;
+}
+EXPORT_SYMBOL_GPL(cumulus_thermal_add);
+
+/**
+ * cumulus_thermal_del() - unregister and free a thermal zone
+ * @ct: object from cumulus_thermal_add(), NULL or an ERR_PTR()
+ */
+void cumulus_thermal_del(struct cumulus_thermal *ct)
+{
+	if (IS_ERR_OR_NULL(ct))
+		return;
+
+	thermal_zone_device_unregister(ct->tzd);
+	kfree(ct);
+}
+EXPORT_SYMBOL_GPL(cumulus_thermal_del);
+
+/**
+ * cumulus_thermal_update() - evaluate a zone now
+ * @ct: thermal zone object, may be NULL or an ERR_PTR()
+ *
+ * For sources that sample on their own schedule and want the governor
+ * to see a new reading without waiting for the next poll.
+ */
+void cumulus_thermal_update(struct cumulus_thermal *ct)
+{
+	if (IS_ERR_OR_NULL(ct))
+		return;
+
+	thermal_zone_device_update(ct->tzd, THERMAL_EVENT_UNSPECIFIED);
+}
+EXPORT_SYMBOL_GPL(cumulus_thermal_update);
+
+MODULE_DESCRIPTION("Cumulus Platform Thermal Zone Library");
+MODULE_LICENSE("GPL");
+MODULE_VERSION(CUMULUS_THERMAL_MODULE_VERSION);
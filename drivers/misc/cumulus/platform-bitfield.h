@@ -281,10 +281,17 @@
  *
  * A few things to keep in mind:
  *
+ * Each field is a struct bf_attribute, <prefix>_<name>, holding the
+ * device attribute, the two accessors and a pointer to a const struct
+ * bf, <prefix>_<name>_bf.  All fields share the show and store
+ * functions in cumulus-platform.c, so a field costs some data but no
+ * code.  The accessors must be declared before the fields that use
+ * them.
+ *
  * Maximum value string length is PLATFORM_LED_COLOR_NAME_SIZE - 1,
- * but isn't enforced anywhere.  Also not enforced is the size
- * of the values array, which of course must match the field width.
- * So be cool.
+ * but isn't enforced anywhere.  The values array must be an array,
+ * not a pointer, since its size is taken at compile time.  Values past
+ * its end are shown as numbers and cannot be written by name.
  *
  * Fields can span up to 4 registers (when offset + width > 8),
  * little endian.  This limit is also not enforced.
@@ -309,67 +316,74 @@
  * the interval [-8, 7] if signed, or [0, 15] if unsigned.
  */
 
+/*
+ * Field descriptors are const and live in rodata.  @num_values is the
+ * number of entries in @values, which bounds the name lookup of a
+ * store; 0 falls back to scanning up to the field mask.
+ */
 struct bf {
-	const char *name;
 	const char * const *values;
-	u8 flags;
-	u16 reg;
-	u32 reg32;
+	u32 reg;
 	u8 shift;
 	u8 width;
+	u8 flags;
+	u8 num_values;
 };
 
+/* Entries in a values array, 0 for NULL */
+#define BF_NUM_VALUES(_values) \
+	__builtin_choose_expr( \
+		__builtin_types_compatible_p(typeof(_values), void *), \
+		0, sizeof(_values) / sizeof(const char *))
+
+typedef int bf_read_func(struct device *dev, int reg, int nregs, u32 *val);
+typedef int bf_write_func(struct device *dev, int reg, int nregs, u32 val);
+
+/*
+ * A field exposed in sysfs.  attr aliases dattr.attr, so attribute
+ * lists can keep using &<prefix>_<name>.attr.
+ */
+struct bf_attribute {
+	union {
+		struct device_attribute dattr;
+		struct attribute attr;
+	};
+	const struct bf *bf;
+	bf_read_func *read;
+	bf_write_func *write;
+};
+
+#define to_bf_attribute(_dattr) \
+	container_of(_dattr, struct bf_attribute, dattr)
+
 /* flags */
 #define BF_COMPLEMENT	0x01		/* complement value */
 #define BF_DECIMAL	0x02		/* show value in decimal */
 #define BF_SIGNED	0x04		/* value is signed */
 
 #define mk_bf_rw(_prefix, _name, _reg, _shift, _width, _values, _flags) \
-	mk_bf_struct(_prefix, _name, _reg, _shift, _width, _values, _flags); \
-	mk_bf_show(_prefix, _name) \
-	mk_bf_store(_prefix, _name) \
-	static struct device_attribute _prefix##_##_name = \
-		__ATTR(_name, 0644, \
-		       _prefix##_##_name##_show, _prefix##_##_name##_store)
+	mk_bf_attr(_prefix, _name, 0644, cumulus_bf_attr_store, \
+		   _prefix##_write_reg, _reg, _shift, _width, _values, _flags)
 
 #define mk_bf_ro(_prefix, _name, _reg, _shift, _width, _values, _flags) \
-	mk_bf_struct(_prefix, _name, _reg, _shift, _width, _values, _flags); \
-	mk_bf_show(_prefix, _name) \
-	static struct device_attribute _prefix##_##_name = \
-		__ATTR(_name, 0444, _prefix##_##_name##_show, NULL)
-
-#define mk_bf_struct(_prefix, _name, _reg, _shift, _width, _values, _flags) \
-	static struct bf _prefix##_##_name##_bf = { \
-		.name = #_name, \
+	mk_bf_attr(_prefix, _name, 0444, NULL, NULL, \
+		   _reg, _shift, _width, _values, _flags)
+
+#define mk_bf_attr(_prefix, _name, _mode, _store, _write, \
+		   _reg, _shift, _width, _values, _flags) \
+	static const struct bf _prefix##_##_name##_bf = { \
+		.values = (_values), \
 		.reg = (_reg), \
 		.shift = (_shift), \
 		.width = (_width), \
-		.values = (_values), \
 		.flags = (_flags), \
-	}
-
-#define mk_bf_show(_prefix, _name) \
-	static ssize_t \
-	_prefix##_##_name##_show(struct device *_dev, \
-				 struct device_attribute *_dattr, \
-				 char *_buf) \
-	{ \
-		return cumulus_bf_show(_dev, _dattr, _buf, \
-				       &_prefix##_##_name##_bf, \
-				       _prefix##_read_reg); \
-	}
-
-#define mk_bf_store(_prefix, _name) \
-	static ssize_t \
-	_prefix##_##_name##_store(struct device *_dev, \
-				  struct device_attribute *_dattr, \
-				  const char *_buf, \
-				  size_t _size) \
-	{ \
-		return cumulus_bf_store(_dev, _dattr, _buf, _size, \
-					&_prefix##_##_name##_bf, \
-					_prefix##_read_reg, \
-					_prefix##_write_reg); \
+		.num_values = BF_NUM_VALUES(_values), \
+	}; \
+	static struct bf_attribute _prefix##_##_name = { \
+		.dattr = __ATTR(_name, _mode, cumulus_bf_attr_show, _store), \
+		.bf = &_prefix##_##_name##_bf, \
+		.read = _prefix##_read_reg, \
+		.write = _write, \
 	}
 
 /* Shortcut macros for defining cpld bits, fields and registers */
@@ -393,57 +407,15 @@ struct bf {
 #define cpld_rg_rw(_name, _reg, _values, _flags) \
 	mk_bf_rw(cpld, _name, _reg, 0, 8, _values, _flags)
 
-/* Same as above, but for 32-bit device addresses */
-#define mk_bf_rw32(_prefix, _name, _reg, _shift, _width, _values, _flags) \
-	mk_bf_struct32(_prefix, _name, _reg, _shift, _width, _values, _flags); \
-	mk_bf_show32(_prefix, _name) \
-	mk_bf_store32(_prefix, _name) \
-	static struct device_attribute _prefix##_##_name = \
-		__ATTR(_name, 0644, \
-		       _prefix##_##_name##_show, _prefix##_##_name##_store)
-
-#define mk_bf_ro32(_prefix, _name, _reg, _shift, _width, _values, _flags) \
-	mk_bf_struct32(_prefix, _name, _reg, _shift, _width, _values, _flags); \
-	mk_bf_show32(_prefix, _name) \
-	static struct device_attribute _prefix##_##_name = \
-		__ATTR(_name, 0444, _prefix##_##_name##_show, NULL)
-
-#define mk_bf_struct32(_prefix, _name, _reg, _shift, _width, _values, _flags) \
-	static struct bf _prefix##_##_name##_bf = { \
-		.name  = #_name, \
-		.reg32 = (_reg), \
-		.shift = (_shift), \
-		.width = (_width), \
-		.values = (_values), \
-		.flags = (_flags), \
-	}
+/*
+ * Same as above, for 32-bit device addresses.  struct bf holds a
+ * 32-bit register, so these are plain aliases.
+ */
+#define mk_bf_rw32 mk_bf_rw
+#define mk_bf_ro32 mk_bf_ro
 
 #include <linux/cumulus-platform.h>
 
-#define mk_bf_show32(_prefix, _name) \
-	static ssize_t \
-	_prefix##_##_name##_show(struct device *_dev, \
-				 struct device_attribute *_dattr, \
-				 char *_buf) \
-	{ \
-		return cumulus_bf_show32(_dev, _dattr, _buf, \
-					 &_prefix##_##_name##_bf, \
-					 _prefix##_read_reg); \
-	}
-
-#define mk_bf_store32(_prefix, _name) \
-	static ssize_t \
-	_prefix##_##_name##_store(struct device *_dev, \
-				  struct device_attribute *_dattr, \
-				  const char *_buf, \
-				  size_t _size) \
-	{ \
-		return cumulus_bf_store32(_dev, _dattr, _buf, _size, \
-					  &_prefix##_##_name##_bf, \
-					  _prefix##_read_reg, \
-					  _prefix##_write_reg); \
-	}
-
 /* Shortcut macros for defining cpld bits, fields and registers */
 #define cpld_bf_ro32(_name, _reg, _field, _values, _flags) \
 	mk_bf_ro32(cpld, _name, _reg, _field##_LSB, FIELD_WIDTH(_field), \
@@ -76,6 +76,16 @@
 #define SFP_PAGE_SIZE                1
 #define SFP_EEPROM_ADDR              0x50
 
+/*
+ * Multi-byte port EEPROM write pages, opt-in per platform.  SFF-8472
+ * allows sequential writes of up to 8 bytes; 4 is the conservative
+ * limit for SFF-8436/SFF-8636 modules.  Some optics still NACK or
+ * corrupt multi-byte writes, so only platforms whose optics have been
+ * validated should use these instead of SFP_PAGE_SIZE/QSFP_PAGE_SIZE.
+ */
+#define QSFP_MULTI_PAGE_SIZE         4
+#define SFP_MULTI_PAGE_SIZE          8
+
 /*
  * Fan Strings
  */
@@ -122,28 +132,50 @@ struct led_color {
 #define mk_eeprom(_label, _addr, _size, _flags)				\
 	mk_eeprom_psize(_label, _addr, _size, 1, _flags)
 
-#define mk_port_eeprom(_label, _addr, _size, _flags)			\
+/**
+ * mk_port_eeprom_psize - Create at24 platform data for an SFP port EEPROM.
+ * mk_qsfp_port_eeprom_psize - Create sff_8436 platform data for a QSFP
+ *              port EEPROM.
+ *
+ * @_label:     EEPROM label, e.g. port1
+ * @_addr:      i2c address
+ * @_size:      size of EEPROM in bytes
+ * @_page_size: write page size
+ * @_flags:     at24 or sff_8436 flags
+ *
+ * mk_port_eeprom() and mk_qsfp_port_eeprom() use SFP_PAGE_SIZE and
+ * QSFP_PAGE_SIZE, one byte per write.  Pass SFP_MULTI_PAGE_SIZE or
+ * QSFP_MULTI_PAGE_SIZE to opt a platform in to multi-byte writes.
+ */
+#define mk_port_eeprom_psize(_label, _addr, _size, _page_size, _flags)	\
 	struct eeprom_platform_data _label##_##_addr##_eeprom = {	\
 		.label = #_label,					\
 	};								\
 	struct at24_platform_data  _label##_##_addr##_at24 = {		\
 		.byte_len = _size,					\
 		.flags = _flags,					\
-		.page_size = 1,						\
+		.page_size = _page_size,				\
 		.eeprom_data = &_label##_##_addr##_eeprom,		\
 	}
 
-#define mk_qsfp_port_eeprom(_label, _addr, _size, _flags)		\
+#define mk_port_eeprom(_label, _addr, _size, _flags)			\
+	mk_port_eeprom_psize(_label, _addr, _size, SFP_PAGE_SIZE, _flags)
+
+#define mk_qsfp_port_eeprom_psize(_label, _addr, _size, _page_size, _flags) \
 	struct eeprom_platform_data _label##_##_addr##_qsfp_eeprom = {	\
 		.label = #_label,					\
 	};								\
 	struct sff_8436_platform_data _label##_##_addr##_sff8436 = {	\
 		.byte_len = _size,					\
 		.flags = _flags,					\
-		.page_size = 1,						\
+		.page_size = _page_size,				\
 		.eeprom_data = &_label##_##_addr##_qsfp_eeprom,		\
 	}
 
+#define mk_qsfp_port_eeprom(_label, _addr, _size, _flags)		\
+	mk_qsfp_port_eeprom_psize(_label, _addr, _size, QSFP_PAGE_SIZE,	\
+				  _flags)
+
 /*
  * Macros for making pca954x_platform_data definitions.
  *
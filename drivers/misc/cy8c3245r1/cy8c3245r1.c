@@ -33,6 +33,9 @@
 #include <linux/log2.h>
 #include <linux/kthread.h>
 #include <linux/slab.h>
+#include <linux/thermal.h>
+#include <linux/cumulus-thermal.h>
+#include <linux/cumulus-cy8c3245r1.h>
 
 /* cy8c3245r1 registers */
 #define CY8C3245R1_REG_BASE_ADDR			0x00
@@ -96,12 +99,12 @@ enum {
 #define CY8C3245R1_FW_REV_MAJ	0x02
 #define CY8C3245R1_FW_REV_MIN	0x03
 
+/* pwm1_enable value that hands the fans to the cooling device */
+#define CY8C3245R1_PWM_AUTO	2
+
 /* "all temps" according to hwmon sysfs interface spec */
 #define CY8C3245R1_PWM_ALL_TEMPS	0x3FF
 
-/* How often do we reread sensors values? (In jiffies) */
-#define SENSOR_REFRESH_INTERVAL	(5 * HZ)
-
 /* How often do we reread sensor limit values? (In jiffies) */
 #define LIMIT_REFRESH_INTERVAL	(60 * HZ)
 
@@ -111,10 +114,21 @@ enum {
 /* auto update thing won't fire more than every 2s */
 #define AUTO_UPDATE_INTERVAL	2000
 
+/* nor, when auto_update_interval is set to 0, more than every 100ms */
+#define AUTO_UPDATE_MIN_INTERVAL	100
+
 /* datasheet says to divide this number by the fan reading to get fan rpm */
 #define FAN_PERIOD_INVALID	65535
 #define FAN_DATA_VALID(x)	((x) && (x) != FAN_PERIOD_INVALID)
 
+struct cy8c3245r1_data;
+
+struct cy8c3245r1_tz {
+	struct cy8c3245r1_data	*data;
+	int			sensor;
+	struct cumulus_thermal	*ct;
+};
+
 struct cy8c3245r1_data {
 	struct i2c_client	*client;
 	struct mutex		lock;			/* Mutex Lock */
@@ -138,6 +152,13 @@ struct cy8c3245r1_data {
 	u8			force_pwm_max;
 	u8			pwm;
 	u8			pwm_automatic;
+	bool			block_read;
+	u8			pwm_min;
+	unsigned long		cooling_state;
+	char			cooling_type[THERMAL_NAME_LENGTH];
+	struct thermal_cooling_device *cdev;
+	struct cy8c3245r1_tz	*tz;
+	int			num_tz;
 	struct task_struct	*auto_update;
 	struct completion	auto_update_stop;
 	unsigned int		auto_update_interval;
@@ -146,32 +167,6 @@ struct cy8c3245r1_data {
 /*
  * 16-bit registers on the CY8C3245R1 are high-byte first.
  */
-static inline int cy8c3245r1_read_word_data(struct i2c_client *client, u8 reg)
-{
-	s32 rc;
-	u16 val;
-
-	/* read high byte */
-	rc = i2c_smbus_read_byte_data(client, reg);
-	if (rc < 0) {
-		dev_warn(&client->dev, "i2c read failed: 0x%02x, errno %d\n",
-			 reg, -rc);
-		return rc;
-	}
-	val = ((u16)rc & 0xFF) << 8;
-
-	/* read low byte */
-	rc = i2c_smbus_read_byte_data(client, reg + 1);
-	if (rc < 0) {
-		dev_warn(&client->dev, "i2c read failed: 0x%02x, errno %d\n",
-			 reg + 1, -rc);
-		return rc;
-	}
-	val |= (u16)rc & 0xFF;
-
-	return val;
-}
-
 static inline int cy8c3245r1_write_word_data(struct i2c_client *client,
 					     u8 reg,
 					     u16 value)
@@ -199,120 +194,371 @@ static inline int cy8c3245r1_write_word_data(struct i2c_client *client,
 	return rc;
 }
 
-/* Probe for temperature sensors.  Assumes lock is held */
-static int cy8c3245r1_read_temperatures(struct i2c_client *client,
-					struct cy8c3245r1_data *data)
+/*
+ * Read @len consecutive registers starting at @reg.  Uses one I2C block
+ * transfer when the adapter can do it and falls back to byte reads
+ * otherwise, or when the block transfer comes back short.
+ */
+static int cy8c3245r1_read_block(struct cy8c3245r1_data *data, u8 reg,
+				 u8 *buf, int len)
 {
+	struct i2c_client *client = data->client;
+	s32 rc;
 	int i;
 
-	/* Only count fans if we have to */
-	if (data->num_temp_sensors >= 0)
-		return 0;
+	if (data->block_read) {
+		rc = i2c_smbus_read_i2c_block_data(client, reg, len, buf);
+		if (rc == len)
+			return 0;
+	}
 
-	for (i = 0; i < CY8C3245R1_TEMP_COUNT; i++) {
-		data->temp[i] = i2c_smbus_read_byte_data(client,
-						CY8C3245R1_TEMP_REG(i));
-		if (data->temp[i])
-			data->num_temp_sensors = i + 1;
+	for (i = 0; i < len; i++) {
+		rc = i2c_smbus_read_byte_data(client, reg + i);
+		if (rc < 0) {
+			dev_warn_ratelimited(&client->dev,
+					     "i2c read failed: 0x%02x, errno %d\n",
+					     reg + i, -rc);
+			return rc;
+		}
+		buf[i] = rc;
 	}
-	data->temperatures_probed = 1;
+
 	return 0;
 }
 
-static int cy8c3245r1_update_thread(void *p)
+/*
+ * Temperatures and their limits, and the fan target and tachometers,
+ * are contiguous, so each is a single transfer.  The limits ride along
+ * with the readings since they cost no extra transaction.  Assumes lock
+ * is held.
+ */
+static int cy8c3245r1_read_sensors(struct cy8c3245r1_data *data)
 {
-	struct i2c_client *client = p;
-	struct cy8c3245r1_data *data = i2c_get_clientdata(client);
+	u8 temp[CY8C3245R1_TEMP_COUNT * 2];
+	u8 fan[2 + CY8C3245R1_FAN_COUNT * 2];
+	u8 pwm;
+	int i, rc;
+
+	rc = cy8c3245r1_read_block(data, CY8C3245R1_TEMP_REG(0), temp,
+				   sizeof(temp));
+	if (rc)
+		return rc;
 
-	while (!kthread_should_stop()) {
-		mutex_lock(&data->lock);
-		cy8c3245r1_read_temperatures(client, data);
-		mutex_unlock(&data->lock);
-		if (kthread_should_stop())
-			break;
-		msleep_interruptible(data->auto_update_interval);
+	rc = cy8c3245r1_read_block(data, CY8C3245R1_REG_FAN_TARGET, fan,
+				   sizeof(fan));
+	if (rc)
+		return rc;
+
+	rc = cy8c3245r1_read_block(data, CY8C3245R1_REG_PWM, &pwm, 1);
+	if (rc)
+		return rc;
+
+	for (i = 0; i < CY8C3245R1_TEMP_COUNT; i++) {
+		data->temp[i] = temp[i];
+		data->temp_max[i] = temp[CY8C3245R1_TEMP_COUNT + i];
 	}
 
-	complete_all(&data->auto_update_stop);
+	/* Probe for temperature sensors, only count them if we have to */
+	if (data->num_temp_sensors < 0) {
+		for (i = 0; i < CY8C3245R1_TEMP_COUNT; i++)
+			if (data->temp[i])
+				data->num_temp_sensors = i + 1;
+		data->temperatures_probed = 1;
+	}
+
+	data->fan_tgt = (fan[0] << 8) | fan[1];
+	for (i = 0; i < CY8C3245R1_FAN_COUNT; i++)
+		data->fan[i] = (fan[2 + i * 2] << 8) | fan[3 + i * 2];
+
+	data->pwm = pwm;
+
 	return 0;
 }
 
-static struct cy8c3245r1_data *cy8c3245r1_update_device(struct device *dev)
+/*
+ * Fan profile registers.  Every fan_max is the HIGH_RPM profile
+ * register, see CY8C3245R1_REG_FAN_MAX().  Assumes lock is held.
+ */
+static int cy8c3245r1_read_limits(struct cy8c3245r1_data *data)
 {
-	struct cy8c3245r1_data *data = dev_get_drvdata(dev);
-	struct i2c_client *client = data->client;
-	unsigned long local_jiffies = jiffies;
-	int i;
-	int need_sensors = 1;
-	int need_limits = 1;
+	u8 profile[CY8C3245R1_FAN_PROFILE_MAX * 2];
+	int i, rc;
 
-	/*
-	 * Figure out if we need to update the shadow registers.
-	 * Lockless means that we may occasionally report out of
-	 * date data.
-	 */
-	if (time_before(local_jiffies, data->sensors_last_updated +
-			SENSOR_REFRESH_INTERVAL) &&
-	    data->sensors_valid)
-		need_sensors = 0;
+	rc = cy8c3245r1_read_block(data, CY8C3245R1_REG_FAN_PROFILE(0),
+				   profile, sizeof(profile));
+	if (rc)
+		return rc;
+
+	for (i = 0; i < CY8C3245R1_FAN_PROFILE_MAX; i++)
+		data->fan_profile[i] = (profile[i * 2] << 8) |
+				       profile[i * 2 + 1];
+
+	for (i = 0; i < CY8C3245R1_FAN_COUNT; i++)
+		data->fan_max[i] =
+			data->fan_profile[CY8C3245R1_FAN_PROFILE_HIGH_RPM];
 
-	if (time_before(local_jiffies, data->limits_last_updated +
-			LIMIT_REFRESH_INTERVAL) &&
-	    data->limits_valid)
-		need_limits = 0;
+	return 0;
+}
 
-	if (!need_sensors && !need_limits)
-		return data;
+/*
+ * Refresh the shadow registers.  Sensors are read on every call, the
+ * fan profile once every LIMIT_REFRESH_INTERVAL.  A failed read keeps
+ * the previous values.
+ */
+static void cy8c3245r1_refresh(struct cy8c3245r1_data *data)
+{
+	unsigned long local_jiffies = jiffies;
 
 	mutex_lock(&data->lock);
-	if (!need_sensors)
-		goto no_sensor_update;
 
-	if (!data->temperatures_probed)
-		cy8c3245r1_read_temperatures(client, data);
-	else
-		for (i = 0; i < CY8C3245R1_TEMP_COUNT; i++)
-			data->temp[i] = i2c_smbus_read_byte_data(client,
-						CY8C3245R1_TEMP_REG(i));
+	if (!cy8c3245r1_read_sensors(data)) {
+		data->sensors_last_updated = local_jiffies;
+		data->sensors_valid = 1;
+	}
 
-	for (i = 0; i < CY8C3245R1_FAN_COUNT; i++) {
-		data->fan[i] = cy8c3245r1_read_word_data(client,
-						      CY8C3245R1_REG_FAN(i));
+	if ((!data->limits_valid ||
+	     time_after_eq(local_jiffies, data->limits_last_updated +
+			   LIMIT_REFRESH_INTERVAL)) &&
+	    !cy8c3245r1_read_limits(data)) {
+		data->limits_last_updated = local_jiffies;
+		data->limits_valid = 1;
 	}
 
-	data->pwm = i2c_smbus_read_byte_data(client,
-					CY8C3245R1_REG_PWM);
+	mutex_unlock(&data->lock);
+}
+
+/*
+ * Thermal cooling device.  The state is the PWM duty cycle, raised to
+ * pwm_min, and only reaches the fans while pwm1_enable is
+ * CY8C3245R1_PWM_AUTO.  Assumes lock is held.
+ */
+static int cy8c3245r1_apply_cooling(struct cy8c3245r1_data *data)
+{
+	u8 pwm = max_t(unsigned long, data->cooling_state, data->pwm_min);
+	int rc;
 
-	data->sensors_last_updated = local_jiffies;
-	data->sensors_valid = 1;
+	if (data->pwm_automatic < CY8C3245R1_PWM_AUTO || pwm == data->pwm)
+		return 0;
 
-no_sensor_update:
-	if (!need_limits)
-		goto out;
+	rc = i2c_smbus_write_byte_data(data->client, CY8C3245R1_REG_PWM, pwm);
+	if (rc < 0)
+		return rc;
+	data->pwm = pwm;
 
-	for (i = 0; i < CY8C3245R1_TEMP_COUNT; i++) {
-		data->temp_max[i] = i2c_smbus_read_byte_data(client,
-						CY8C3245R1_TEMP_MAX_REG(i));
+	return 0;
+}
+
+/*
+ * Automatic mode hands the fans to cooling_state, which stays 0 unless
+ * something drives it: a zone from platform data or a zone bound from
+ * elsewhere.  Without either, the fans would drop to pwm_min.
+ */
+static bool cy8c3245r1_cooling_bound(struct cy8c3245r1_data *data)
+{
+	return data->num_tz ||
+	       (data->cdev && !list_empty(&data->cdev->thermal_instances));
+}
+
+static int cy8c3245r1_get_max_state(struct thermal_cooling_device *cdev,
+				    unsigned long *state)
+{
+	*state = CY8C3245R1_COOLING_MAX_STATE;
+	return 0;
+}
+
+static int cy8c3245r1_get_cur_state(struct thermal_cooling_device *cdev,
+				    unsigned long *state)
+{
+	struct cy8c3245r1_data *data = cdev->devdata;
+
+	*state = READ_ONCE(data->cooling_state);
+	return 0;
+}
+
+static int cy8c3245r1_set_cur_state(struct thermal_cooling_device *cdev,
+				    unsigned long state)
+{
+	struct cy8c3245r1_data *data = cdev->devdata;
+	int rc;
+
+	if (state > CY8C3245R1_COOLING_MAX_STATE)
+		return -EINVAL;
+
+	mutex_lock(&data->lock);
+	data->cooling_state = state;
+	rc = cy8c3245r1_apply_cooling(data);
+	mutex_unlock(&data->lock);
+
+	return rc;
+}
+
+static const struct thermal_cooling_device_ops cy8c3245r1_cooling_ops = {
+	.get_max_state	= cy8c3245r1_get_max_state,
+	.get_cur_state	= cy8c3245r1_get_cur_state,
+	.set_cur_state	= cy8c3245r1_set_cur_state,
+};
+
+/*
+ * Thermal zones from platform data, one per sensor, registered through
+ * cumulus-thermal.  Each trip is bound to the cooling device with its
+ * PWM as both the lower and upper state, so step_wise jumps straight
+ * to the curve value when the trip is crossed and the highest crossed
+ * trip wins.
+ */
+static int cy8c3245r1_tz_get_temp(void *priv, int *temp)
+{
+	struct cy8c3245r1_tz *tz = priv;
+
+	if (!tz->data->sensors_valid)
+		return -EAGAIN;
+
+	*temp = 1000 * tz->data->temp[tz->sensor];
+	return 0;
+}
+
+static const struct cumulus_thermal_sensor_ops cy8c3245r1_tz_ops = {
+	.get_temp	= cy8c3245r1_tz_get_temp,
+};
+
+/*
+ * The thermal core polls the zones every cumulus-thermal poll_ms.  The
+ * update thread also evaluates them right after every sensor refresh,
+ * so the fans follow a new reading without waiting for that poll.
+ */
+static void cy8c3245r1_thermal_update(struct cy8c3245r1_data *data)
+{
+	int i;
+
+	for (i = 0; i < data->num_tz; i++)
+		cumulus_thermal_update(data->tz[i].ct);
+}
+
+static void cy8c3245r1_thermal_remove(struct cy8c3245r1_data *data)
+{
+	while (data->num_tz)
+		cumulus_thermal_del(data->tz[--data->num_tz].ct);
+
+	if (data->cdev)
+		thermal_cooling_device_unregister(data->cdev);
+	data->cdev = NULL;
+}
+
+static int cy8c3245r1_thermal_init(struct cy8c3245r1_data *data,
+				   const struct cy8c3245r1_platform_data *pdata)
+{
+	struct cumulus_thermal_trip trips[THERMAL_MAX_TRIPS];
+	struct i2c_client *client = data->client;
+	struct device *dev = &client->dev;
+	const struct cy8c3245r1_zone *zone;
+	struct thermal_cooling_device *cdev;
+	struct cumulus_thermal_desc desc;
+	struct cumulus_thermal *ct;
+	int num_zones = pdata ? pdata->num_zones : 0;
+	int i, j;
+
+	snprintf(data->cooling_type, sizeof(data->cooling_type),
+		 "cy8c3245r1-%d-%02x", i2c_adapter_id(client->adapter),
+		 client->addr);
+	cdev = thermal_cooling_device_register(data->cooling_type, data,
+					       &cy8c3245r1_cooling_ops);
+	if (IS_ERR(cdev)) {
+		if (!num_zones) {
+			dev_warn(dev, "no cooling device (%ld)\n",
+				 PTR_ERR(cdev));
+			return 0;
+		}
+		return PTR_ERR(cdev);
 	}
+	data->cdev = cdev;
 
-	for (i = 0; i < CY8C3245R1_FAN_COUNT; i++) {
-		data->fan_max[i] = cy8c3245r1_read_word_data(client,
-						CY8C3245R1_REG_FAN_MAX(i));
+	if (!num_zones)
+		return 0;
+
+	data->tz = devm_kcalloc(dev, num_zones, sizeof(*data->tz), GFP_KERNEL);
+	if (!data->tz) {
+		cy8c3245r1_thermal_remove(data);
+		return -ENOMEM;
 	}
-	data->fan_tgt = cy8c3245r1_read_word_data(client,
-					CY8C3245R1_REG_FAN_TARGET);
 
-	for (i = 0; i < CY8C3245R1_FAN_PROFILE_MAX; i++) {
-		data->fan_profile[i] = cy8c3245r1_read_word_data(client,
-					  CY8C3245R1_REG_FAN_PROFILE(i));
+	memset(&desc, 0, sizeof(desc));
+	desc.ops = &cy8c3245r1_tz_ops;
+	desc.trips = trips;
+	desc.cdev_type = data->cooling_type;
+	desc.governor = "step_wise";
+
+	for (i = 0; i < num_zones; i++) {
+		zone = &pdata->zones[i];
+		if (!zone->type ||
+		    zone->sensor < 0 || zone->sensor >= CY8C3245R1_TEMP_COUNT ||
+		    zone->num_trips <= 0 || zone->num_trips > THERMAL_MAX_TRIPS)
+			goto err_inval;
+
+		/* An upper state of 0 would bind the full range */
+		memset(trips, 0, sizeof(trips));
+		for (j = 0; j < zone->num_trips; j++) {
+			if (!zone->trips[j].pwm ||
+			    (j && zone->trips[j].temp < zone->trips[j - 1].temp))
+				goto err_inval;
+			trips[j].temp = zone->trips[j].temp;
+			trips[j].hyst = zone->trips[j].hyst;
+			trips[j].type = THERMAL_TRIP_ACTIVE;
+			trips[j].lower = zone->trips[j].pwm;
+			trips[j].upper = zone->trips[j].pwm;
+		}
+
+		data->tz[i].data = data;
+		data->tz[i].sensor = zone->sensor;
+		desc.type = zone->type;
+		desc.priv = &data->tz[i];
+		desc.num_trips = zone->num_trips;
+		ct = cumulus_thermal_add(dev, &desc);
+		if (IS_ERR(ct)) {
+			cy8c3245r1_thermal_remove(data);
+			return PTR_ERR(ct);
+		}
+		data->tz[i].ct = ct;
+		data->num_tz++;
 	}
 
-	data->limits_last_updated = local_jiffies;
-	data->limits_valid = 1;
+	dev_info(dev, "%s: %d thermal zones\n", data->cooling_type,
+		 data->num_tz);
 
-out:
-	mutex_unlock(&data->lock);
-	return data;
+	return 0;
+
+err_inval:
+	dev_err(dev, "invalid thermal zone %d\n", i);
+	cy8c3245r1_thermal_remove(data);
+	return -EINVAL;
+}
+
+static int cy8c3245r1_update_thread(void *p)
+{
+	struct i2c_client *client = p;
+	struct cy8c3245r1_data *data = i2c_get_clientdata(client);
+	unsigned int interval;
+
+	while (!kthread_should_stop()) {
+		cy8c3245r1_refresh(data);
+		cy8c3245r1_thermal_update(data);
+		if (kthread_should_stop())
+			break;
+		interval = READ_ONCE(data->auto_update_interval);
+		msleep_interruptible(max_t(unsigned int, interval,
+					   AUTO_UPDATE_MIN_INTERVAL));
+	}
+
+	complete_all(&data->auto_update_stop);
+	return 0;
+}
+
+/*
+ * The update thread keeps the shadow registers current, so readers
+ * never wait on the bus.  Lockless means that we may occasionally
+ * report out of date data.
+ */
+static struct cy8c3245r1_data *cy8c3245r1_update_device(struct device *dev)
+{
+	return dev_get_drvdata(dev);
 }
 
 static ssize_t show_auto_update_interval(struct device *dev,
@@ -337,9 +583,7 @@ static ssize_t set_auto_update_interval(struct device *dev,
 
 	temp = clamp_val(temp, 0, 60000);
 
-	mutex_lock(&data->lock);
-	data->auto_update_interval = temp;
-	mutex_unlock(&data->lock);
+	WRITE_ONCE(data->auto_update_interval, temp);
 
 	return count;
 }
@@ -598,6 +842,10 @@ static ssize_t set_pwm(struct device *dev, struct device_attribute *devattr,
 	temp = clamp_val(temp, 0, 255);
 
 	mutex_lock(&data->lock);
+	if (data->pwm_automatic >= CY8C3245R1_PWM_AUTO) {
+		mutex_unlock(&data->lock);
+		return -EBUSY;
+	}
 	data->pwm = temp;
 	i2c_smbus_write_byte_data(client, CY8C3245R1_REG_PWM, temp);
 	mutex_unlock(&data->lock);
@@ -687,7 +935,9 @@ static ssize_t set_pwm_auto(struct device *dev,
 			    const char *buf,
 			    size_t count)
 {
+	struct cy8c3245r1_data *data = dev_get_drvdata(dev);
 	long temp;
+	int rc;
 
 	if (kstrtol(buf, 10, &temp))
 		return -EINVAL;
@@ -695,7 +945,20 @@ static ssize_t set_pwm_auto(struct device *dev,
 	if (!(temp >= 0 && temp <= 3))
 		return -EINVAL;
 
-	return count;
+	/*
+	 * Nothing drives the cooling device, so automatic mode would drop
+	 * the fans to pwm_min.  Accept the write and leave the fans alone,
+	 * as this attribute always did.
+	 */
+	if (temp >= CY8C3245R1_PWM_AUTO && !cy8c3245r1_cooling_bound(data))
+		return count;
+
+	mutex_lock(&data->lock);
+	data->pwm_automatic = temp;
+	rc = cy8c3245r1_apply_cooling(data);
+	mutex_unlock(&data->lock);
+
+	return rc ? rc : count;
 }
 
 static ssize_t show_pwm_auto(struct device *dev,
@@ -715,20 +978,20 @@ static ssize_t show_debug(struct device *dev,
 			  char *buf)
 {
 	struct cy8c3245r1_data *data = dev_get_drvdata(dev);
-	struct i2c_client *client = data->client;
 	int len = 0, i, j;
-	u8  val;
+	u8  val[16];
 	int reg_count = (CY8C3245R1_REG_MAX - CY8C3245R1_REG_MIN) / 16;
 
 	for (i = 0; i < reg_count; i++) {
 		len += sprintf(buf + len, "0x%02x: ",
 			       CY8C3245R1_REG_MIN + (i * 16));
-		for (j = 0; j < 16; j++) {
-			val = i2c_smbus_read_byte_data(client,
-						       CY8C3245R1_REG_MIN
-						       + (i * 16) + j);
-			len += sprintf(buf + len, "%02x ", val);
-		}
+		mutex_lock(&data->lock);
+		if (cy8c3245r1_read_block(data, CY8C3245R1_REG_MIN + (i * 16),
+					  val, sizeof(val)))
+			memset(val, 0xff, sizeof(val));
+		mutex_unlock(&data->lock);
+		for (j = 0; j < 16; j++)
+			len += sprintf(buf + len, "%02x ", val[j]);
 		len += sprintf(buf + len, "\n");
 	}
 	return len;
@@ -999,9 +1262,11 @@ static void cy8c3245r1_init_client(struct i2c_client *client)
 static int cy8c3245r1_probe(struct i2c_client *client,
 			    const struct i2c_device_id *id)
 {
+	struct cy8c3245r1_platform_data *pdata = dev_get_platdata(&client->dev);
 	struct device *dev = &client->dev;
 	struct cy8c3245r1_data *data;
 	struct device *hwmon_dev;
+	int rc;
 
 	data = devm_kzalloc(dev, sizeof(struct cy8c3245r1_data), GFP_KERNEL);
 	if (!data)
@@ -1009,6 +1274,11 @@ static int cy8c3245r1_probe(struct i2c_client *client,
 
 	data->num_temp_sensors = -1;
 	data->auto_update_interval = AUTO_UPDATE_INTERVAL;
+	if (pdata) {
+		data->pwm_min = pdata->pwm_min;
+		if (pdata->num_zones)
+			data->pwm_automatic = CY8C3245R1_PWM_AUTO;
+	}
 
 	i2c_set_clientdata(client, data);
 	data->client = client;
@@ -1019,6 +1289,12 @@ static int cy8c3245r1_probe(struct i2c_client *client,
 	/* Initialize the CY8C3245R1 chip */
 	cy8c3245r1_init_client(client);
 
+	data->block_read = i2c_check_functionality(client->adapter,
+					I2C_FUNC_SMBUS_READ_I2C_BLOCK);
+
+	/* Fill the shadow registers before sysfs can read them */
+	cy8c3245r1_refresh(data);
+
 	/* Register sysfs hooks */
 	hwmon_dev = devm_hwmon_device_register_with_groups(dev, client->name,
 							   data,
@@ -1027,11 +1303,17 @@ static int cy8c3245r1_probe(struct i2c_client *client,
 	if (IS_ERR(hwmon_dev))
 		return PTR_ERR(hwmon_dev);
 
+	rc = cy8c3245r1_thermal_init(data, pdata);
+	if (rc)
+		return rc;
+
 	init_completion(&data->auto_update_stop);
 	data->auto_update = kthread_run(cy8c3245r1_update_thread, client, "%s",
 					dev_name(hwmon_dev));
-	if (IS_ERR(data->auto_update))
+	if (IS_ERR(data->auto_update)) {
+		cy8c3245r1_thermal_remove(data);
 		return PTR_ERR(data->auto_update);
+	}
 
 	return 0;
 }
@@ -1042,6 +1324,7 @@ static int cy8c3245r1_remove(struct i2c_client *client)
 
 	kthread_stop(data->auto_update);
 	wait_for_completion(&data->auto_update_stop);
+	cy8c3245r1_thermal_remove(data);
 	return 0;
 }
 
@@ -536,7 +536,7 @@ static struct i2c_board_info *alloc_qsfp_board_info(int port) {
 
      sff8436_data->byte_len = 256;
      sff8436_data->flags = SFF_8436_FLAG_IRUGO;
-     sff8436_data->page_size = 1;
+     sff8436_data->page_size = QSFP_PAGE_SIZE;
      sff8436_data->eeprom_data = eeprom_data;
 
      strcpy(board_info->type, "sff8436");
@@ -30,7 +30,7 @@
 #include "dell-s6100-smf.h"
 #include "dell-s6100-16x40G.h"
 
-#define DRIVER_VERSION "1.0"
+#define DRIVER_VERSION "1.1"
 
 /**
  * s6100_smf_ids -- driver alias names
@@ -281,6 +281,34 @@ get_gpio_type(int offset) {
 		return offset / S6100_16X40G_NUM_QSFPP;
 }
 
+/**
+ * get_gpio_reg()
+ * @offset: GPIO number
+ * @reg:    CPLD register holding the GPIO [out]
+ * @bit:    bit of the GPIO in @reg [out]
+ *
+ * Given a GPIO return its 'type' and locate it in the CPLD registers.
+ * The per-port GPIOs of one type are packed eight to a register, so
+ * consecutive GPIO numbers share a register.
+ */
+static int
+get_gpio_reg(int offset, int *reg, int *bit)
+{
+	int gpio_type = get_gpio_type(offset);
+	int gpio_index;
+
+	*reg = gpio_data[gpio_type].reg;
+	if (gpio_type == MODULE_BEACON_GPIO_TYPE) {
+		*bit = gpio_data[gpio_type].bit;
+	} else {
+		gpio_index = offset % S6100_16X40G_NUM_QSFPP;
+		*reg += gpio_index / S6100_16X40G_GPIOS_PER_REG;
+		*bit = gpio_index % S6100_16X40G_GPIOS_PER_REG;
+	}
+
+	return gpio_type;
+}
+
 /**
  * cpld_gpio_get_direction()
  *
@@ -373,15 +401,9 @@ cpld_gpio_get(struct gpio_chip *chip, unsigned offset)
 		return -EINVAL;
 	}
 
-	gpio_type = get_gpio_type(offset);
-	reg_offset = gpio_data[gpio_type].reg;
-	if (gpio_type == MODULE_BEACON_GPIO_TYPE) {
-		bit_offset = gpio_data[gpio_type].bit;
-	} else {
+	gpio_type = get_gpio_reg(offset, &reg_offset, &bit_offset);
+	if (gpio_type != MODULE_BEACON_GPIO_TYPE)
 		gpio_index = offset % S6100_16X40G_NUM_QSFPP;
-		reg_offset += gpio_index / S6100_16X40G_GPIOS_PER_REG;
-		bit_offset = gpio_index % S6100_16X40G_GPIOS_PER_REG;
-	}
 
 	rc = cpld_reg_rd(priv->map, reg_offset, &val);
 	if (rc)
@@ -420,16 +442,9 @@ static void cpld_gpio_set(struct gpio_chip *chip, unsigned offset, int value)
 		return;
 	}
 
-	gpio_type  = offset / S6100_16X40G_NUM_QSFPP;
-	reg_offset = gpio_data[gpio_type].reg;
-
-	if (gpio_type == MODULE_BEACON_GPIO_TYPE) {
-		bit_offset = gpio_data[gpio_type].bit;
-	} else {
+	gpio_type = get_gpio_reg(offset, &reg_offset, &bit_offset);
+	if (gpio_type != MODULE_BEACON_GPIO_TYPE)
 		gpio_index = offset % S6100_16X40G_NUM_QSFPP;
-		reg_offset += gpio_index / S6100_16X40G_GPIOS_PER_REG;
-		bit_offset = gpio_index % S6100_16X40G_GPIOS_PER_REG;
-	}
 
 	if (gpio_data[gpio_type].flags & GPIOF_DIR_IN) {
 		dev_warn(&priv->pdev->dev,
@@ -461,6 +476,100 @@ static void cpld_gpio_set(struct gpio_chip *chip, unsigned offset, int value)
 		 gpio_type, gpio_index, reg_offset, bit_offset, reg_val);
 }
 
+/**
+ * cpld_gpio_get_multiple()
+ *
+ * gpio_chip driver interface callback. Returns the current values of
+ * the GPIO signals in @mask in @bits, reading each CPLD register once.
+ */
+static int
+cpld_gpio_get_multiple(struct gpio_chip *chip, unsigned long *mask,
+		       unsigned long *bits)
+{
+	struct s6100_16x40G_drv_priv *priv = to_cpld_gpio(chip);
+	int cur_reg = -1;
+	int gpio_type;
+	int reg_offset;
+	int bit_offset;
+	uint8_t val = 0;
+	int offset;
+	int rc;
+
+	for_each_set_bit(offset, mask, S6100_16X40G_NUM_GPIOS) {
+		gpio_type = get_gpio_reg(offset, &reg_offset, &bit_offset);
+		if (reg_offset != cur_reg) {
+			rc = cpld_reg_rd(priv->map, reg_offset, &val);
+			if (rc)
+				return rc;
+			cur_reg = reg_offset;
+		}
+
+		rc = val & BIT(bit_offset) ? 1 : 0;
+		if (gpio_data[gpio_type].flags & GPIOF_ACTIVE_LOW)
+			rc = !rc;
+		if (rc)
+			set_bit(offset, bits);
+		else
+			clear_bit(offset, bits);
+	}
+
+	return 0;
+}
+
+/**
+ * cpld_gpio_set_multiple()
+ *
+ * gpio_chip driver interface callback. Sets the output GPIO signals
+ * in @mask to the values in @bits, with one read/modify/write per CPLD
+ * register.
+ */
+static void
+cpld_gpio_set_multiple(struct gpio_chip *chip, unsigned long *mask,
+		       unsigned long *bits)
+{
+	struct s6100_16x40G_drv_priv *priv = to_cpld_gpio(chip);
+	int cur_reg = -1;
+	int gpio_type;
+	int reg_offset;
+	int bit_offset;
+	uint8_t reg_val = 0;
+	int offset;
+	int value;
+	int rc;
+
+	mutex_lock(&priv->gpio_lock);
+	for_each_set_bit(offset, mask, S6100_16X40G_NUM_GPIOS) {
+		gpio_type = get_gpio_reg(offset, &reg_offset, &bit_offset);
+		if (gpio_data[gpio_type].flags & GPIOF_DIR_IN) {
+			dev_warn(&priv->pdev->dev,
+				 "Ignoring request to write read-only GPIO: %u",
+				 offset);
+			continue;
+		}
+
+		if (reg_offset != cur_reg) {
+			if (cur_reg >= 0)
+				cpld_reg_wr(priv->map, cur_reg, reg_val);
+			rc = cpld_reg_rd(priv->map, reg_offset, &reg_val);
+			if (rc) {
+				cur_reg = -1;
+				break;
+			}
+			cur_reg = reg_offset;
+		}
+
+		value = test_bit(offset, bits);
+		if (gpio_data[gpio_type].flags & GPIOF_ACTIVE_LOW)
+			value = !value;
+		reg_val &= ~BIT(bit_offset);
+		if (value)
+			reg_val |= BIT(bit_offset);
+	}
+	if (cur_reg >= 0)
+		cpld_reg_wr(priv->map, cur_reg, reg_val);
+	mutex_unlock(&priv->gpio_lock);
+}
+
 /**
  * init_optical_i2c()
  * @priv: 16x40G private driver data
@@ -533,7 +642,7 @@ static int init_optical_i2c(struct s6100_16x40G_drv_priv *priv, int bus)
 		qsfp->eeprom_pdata.label = qsfp->eeprom_label;
 		qsfp->sff8436_pdata.byte_len = 256;
 		qsfp->sff8436_pdata.flags = SFF_8436_FLAG_IRUGO;
-		qsfp->sff8436_pdata.page_size = 1;
+		qsfp->sff8436_pdata.page_size = QSFP_PAGE_SIZE;
 		qsfp->sff8436_pdata.eeprom_data = &qsfp->eeprom_pdata;
 		strncpy(qsfp->sff8436_info.type, "sff8436",
 			sizeof(qsfp->sff8436_info.type) - 1);
@@ -801,7 +910,9 @@ static int s6100_16x40G_probe(struct platform_device *pdev)
 	priv->gpio_ctrl.direction_input = cpld_gpio_direction_input;
 	priv->gpio_ctrl.direction_output = cpld_gpio_direction_output;
 	priv->gpio_ctrl.get = cpld_gpio_get;
+	priv->gpio_ctrl.get_multiple = cpld_gpio_get_multiple;
 	priv->gpio_ctrl.set = cpld_gpio_set;
+	priv->gpio_ctrl.set_multiple = cpld_gpio_set_multiple;
 	priv->gpio_ctrl.base = S6100_MODULE_GPIO_CTRL_BASE +
 		(S6100_GPIO_PER_MODULE * pdev->id);
 	priv->gpio_ctrl.ngpio = S6100_16X40G_NUM_GPIOS;
@@ -24,7 +24,7 @@
 #include "dell-s6100-smf.h"
 #include "dell-s6100-smf-fan.h"
 
-#define DRIVER_VERSION "1.0"
+#define DRIVER_VERSION "1.2"
 
 #define MAX_FAN_TRAY_FRU_NAME_LEN  (10)
 
@@ -32,7 +32,9 @@
  * struct s6100_smf_fan_drv_priv -- private driver data
  * @pdev:            Parent platform device
  * @smf_mb_map:      smf mailbox regmap
+ * @smf_mb_snap:     smf mailbox sensor snapshot
  * @num_fans:        number of fans on this tray
+ * @vpd_present:     tray presence the cached VPD belongs to
  * @name:            human readable name
  * @fan_attr_group:  attribute group for fan objects
  * @fan_attr_groups: array of attribute groups for fan objects
@@ -42,7 +44,9 @@
 struct s6100_smf_fan_drv_priv {
 	struct platform_device         *pdev;
 	struct regmap                  *smf_mb_map;
+	struct smf_mb_snapshot         *smf_mb_snap;
 	uint8_t                         num_fans;
+	int                             vpd_present;
 	char                            name[MAX_FAN_TRAY_FRU_NAME_LEN];
 	struct attribute_group          fan_attr_group;
 	const struct attribute_group   *fan_attr_groups[2];
@@ -72,10 +76,10 @@ static ssize_t smf_mb_fan_speed_show(struct device *dev,
 	uint16_t fan_speed;
 	int rc;
 
-	rc = smf_mb_reg_rd16(priv->smf_mb_map,
-			     S6100_SMF_MB_FAN_TRAY_SPEED_BASE +
-			     S6100_SMF_MB_FAN_TRAY_SPEED_OFFSET * priv->pdev->id +
-			     2 * fan_num, &fan_speed);
+	rc = smf_mb_snap_rd16(priv->smf_mb_snap,
+			      S6100_SMF_MB_FAN_TRAY_SPEED_BASE +
+			      S6100_SMF_MB_FAN_TRAY_SPEED_OFFSET * priv->pdev->id +
+			      2 * fan_num, &fan_speed);
 	if (rc)
 		return rc;
 
@@ -101,8 +105,8 @@ static ssize_t smf_mb_fan_ok_show(struct device *dev,
 	uint16_t fan_mask = BIT(priv->pdev->id * priv->num_fans + fan_num);
 	int rc;
 
-	rc = smf_mb_reg_rd16(priv->smf_mb_map,
-			     S6100_SMF_MB_FAN_STATUS, &fan_status);
+	rc = smf_mb_snap_rd16(priv->smf_mb_snap,
+			      S6100_SMF_MB_FAN_STATUS, &fan_status);
 	if (rc)
 		return rc;
 
@@ -144,8 +148,8 @@ static ssize_t smf_mb_fan_present_show(struct device *dev,
 	uint8_t fan_mask = BIT(priv->pdev->id);
 	int rc;
 
-	rc = smf_mb_reg_rd(priv->smf_mb_map,
-			   S6100_SMF_MB_FAN_TRAYS_PRESENT, &fan_present);
+	rc = smf_mb_snap_rd(priv->smf_mb_snap,
+			    S6100_SMF_MB_FAN_TRAYS_PRESENT, &fan_present);
 	if (rc)
 		return rc;
 
@@ -167,13 +171,26 @@ static ssize_t smf_mb_fan_f2b_show(struct device *dev,
 	uint8_t fan_mask = BIT(priv->pdev->id);
 	int rc;
 
-	rc = smf_mb_reg_rd(priv->smf_mb_map, S6100_SMF_MB_FAN_TRAYS_F2B, &fan_f2b);
+	rc = smf_mb_snap_rd(priv->smf_mb_snap, S6100_SMF_MB_FAN_TRAYS_F2B, &fan_f2b);
 	if (rc)
 		return rc;
 
 	return snprintf(buf, PAGE_SIZE, "%d\n", (fan_f2b & fan_mask) ? 1 : 0);
 }
 
+/**
+ * smf_mb_fan_vpd_sync -- drop the cached VPD of a swapped fan tray
+ */
+static int smf_mb_fan_vpd_sync(struct s6100_smf_fan_drv_priv *priv)
+{
+	return smf_mb_fru_sync(priv->smf_mb_map,
+			       S6100_SMF_MB_FAN_TRAYS_PRESENT,
+			       BIT(priv->pdev->id), &priv->vpd_present,
+			       S6100_SMF_MB_FAN_TRAY1_SERIAL_NUM +
+			       priv->pdev->id * S6100_SMF_MB_FAN_TRAY_VPD_OFFSET,
+			       S6100_SMF_MB_FAN_TRAY_VPD_OFFSET);
+}
+
 /**
  * smf_mb_fan_mfg_date_show -- decode the manufacturing date register
  *
@@ -188,6 +205,10 @@ static ssize_t smf_mb_fan_mfg_date_show(struct device *dev,
 	uint16_t reg = S6100_SMF_MB_FAN_TRAY1_MFG_DATE;
 	int rc;
 
+	rc = smf_mb_fan_vpd_sync(priv);
+	if (rc)
+		return rc;
+
 	reg += priv->pdev->id * S6100_SMF_MB_FAN_TRAY_VPD_OFFSET;
 	rc = smf_mb_reg_rd_array(priv->smf_mb_map, reg, mfg_date,
 				 S6100_SMF_MB_FAN_TRAY_MFG_DATE_SIZE);
@@ -237,6 +258,10 @@ static ssize_t smf_mb_fan_string_show(struct device *dev,
 		return -EINVAL;
 	};
 
+	rc = smf_mb_fan_vpd_sync(priv);
+	if (rc)
+		return rc;
+
 	base_reg += priv->pdev->id * S6100_SMF_MB_FAN_TRAY_VPD_OFFSET;
 	rc = smf_mb_reg_rd_array(priv->smf_mb_map, base_reg, str, len);
 	if (rc)
@@ -364,6 +389,8 @@ static int s6100_smf_fan_probe(struct platform_device *pdev)
 
 	priv->pdev = pdev;
 	priv->smf_mb_map = pdata->smf_mb_map;
+	priv->smf_mb_snap = pdata->smf_mb_snap;
+	priv->vpd_present = -1;
 	platform_set_drvdata(pdev, (void *)priv);
 
 	/* Human readable name */
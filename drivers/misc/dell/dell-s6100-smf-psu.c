@@ -24,7 +24,7 @@
 #include "dell-s6100-smf.h"
 #include "dell-s6100-smf-psu.h"
 
-#define DRIVER_VERSION "1.0"
+#define DRIVER_VERSION "1.2"
 
 #define MAX_PSU_FRU_NAME_LEN  (10)
 
@@ -32,6 +32,8 @@
  * struct s6100_smf_psu_drv_priv -- private driver data
  * @pdev:            Parent platform device
  * @smf_mb_map:      smf mailbox regmap
+ * @smf_mb_snap:     smf mailbox sensor snapshot
+ * @vpd_present:     PSU presence the cached VPD belongs to
  * @name:            human readable name
  * @psu_attr_group:  attribute group for psu objects
  * @psu_attr_groups: array of attribute groups for psu objects
@@ -41,6 +43,8 @@
 struct s6100_smf_psu_drv_priv {
 	struct platform_device         *pdev;
 	struct regmap                  *smf_mb_map;
+	struct smf_mb_snapshot         *smf_mb_snap;
+	int                             vpd_present;
 	char                            name[MAX_PSU_FRU_NAME_LEN];
 };
 
@@ -91,7 +95,7 @@ static ssize_t smf_mb_psu_present_show(struct device *dev,
 	int rc;
 
 	reg += S6100_SMF_MB_PSU_OFFSET * priv->pdev->id;
-	rc = smf_mb_reg_rd(priv->smf_mb_map, reg, &psu_status);
+	rc = smf_mb_snap_rd(priv->smf_mb_snap, reg, &psu_status);
 	if (rc)
 		return rc;
 
@@ -117,7 +121,7 @@ static ssize_t smf_mb_psu_input_ok_show(struct device *dev,
 	/* Read input voltage */
 	reg = S6100_SMF_MB_PSU1_INPUT_VOLT;
 	reg += S6100_SMF_MB_PSU_OFFSET * priv->pdev->id;
-	rc = smf_mb_reg_rd(priv->smf_mb_map, reg, &psu_val);
+	rc = smf_mb_snap_rd(priv->smf_mb_snap, reg, &psu_val);
 	if (rc)
 		input_bad++;
 	if (psu_val == 0x0)
@@ -126,7 +130,7 @@ static ssize_t smf_mb_psu_input_ok_show(struct device *dev,
 	/* Read input power */
 	reg = S6100_SMF_MB_PSU1_INPUT_POWER;
 	reg += S6100_SMF_MB_PSU_OFFSET * priv->pdev->id;
-	rc = smf_mb_reg_rd(priv->smf_mb_map, reg, &psu_val);
+	rc = smf_mb_snap_rd(priv->smf_mb_snap, reg, &psu_val);
 	if (rc)
 		input_bad++;
 	if (psu_val == 0x0)
@@ -151,7 +155,7 @@ static ssize_t smf_mb_psu_f2b_show(struct device *dev,
 	int rc;
 
 	reg += S6100_SMF_MB_PSU_OFFSET * priv->pdev->id;
-	rc = smf_mb_reg_rd(priv->smf_mb_map, reg, &psu_fan_status);
+	rc = smf_mb_snap_rd(priv->smf_mb_snap, reg, &psu_fan_status);
 	if (rc)
 		return rc;
 
@@ -159,6 +163,22 @@ static ssize_t smf_mb_psu_f2b_show(struct device *dev,
 			(psu_fan_status & PSU_FAN_STATUS_F2B) ? 1 : 0);
 }
 
+/**
+ * smf_mb_psu_vpd_sync
+ *
+ * drop the cached VPD of a swapped PSU
+ */
+static int smf_mb_psu_vpd_sync(struct s6100_smf_psu_drv_priv *priv)
+{
+	unsigned int offset = S6100_SMF_MB_PSU_OFFSET * priv->pdev->id;
+
+	return smf_mb_fru_sync(priv->smf_mb_map,
+			       S6100_SMF_MB_PSU1_STATUS + offset,
+			       PSU_STATUS_PRESENT_L, &priv->vpd_present,
+			       S6100_SMF_MB_PSU1_COUNTY_CODE + offset,
+			       S6100_SMF_MB_PSU_VPD_SIZE);
+}
+
 /**
  * smf_mb_psu_string_show
  *
@@ -205,6 +225,10 @@ static ssize_t smf_mb_psu_string_show(struct device *dev,
 		return -EINVAL;
 	};
 
+	rc = smf_mb_psu_vpd_sync(priv);
+	if (rc)
+		return rc;
+
 	reg += S6100_SMF_MB_PSU_OFFSET * priv->pdev->id;
 	rc = smf_mb_reg_rd_array(priv->smf_mb_map, reg, str, len);
 	if (rc)
@@ -262,7 +286,7 @@ static ssize_t smf_mb_psu_temp_show(struct device *dev,
 	int rc;
 
 	reg += S6100_SMF_MB_PSU_OFFSET * priv->pdev->id;
-	rc = smf_mb_reg_rd16(priv->smf_mb_map, reg, &temp);
+	rc = smf_mb_snap_rd16(priv->smf_mb_snap, reg, &temp);
 	if (rc)
 		return rc;
 
@@ -316,7 +340,7 @@ static ssize_t smf_mb_psu_fan_speed_show(struct device *dev,
 	int rc;
 
 	reg += S6100_SMF_MB_PSU_OFFSET * priv->pdev->id;
-	rc = smf_mb_reg_rd16(priv->smf_mb_map, reg, &rpm);
+	rc = smf_mb_snap_rd16(priv->smf_mb_snap, reg, &rpm);
 	if (rc)
 		return rc;
 
@@ -341,7 +365,7 @@ static ssize_t smf_mb_psu_fan_ok_show(struct device *dev,
 	int rc;
 
 	reg += S6100_SMF_MB_PSU_OFFSET * priv->pdev->id;
-	rc = smf_mb_reg_rd(priv->smf_mb_map, reg, &status);
+	rc = smf_mb_snap_rd(priv->smf_mb_snap, reg, &status);
 	if (rc)
 		return rc;
 
@@ -364,7 +388,7 @@ static ssize_t smf_mb_psu_voltage_show(struct device *dev,
 	int rc;
 
 	reg += S6100_SMF_MB_PSU_OFFSET * priv->pdev->id;
-	rc = smf_mb_reg_rd16(priv->smf_mb_map, reg, &voltage);
+	rc = smf_mb_snap_rd16(priv->smf_mb_snap, reg, &voltage);
 	if (rc)
 		return rc;
 
@@ -395,7 +419,7 @@ static ssize_t smf_mb_psu_current_show(struct device *dev,
 	int rc;
 
 	reg += S6100_SMF_MB_PSU_OFFSET * priv->pdev->id;
-	rc = smf_mb_reg_rd16(priv->smf_mb_map, reg, &amp);
+	rc = smf_mb_snap_rd16(priv->smf_mb_snap, reg, &amp);
 	if (rc)
 		return rc;
 
@@ -426,7 +450,7 @@ static ssize_t smf_mb_psu_power_show(struct device *dev,
 	int rc;
 
 	reg += S6100_SMF_MB_PSU_OFFSET * priv->pdev->id;
-	rc = smf_mb_reg_rd16(priv->smf_mb_map, reg, &power);
+	rc = smf_mb_snap_rd16(priv->smf_mb_snap, reg, &power);
 	if (rc)
 		return rc;
 
@@ -509,6 +533,8 @@ static int s6100_smf_psu_probe(struct platform_device *pdev)
 
 	priv->pdev = pdev;
 	priv->smf_mb_map = pdata->smf_mb_map;
+	priv->smf_mb_snap = pdata->smf_mb_snap;
+	priv->vpd_present = -1;
 	platform_set_drvdata(pdev, (void *)priv);
 
 	/* Human readable name */
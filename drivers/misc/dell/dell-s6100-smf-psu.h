@@ -23,6 +23,7 @@
 
 struct s6100_smf_psu_platform_data {
 	struct regmap          *smf_mb_map;
+	struct smf_mb_snapshot *smf_mb_snap;
 };
 
 #endif /* S6100_SMF_PSU_H */
@@ -122,6 +122,35 @@ smf_mb_reg_wr(struct regmap *smf_mb_map, unsigned int reg, uint8_t val)
 	return rc;
 }
 
+/**
+ * smf_mb_reg_rd_array(): Read N 8-bit smf mailbox registers
+ *
+ * @smf_mb_map: regmap configured for the smf mailbox registers
+ * @reg: base register offset
+ * @val: storage to hold register data
+ * @len: length of @val array in bytes
+ *
+ * Read @len consecutive 8-bit smf mailbox registers and return the
+ * result in @val.  The mailbox regmap streams the bytes through the
+ * data register, programming the address registers only when it has
+ * to.
+ *
+ * A value of zero will be returned on success, a negative errno will
+ * be returned in error cases.
+ */
+static inline int
+smf_mb_reg_rd_array(struct regmap *smf_mb_map, unsigned int reg,
+		    uint8_t *val, size_t len)
+{
+	int rc;
+
+	rc = regmap_bulk_read(smf_mb_map, reg, val, len);
+	WARN(rc, "regmap_bulk_read(smf_mb_map, 0x%x,..., %zu) failed: (%i)\n",
+	     reg, len, rc);
+
+	return rc;
+}
+
 /**
  * smf_mb_reg_rd16(): Read 16-bit smf mailbox register
  *
@@ -129,8 +158,8 @@ smf_mb_reg_wr(struct regmap *smf_mb_map, unsigned int reg, uint8_t val)
  * @reg: register offset
  * @val: pointer to hold 16-bit register read value
  *
- * Read two consecutive 8-bit smf mailbox registers and return the
- * 16-bit result in @val.
+ * Read two consecutive 8-bit smf mailbox registers, most significant
+ * byte first, in one bulk read and return the 16-bit result in @val.
  *
  * A value of zero will be returned on success, a negative errno will
  * be returned in error cases.
@@ -138,49 +167,57 @@ smf_mb_reg_wr(struct regmap *smf_mb_map, unsigned int reg, uint8_t val)
 static inline int
 smf_mb_reg_rd16(struct regmap *smf_mb_map, unsigned int reg, uint16_t *val)
 {
+	uint8_t buf[2];
 	int rc;
-	uint8_t val1, val2;
-
-	rc = smf_mb_reg_rd(smf_mb_map, reg, &val1);
-	if (rc)
-		return rc;
 
-	rc = smf_mb_reg_rd(smf_mb_map, reg + 1, &val2);
+	rc = smf_mb_reg_rd_array(smf_mb_map, reg, buf, sizeof(buf));
 	if (rc)
 		return rc;
 
-	*val = ((val1 & 0xFF) << 8) | (val2 & 0xFF);
+	*val = (buf[0] << 8) | buf[1];
 	return rc;
 }
 
 /**
- * smf_mb_reg_rd_array(): Read N 8-bit smf mailbox registers
+ * smf_mb_fru_sync(): Drop cached FRU VPD after a presence change
  *
  * @smf_mb_map: regmap configured for the smf mailbox registers
- * @reg: base register offset
- * @val: storage to hold register data
- * @len: length of @val array in bytes
+ * @reg: presence register
+ * @mask: presence bit in @reg, active low
+ * @present: presence seen by the last call, -1 before the first one
+ * @base: first VPD register of the FRU
+ * @len: number of VPD registers of the FRU
  *
- * Read @len consecutive 8-bit smf mailbox registers and return the
- * result in @val.
+ * The fan tray and PSU VPD ranges of the mailbox are cached.  Call
+ * this before reading them: it reads the volatile presence register
+ * and drops the VPD of the FRU from the cache whenever the presence
+ * differs from @present, so a swapped FRU is read again.
  *
  * A value of zero will be returned on success, a negative errno will
  * be returned in error cases.
  */
 static inline int
-smf_mb_reg_rd_array(struct regmap *smf_mb_map, unsigned int reg,
-		    uint8_t *val, size_t len)
+smf_mb_fru_sync(struct regmap *smf_mb_map, unsigned int reg, uint8_t mask,
+		int *present, unsigned int base, size_t len)
 {
-	int rc = 0;
-	int i;
+	uint8_t val;
+	int now;
+	int rc;
+
+	rc = smf_mb_reg_rd(smf_mb_map, reg, &val);
+	if (rc)
+		return rc;
 
-	for (i = 0; i < len; i++) {
-		rc = smf_mb_reg_rd(smf_mb_map, reg + i, val++);
-		if (rc)
-			return rc;
-	}
+	now = (val & mask) ? 0 : 1;
+	if (now == READ_ONCE(*present))
+		return 0;
 
-	return rc;
+	rc = regcache_drop_region(smf_mb_map, base, base + len - 1);
+	if (rc)
+		return rc;
+	WRITE_ONCE(*present, now);
+
+	return 0;
 }
 
 #define S6100_SMF_IO_BASE 0x200
@@ -315,6 +352,11 @@ smf_mb_reg_rd_array(struct regmap *smf_mb_map, unsigned int reg,
 	(S6100_SMF_MB_PSU1_LABEL_REV +	   \
 	 S6100_SMF_MB_PSU_LABEL_REV_SIZE - \
 	 S6100_SMF_MB_PSU_BASE)
+#define S6100_SMF_MB_NUM_FAN_TRAYS		8
+#define S6100_SMF_MB_PSU_VPD_SIZE		   \
+	(S6100_SMF_MB_PSU1_LABEL_REV +		   \
+	 S6100_SMF_MB_PSU_LABEL_REV_SIZE -	   \
+	 S6100_SMF_MB_PSU1_COUNTY_CODE)
 #define S6100_SMF_MB_MAX_STRING_SIZE \
 	(S6100_SMF_MB_FAN_TRAY_SERIAL_NUM_SIZE + 1)
 
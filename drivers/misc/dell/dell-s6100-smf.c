@@ -23,7 +23,11 @@
 #include <linux/gpio.h>
 #include <linux/gpio/machine.h>
 #include <linux/delay.h>
+#include <linux/mutex.h>
+#include <linux/jiffies.h>
+#include <linux/string.h>
 #include <linux/cumulus-platform.h>
+#include <linux/cumulus-thermal.h>
 
 #include "platform-defs.h"
 #include "dell-s6100-platform.h"
@@ -31,7 +35,22 @@
 #include "dell-s6100-smf-fan.h"
 #include "dell-s6100-smf-psu.h"
 
-#define DRIVER_VERSION "1.0"
+#define DRIVER_VERSION "1.7"
+
+static bool mb_stream = true;
+module_param(mb_stream, bool, 0444);
+MODULE_PARM_DESC(mb_stream,
+		 "Probe for SMF mailbox address auto-increment and stream bulk reads (default true)");
+
+static unsigned int snapshot_ms = 1000;
+module_param(snapshot_ms, uint, 0444);
+MODULE_PARM_DESC(snapshot_ms,
+		 "Lifetime in ms of the SMF sensor snapshot, 0 reads every sensor directly (default 1000)");
+
+static bool thermal_zones;
+module_param(thermal_zones, bool, 0444);
+MODULE_PARM_DESC(thermal_zones,
+		 "Register the SMF temperature sensors as thermal zones for monitoring only: the SMF firmware owns the fans, so no cooling device is bound, and crossing the major alarm limit is only logged (default false)");
 
 /**
  * s6100_smf_ids -- driver alias names
@@ -44,6 +63,20 @@ MODULE_DEVICE_TABLE(platform, s6100_smf_ids);
 
 #define MAX_SMF_DEV_NAME_LEN  (20)
 
+struct s6100_smf_drv_priv;
+
+/**
+ * struct smf_thermal_sensor
+ * @priv:  private driver data
+ * @index: temperature sensor index
+ * @ct:    thermal zone object
+ */
+struct smf_thermal_sensor {
+	struct s6100_smf_drv_priv *priv;
+	int                        index;
+	struct cumulus_thermal    *ct;
+};
+
 /**
  * struct module_cpld_i2c_data
  * @eeprom_label: EEPROM class label for at24 device
@@ -69,12 +102,260 @@ struct module_cpld_i2c_data {
 	struct i2c_client *cpld_client;
 };
 
+/*
+ * What reading the mailbox data register does to the address
+ * registers, found by smf_mb_addr_mode_probe().
+ */
+enum {
+	SMF_MB_ADDR_UNKNOWN = 0,
+	SMF_MB_ADDR_FIXED,
+	SMF_MB_ADDR_AUTOINC,
+};
+
+/**
+ * struct smf_mb_bus -- SMF mailbox regmap bus context
+ * @map:  SMF LPC register map holding the address and data registers
+ * @addr: shadow of the mailbox address registers, -1 when unknown
+ * @mode: SMF_MB_ADDR_* behaviour of the data register
+ *
+ * Only accessed under the mailbox regmap lock, after probe.
+ */
+struct smf_mb_bus {
+	struct regmap *map;
+	int            addr;
+	int            mode;
+};
+
+/**
+ * struct smf_mb_snap_block -- mailbox range held in a sensor snapshot
+ * @reg: first register of the range
+ * @len: number of registers in the range
+ */
+struct smf_mb_snap_block {
+	uint16_t reg;
+	uint16_t len;
+};
+
+#define SMF_MB_SNAP_BLOCK(first, last) { (first), (last) + 1 - (first) }
+
+/*
+ * The sensor blocks of the mailbox: temperature readings and status,
+ * fan speeds and status, total PSU power and the monitoring block of
+ * each PSU.  Each block is volatile end to end, so it is read in
+ * streamed bulk reads of up to S6100_SMF_MB_MAX_RAW_READ bytes.
+ */
+static const struct smf_mb_snap_block smf_mb_snap_blocks[] = {
+	SMF_MB_SNAP_BLOCK(S6100_SMF_MB_TEMP01_SENSOR,
+			  S6100_SMF_MB_TEMP01_HW_SHUT_LIMIT - 1),
+	SMF_MB_SNAP_BLOCK(S6100_SMF_MB_TEMP01_STATUS,
+			  S6100_SMF_MB_FAN_TRAY_CNT - 1),
+	SMF_MB_SNAP_BLOCK(S6100_SMF_MB_FAN_MAX_SPEED,
+			  S6100_SMF_MB_FAN_TRAYS_F2B),
+	SMF_MB_SNAP_BLOCK(S6100_SMF_MB_PSU_TOTAL_POWER_H,
+			  S6100_SMF_MB_PSU1_COUNTY_CODE - 1),
+	SMF_MB_SNAP_BLOCK(S6100_SMF_MB_PSU1_MAX_H + S6100_SMF_MB_PSU_OFFSET,
+			  S6100_SMF_MB_PSU1_COUNTY_CODE +
+			  S6100_SMF_MB_PSU_OFFSET - 1),
+};
+
+#define S6100_SMF_MB_SNAP_SIZE	256
+
+/*
+ * Most mailbox bytes read under one hold of the regmap spinlock, which
+ * keeps IRQs off while the bytes are streamed over LPC.
+ */
+#define S6100_SMF_MB_MAX_RAW_READ	32
+
+/**
+ * struct smf_mb_snapshot -- cached copy of the mailbox sensor blocks
+ * @map:       regmap configured for the smf mailbox registers
+ * @lock:      serializes refreshes and readers of @data
+ * @period:    age in jiffies after which @data is read again, 0 disables
+ *             the snapshot
+ * @stamp:     jiffies of the last refresh
+ * @valid:     @data holds a complete refresh
+ * @data:      the blocks of smf_mb_snap_blocks[], back to back
+ *
+ * The SMF refreshes its sensor readings once per scan of its i2c
+ * devices.  All sensor attributes are served from one copy of the
+ * sensor blocks, read at most once per @period, so readings returned
+ * together come from the same refresh and cost no mailbox cycles.
+ */
+struct smf_mb_snapshot {
+	struct regmap *map;
+	struct mutex   lock;
+	unsigned long  period;
+	unsigned long  stamp;
+	bool           valid;
+	uint8_t        data[S6100_SMF_MB_SNAP_SIZE];
+};
+
+/**
+ * smf_mb_snapshot_init(): Initialize a sensor snapshot
+ *
+ * @snap: snapshot to initialize
+ * @smf_mb_map: regmap configured for the smf mailbox registers
+ * @period_ms: snapshot lifetime in ms, 0 reads every value directly
+ */
+static void
+smf_mb_snapshot_init(struct smf_mb_snapshot *snap, struct regmap *smf_mb_map,
+		     unsigned int period_ms)
+{
+	size_t size = 0;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(smf_mb_snap_blocks); i++)
+		size += smf_mb_snap_blocks[i].len;
+	if (WARN_ON(size > sizeof(snap->data)))
+		period_ms = 0;
+
+	snap->map = smf_mb_map;
+	mutex_init(&snap->lock);
+	snap->period = msecs_to_jiffies(period_ms);
+	snap->valid = false;
+}
+
+/**
+ * smf_mb_snapshot_find(): Locate a register range in a snapshot
+ *
+ * @reg: first register
+ * @len: number of registers
+ *
+ * Returns the offset of @reg in struct smf_mb_snapshot.data, or -1 if
+ * the range is not contained in a single snapshot block.
+ */
+static int
+smf_mb_snapshot_find(unsigned int reg, size_t len)
+{
+	const struct smf_mb_snap_block *blk;
+	int off = 0;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(smf_mb_snap_blocks); i++) {
+		blk = &smf_mb_snap_blocks[i];
+		if (reg >= blk->reg && reg + len <= blk->reg + blk->len)
+			return off + reg - blk->reg;
+		off += blk->len;
+	}
+
+	return -1;
+}
+
+/* Called with @snap->lock held */
+static int
+smf_mb_snapshot_refresh(struct smf_mb_snapshot *snap)
+{
+	const struct smf_mb_snap_block *blk;
+	uint8_t *data = snap->data;
+	size_t off, len;
+	int rc;
+	int i;
+
+	if (snap->valid && time_before(jiffies, snap->stamp + snap->period))
+		return 0;
+
+	snap->valid = false;
+	for (i = 0; i < ARRAY_SIZE(smf_mb_snap_blocks); i++) {
+		blk = &smf_mb_snap_blocks[i];
+		for (off = 0; off < blk->len; off += len) {
+			len = min_t(size_t, blk->len - off,
+				    S6100_SMF_MB_MAX_RAW_READ);
+			rc = smf_mb_reg_rd_array(snap->map, blk->reg + off,
+						 data + off, len);
+			if (rc)
+				return rc;
+		}
+		data += blk->len;
+	}
+	snap->stamp = jiffies;
+	snap->valid = true;
+
+	return 0;
+}
+
+/**
+ * smf_mb_snap_rd_array(): Read N 8-bit smf mailbox sensor registers
+ *
+ * @snap: sensor snapshot
+ * @reg: base register offset
+ * @val: storage to hold register data
+ * @len: length of @val array in bytes
+ *
+ * Like smf_mb_reg_rd_array(), but returns the registers from the
+ * sensor snapshot, refreshing it first if it is stale.  Ranges outside
+ * of the snapshot blocks are read from the mailbox.
+ *
+ * A value of zero will be returned on success, a negative errno will
+ * be returned in error cases.
+ */
+static int
+smf_mb_snap_rd_array(struct smf_mb_snapshot *snap, unsigned int reg,
+		     uint8_t *val, size_t len)
+{
+	int off;
+	int rc;
+
+	off = smf_mb_snapshot_find(reg, len);
+	if (!snap->period || off < 0)
+		return smf_mb_reg_rd_array(snap->map, reg, val, len);
+
+	mutex_lock(&snap->lock);
+	rc = smf_mb_snapshot_refresh(snap);
+	if (!rc)
+		memcpy(val, snap->data + off, len);
+	mutex_unlock(&snap->lock);
+
+	return rc;
+}
+
+/**
+ * smf_mb_snap_rd(): Read 8-bit smf mailbox sensor register
+ *
+ * @snap: sensor snapshot
+ * @reg: register offset
+ * @val: pointer to hold 8-bit register read value
+ *
+ * See smf_mb_snap_rd_array().
+ */
+int smf_mb_snap_rd(struct smf_mb_snapshot *snap, unsigned int reg,
+		   uint8_t *val)
+{
+	return smf_mb_snap_rd_array(snap, reg, val, 1);
+}
+EXPORT_SYMBOL_GPL(smf_mb_snap_rd);
+
+/**
+ * smf_mb_snap_rd16(): Read 16-bit smf mailbox sensor register
+ *
+ * @snap: sensor snapshot
+ * @reg: register offset
+ * @val: pointer to hold 16-bit register read value
+ *
+ * See smf_mb_snap_rd_array() and smf_mb_reg_rd16().
+ */
+int smf_mb_snap_rd16(struct smf_mb_snapshot *snap, unsigned int reg,
+		     uint16_t *val)
+{
+	uint8_t buf[2];
+	int rc;
+
+	rc = smf_mb_snap_rd_array(snap, reg, buf, sizeof(buf));
+	if (rc)
+		return rc;
+
+	*val = (buf[0] << 8) | buf[1];
+	return rc;
+}
+EXPORT_SYMBOL_GPL(smf_mb_snap_rd16);
+
 /**
  * struct s6100_smf_priv -- private driver data
  * @pdev:             Parent platform device
  * @name:             Device name
  * @smf_map:          SMF LPC register map
  * @smf_mb_map:       SMF mailbox register map
+ * @smf_mb_bus:       SMF mailbox regmap bus context
+ * @smf_mb_snap:      SMF mailbox sensor snapshot, shared with the FRU devices
  * @fan_frus:         array of fan tray FRU devices
  * @num_fan_frus:     number of fan tray FRU devices
  * @psu_frus:         array of PSU FRU devices
@@ -82,6 +363,7 @@ struct module_cpld_i2c_data {
  * @num_temps:        number of temperature sensors
  * @temp_attr_group:  attribute group for temperature sensors objects
  * @temp_attr_groups: array of attribute groups for temperature sensors objects
+ * @thermal_sensors:  array of num_temps thermal zones, or NULL
  * @gpio_ctrl:	      GPIO controller object
  * @gpio_lock:        spinlock used to serialize read/modify/write GPIO
  *                    operations
@@ -95,6 +377,8 @@ struct s6100_smf_drv_priv {
 	char                           name[MAX_SMF_DEV_NAME_LEN];
 	struct regmap                 *smf_map;
 	struct regmap                 *smf_mb_map;
+	struct smf_mb_bus              smf_mb_bus;
+	struct smf_mb_snapshot         smf_mb_snap;
 	struct platform_device       **fan_frus;
 	uint8_t                        num_fan_frus;
 	struct platform_device       **psu_frus;
@@ -102,6 +386,7 @@ struct s6100_smf_drv_priv {
 	uint8_t                        num_temps;
 	struct attribute_group         temp_attr_group;
 	const struct attribute_group  *temp_attr_groups[2];
+	struct smf_thermal_sensor     *thermal_sensors;
 	struct gpio_chip               gpio_ctrl;
 	spinlock_t                     gpio_lock;
 	struct platform_device        *mod_frus[NUM_IO_MODULES];
@@ -124,13 +409,16 @@ static const struct regmap_range smf_ro_ranges[] = {
 };
 
 /**
- * smf_volatile_ranges
+ * smf_cached_ranges
  *
- * Array of regmap volatile ranges for the SMF LPC registers.
+ * Array of regmap ranges of the SMF LPC registers that do not change
+ * after boot and are cached.  Everything else is volatile, including
+ * the control registers, which may clear themselves.
  */
-static const struct regmap_range smf_volatile_ranges[] = {
-	regmap_reg_range(S6100_SMF_UART_STA,   S6100_SMF_MSS_STA),
-	regmap_reg_range(S6100_SMF_RAM_R_DATA, S6100_SMF_RAM_R_DATA),
+static const struct regmap_range smf_cached_ranges[] = {
+	regmap_reg_range(S6100_SMF_VER,        S6100_SMF_BOARD_TYPE),
+	regmap_reg_range(S6100_SMF_BOOT_OK,    S6100_SMF_BOOT_OK),
+	regmap_reg_range(S6100_SMF_POR_SOURCE, S6100_SMF_RST_SOURCE),
 };
 
 static struct regmap_access_table smf_write_table = {
@@ -139,8 +427,8 @@ static struct regmap_access_table smf_write_table = {
 };
 
 static struct regmap_access_table smf_volatile_table = {
-	.yes_ranges   = smf_volatile_ranges,
-	.n_yes_ranges = ARRAY_SIZE(smf_volatile_ranges),
+	.no_ranges   = smf_cached_ranges,
+	.n_no_ranges = ARRAY_SIZE(smf_cached_ranges),
 };
 
 /**
@@ -181,6 +469,13 @@ smf_regmap_reg_write(void *context, unsigned int reg, unsigned int val)
  * s6100_smf_regmap_config
  *
  * regmap configuration for the SMF LPC registers.
+ *
+ * The regmap lock is a spinlock (fast_io) and the GPIO callbacks run
+ * with IRQs off, but the rbtree cache allocates its blocks with
+ * GFP_KERNEL.  num_reg_defaults_raw makes regmap read the cached
+ * registers once at init, outside the lock, and create every block
+ * then.  Dropping a region only clears its present bits, so later
+ * cache fills never allocate.
  */
 static struct regmap_config s6100_smf_regmap_config = {
 	.name            = "s6100-smf",
@@ -190,8 +485,10 @@ static struct regmap_config s6100_smf_regmap_config = {
 	.val_bits	 = 8,
 	.fast_io	 = true,
 	.max_register	 = S6100_SMF_TPM_STA_ID,
+	.num_reg_defaults_raw = S6100_SMF_TPM_STA_ID + 1,
 	.wr_table	 = &smf_write_table,
 	.volatile_table	 = &smf_volatile_table,
+	.cache_type	 = REGCACHE_RBTREE,
 	.use_single_rw	 = true,
 	.can_multi_write = false,
 	.reg_read        = smf_regmap_reg_read,
@@ -221,16 +518,29 @@ static const struct regmap_range smf_mb_write_ranges[] = {
 };
 
 /**
- * smf_mb_volatile_ranges
+ * smf_mb_cached_ranges
+ *
+ * Array of regmap ranges of the SMF mailbox registers that are
+ * cached: firmware versions, sensor and FRU counts, temperature
+ * limits and the fan tray and PSU VPD.  Everything else is volatile.
  *
- * Array of regmap volatile ranges for the SMF mailbox registers.
+ * The VPD of a FRU is dropped from the cache whenever its presence
+ * changes, see smf_mb_fru_sync().
  */
-static const struct regmap_range smf_mb_volatile_ranges[] = {
-	regmap_reg_range(S6100_SMF_MB_TEMP01_SENSOR, S6100_SMF_MB_TEMP16_STATUS),
-	regmap_reg_range(S6100_SMF_MB_FAN_MAX_SPEED,
-			 S6100_SMF_MB_FAN_TRAY8_MFG_DATE + S6100_SMF_MB_FAN_TRAY_MFG_DATE_SIZE - 1),
-	regmap_reg_range(S6100_SMF_MB_PSU_TOTAL_POWER_H, S6100_SMF_MB_SCAN_RESULT_4),
-	regmap_reg_range(S6100_SMF_MB_TEMP_UPDATE_FLAG, S6100_SMF_MB_POWER_CYCLE_CTRL),
+static const struct regmap_range smf_mb_cached_ranges[] = {
+	regmap_reg_range(S6100_SMF_MB_PROTO_VER, S6100_SMF_MB_NUM_TEMP_SENSORS),
+	regmap_reg_range(S6100_SMF_MB_TEMP01_HW_SHUT_LIMIT,
+			 S6100_SMF_MB_TEMP01_STATUS - 1),
+	regmap_reg_range(S6100_SMF_MB_FAN_TRAY_CNT, S6100_SMF_MB_FANS_PER_TRAY),
+	regmap_reg_range(S6100_SMF_MB_FAN_TRAY1_SERIAL_NUM,
+			 S6100_SMF_MB_FAN_TRAY1_SERIAL_NUM +
+			 S6100_SMF_MB_NUM_FAN_TRAYS * S6100_SMF_MB_FAN_TRAY_VPD_OFFSET - 1),
+	regmap_reg_range(S6100_SMF_MB_PSU_CNT, S6100_SMF_MB_PSU_CNT),
+	regmap_reg_range(S6100_SMF_MB_PSU1_COUNTY_CODE,
+			 S6100_SMF_MB_PSU1_COUNTY_CODE + S6100_SMF_MB_PSU_VPD_SIZE - 1),
+	regmap_reg_range(S6100_SMF_MB_PSU1_COUNTY_CODE + S6100_SMF_MB_PSU_OFFSET,
+			 S6100_SMF_MB_PSU1_COUNTY_CODE + S6100_SMF_MB_PSU_OFFSET +
+			 S6100_SMF_MB_PSU_VPD_SIZE - 1),
 };
 
 static struct regmap_access_table smf_mb_write_table = {
@@ -244,95 +554,253 @@ static struct regmap_access_table smf_mb_read_table = {
 };
 
 static struct regmap_access_table smf_mb_volatile_table = {
-	.yes_ranges   = smf_mb_volatile_ranges,
-	.n_yes_ranges = ARRAY_SIZE(smf_mb_volatile_ranges),
+	.no_ranges   = smf_mb_cached_ranges,
+	.n_no_ranges = ARRAY_SIZE(smf_mb_cached_ranges),
 };
 
 
 /**
  * smf_mb_regmap_addr_set() -- set mailbox register address
- * @map: regmap object for smf IO-space registers
+ * @bus: smf mailbox bus context
  * @addr: mailbox register address
  *
- * Configures the smf mailbox address registers.  Returns 0 on success
- * or negative errno codes from regmap infrastructure.
+ * Configures the smf mailbox address registers, skipping the writes
+ * that would not change them according to the shadowed address.
+ * Returns 0 on success or negative errno codes from regmap
+ * infrastructure.
  */
-static int smf_mb_regmap_addr_set(struct regmap *map, unsigned int addr)
+static int smf_mb_regmap_addr_set(struct smf_mb_bus *bus, unsigned int addr)
 {
+	struct regmap *map = bus->map;
 	int rc;
 
+	if (bus->addr == addr)
+		return 0;
+
 	/* program indirect addressing registers */
-	rc = regmap_write(map, S6100_SMF_RAM_ADDR_H,
-			  (addr >> 8) & 0xFF);
-	if (WARN(rc, "regmap_write(map, 0x%x, 0x%x) failed: (%d)\n",
-		 S6100_SMF_RAM_ADDR_H, (addr >> 8) & 0xFF, rc))
-		return rc;
+	if (bus->addr < 0 || (bus->addr >> 8) != (addr >> 8)) {
+		bus->addr = -1;
+		rc = regmap_write(map, S6100_SMF_RAM_ADDR_H,
+				  (addr >> 8) & 0xFF);
+		if (WARN(rc, "regmap_write(map, 0x%x, 0x%x) failed: (%d)\n",
+			 S6100_SMF_RAM_ADDR_H, (addr >> 8) & 0xFF, rc))
+			return rc;
+	}
 
 	rc = regmap_write(map, S6100_SMF_RAM_ADDR_L, addr & 0xFF);
-	WARN(rc, "regmap_write(map, 0x%x, 0x%x) failed: (%d)\n",
-	     S6100_SMF_RAM_ADDR_L, addr & 0xFF, rc);
+	if (WARN(rc, "regmap_write(map, 0x%x, 0x%x) failed: (%d)\n",
+		 S6100_SMF_RAM_ADDR_L, addr & 0xFF, rc)) {
+		bus->addr = -1;
+		return rc;
+	}
+	bus->addr = addr;
 
-	return rc;
+	return 0;
 }
 
 /**
- * smf_mb_regmap_reg_read()
- * @context: regmap object for smf IO-space registers
- * @reg: register offset
+ * smf_mb_regmap_data_read()
+ * @bus: smf mailbox bus context
+ * @addr: mailbox register address
  * @val: pointer to hold register read value
  *
- * Regmap read register callback for the SmartFusion mailbox
- * registers.  Returns 0 on success or negative errno codes from
- * regmap infrastructure.
+ * Read one mailbox byte and track where the data register left the
+ * address.  Returns 0 on success or negative errno codes from regmap
+ * infrastructure.
  */
-static int
-smf_mb_regmap_reg_read(void *context, unsigned int reg, unsigned int *val)
+static int smf_mb_regmap_data_read(struct smf_mb_bus *bus, unsigned int addr,
+				   uint8_t *val)
 {
-	struct regmap *map = (struct regmap *)context;
-	int rc = 0;
+	unsigned int val32 = 0;
+	int rc;
 
-	rc = smf_mb_regmap_addr_set(map, reg);
+	rc = smf_mb_regmap_addr_set(bus, addr);
 	if (rc)
 		return rc;
 
-	rc = regmap_read(map, S6100_SMF_RAM_R_DATA, val);
-	WARN(rc, "regmap_read(map, 0x%x, val) failed: (%d)\n",
-	     S6100_SMF_RAM_R_DATA, rc);
+	rc = regmap_read(bus->map, S6100_SMF_RAM_R_DATA, &val32);
+	if (WARN(rc, "regmap_read(map, 0x%x, val) failed: (%d)\n",
+		 S6100_SMF_RAM_R_DATA, rc)) {
+		bus->addr = -1;
+		return rc;
+	}
+	*val = val32 & 0xFF;
 
-	return rc;
+	switch (bus->mode) {
+	case SMF_MB_ADDR_AUTOINC:
+		/* do not rely on a carry into the high address byte */
+		bus->addr = (addr & 0xFF) == 0xFF ? -1 : addr + 1;
+		break;
+	case SMF_MB_ADDR_FIXED:
+		break;
+	default:
+		bus->addr = -1;
+		break;
+	}
+
+	return 0;
 }
 
 /**
- * smf_mb_regmap_reg_write()
- * @context: regmap object for smf IO-space registers
- * @reg: register offset
- * @val: value to write to register
+ * smf_mb_regmap_read()
+ * @context: smf mailbox bus context
+ * @reg_buf: big endian register address
+ * @reg_size: size of @reg_buf
+ * @val_buf: storage for the register values
+ * @val_size: number of registers to read
  *
- * regmap write register callback for the SmartFusion mailbox
- * registers.  Returns 0 on success or negative errno codes from
- * regmap infrastructure.
+ * regmap raw read callback for the SmartFusion mailbox registers.
+ * Single register reads and bulk reads both end up here.  With
+ * address auto-increment the address is programmed once and the
+ * bytes are streamed from the data register, otherwise only the low
+ * address byte is rewritten between bytes of the same page.
  */
-static int
-smf_mb_regmap_reg_write(void *context, unsigned int reg, unsigned int val)
+static int smf_mb_regmap_read(void *context, const void *reg_buf,
+			      size_t reg_size, void *val_buf, size_t val_size)
 {
-	struct regmap *map = (struct regmap *)context;
-	int rc = 0;
+	struct smf_mb_bus *bus = context;
+	const uint8_t *r = reg_buf;
+	uint8_t *val = val_buf;
+	unsigned int reg;
+	size_t i;
+	int rc;
 
-	rc = smf_mb_regmap_addr_set(map, reg);
-	if (rc)
-		return rc;
+	if (reg_size != 2)
+		return -EINVAL;
+	reg = (r[0] << 8) | r[1];
 
-	rc = regmap_write(map, S6100_SMF_RAM_W_DATA, val);
-	WARN(rc, "regmap_write(map, 0x%x, 0x%x) failed: (%d)\n",
-	     S6100_SMF_RAM_W_DATA, val, rc);
+	for (i = 0; i < val_size; i++) {
+		rc = smf_mb_regmap_data_read(bus, reg + i, val + i);
+		if (rc)
+			return rc;
+	}
 
-	return rc;
+	return 0;
 }
 
+/**
+ * smf_mb_regmap_write()
+ * @context: smf mailbox bus context
+ * @data: big endian register address followed by the values
+ * @count: size of @data
+ *
+ * regmap raw write callback for the SmartFusion mailbox registers.
+ * Whether writes move the address is not known, so the shadowed
+ * address is dropped after each one.
+ */
+static int smf_mb_regmap_write(void *context, const void *data, size_t count)
+{
+	struct smf_mb_bus *bus = context;
+	const uint8_t *d = data;
+	unsigned int reg;
+	size_t i;
+	int rc;
+
+	if (count < 2)
+		return -EINVAL;
+	reg = (d[0] << 8) | d[1];
+
+	for (i = 2; i < count; i++, reg++) {
+		rc = smf_mb_regmap_addr_set(bus, reg);
+		if (rc)
+			return rc;
+
+		rc = regmap_write(bus->map, S6100_SMF_RAM_W_DATA, d[i]);
+		bus->addr = -1;
+		if (WARN(rc, "regmap_write(map, 0x%x, 0x%x) failed: (%d)\n",
+			 S6100_SMF_RAM_W_DATA, d[i], rc))
+			return rc;
+	}
+
+	return 0;
+}
+
+/*
+ * Compare byte by byte reads of the static mailbox header against a
+ * stream of data register reads after a single address write.  If
+ * the header bytes all read the same the test is inconclusive and
+ * the address registers are programmed for every byte, as before.
+ */
+#define SMF_MB_PROBE_LEN (S6100_SMF_MB_NUM_TEMP_SENSORS - S6100_SMF_MB_PROTO_VER)
+
+static void smf_mb_addr_mode_probe(struct device *dev, struct smf_mb_bus *bus)
+{
+	uint8_t single[SMF_MB_PROBE_LEN];
+	uint8_t stream[SMF_MB_PROBE_LEN];
+	bool varies = false;
+	bool same = true;
+	bool fixed = true;
+	int i;
+
+	bus->mode = SMF_MB_ADDR_UNKNOWN;
+	bus->addr = -1;
+	if (!mb_stream)
+		return;
+
+	for (i = 0; i < SMF_MB_PROBE_LEN; i++) {
+		if (smf_mb_regmap_data_read(bus, S6100_SMF_MB_PROTO_VER + i,
+					    &single[i]))
+			return;
+		if (single[i] != single[0])
+			varies = true;
+	}
+	if (!varies)
+		return;
+
+	bus->addr = -1;
+	if (smf_mb_regmap_addr_set(bus, S6100_SMF_MB_PROTO_VER))
+		return;
+	for (i = 0; i < SMF_MB_PROBE_LEN; i++) {
+		unsigned int val32;
+
+		if (regmap_read(bus->map, S6100_SMF_RAM_R_DATA, &val32)) {
+			bus->addr = -1;
+			return;
+		}
+		stream[i] = val32 & 0xFF;
+		if (stream[i] != single[i])
+			same = false;
+		if (stream[i] != single[0])
+			fixed = false;
+	}
+	bus->addr = -1;
+
+	if (same)
+		bus->mode = SMF_MB_ADDR_AUTOINC;
+	else if (fixed)
+		bus->mode = SMF_MB_ADDR_FIXED;
+
+	dev_info(dev, "smf mailbox address %s\n",
+		 bus->mode == SMF_MB_ADDR_AUTOINC ? "auto-increments" :
+		 bus->mode == SMF_MB_ADDR_FIXED ? "is fixed" : "is unknown");
+}
+
+/**
+ * s6100_smf_mb_regmap_bus
+ *
+ * regmap bus for the SMF mailbox registers, reached through the
+ * indirect address and data registers of the SMF LPC register map.
+ *
+ * The GPIO callbacks reach mailbox registers with IRQs off, so the
+ * lock stays a spinlock (fast_io).  max_raw_read keeps the cache init
+ * from reading the whole mailbox, unreadable gap included, in one go:
+ * it falls back to reading the cached registers one by one.  It also
+ * bounds any bulk read of volatile registers, and the snapshot reads
+ * its blocks in pieces of that size, so IRQs stay off for at most
+ * S6100_SMF_MB_MAX_RAW_READ mailbox cycles at a time.
+ */
+static struct regmap_bus s6100_smf_mb_regmap_bus = {
+	.fast_io = true,
+	.max_raw_read = S6100_SMF_MB_MAX_RAW_READ,
+	.read    = smf_mb_regmap_read,
+	.write   = smf_mb_regmap_write,
+};
+
 /**
  * s6100_smf_mb_regmap_config
  *
- * regmap configuration for the SMF mailbox registers.
+ * regmap configuration for the SMF mailbox registers.  The cache is
+ * populated at init, see s6100_smf_regmap_config.
  */
 static struct regmap_config s6100_smf_mb_regmap_config = {
 	.name                 = "s6100-smf-mb",
@@ -342,13 +810,13 @@ static struct regmap_config s6100_smf_mb_regmap_config = {
 	.val_bits             = 8,
 	.fast_io              = true,
 	.max_register         = S6100_SMF_MB_POWER_CYCLE_CTRL,
+	.num_reg_defaults_raw = S6100_SMF_MB_POWER_CYCLE_CTRL + 1,
 	.wr_table             = &smf_mb_write_table,
 	.rd_table             = &smf_mb_read_table,
 	.volatile_table       = &smf_mb_volatile_table,
-	.use_single_rw        = true,
+	.cache_type           = REGCACHE_RBTREE,
+	.use_single_rw        = false,
 	.can_multi_write      = false,
-	.reg_read             = smf_mb_regmap_reg_read,
-	.reg_write            = smf_mb_regmap_reg_write,
 };
 
 #define S6100_SMF_GPIO_CTRL_BASE 1100
@@ -445,6 +913,86 @@ smf_gpio_direction_output(struct gpio_chip *chip, unsigned offset, int value)
 	return gpio_data[offset].flags & GPIOF_DIR_IN ? -EINVAL : 0;
 }
 
+/*
+ * smf_gpio_reg_rd()/smf_gpio_reg_wr()
+ *
+ * Read or write the register holding a GPIO signal, in whichever
+ * register map it lives.
+ */
+static int
+smf_gpio_reg_rd(struct s6100_smf_drv_priv *priv,
+		const struct s6100_gpio_data *gd, uint8_t *val)
+{
+	if (gd->reg_map == SMF_REG_MAP)
+		return smf_reg_rd(priv->smf_map, gd->reg, val);
+	else
+		return smf_mb_reg_rd(priv->smf_mb_map, gd->reg, val);
+}
+
+static int
+smf_gpio_reg_wr(struct s6100_smf_drv_priv *priv,
+		const struct s6100_gpio_data *gd, uint8_t val)
+{
+	if (gd->reg_map == SMF_REG_MAP)
+		return smf_reg_wr(priv->smf_map, gd->reg, val);
+	else
+		return smf_mb_reg_wr(priv->smf_mb_map, gd->reg, val);
+}
+
+/*
+ * smf_gpio_same_reg()
+ *
+ * True if two GPIO signals live in the same register.
+ */
+static inline bool
+smf_gpio_same_reg(const struct s6100_gpio_data *a,
+		  const struct s6100_gpio_data *b)
+{
+	return a->reg_map == b->reg_map && a->reg == b->reg;
+}
+
+/*
+ * smf_gpio_val()
+ *
+ * Decode the value of a GPIO signal from its register value.
+ */
+static inline int
+smf_gpio_val(const struct s6100_gpio_data *gd, uint8_t reg_val)
+{
+	int val = reg_val & BIT(gd->bit) ? 1 : 0;
+
+	if (gd->flags & GPIOF_ACTIVE_LOW)
+		val = !val;
+
+	return val;
+}
+
+/*
+ * smf_gpio_reg_val()
+ *
+ * Return @reg_val updated to drive the GPIO signal to @value.
+ */
+static uint8_t
+smf_gpio_reg_val(const struct s6100_gpio_data *gd, uint8_t reg_val, int value)
+{
+	if (gd->flags & GPIOF_ACTIVE_LOW)
+		value = !value;
+
+	if ((gd->reg == S6100_SMF_MB_SYS_STACKING_LED_CTRL) ||
+	    (gd->reg == S6100_SMF_MB_SYS_BEACON_LED_CTRL)) {
+		/*
+		 * These registers use an enumeration instead of a bitmask.
+		 */
+		return value ? 0x2 : 0x1;
+	}
+
+	reg_val &= ~BIT(gd->bit);
+	if (value)
+		reg_val |= BIT(gd->bit);
+
+	return reg_val;
+}
+
 /**
  * smf_gpio_get()
  *
@@ -464,22 +1012,48 @@ smf_gpio_get(struct gpio_chip *chip, unsigned offset)
 		return -EINVAL;
 	}
 
-	if (gpio_data[offset].reg_map == SMF_REG_MAP)
-		rc = smf_reg_rd(priv->smf_map, gpio_data[offset].reg, &val);
-	else
-		rc = smf_mb_reg_rd(priv->smf_mb_map, gpio_data[offset].reg, &val);
+	rc = smf_gpio_reg_rd(priv, &gpio_data[offset], &val);
 	if (rc)
 		return rc;
 
-	rc = val & BIT(gpio_data[offset].bit) ? 1 : 0;
-	if (gpio_data[offset].flags & GPIOF_ACTIVE_LOW)
-		rc = !rc;
+	return smf_gpio_val(&gpio_data[offset], val);
+}
 
-	return rc;
+/**
+ * smf_gpio_get_multiple()
+ *
+ * gpio_chip driver interface callback. Returns the current values of
+ * the GPIO signals in @mask in @bits.  Signals sharing a register are
+ * adjacent in gpio_data[], so each register is read once.
+ */
+static int
+smf_gpio_get_multiple(struct gpio_chip *chip, unsigned long *mask,
+		      unsigned long *bits)
+{
+	struct s6100_smf_drv_priv *priv = to_smf_gpio(chip);
+	const struct s6100_gpio_data *cur = NULL;
+	uint8_t val = 0;
+	int offset;
+	int rc;
+
+	for_each_set_bit(offset, mask, ARRAY_SIZE(gpio_data)) {
+		if (!cur || !smf_gpio_same_reg(cur, &gpio_data[offset])) {
+			cur = &gpio_data[offset];
+			rc = smf_gpio_reg_rd(priv, cur, &val);
+			if (rc)
+				return rc;
+		}
+		if (smf_gpio_val(&gpio_data[offset], val))
+			set_bit(offset, bits);
+		else
+			clear_bit(offset, bits);
+	}
+
+	return 0;
 }
 
 /**
- * smf_gpio_get()
+ * smf_gpio_set()
  *
  * gpio_chip driver interface callback. For output GPIO signals, sets
  * the current value of the specified GPIO signal.
@@ -506,32 +1080,57 @@ smf_gpio_set(struct gpio_chip *chip, unsigned offset, int value)
 	}
 
 	spin_lock_irqsave(&priv->gpio_lock, flags);
-	if (gpio_data[offset].reg_map == SMF_REG_MAP)
-		rc = smf_reg_rd(priv->smf_map, gpio_data[offset].reg, &reg_val);
-	else
-		rc = smf_mb_reg_rd(priv->smf_mb_map, gpio_data[offset].reg, &reg_val);
+	rc = smf_gpio_reg_rd(priv, &gpio_data[offset], &reg_val);
 	if (rc) {
 		spin_unlock_irqrestore(&priv->gpio_lock, flags);
 		return;
 	}
-	reg_val &= ~BIT(gpio_data[offset].bit);
-	if (gpio_data[offset].flags & GPIOF_ACTIVE_LOW)
-		value = !value;
+	reg_val = smf_gpio_reg_val(&gpio_data[offset], reg_val, value);
+	smf_gpio_reg_wr(priv, &gpio_data[offset], reg_val);
+	spin_unlock_irqrestore(&priv->gpio_lock, flags);
+}
 
-	if ((gpio_data[offset].reg == S6100_SMF_MB_SYS_STACKING_LED_CTRL) ||
-	    (gpio_data[offset].reg == S6100_SMF_MB_SYS_BEACON_LED_CTRL)) {
-		/*
-		 * These registers use an enumeration instead of a bitmask.
-		 */
-		reg_val = value ? 0x2 : 0x1;
-	} else {
-		if (value)
-			reg_val |= BIT(gpio_data[offset].bit);
+/**
+ * smf_gpio_set_multiple()
+ *
+ * gpio_chip driver interface callback. Sets the output GPIO signals
+ * in @mask to the values in @bits, with one read/modify/write per
+ * register.
+ */
+static void
+smf_gpio_set_multiple(struct gpio_chip *chip, unsigned long *mask,
+		      unsigned long *bits)
+{
+	struct s6100_smf_drv_priv *priv = to_smf_gpio(chip);
+	const struct s6100_gpio_data *cur = NULL;
+	uint8_t reg_val = 0;
+	unsigned long flags;
+	int offset;
+	int rc;
+
+	spin_lock_irqsave(&priv->gpio_lock, flags);
+	for_each_set_bit(offset, mask, ARRAY_SIZE(gpio_data)) {
+		if (gpio_data[offset].flags & GPIOF_DIR_IN) {
+			dev_warn(&priv->pdev->dev,
+				 "Ignoring request to write read-only GPIO: %u",
+				 offset);
+			continue;
+		}
+		if (!cur || !smf_gpio_same_reg(cur, &gpio_data[offset])) {
+			if (cur)
+				smf_gpio_reg_wr(priv, cur, reg_val);
+			cur = &gpio_data[offset];
+			rc = smf_gpio_reg_rd(priv, cur, &reg_val);
+			if (rc) {
+				cur = NULL;
+				break;
+			}
+		}
+		reg_val = smf_gpio_reg_val(&gpio_data[offset], reg_val,
+					   test_bit(offset, bits));
 	}
-	if (gpio_data[offset].reg_map == SMF_REG_MAP)
-		rc = smf_reg_wr(priv->smf_map, gpio_data[offset].reg, reg_val);
-	else
-		rc = smf_mb_reg_wr(priv->smf_mb_map, gpio_data[offset].reg, reg_val);
+	if (cur)
+		smf_gpio_reg_wr(priv, cur, reg_val);
 	spin_unlock_irqrestore(&priv->gpio_lock, flags);
 }
 
@@ -640,7 +1239,7 @@ static ssize_t smf_mb_temp_show(struct device *dev,
 	};
 
 	reg += attr->index << index_shift;
-	rc = smf_mb_reg_rd16(priv->smf_mb_map, reg, &temp);
+	rc = smf_mb_snap_rd16(&priv->smf_mb_snap, reg, &temp);
 	if (rc)
 		return rc;
 
@@ -717,7 +1316,7 @@ static ssize_t smf_mb_fault_show(struct device *dev,
 	}
 
 	reg += attr->index;
-	rc = smf_mb_reg_rd(priv->smf_mb_map, reg, &status);
+	rc = smf_mb_snap_rd(&priv->smf_mb_snap, reg, &status);
 	if (rc)
 		return rc;
 
@@ -902,6 +1501,132 @@ static int __init probe_temperature_system(struct s6100_smf_drv_priv *priv)
 	return rc;
 }
 
+/**
+ * smf_thermal_get_temp()
+ *
+ * Thermal zone temperature callback, served from the sensor snapshot.
+ */
+static int smf_thermal_get_temp(void *data, int *temp)
+{
+	struct smf_thermal_sensor *sensor = data;
+	uint16_t val;
+	int rc;
+
+	rc = smf_mb_snap_rd16(&sensor->priv->smf_mb_snap,
+			      S6100_SMF_MB_TEMP01_SENSOR + (sensor->index << 1),
+			      &val);
+	if (rc)
+		return rc;
+
+	if (val == S6100_SMF_MB_BAD_READ)
+		return -EAGAIN;
+
+	*temp = (int)val * 100;
+	return 0;
+}
+
+static const struct cumulus_thermal_sensor_ops smf_thermal_ops = {
+	.get_temp = smf_thermal_get_temp,
+};
+
+/**
+ * smf_thermal_limit()
+ *
+ * Read a temperature limit in millidegree Celsius, or @def degree
+ * Celsius when the SMF does not implement it.
+ */
+static int smf_thermal_limit(struct s6100_smf_drv_priv *priv, int reg,
+			     int def)
+{
+	uint16_t val;
+
+	if (smf_mb_reg_rd16(priv->smf_mb_map, reg, &val) ||
+	    val == S6100_SMF_MB_BAD_READ)
+		return def * 1000;
+
+	return (int)val * 100;
+}
+
+#define SMF_THERMAL_HYST 2000
+
+/**
+ * probe_thermal_zones()
+ *
+ * Register every SMF temperature sensor as a thermal zone, with the
+ * minor alarm limit as an active trip and the major alarm limit as a
+ * hot trip.  The SMF firmware owns the fans and the shutdown limits
+ * and the host cannot set a fan speed, so these zones are for
+ * monitoring: no cooling device is bound, no critical trip is set, and
+ * cumulus-thermal logs the hot trip.  Failures only lose the thermal
+ * zones, the hwmon interface is unaffected.
+ */
+static void probe_thermal_zones(struct s6100_smf_drv_priv *priv)
+{
+	struct cumulus_thermal_trip trips[2];
+	struct cumulus_thermal_desc desc;
+	struct smf_thermal_sensor *sensor;
+	char type[THERMAL_NAME_LENGTH];
+	int i, off;
+
+	if (!thermal_zones || !priv->num_temps)
+		return;
+
+	priv->thermal_sensors = devm_kcalloc(&priv->pdev->dev, priv->num_temps,
+					     sizeof(*priv->thermal_sensors),
+					     GFP_KERNEL);
+	if (!priv->thermal_sensors)
+		return;
+
+	memset(trips, 0, sizeof(trips));
+	trips[0].type = THERMAL_TRIP_ACTIVE;
+	trips[0].hyst = SMF_THERMAL_HYST;
+	trips[1].type = THERMAL_TRIP_HOT;
+	trips[1].hyst = SMF_THERMAL_HYST;
+
+	memset(&desc, 0, sizeof(desc));
+	desc.type = type;
+	desc.ops = &smf_thermal_ops;
+	desc.trips = trips;
+	desc.num_trips = ARRAY_SIZE(trips);
+	desc.poll_ms = snapshot_ms;
+
+	for (i = 0; i < priv->num_temps; i++) {
+		sensor = &priv->thermal_sensors[i];
+		sensor->priv = priv;
+		sensor->index = i;
+
+		off = i << 3;
+		trips[0].temp = smf_thermal_limit(priv,
+				S6100_SMF_MB_TEMP01_MNR_ALARM_LIMIT + off,
+				SMF_DEFAULT_TMP_MAX);
+		trips[1].temp = smf_thermal_limit(priv,
+				S6100_SMF_MB_TEMP01_MJR_ALARM_LIMIT + off,
+				SMF_DEFAULT_TMP_CRIT);
+
+		snprintf(type, sizeof(type), "smf-temp%d", i + 1);
+		desc.priv = sensor;
+		sensor->ct = cumulus_thermal_add(&priv->pdev->dev, &desc);
+		if (IS_ERR(sensor->ct))
+			dev_warn(&priv->pdev->dev,
+				 "no thermal zone for temp%d: %ld\n",
+				 i + 1, PTR_ERR(sensor->ct));
+	}
+}
+
+/**
+ * remove_thermal_zones()
+ */
+static void remove_thermal_zones(struct s6100_smf_drv_priv *priv)
+{
+	int i;
+
+	if (!priv->thermal_sensors)
+		return;
+
+	for (i = 0; i < priv->num_temps; i++)
+		cumulus_thermal_del(priv->thermal_sensors[i].ct);
+}
+
 /**
  * smf_mb_u8_show()
  *
@@ -968,8 +1693,9 @@ static int __init probe_fan_system(struct s6100_smf_drv_priv *priv)
 	if (!priv->fan_frus)
 		return -ENOMEM;
 
-	/* Pass the smf mailbox regmap to the children */
+	/* Pass the smf mailbox regmap and sensor snapshot to the children */
 	fan_pdata.smf_mb_map = priv->smf_mb_map;
+	fan_pdata.smf_mb_snap = &priv->smf_mb_snap;
 
 	for (i = 0; i < priv->num_fan_frus; i++) {
 		s6100_smf_fan_info.id = i;
@@ -1003,7 +1729,7 @@ static ssize_t smf_mb_power_show(struct device *dev,
 	uint16_t val;
 	int rc;
 
-	rc = smf_mb_reg_rd16(priv->smf_mb_map, attr->index, &val);
+	rc = smf_mb_snap_rd16(&priv->smf_mb_snap, attr->index, &val);
 	if (rc)
 		return rc;
 
@@ -1061,8 +1787,9 @@ static int __init probe_psu_system(struct s6100_smf_drv_priv *priv)
 	if (!priv->psu_frus)
 		return -ENOMEM;
 
-	/* Pass the smf mailbox regmap to the children */
+	/* Pass the smf mailbox regmap and sensor snapshot to the children */
 	psu_pdata.smf_mb_map = priv->smf_mb_map;
+	psu_pdata.smf_mb_snap = &priv->smf_mb_snap;
 
 	for (i = 0; i < priv->num_psu_frus; i++) {
 		s6100_smf_psu_info.id = i;
@@ -1636,14 +2363,18 @@ static int __init s6100_smf_probe(struct platform_device *pdev)
 		 version & 0xF);
 
 	/* Initialize SMF mailbox register regmap */
-	priv->smf_mb_map = devm_regmap_init(&pdev->dev, NULL,
-					    (void *)priv->smf_map,
+	priv->smf_mb_bus.map = priv->smf_map;
+	smf_mb_addr_mode_probe(&pdev->dev, &priv->smf_mb_bus);
+	priv->smf_mb_map = devm_regmap_init(&pdev->dev,
+					    &s6100_smf_mb_regmap_bus,
+					    &priv->smf_mb_bus,
 					    &s6100_smf_mb_regmap_config);
 	if (IS_ERR(priv->smf_mb_map)) {
 		rc = PTR_ERR(priv->smf_mb_map);
 		dev_err(&pdev->dev, "unable to create smf_mb regmap: %d\n", rc);
 		return rc;
 	}
+	smf_mb_snapshot_init(&priv->smf_mb_snap, priv->smf_mb_map, snapshot_ms);
 
 	platform_set_drvdata(pdev, (void *)priv);
 
@@ -1656,7 +2387,9 @@ static int __init s6100_smf_probe(struct platform_device *pdev)
 	priv->gpio_ctrl.direction_input = smf_gpio_direction_input;
 	priv->gpio_ctrl.direction_output = smf_gpio_direction_output;
 	priv->gpio_ctrl.get = smf_gpio_get;
+	priv->gpio_ctrl.get_multiple = smf_gpio_get_multiple;
 	priv->gpio_ctrl.set = smf_gpio_set;
+	priv->gpio_ctrl.set_multiple = smf_gpio_set_multiple;
 	priv->gpio_ctrl.base = S6100_SMF_GPIO_CTRL_BASE;
 	priv->gpio_ctrl.ngpio = ARRAY_SIZE(gpio_data);
 	priv->gpio_ctrl.can_sleep = false;
@@ -1722,6 +2455,8 @@ static int __init s6100_smf_probe(struct platform_device *pdev)
 		return rc;
 	}
 
+	probe_thermal_zones(priv);
+
 	if (rc == 0)
 		dev_info(&pdev->dev, "device probed ok\n");
 
@@ -1738,6 +2473,8 @@ static int s6100_smf_remove(struct platform_device *pdev)
 	struct s6100_smf_drv_priv *priv = platform_get_drvdata(pdev);
 	int i;
 
+	remove_thermal_zones(priv);
+
 	gpiochip_remove(&priv->gpio_ctrl);
 
 	for (i = 0; i < priv->num_fan_frus; i++)
@@ -25,6 +25,17 @@
 
 #define S6100_SMF_DRIVER_NAME	"dell-s6100-smf"
 
+/*
+ * SMF mailbox sensor snapshot, owned by the SMF driver and shared with
+ * the fan and PSU FRU drivers through their platform data.
+ */
+struct smf_mb_snapshot;
+
+int smf_mb_snap_rd(struct smf_mb_snapshot *snap, unsigned int reg,
+		   uint8_t *val);
+int smf_mb_snap_rd16(struct smf_mb_snapshot *snap, unsigned int reg,
+		     uint16_t *val);
+
 /**
  * gen_device_attr() -- helper function
  *
@@ -32,13 +32,14 @@
 #include <linux/sysfs.h>
 #include <linux/platform_device.h>
 #include <linux/mutex.h>
+#include <linux/bitmap.h>
 #include <asm/io.h>
 
 #include "platform-defs.h"
 #include "dell-z9100-smf.h"
 
 static const char driver_name[] = "dell_z9100_smf";
-#define DRIVER_VERSION "1.0"
+#define DRIVER_VERSION "1.1"
 
 static uint8_t* z9100_smf_regs;
 static DEFINE_MUTEX(z9100_smf_mbox_mutex);
@@ -86,6 +87,109 @@ static SENSOR_DEVICE_ATTR(smf_therm_timeout, S_IRUGO, smf_show, NULL, Z9100_SMF_
 
 /* SMF Mailbox Access */
 
+/*
+ * Mailbox bytes that do not change at runtime are cached: versions,
+ * fan tray counts, temperature limits and the fan tray and PSU
+ * VPD.  The VPD of a FRU is dropped when its presence changes, see
+ * z9100_smf_mb_fru_sync().  The cache is protected by
+ * z9100_smf_mbox_mutex.
+ */
+#define Z9100_SMF_MB_CACHE_SIZE	0x300
+
+struct z9100_smf_mb_range {
+	u32 start;
+	u32 end;
+};
+
+static const struct z9100_smf_mb_range z9100_smf_mb_cached[] = {
+	{ Z9100_SMF_MB_PROTO_VER, Z9100_SMF_MB_TEMP1_SENSOR - 1 },
+	{ Z9100_SMF_MB_TEMP1_HW_SHUT_LIMIT, Z9100_SMF_MB_TEMP1_FAULT - 1 },
+	{ Z9100_SMF_MB_FANS_TRAYS_CNT, Z9100_SMF_MB_FANS_PER_TRAY },
+	{ Z9100_SMF_MB_FAN1_SERIAL_NUM, Z9100_SMF_MB_FAN_ALGO - 1 },
+	{ Z9100_SMF_MB_PSU1_COUNTY,
+	  Z9100_SMF_MB_PSU1_COUNTY + Z9100_SMF_MB_PSU_VPD_SIZE - 1 },
+	{ Z9100_SMF_MB_PSU1_COUNTY + Z9100_SMF_MB_PSU_OFFSET,
+	  Z9100_SMF_MB_PSU1_COUNTY + Z9100_SMF_MB_PSU_OFFSET +
+	  Z9100_SMF_MB_PSU_VPD_SIZE - 1 },
+};
+
+static u8 z9100_smf_mb_cache[Z9100_SMF_MB_CACHE_SIZE];
+static DECLARE_BITMAP(z9100_smf_mb_cache_valid, Z9100_SMF_MB_CACHE_SIZE);
+static int z9100_smf_mb_fan_present = -1;
+static int z9100_smf_mb_psu_present[Z9100_SMF_MB_NUM_PSUS] = { -1, -1 };
+
+static bool z9100_smf_mb_cacheable(u32 reg)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(z9100_smf_mb_cached); i++)
+		if (reg >= z9100_smf_mb_cached[i].start &&
+		    reg <= z9100_smf_mb_cached[i].end)
+			return true;
+
+	return false;
+}
+
+/* Read one mailbox byte, called with z9100_smf_mbox_mutex held */
+static u8 z9100_smf_mb_rd_locked(u32 reg)
+{
+	bool cacheable = z9100_smf_mb_cacheable(reg);
+	u8 rdata;
+
+	if (cacheable && test_bit(reg, z9100_smf_mb_cache_valid))
+		return z9100_smf_mb_cache[reg];
+
+	z9100_smf_wr(Z9100_SMF_RAM_ADDR_H, (reg >> 8) & 0xff);
+	z9100_smf_wr(Z9100_SMF_RAM_ADDR_L, reg & 0xff);
+	rdata = z9100_smf_rd(Z9100_SMF_RAM_R_DATA);
+
+	if (cacheable) {
+		z9100_smf_mb_cache[reg] = rdata;
+		set_bit(reg, z9100_smf_mb_cache_valid);
+	}
+
+	return rdata;
+}
+
+/*
+ * Read the presence of the fan trays and PSUs and drop the cached VPD
+ * of every FRU whose presence changed since the last call.  Called
+ * before reading VPD.
+ */
+static void z9100_smf_mb_fru_sync(void)
+{
+	unsigned long changed;
+	u32 reg;
+	int now;
+	int i;
+
+	mutex_lock(&z9100_smf_mbox_mutex);
+
+	now = z9100_smf_mb_rd_locked(Z9100_SMF_MB_FAN_TRAYS_PRESENT);
+	changed = (z9100_smf_mb_fan_present < 0) ? 0xff :
+		(now ^ z9100_smf_mb_fan_present);
+	for_each_set_bit(i, &changed, BITS_PER_BYTE)
+		bitmap_clear(z9100_smf_mb_cache_valid,
+			     Z9100_SMF_MB_FAN1_SERIAL_NUM +
+			     i * Z9100_SMF_MB_FAN_OFFSET,
+			     Z9100_SMF_MB_FAN_OFFSET);
+	z9100_smf_mb_fan_present = now;
+
+	for (i = 0; i < Z9100_SMF_MB_NUM_PSUS; i++) {
+		reg = Z9100_SMF_MB_PSU1_STATUS + i * Z9100_SMF_MB_PSU_OFFSET;
+		now = z9100_smf_mb_rd_locked(reg) &
+			Z9100_SMF_MB_PSU_PRESENT_FLAG;
+		if (now != z9100_smf_mb_psu_present[i])
+			bitmap_clear(z9100_smf_mb_cache_valid,
+				     Z9100_SMF_MB_PSU1_COUNTY +
+				     i * Z9100_SMF_MB_PSU_OFFSET,
+				     Z9100_SMF_MB_PSU_VPD_SIZE);
+		z9100_smf_mb_psu_present[i] = now;
+	}
+
+	mutex_unlock(&z9100_smf_mbox_mutex);
+}
+
 enum mb_dir {
 	MB_FWD,		/* pack bytes in forward order from hi end of array */
 	MB_REV		/* pack bytes in reverse order from lo end of array */
@@ -96,8 +200,6 @@ static void z9100_smf_mb_rd_array(u32 reg, unsigned int n, enum mb_dir dir,
 {
 	int i;
 	int index;
-	u8 hbyte;
-	u8 lbyte;
 
 	/*
 	 * Read a series of `n' SMF mailbox bytes into `array' starting
@@ -114,9 +216,6 @@ static void z9100_smf_mb_rd_array(u32 reg, unsigned int n, enum mb_dir dir,
 	 * Note that `array' may be larger than `n', e.g. to accommodate
 	 *   a terminating NULL for a string.
 	 */
-	hbyte = (reg >> 8) & 0xff;
-	lbyte = reg & 0xff;
-
 	mutex_lock(&z9100_smf_mbox_mutex);
 	for (i = 0; i < n; i++) {
 		if (dir == MB_FWD) {
@@ -124,16 +223,7 @@ static void z9100_smf_mb_rd_array(u32 reg, unsigned int n, enum mb_dir dir,
 		} else {
 			index = (n - 1) - i;
 		}
-		z9100_smf_wr(Z9100_SMF_RAM_ADDR_H, hbyte);
-		z9100_smf_wr(Z9100_SMF_RAM_ADDR_L, lbyte);
-
-		*(array + index) = z9100_smf_rd(Z9100_SMF_RAM_R_DATA);
-
-		if (lbyte == 0xff) {
-			lbyte = 0;	/* address wraps around */
-			hbyte++;
-		} else
-			lbyte++;
+		*(array + index) = z9100_smf_mb_rd_locked(reg + i);
 	}
 	mutex_unlock(&z9100_smf_mbox_mutex);
 }
@@ -402,6 +492,7 @@ static ssize_t mb_fan_serial_num_show(struct device * dev,
 	u32 reg = Z9100_SMF_MB_FAN1_SERIAL_NUM + (35 * idx);
 	char val[Z9100_SMF_MB_FAN1_SERIAL_NUM_SIZE + 1];
 
+	z9100_smf_mb_fru_sync();
 	z9100_smf_mb_rd_array(reg, Z9100_SMF_MB_FAN1_SERIAL_NUM_SIZE, MB_FWD,
 			      val);
 	val[Z9100_SMF_MB_FAN1_SERIAL_NUM_SIZE] = '\0';
@@ -429,6 +520,7 @@ static ssize_t mb_fan_part_num_show(struct device * dev,
 	u32 reg = Z9100_SMF_MB_FAN1_PART_NUM + (35 * idx);
 	char val[Z9100_SMF_MB_FAN1_PART_NUM_SIZE + 1];
 
+	z9100_smf_mb_fru_sync();
 	z9100_smf_mb_rd_array(reg, Z9100_SMF_MB_FAN1_PART_NUM_SIZE, MB_FWD,
 			      val);
 	val[Z9100_SMF_MB_FAN1_PART_NUM_SIZE] = '\0';
@@ -455,6 +547,7 @@ static ssize_t mb_fan_label_rev_show(struct device * dev,
 	u32 reg = Z9100_SMF_MB_FAN1_LABEL_REV + (35 * idx);
 	char val[Z9100_SMF_MB_FAN1_LABEL_REV_SIZE + 1];
 
+	z9100_smf_mb_fru_sync();
 	z9100_smf_mb_rd_array(reg, Z9100_SMF_MB_FAN1_LABEL_REV_SIZE, MB_FWD,
 			      val);
 	val[Z9100_SMF_MB_FAN1_LABEL_REV_SIZE] = '\0';
@@ -661,6 +754,7 @@ static ssize_t mb_psu_county_show(struct device * dev,
 		((attr->index - 1) * Z9100_SMF_MB_PSU_OFFSET);
 	char val[Z9100_SMF_MB_PSU1_COUNTY_SIZE + 1];
 
+	z9100_smf_mb_fru_sync();
 	z9100_smf_mb_rd_array(reg, Z9100_SMF_MB_PSU1_COUNTY_SIZE, MB_FWD, val);
 	val[Z9100_SMF_MB_PSU1_COUNTY_SIZE] = '\0';
 
@@ -679,6 +773,7 @@ static ssize_t mb_psu_part_num_show(struct device * dev,
 		((attr->index - 1) * Z9100_SMF_MB_PSU_OFFSET);
 	char val[Z9100_SMF_MB_PSU1_PART_NUM_SIZE + 1];
 
+	z9100_smf_mb_fru_sync();
 	z9100_smf_mb_rd_array(reg, Z9100_SMF_MB_PSU1_PART_NUM_SIZE, MB_FWD,
 			      val);
 	val[Z9100_SMF_MB_PSU1_PART_NUM_SIZE] = '\0';
@@ -698,6 +793,7 @@ static ssize_t mb_psu_mfg_id_show(struct device * dev,
 		((attr->index - 1) * Z9100_SMF_MB_PSU_OFFSET);
 	char val[Z9100_SMF_MB_PSU1_MFG_ID_SIZE + 1];
 
+	z9100_smf_mb_fru_sync();
 	z9100_smf_mb_rd_array(reg, Z9100_SMF_MB_PSU1_MFG_ID_SIZE, MB_FWD, val);
 	val[Z9100_SMF_MB_PSU1_MFG_ID_SIZE] = '\0';
 
@@ -716,6 +812,7 @@ static ssize_t mb_psu_mfg_date_show(struct device * dev,
 		((attr->index - 1) * Z9100_SMF_MB_PSU_OFFSET);
 	char val[Z9100_SMF_MB_PSU1_MFG_DATE_SIZE + 1];
 
+	z9100_smf_mb_fru_sync();
 	z9100_smf_mb_rd_array(reg, Z9100_SMF_MB_PSU1_MFG_DATE_SIZE, MB_FWD,
 			      val);
 	val[Z9100_SMF_MB_PSU1_MFG_DATE_SIZE] = '\0';
@@ -735,6 +832,7 @@ static ssize_t mb_psu_serial_num_show(struct device * dev,
 		((attr->index - 1) * Z9100_SMF_MB_PSU_OFFSET);
 	char val[Z9100_SMF_MB_PSU1_SERIAL_NUM_SIZE + 1];
 
+	z9100_smf_mb_fru_sync();
 	z9100_smf_mb_rd_array(reg, Z9100_SMF_MB_PSU1_SERIAL_NUM_SIZE, MB_FWD,
 			      val);
 	val[Z9100_SMF_MB_PSU1_SERIAL_NUM_SIZE] = '\0';
@@ -754,6 +852,7 @@ static ssize_t mb_psu_service_tag_show(struct device * dev,
 		((attr->index - 1) * Z9100_SMF_MB_PSU_OFFSET);
 	char val[Z9100_SMF_MB_PSU1_SERVICE_TAG_SIZE + 1];
 
+	z9100_smf_mb_fru_sync();
 	z9100_smf_mb_rd_array(reg, Z9100_SMF_MB_PSU1_SERVICE_TAG_SIZE, MB_FWD,
 			      val);
 	val[Z9100_SMF_MB_PSU1_SERVICE_TAG_SIZE] = '\0';
@@ -773,6 +872,7 @@ static ssize_t mb_psu_label_rev_show(struct device * dev,
 		((attr->index - 1) * Z9100_SMF_MB_PSU_OFFSET);
 	char val[Z9100_SMF_MB_PSU1_LABEL_REV_SIZE + 1];
 
+	z9100_smf_mb_fru_sync();
 	z9100_smf_mb_rd_array(reg, Z9100_SMF_MB_PSU1_LABEL_REV_SIZE, MB_FWD,
 			      val);
 	val[Z9100_SMF_MB_PSU1_LABEL_REV_SIZE] = '\0';
@@ -117,6 +117,10 @@
 
 #define Z9100_SMF_MB_PSU1_BASE     Z9100_SMF_MB_PSU1_MAX
 #define Z9100_SMF_MB_PSU_OFFSET                  57
+#define Z9100_SMF_MB_PSU_VPD_SIZE                (Z9100_SMF_MB_PSU1_LABEL_REV + \
+						  Z9100_SMF_MB_PSU1_LABEL_REV_SIZE - \
+						  Z9100_SMF_MB_PSU1_COUNTY)
+#define Z9100_SMF_MB_NUM_PSUS                    2
 #define Z9100_SMF_MB_PSU_PRESENT_FLAG            0x1 
 #define Z9100_SMF_MB_PSU_OK_FLAG                 0x1c 
 #define Z9100_SMF_MB_PSU_FAN_PRESENT_FLAG        (1 << 2)
@@ -24,93 +24,61 @@
 #include <linux/init.h>
 #include <linux/i2c-ismt.h>
 #include <linux/i2c-mux.h>
+#include <linux/cumulus-cpld-mux.h>
 
 #include "dellemc-n32xx-n22xx-cplds.h"
 
 #define DRIVER_NAME             SYS_CPLD_MUX_DRIVER_NAME
-#define DRIVER_VERSION          "1.2"
+#define DRIVER_VERSION          "1.3"
 
 struct cpld_mux_control {
 	char *dev_name;
-	int invalid_channel;
 	int num_legs;
-	u8 reg;
 	int first_bus;
+	struct cumulus_cpld_mux_group group;
 };
 
+#define CPLD_MUX_GROUP(_reg, _num_legs)		\
+	{					\
+		.reg = _reg,			\
+		.first_chan = 0,		\
+		.num_chans = _num_legs,		\
+		.base_val = 1,			\
+		.idle_val = 0,			\
+	}
+
 static struct cpld_mux_control cpld_muxes[] = {
 	{
 		.dev_name = PORT_MUX_DEVICE_NAME,
-		.invalid_channel = 0,
 		.num_legs = 31,
-		.reg = DELL_N32XX_SYS_PORT_I2C_MUX_REG,
-		.first_bus = DELL_N32XX_N22XX_PORT_MUX_BUS_START
+		.first_bus = DELL_N32XX_N22XX_PORT_MUX_BUS_START,
+		.group = CPLD_MUX_GROUP(DELL_N32XX_SYS_PORT_I2C_MUX_REG, 31),
 	},
 	{
 		.dev_name = FAN_MUX_DEVICE_NAME,
-		.invalid_channel = 0,
 		.num_legs = 3,
-		.reg = DELL_N32XX_SYS_FAN_I2C_MUX_REG,
-		.first_bus = DELL_N32XX_N22XX_FAN_MUX_BUS_START
+		.first_bus = DELL_N32XX_N22XX_FAN_MUX_BUS_START,
+		.group = CPLD_MUX_GROUP(DELL_N32XX_SYS_FAN_I2C_MUX_REG, 3),
 	},
 	{
 		.dev_name = PSU_MUX_DEVICE_NAME,
-		.invalid_channel = 0,
 		.num_legs = 3,
-		.reg = DELL_N32XX_SYS_PSU_I2C_MUX_REG,
-		.first_bus = DELL_N32XX_N22XX_PSU_MUX_BUS_START
+		.first_bus = DELL_N32XX_N22XX_PSU_MUX_BUS_START,
+		.group = CPLD_MUX_GROUP(DELL_N32XX_SYS_PSU_I2C_MUX_REG, 3),
 	},
 	{
 		.dev_name = NULL
 	}
 };
 
-struct cpld_mux_info {
-	int    prev_chan;
-	struct i2c_client *cpld_client;
-	struct i2c_mux_core *muxc;
-	struct cpld_mux_control *mux_cntrl;
-};
-
-static int mux_select_chan(struct i2c_mux_core *muxc, u32 chan)
-{
-	struct cpld_mux_info *data = i2c_mux_priv(muxc);
-	int ret;
-
-	if (data->prev_chan == chan + 1)
-		return 0;
-	ret = i2c_smbus_write_byte_data(data->cpld_client,
-					data->mux_cntrl->reg,
-					chan + 1);
-	if (ret < 0) {
-		data->prev_chan = data->mux_cntrl->invalid_channel;
-		return ret;
-	}
-
-	data->prev_chan = chan + 1;
-	return 0;
-}
-
-static int deselect_mux(struct i2c_mux_core *muxc, u32 chan)
-{
-	struct cpld_mux_info *data = i2c_mux_priv(muxc);
-
-	data->prev_chan = data->mux_cntrl->invalid_channel;
-	return i2c_smbus_write_byte_data(data->cpld_client,
-					 data->mux_cntrl->reg,
-					 data->mux_cntrl->invalid_channel);
-}
-
 static int mux_probe(struct i2c_client *client)
 {
 	struct i2c_adapter *adap = to_i2c_adapter(client->dev.parent);
 	struct device *dev = &client->dev;
 	struct system_cpld_mux_platform_data *pd = dev_get_platdata(dev);
+	struct cumulus_cpld_mux_desc desc = { 0 };
 	struct i2c_mux_core *muxc;
-	struct cpld_mux_info *data;
 	struct cpld_mux_control *mux_cntrl;
-	int i;
-	int ret;
 
 	if (!i2c_check_functionality(adap, I2C_FUNC_SMBUS_BYTE_DATA))
 		return -ENODEV;
@@ -123,52 +91,28 @@ static int mux_probe(struct i2c_client *client)
 	if (!mux_cntrl->dev_name)
 		return -EINVAL;
 
-	muxc = i2c_mux_alloc(adap, dev, mux_cntrl->num_legs, sizeof(*data),
-			     I2C_MUX_LOCKED, mux_select_chan, deselect_mux);
-	if (!muxc)
-		return -ENOMEM;
-	data = i2c_mux_priv(muxc);
-
-	i2c_set_clientdata(client, muxc);
-	data->cpld_client = pd->cpld;
-	data->mux_cntrl = mux_cntrl;
-
 	/*
-	 * Write the mux register at addr to verify that the mux is in fact
-	 * present. This also initializes the mux to deselected state.
+	 * Each mux hangs off its own leg of the PCA9548, so the last
+	 * channel is left selected between transfers.
 	 */
-	if (i2c_smbus_write_byte_data(data->cpld_client,
-				      data->mux_cntrl->reg,
-				      data->mux_cntrl->invalid_channel)) {
-		dev_warn(dev, "probe failed\n");
-		return -ENODEV;
-	}
-
-	data->prev_chan = mux_cntrl->invalid_channel;
-
-	/* Now create an adapter for each channel */
-	for (i = 0; i < mux_cntrl->num_legs; i++) {
-		ret = i2c_mux_add_adapter(muxc, mux_cntrl->first_bus + i, i, 0);
-		if (ret)
-			goto fail_cleanup;
-	}
-
-	dev_info(dev, "registered %d multiplexed busses for I2C mux %s\n",
-		 i, mux_cntrl->dev_name);
+	desc.name = mux_cntrl->dev_name;
+	desc.num_chans = mux_cntrl->num_legs;
+	desc.first_bus = mux_cntrl->first_bus;
+	desc.groups = &mux_cntrl->group;
+	desc.num_groups = 1;
+	desc.mux_flags = I2C_MUX_LOCKED;
+	desc.client = pd->cpld;
+
+	muxc = cumulus_cpld_mux_add(dev, adap, &desc);
+	if (IS_ERR(muxc))
+		return PTR_ERR(muxc);
 
 	return 0;
-
-fail_cleanup:
-	i2c_mux_del_adapters(muxc);
-	return ret;
 }
 
 static int mux_remove(struct i2c_client *client)
 {
-	struct i2c_mux_core *muxc = i2c_get_clientdata(client);
-
-	if (muxc)
-		i2c_mux_del_adapters(muxc);
+	cumulus_cpld_mux_del(i2c_get_clientdata(client));
 	return 0;
 }
 
@@ -24,109 +24,57 @@
 #include <linux/init.h>
 #include <linux/i2c-ismt.h>
 #include <linux/i2c-mux.h>
+#include <linux/cumulus-cpld-mux.h>
 
 #include "dellemc-s41xx-cplds.h"
 
 #define DRIVER_NAME             MUX_DRIVER_NAME
-#define DRIVER_VERSION          "1.1"
+#define DRIVER_VERSION          "1.2"
 #define MUX_INVALID_CHANNEL     0xFF
 #define MUX_NUM_PORTS           54
 #define MUX_SELECT_REG          DELL_S41XX_MSTR_PORT_I2C_MUX_REG
 #define MUX_FIRST_BUS_NUM       DELL_S41XX_MUX_BUS_START
 
-struct port_mux_info {
-	int    prev_chan;
-	struct i2c_client *cpld_client;
-	struct i2c_mux_core *muxc;
+static const struct cumulus_cpld_mux_group mux_group = {
+	.reg = MUX_SELECT_REG,
+	.first_chan = 0,
+	.num_chans = MUX_NUM_PORTS,
+	.base_val = 1,
+	.idle_val = MUX_INVALID_CHANNEL,
 };
 
-static int mux_select_chan(struct i2c_mux_core *muxc, u32 chan)
-{
-	struct port_mux_info *data = i2c_mux_priv(muxc);
-	int ret;
-
-	if (data->prev_chan == chan)
-		return 0;
-	ret = i2c_smbus_write_byte_data(data->cpld_client,
-					MUX_SELECT_REG,
-					chan + 1);
-	if (ret < 0) {
-		data->prev_chan = MUX_INVALID_CHANNEL;
-		return ret;
-	}
-
-	data->prev_chan = chan;
-	return 0;
-}
-
-static int deselect_mux(struct i2c_mux_core *muxc, u32 chan)
-{
-	struct port_mux_info *data = i2c_mux_priv(muxc);
-
-	data->prev_chan = MUX_INVALID_CHANNEL;
-	return i2c_smbus_write_byte_data(data->cpld_client,
-					 MUX_SELECT_REG,
-					 MUX_INVALID_CHANNEL);
-}
-
 static int mux_probe(struct i2c_client *client)
 {
 	struct i2c_adapter *adap = to_i2c_adapter(client->dev.parent);
 	struct device *dev = &client->dev;
-	struct i2c_client *cpld_client = dev_get_platdata(dev);
+	struct cumulus_cpld_mux_desc desc = {
+		.name = client->name,
+		.num_chans = MUX_NUM_PORTS,
+		.first_bus = MUX_FIRST_BUS_NUM,
+		.groups = &mux_group,
+		.num_groups = 1,
+		.mux_flags = I2C_MUX_LOCKED,
+		.client = dev_get_platdata(dev),
+	};
 	struct i2c_mux_core *muxc;
-	struct port_mux_info *data;
-	int i;
-	int ret;
 
 	if (!i2c_check_functionality(adap, I2C_FUNC_SMBUS_BYTE_DATA))
 		return -ENODEV;
 
-	muxc = i2c_mux_alloc(adap, dev, MUX_NUM_PORTS, sizeof(*data),
-			     I2C_MUX_LOCKED, mux_select_chan, deselect_mux);
-	if (!muxc)
-		return -ENOMEM;
-	data = i2c_mux_priv(muxc);
-
-	i2c_set_clientdata(client, muxc);
-	data->cpld_client = cpld_client;
-
 	/*
-	 * Write the mux register at addr to verify that the mux is in fact
-	 * present. This also initializes the mux to deselected state.
+	 * The port leg carries nothing but the ports, so the last port is
+	 * left selected between transfers.
 	 */
-	if (i2c_smbus_write_byte_data(cpld_client,
-				      MUX_SELECT_REG,
-				      MUX_INVALID_CHANNEL)) {
-		dev_warn(dev, "probe failed\n");
-		return -ENODEV;
-	}
-
-	data->prev_chan = MUX_INVALID_CHANNEL;
-
-	/* Now create an adapter for each channel */
-	for (i = 0; i < MUX_NUM_PORTS; i++) {
-		ret = i2c_mux_add_adapter(muxc, MUX_FIRST_BUS_NUM + i, i, 0);
-		if (ret)
-			goto fail_cleanup;
-	}
-
-	dev_info(dev, "registered %d multiplexed busses for I2C mux %s\n",
-		 i, client->name);
+	muxc = cumulus_cpld_mux_add(dev, adap, &desc);
+	if (IS_ERR(muxc))
+		return PTR_ERR(muxc);
 
 	return 0;
-
-fail_cleanup:
-	i2c_mux_del_adapters(muxc);
-	return ret;
 }
 
 static int mux_remove(struct i2c_client *client)
 {
-	struct i2c_mux_core *muxc = i2c_get_clientdata(client);
-
-	if (muxc)
-		i2c_mux_del_adapters(muxc);
+	cumulus_cpld_mux_del(i2c_get_clientdata(client));
 	return 0;
 }
 
@@ -30,12 +30,13 @@
 #include <linux/sysfs.h>
 #include <linux/platform_device.h>
 #include <linux/io.h>
+#include <linux/bitmap.h>
 
 #include "platform-defs.h"
 #include "dellemc-s4248fbl-smf.h"
 
 #define DRIVER_NAME "dellemc_s4248fbl_smf"
-#define DRIVER_VERSION "1.0"
+#define DRIVER_VERSION "1.1"
 
 static DEFINE_MUTEX(dellemc_s4248fbl_smf_mutex);
 
@@ -82,20 +83,104 @@ static SENSOR_DEVICE_ATTR_RO(smf_cpu_eeprom_wp, smf_show, SMF_CPU_EEPROM_WP);
 static SENSOR_DEVICE_ATTR_RO(smf_tpm_status,    smf_show, SMF_TPM_STA_ID);
 
 /* SMF Mailbox Access */
+/*
+ * Mailbox bytes that do not change at runtime are cached: versions,
+ * sensor and FRU counts, temperature limits and the fan tray and PSU
+ * VPD.  The VPD of a FRU is dropped when its presence changes, see
+ * mb_fru_sync().  The cache is protected by dellemc_s4248fbl_smf_mutex.
+ */
+#define SMF_MB_CACHE_SIZE 0x300
+
+struct mb_range {
+	u32 start;
+	u32 end;
+};
+
+static const struct mb_range mb_cached[] = {
+	{ SMF_PROTOCOL_VER, SMF_TEMP_SENSOR_BASE - 1 },
+	{ SMF_TEMP_HW_SHUT_BASE, SMF_TEMP_STATUS_BASE - 1 },
+	{ SMF_MAX_FAN_TRAYS, SMF_FANS_PER_TRAY },
+	{ SMF_FAN_TRAY_SERIAL_NUM_BASE, SMF_FAN_CONTROL_ALGO_FLAG - 1 },
+	{ SMF_MAX_PSUS, SMF_MAX_PSUS },
+	{ SMF_PSU_COUNTRY_CODE_BASE,
+	  SMF_PSU_COUNTRY_CODE_BASE + SMF_PSU_VPD_SIZE - 1 },
+	{ SMF_PSU_COUNTRY_CODE_BASE + SMF_PSU_BLOCK_SIZE,
+	  SMF_PSU_COUNTRY_CODE_BASE + SMF_PSU_BLOCK_SIZE +
+	  SMF_PSU_VPD_SIZE - 1 },
+};
+
+static u8 mb_cache[SMF_MB_CACHE_SIZE];
+static DECLARE_BITMAP(mb_cache_valid, SMF_MB_CACHE_SIZE);
+static int mb_fan_present = -1;
+static int mb_psu_present[SMF_NUM_PSUS] = { -1, -1 };
+
+static bool mb_cacheable(u32 reg)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(mb_cached); i++)
+		if (reg >= mb_cached[i].start && reg <= mb_cached[i].end)
+			return true;
+
+	return false;
+}
+
+/* Called with dellemc_s4248fbl_smf_mutex held */
 static u8 mb_rd(u32 reg)
 {
+	bool cacheable = mb_cacheable(reg);
 	u8 hbyte, lbyte;
 	u8 rdata;
 
+	if (cacheable && test_bit(reg, mb_cache_valid))
+		return mb_cache[reg];
+
 	hbyte = (reg >> 8) & 0xff;
 	lbyte = reg & 0xff;
 	smf_wr(SMF_RAM_ADDR_H, hbyte);
 	smf_wr(SMF_RAM_ADDR_L, lbyte);
 
 	rdata = smf_rd(SMF_RAM_R_DATA);
+	if (cacheable) {
+		mb_cache[reg] = rdata;
+		set_bit(reg, mb_cache_valid);
+	}
 	return rdata;
 }
 
+/*
+ * Read the presence of the fan trays and PSUs and drop the cached VPD
+ * of every FRU whose presence changed since the last call.  Called
+ * with dellemc_s4248fbl_smf_mutex held before reading VPD.
+ */
+static void mb_fru_sync(void)
+{
+	unsigned long changed;
+	u32 reg;
+	int now;
+	int i;
+
+	now = mb_rd(SMF_FAN_PRESENT);
+	changed = (mb_fan_present < 0) ? 0xff : (now ^ mb_fan_present);
+	for_each_set_bit(i, &changed, BITS_PER_BYTE)
+		bitmap_clear(mb_cache_valid,
+			     SMF_FAN_TRAY_SERIAL_NUM_BASE +
+			     i * SMF_FAN_BLOCK_SIZE,
+			     SMF_FAN_BLOCK_SIZE);
+	mb_fan_present = now;
+
+	for (i = 0; i < SMF_NUM_PSUS; i++) {
+		reg = SMF_PSU_STATUS_BASE + i * SMF_PSU_BLOCK_SIZE;
+		now = mb_rd(reg) & SMF_PSU_PRESENT_N_MASK;
+		if (now != mb_psu_present[i])
+			bitmap_clear(mb_cache_valid,
+				     SMF_PSU_COUNTRY_CODE_BASE +
+				     i * SMF_PSU_BLOCK_SIZE,
+				     SMF_PSU_VPD_SIZE);
+		mb_psu_present[i] = now;
+	}
+}
+
 /* SMF Mailbox sysfs access */
 static ssize_t mb_show(struct device *dev,
 		       struct device_attribute *dattr,
@@ -430,6 +515,7 @@ static ssize_t mb_fan_tray_serial_num_show(struct device *dev,
 	int i;
 
 	mutex_lock(&dellemc_s4248fbl_smf_mutex);
+	mb_fru_sync();
 	for (i = 0; i < SMF_FAN_TRAY_SERIAL_NUM_SIZE; i++)
 		val[i] = mb_rd(reg + i);
 	mutex_unlock(&dellemc_s4248fbl_smf_mutex);
@@ -466,6 +552,7 @@ static ssize_t mb_fan_tray_part_num_show(struct device *dev,
 	int i;
 
 	mutex_lock(&dellemc_s4248fbl_smf_mutex);
+	mb_fru_sync();
 	for (i = 0; i < SMF_FAN_TRAY_PART_NUM_SIZE; i++)
 		val[i] = mb_rd(reg + i);
 	mutex_unlock(&dellemc_s4248fbl_smf_mutex);
@@ -493,6 +580,7 @@ static ssize_t mb_fan_tray_label_rev_show(struct device *dev,
 	int i;
 
 	mutex_lock(&dellemc_s4248fbl_smf_mutex);
+	mb_fru_sync();
 	for (i = 0; i < SMF_FAN_TRAY_LABEL_REV_SIZE; i++)
 		val[i] = mb_rd(reg + i);
 	mutex_unlock(&dellemc_s4248fbl_smf_mutex);
@@ -740,6 +828,7 @@ static ssize_t mb_psu_country_code_show(struct device *dev,
 	int i;
 
 	mutex_lock(&dellemc_s4248fbl_smf_mutex);
+	mb_fru_sync();
 	for (i = 0; i < SMF_PSU_COUNTRY_CODE_SIZE; i++)
 		val[i] = mb_rd(reg + i);
 	mutex_unlock(&dellemc_s4248fbl_smf_mutex);
@@ -760,6 +849,7 @@ static ssize_t mb_psu_part_num_show(struct device *dev,
 	int i;
 
 	mutex_lock(&dellemc_s4248fbl_smf_mutex);
+	mb_fru_sync();
 	for (i = 0; i < SMF_PSU_PART_NUM_SIZE; i++)
 		val[i] = mb_rd(reg + i);
 	mutex_unlock(&dellemc_s4248fbl_smf_mutex);
@@ -780,6 +870,7 @@ static ssize_t mb_psu_mfg_id_show(struct device *dev,
 	int i;
 
 	mutex_lock(&dellemc_s4248fbl_smf_mutex);
+	mb_fru_sync();
 	for (i = 0; i < SMF_PSU_MFG_ID_SIZE; i++)
 		val[i] = mb_rd(reg + i);
 	mutex_unlock(&dellemc_s4248fbl_smf_mutex);
@@ -800,6 +891,7 @@ static ssize_t mb_psu_mfg_date_show(struct device *dev,
 	int i;
 
 	mutex_lock(&dellemc_s4248fbl_smf_mutex);
+	mb_fru_sync();
 	for (i = 0; i < SMF_PSU_MFG_DATE_SIZE; i++)
 		val[i] = mb_rd(reg + i);
 	mutex_unlock(&dellemc_s4248fbl_smf_mutex);
@@ -820,6 +912,7 @@ static ssize_t mb_psu_serial_num_show(struct device *dev,
 	int i;
 
 	mutex_lock(&dellemc_s4248fbl_smf_mutex);
+	mb_fru_sync();
 	for (i = 0; i < SMF_PSU_SERIAL_NUM_SIZE; i++)
 		val[i] = mb_rd(reg + i);
 	mutex_unlock(&dellemc_s4248fbl_smf_mutex);
@@ -840,6 +933,7 @@ static ssize_t mb_psu_service_tag_show(struct device *dev,
 	int i;
 
 	mutex_lock(&dellemc_s4248fbl_smf_mutex);
+	mb_fru_sync();
 	for (i = 0; i < SMF_PSU_SERVICE_TAG_SIZE; i++)
 		val[i] = mb_rd(reg + i);
 	mutex_unlock(&dellemc_s4248fbl_smf_mutex);
@@ -860,6 +954,7 @@ static ssize_t mb_psu_label_rev_show(struct device *dev,
 	int i;
 
 	mutex_lock(&dellemc_s4248fbl_smf_mutex);
+	mb_fru_sync();
 	for (i = 0; i < SMF_PSU_LABEL_REV_SIZE; i++)
 		val[i] = mb_rd(reg + i);
 	mutex_unlock(&dellemc_s4248fbl_smf_mutex);
@@ -123,6 +123,10 @@
 #define SMF_PSU_LABEL_REV_SIZE          3
 
 #define SMF_PSU_BLOCK_SIZE              57
+#define SMF_PSU_VPD_SIZE                (SMF_PSU_LABEL_REV_BASE + \
+					 SMF_PSU_LABEL_REV_SIZE - \
+					 SMF_PSU_COUNTRY_CODE_BASE)
+#define SMF_NUM_PSUS                    2
 #define SMF_PSU_PRESENT_N_MASK          BIT(0)
 #define SMF_PSU_DC_MASK                 BIT(1)
 #define SMF_PSU_ALL_OK_N_MASK           0x1d
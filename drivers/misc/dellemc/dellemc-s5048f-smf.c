@@ -21,16 +21,19 @@
 #include <linux/hwmon.h>
 #include <linux/hwmon-sysfs.h>
 #include <linux/platform_device.h>
+#include <linux/mutex.h>
+#include <linux/bitmap.h>
 
 #include "platform-defs.h"
 #include "dellemc-s5048f-smf.h"
 
 #define DRIVER_NAME    S5048F_SMF_NAME
-#define DRIVER_VERSION "1.1"
+#define DRIVER_VERSION "1.2"
 #define IO_BASE        SMF_IO_BASE
 #define IO_SIZE        SMF_IO_SIZE
 
 static u8 *smf_regs;
+static DEFINE_MUTEX(s5048f_smf_mb_mutex);
 
 /* SMF Access via LPC registers */
 static inline uint8_t smf_rd(u32 reg)
@@ -72,20 +75,123 @@ static SENSOR_DEVICE_ATTR_RO(smf_cpu_eeprom_wp, smf_show, SMF_CPU_EEPROM_WP);
 static SENSOR_DEVICE_ATTR_RO(smf_tpm_status,    smf_show, SMF_TPM_STA_ID);
 
 /* SMF Mailbox Access */
-static u8 mb_rd(u32 reg)
+/*
+ * Mailbox bytes that do not change at runtime are cached: versions,
+ * sensor and FRU counts, temperature limits and the fan tray and PSU
+ * VPD.  The VPD of a FRU is dropped when its presence changes, see
+ * mb_fru_sync().  The cache is protected by s5048f_smf_mb_mutex.
+ */
+#define SMF_MB_CACHE_SIZE 0x300
+
+struct mb_range {
+	u32 start;
+	u32 end;
+};
+
+static const struct mb_range mb_cached[] = {
+	{ SMF_PROTOCOL_VER, SMF_TEMP_SENSOR_BASE - 1 },
+	{ SMF_TEMP_HW_SHUT_BASE, SMF_TEMP_STATUS_BASE - 1 },
+	{ SMF_MAX_FAN_TRAYS, SMF_FANS_PER_TRAY },
+	{ SMF_FAN_TRAY_SERIAL_NUM_BASE, SMF_FAN_CONTROL_ALGO_FLAG - 1 },
+	{ SMF_MAX_PSUS, SMF_MAX_PSUS },
+	{ SMF_PSU_COUNTRY_CODE_BASE,
+	  SMF_PSU_COUNTRY_CODE_BASE + SMF_PSU_VPD_SIZE - 1 },
+	{ SMF_PSU_COUNTRY_CODE_BASE + SMF_PSU_BLOCK_SIZE,
+	  SMF_PSU_COUNTRY_CODE_BASE + SMF_PSU_BLOCK_SIZE +
+	  SMF_PSU_VPD_SIZE - 1 },
+};
+
+static u8 mb_cache[SMF_MB_CACHE_SIZE];
+static DECLARE_BITMAP(mb_cache_valid, SMF_MB_CACHE_SIZE);
+static int mb_fan_present = -1;
+static int mb_psu_present[SMF_NUM_PSUS] = { -1, -1 };
+
+static bool mb_cacheable(u32 reg)
 {
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(mb_cached); i++)
+		if (reg >= mb_cached[i].start && reg <= mb_cached[i].end)
+			return true;
+
+	return false;
+}
+
+/* Read one mailbox byte, called with s5048f_smf_mb_mutex held */
+static u8 __mb_rd(u32 reg)
+{
+	bool cacheable = mb_cacheable(reg);
 	u8 hbyte, lbyte;
 	u8 rdata;
 
+	if (cacheable && test_bit(reg, mb_cache_valid))
+		return mb_cache[reg];
+
 	hbyte = (reg >> 8) & 0xff;
 	lbyte = reg & 0xff;
 	smf_wr(SMF_RAM_ADDR_H, hbyte);
 	smf_wr(SMF_RAM_ADDR_L, lbyte);
 
 	rdata = smf_rd(SMF_RAM_R_DATA);
+	if (cacheable) {
+		mb_cache[reg] = rdata;
+		set_bit(reg, mb_cache_valid);
+	}
 	return rdata;
 }
 
+static u8 mb_rd(u32 reg)
+{
+	u8 rdata;
+
+	mutex_lock(&s5048f_smf_mb_mutex);
+	rdata = __mb_rd(reg);
+	mutex_unlock(&s5048f_smf_mb_mutex);
+
+	return rdata;
+}
+
+/*
+ * Read the presence of the fan trays and PSUs and drop the cached VPD
+ * of every FRU whose presence changed since the last call.  Called
+ * with s5048f_smf_mb_mutex held.
+ */
+static void __mb_fru_sync(void)
+{
+	unsigned long changed;
+	u32 reg;
+	int now;
+	int i;
+
+	now = __mb_rd(SMF_FAN_PRESENT);
+	changed = (mb_fan_present < 0) ? 0xff : (now ^ mb_fan_present);
+	for_each_set_bit(i, &changed, BITS_PER_BYTE)
+		bitmap_clear(mb_cache_valid,
+			     SMF_FAN_TRAY_SERIAL_NUM_BASE +
+			     i * SMF_FAN_BLOCK_SIZE,
+			     SMF_FAN_BLOCK_SIZE);
+	mb_fan_present = now;
+
+	for (i = 0; i < SMF_NUM_PSUS; i++) {
+		reg = SMF_PSU_STATUS_BASE + i * SMF_PSU_BLOCK_SIZE;
+		now = __mb_rd(reg) & SMF_PSU_PRESENT_N_MASK;
+		if (now != mb_psu_present[i])
+			bitmap_clear(mb_cache_valid,
+				     SMF_PSU_COUNTRY_CODE_BASE +
+				     i * SMF_PSU_BLOCK_SIZE,
+				     SMF_PSU_VPD_SIZE);
+		mb_psu_present[i] = now;
+	}
+}
+
+/* Called before reading VPD */
+static void mb_fru_sync(void)
+{
+	mutex_lock(&s5048f_smf_mb_mutex);
+	__mb_fru_sync();
+	mutex_unlock(&s5048f_smf_mb_mutex);
+}
+
 /* SMF Mailbox sysfs access */
 static ssize_t mb_show(struct device *dev,
 		       struct device_attribute *dattr,
@@ -391,6 +497,7 @@ static ssize_t mb_fan_tray_serial_num_show(struct device *dev,
 	char val[SMF_FAN_TRAY_SERIAL_NUM_SIZE + 1];
 	int i;
 
+	mb_fru_sync();
 	for (i = 0; i < SMF_FAN_TRAY_SERIAL_NUM_SIZE; i++)
 		val[i] = mb_rd(reg + i);
 	val[SMF_FAN_TRAY_SERIAL_NUM_SIZE] = '\0';
@@ -424,6 +531,7 @@ static ssize_t mb_fan_tray_part_num_show(struct device *dev,
 	char val[SMF_FAN_TRAY_PART_NUM_SIZE + 1];
 	int i;
 
+	mb_fru_sync();
 	for (i = 0; i < SMF_FAN_TRAY_PART_NUM_SIZE; i++)
 		val[i] = mb_rd(reg + i);
 	val[SMF_FAN_TRAY_PART_NUM_SIZE] = '\0';
@@ -448,6 +556,7 @@ static ssize_t mb_fan_tray_label_rev_show(struct device *dev,
 	char val[SMF_FAN_TRAY_LABEL_REV_SIZE + 1];
 	int i;
 
+	mb_fru_sync();
 	for (i = 0; i < SMF_FAN_TRAY_LABEL_REV_SIZE; i++)
 		val[i] = mb_rd(reg + i);
 	val[SMF_FAN_TRAY_LABEL_REV_SIZE] = '\0';
@@ -661,6 +770,7 @@ static ssize_t mb_psu_country_code_show(struct device *dev,
 	char val[SMF_PSU_COUNTRY_CODE_SIZE + 1];
 	int i;
 
+	mb_fru_sync();
 	for (i = 0; i < SMF_PSU_COUNTRY_CODE_SIZE; i++)
 		val[i] = mb_rd(reg + i);
 	val[SMF_PSU_COUNTRY_CODE_SIZE] = '\0';
@@ -678,6 +788,7 @@ static ssize_t mb_psu_part_num_show(struct device *dev,
 	char val[SMF_PSU_PART_NUM_SIZE + 1];
 	int i;
 
+	mb_fru_sync();
 	for (i = 0; i < SMF_PSU_PART_NUM_SIZE; i++)
 		val[i] = mb_rd(reg + i);
 	val[SMF_PSU_PART_NUM_SIZE] = '\0';
@@ -695,6 +806,7 @@ static ssize_t mb_psu_mfg_id_show(struct device *dev,
 	char val[SMF_PSU_MFG_ID_SIZE + 1];
 	int i;
 
+	mb_fru_sync();
 	for (i = 0; i < SMF_PSU_MFG_ID_SIZE; i++)
 		val[i] = mb_rd(reg + i);
 	val[SMF_PSU_MFG_ID_SIZE] = '\0';
@@ -712,6 +824,7 @@ static ssize_t mb_psu_mfg_date_show(struct device *dev,
 	char val[SMF_PSU_MFG_DATE_SIZE + 1];
 	int i;
 
+	mb_fru_sync();
 	for (i = 0; i < SMF_PSU_MFG_DATE_SIZE; i++)
 		val[i] = mb_rd(reg + i);
 	val[SMF_PSU_MFG_DATE_SIZE] = '\0';
@@ -729,6 +842,7 @@ static ssize_t mb_psu_serial_num_show(struct device *dev,
 	char val[SMF_PSU_SERIAL_NUM_SIZE + 1];
 	int i;
 
+	mb_fru_sync();
 	for (i = 0; i < SMF_PSU_SERIAL_NUM_SIZE; i++)
 		val[i] = mb_rd(reg + i);
 	val[SMF_PSU_SERIAL_NUM_SIZE] = '\0';
@@ -746,6 +860,7 @@ static ssize_t mb_psu_service_tag_show(struct device *dev,
 	char val[SMF_PSU_SERVICE_TAG_SIZE + 1];
 	int i;
 
+	mb_fru_sync();
 	for (i = 0; i < SMF_PSU_SERVICE_TAG_SIZE; i++)
 		val[i] = mb_rd(reg + i);
 	val[SMF_PSU_SERVICE_TAG_SIZE] = '\0';
@@ -763,6 +878,7 @@ static ssize_t mb_psu_label_rev_show(struct device *dev,
 	char val[SMF_PSU_LABEL_REV_SIZE + 1];
 	int i;
 
+	mb_fru_sync();
 	for (i = 0; i < SMF_PSU_LABEL_REV_SIZE; i++)
 		val[i] = mb_rd(reg + i);
 	val[SMF_PSU_LABEL_REV_SIZE] = '\0';
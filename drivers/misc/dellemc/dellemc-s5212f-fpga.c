@@ -33,6 +33,7 @@
 #include <linux/platform_data/sff-8436.h>
 #include <linux/platform_data/pca954x.h>
 #include <linux/cumulus-platform.h>
+#include <linux/cumulus-ocores-irq.h>
 #include "platform-defs.h"
 #include "platform-bitfield.h"
 #include "dellemc-z9xxx-s52xx-fpga.h"
@@ -324,6 +325,7 @@ struct fpga_priv {
 	u8 __iomem                   *pbar;
 	struct pci_dev               *pci_dev;
 	struct fpga_desc             *hw;
+	struct cumulus_ocores_irq    *i2c_irq;
 };
 
 /* Accessor functions for reading and writing the FPGA registers */
@@ -672,13 +674,22 @@ static struct resource ctrl_resource;
 
 static struct platform_device *platdev[NUM_FPGA_BUSSES];
 
+/* The i2c channels, see cumulus_ocores_irq_pci_add() */
+static const struct cumulus_ocores_irq_desc fpga_i2c_irq_desc = {
+	.name = DRIVER_NAME,
+	.stride = DELL_Z9S52_I2C_CH_STRIDE,
+	.num_channels = NUM_FPGA_BUSSES,
+};
+
 static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *devid)
 {
 	struct fpga_priv *priv;
 	struct resource *cres;
 	struct ocores_i2c_platform_data *fipd;
+	struct resource res[2];
 	unsigned long start, len;
 	int i, j, ch, index;
+	int irq;
 	int err;
 	struct i2c_client *client;
 
@@ -735,6 +746,10 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *devid)
 		goto err_sysfs_create;
 	}
 
+	/* the channels keep polling if this fails */
+	priv->i2c_irq = cumulus_ocores_irq_pci_add(pdev,
+			start + DELL_Z9S52_I2C_PREPLO_REG, &fpga_i2c_irq_desc);
+
 	/*
 	 * The device slice loop.  Each of the devices in
 	 * fpga_device_infotab[] carves out its own name, resources,
@@ -777,7 +792,11 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *devid)
 			goto err_device_alloc;
 		}
 
-		err = platform_device_add_resources(platdev[index], cres, 1);
+		irq = cumulus_ocores_irq_get(priv->i2c_irq, index);
+		res[0] = *cres;
+		res[1] = (struct resource)DEFINE_RES_IRQ(irq);
+		err = platform_device_add_resources(platdev[index], res,
+						    irq > 0 ? 2 : 1);
 		if (err) {
 			pr_err(DRIVER_NAME ": failed to add resources for FPGA I2C ch%d\n",
 			       ch);
@@ -791,7 +810,8 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *devid)
 		fipd->clock_khz		= 100000;
 		fipd->devices		= &fpga_device_infotab[index];
 		fipd->num_devices	= 1;
-		fipd->interrupt_mode	= OCI2C_POLL;
+		/* zero is interrupt mode, using the IRQ resource */
+		fipd->interrupt_mode	= irq > 0 ? 0 : OCI2C_POLL;
 
 		err = platform_device_add_data(platdev[index], fipd,
 					       sizeof(*fipd));
@@ -852,6 +872,8 @@ err_device_alloc:
 		}
 	}
 
+	cumulus_ocores_irq_del(priv->i2c_irq);
+	priv->i2c_irq = NULL;
 	sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
 err_sysfs_create:
 	devm_iounmap(&pdev->dev, priv->pbar);
@@ -887,6 +909,8 @@ static void fpga_remove(struct pci_dev *pdev)
 		platdev[index] = NULL;
 	}
 	priv = dev_get_drvdata(&pdev->dev);
+	cumulus_ocores_irq_del(priv->i2c_irq);
+	priv->i2c_irq = NULL;
 	sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
 	devm_iounmap(&pdev->dev, priv->pbar);
 	/*	devm_kfree(&pdev->dev, priv->hw);*/
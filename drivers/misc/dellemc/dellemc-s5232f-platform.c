@@ -32,8 +32,10 @@
 #include <linux/platform_data/sff-8436.h>
 #include <linux/platform_data/pca954x.h>
 #include <linux/cumulus-platform.h>
+#include <linux/cumulus-ocores-irq.h>
 #include "platform-defs.h"
 #include "platform-bitfield.h"
+#include "dellemc-z9xxx-s52xx-fpga.h"
 
 #define DRIVER_NAME		  "dellemc_s5232f_platform"
 #define DRIVER_VERSION		  "1.1"
@@ -315,6 +317,7 @@ struct fpga_priv {
 	u8 __iomem *pbar;                       /* PCIe base address register */
 	struct pci_dev *pci_dev;
 	struct fpga_desc *hw;			/* descriptor virt base addr */
+	struct cumulus_ocores_irq *i2c_irq;	/* i2c channel interrupts */
 };
 
 /* Accessor functions for reading and writing the FPGA registers */
@@ -809,7 +812,7 @@ static struct __init i2c_board_info * alloc_port_i2c_board_info(int port)
 
 	sff8436_data->byte_len = 256;
 	sff8436_data->flags = SFF_8436_FLAG_IRUGO;
-	sff8436_data->page_size = 1;
+	sff8436_data->page_size = QSFP_PAGE_SIZE;
 	sff8436_data->eeprom_data = eeprom_data;
 	board_info->platform_data = sff8436_data;
 	strcpy(board_info->type, "sff8436");
@@ -845,6 +848,33 @@ err_kzalloc:
 
 static struct resource fpga_resources[NUM_FPGA_BUSSES + 1];
 static struct resource ctrl_resource;
+static struct platform_device *ocores_platdevs[ITABSIZE];
+
+/* The i2c channels, see cumulus_ocores_irq_pci_add() */
+static const struct cumulus_ocores_irq_desc fpga_i2c_irq_desc = {
+	.name = DRIVER_NAME,
+	.stride = DELL_Z9S52_I2C_CH_STRIDE,
+	.num_channels = NUM_FPGA_BUSSES,
+};
+
+/*
+ * Unregister the i2c-ocores devices, which also removes every client
+ * on their busses, then release the interrupt they used.
+ */
+static void fpga_ocores_exit(struct pci_dev *pdev, struct fpga_priv *priv)
+{
+	int i;
+
+	for (i = ARRAY_SIZE(ocores_platdevs); --i >= 0;) {
+		if (ocores_platdevs[i]) {
+			platform_device_unregister(ocores_platdevs[i]);
+			ocores_platdevs[i] = NULL;
+		}
+	}
+
+	cumulus_ocores_irq_del(priv->i2c_irq);
+	priv->i2c_irq = NULL;
+}
 
 static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 {
@@ -854,9 +884,11 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 	struct platform_i2c_device_info *muxdev;
 	struct ocores_i2c_platform_data *oipd;
 	struct platform_device *platdev;
+	struct resource res[2];
 	unsigned long start, len;
 	int i;
 	int err;
+	int irq;
 
 	priv = devm_kzalloc(&pdev->dev, sizeof(*priv), GFP_KERNEL);
 	if (!priv)
@@ -944,6 +976,10 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 		ores->flags = IORESOURCE_MEM;
 	}
 
+	/* the channels keep polling if this fails */
+	priv->i2c_irq = cumulus_ocores_irq_pci_add(pdev,
+			start + DELL_Z9S52_I2C_PREPLO_REG, &fpga_i2c_irq_desc);
+
 	/*
 	 * The device slice loop.  Each of the devices in
 	 * fpga_device_infotab[] carves out its own name, resources,
@@ -968,6 +1004,7 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 		if (!platdev) {
 			pr_err("device allocation failed for ocores %d\n", i);
 			err = -ENOMEM;
+			fpga_ocores_exit(pdev, priv);
 			sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
 			devm_iounmap(&pdev->dev, priv->pbar);
 			fpga_dev_release(priv);
@@ -977,9 +1014,14 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 		}
 
 		ores = &fpga_resources[muxdev->bus];
-		err = platform_device_add_resources(platdev, ores, 1);
+		irq = cumulus_ocores_irq_get(priv->i2c_irq, muxdev->bus - 1);
+		res[0] = *ores;
+		res[1] = (struct resource)DEFINE_RES_IRQ(irq);
+		err = platform_device_add_resources(platdev, res,
+						    irq > 0 ? 2 : 1);
 		if (err) {
 			pr_err("failed to add resources for ocores %d\n", i);
+			fpga_ocores_exit(pdev, priv);
 			sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
 			devm_iounmap(&pdev->dev, priv->pbar);
 			fpga_dev_release(priv);
@@ -995,11 +1037,13 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 		oipd->clock_khz		= 100000;
 		oipd->devices		= info;
 		oipd->num_devices	= 1;
-		oipd->interrupt_mode	= OCI2C_POLL;
+		/* zero is interrupt mode, using the IRQ resource */
+		oipd->interrupt_mode	= irq > 0 ? 0 : OCI2C_POLL;
 
 		err = platform_device_add_data(platdev, oipd, sizeof(*oipd));
 		if (err) {
 			pr_err("add data failed for ocores %d\n", i);
+			fpga_ocores_exit(pdev, priv);
 			sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
 			devm_iounmap(&pdev->dev, priv->pbar);
 			fpga_dev_release(priv);
@@ -1011,6 +1055,7 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 		err = platform_device_add(platdev);
 		if (err) {
 			pr_err("failed to add device for ocores %d\n", i);
+			fpga_ocores_exit(pdev, priv);
 			sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
 			devm_iounmap(&pdev->dev, priv->pbar);
 			fpga_dev_release(priv);
@@ -1018,6 +1063,7 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 			devm_kfree(&pdev->dev, priv);
 			goto fail;
 		}
+		ocores_platdevs[i] = platdev;
 	}
 
 	pr_debug("fpga driver loaded\n");
@@ -1031,6 +1077,7 @@ static void fpga_remove(struct pci_dev *pdev)
 	struct fpga_priv *priv;
 
 	priv = dev_get_drvdata(&pdev->dev);
+	fpga_ocores_exit(pdev, priv);
 	sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
 	devm_iounmap(&pdev->dev, priv->pbar);
 	fpga_dev_release(priv);
@@ -1141,8 +1188,8 @@ static int __init dellemc_s5232f_init(void)
 	ret = fpga_init();
 	if (ret) {
 		pr_err("FPGA initialization failed\n");
-		fpga_exit();
 		i2c_exit();
+		fpga_exit();
 		return ret;
 	}
 
@@ -1153,8 +1200,8 @@ static int __init dellemc_s5232f_init(void)
 
 static void __exit dellemc_s5232f_exit(void)
 {
-	fpga_exit();
 	i2c_exit();
+	fpga_exit();
 	pr_info(DRIVER_NAME " driver successfully unloaded\n");
 }
 
@@ -33,12 +33,15 @@
 #include <linux/platform_data/sff-8436.h>
 #include <linux/platform_data/pca954x.h>
 #include <linux/cumulus-platform.h>
+#include <linux/cumulus-port-eeprom.h>
+#include <linux/cumulus-ocores-irq.h>
 
 #include "platform-defs.h"
 #include "platform-bitfield.h"
+#include "dellemc-z9xxx-s52xx-fpga.h"
 
 #define DRIVER_NAME		  "dellemc_s5248f_platform"
-#define DRIVER_VERSION		  "1.2"
+#define DRIVER_VERSION		  "1.3"
 
 #define ISMT_ADAPTER_NAME	  "SMBus iSMT adapter"
 #define I801_ADAPTER_NAME	  "SMBus I801 adapter"
@@ -429,7 +432,7 @@ static struct __init i2c_board_info * alloc_port_i2c_board_info(int port)
 
 		sff8436_data->byte_len = 256;
 		sff8436_data->flags = SFF_8436_FLAG_IRUGO;
-		sff8436_data->page_size = 1;
+		sff8436_data->page_size = QSFP_PAGE_SIZE;
 		sff8436_data->eeprom_data = eeprom_data;
 		board_info->platform_data = sff8436_data;
 		strcpy(board_info->type, "sff8436");
@@ -442,7 +445,7 @@ static struct __init i2c_board_info * alloc_port_i2c_board_info(int port)
 
 		at24_data->byte_len = 512;
 		at24_data->flags = AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG;
-		at24_data->page_size = 1;
+		at24_data->page_size = SFP_PAGE_SIZE;
 		at24_data->eeprom_data = eeprom_data;
 		board_info->platform_data = at24_data;
 		strcpy(board_info->type, "24c04");
@@ -543,6 +546,9 @@ struct fpga_priv {
 	u8 __iomem *pbar;		/* PCIe BAR virtual addr */
 	struct pci_dev *pci_dev;
 	struct fpga_desc *hw;		/* FPGA descriptor virtual base addr */
+	struct cumulus_presence *presence;
+	struct cumulus_port_eeprom *port_eeprom;
+	struct cumulus_ocores_irq *i2c_irq;
 };
 
 /* Accessor functions for reading and writing the FPGA registers */
@@ -1182,6 +1188,139 @@ static struct attribute_group  fpga_attr_group = {
 	.attrs = fpga_attrs,
 };
 
+/*
+ * Port table for cumulus-port-eeprom.c, in ocores_i2c_devices[] order.
+ * The QSFP-DD ports 49 and 52 get the CMIS paged layout.
+ */
+#define NUM_SFP_PORTS	48
+#define NUM_QSFP_PORTS	6
+
+static const struct cumulus_port_eeprom_port fpga_port_eeproms[] = {
+	{ CL_I2C_FPGA_BUS4_0,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS4_1,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS4_2,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS4_3,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS4_4,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS4_5,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS4_6,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS4_7,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS5_0,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS5_1,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS5_2,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS5_3,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS5_4,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS5_5,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS5_6,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS5_7,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS6_0,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS6_1,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS6_2,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS6_3,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS6_4,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS6_5,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS6_6,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS6_7,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS7_0,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS7_1,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS7_2,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS7_3,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS7_4,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS7_5,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS7_6,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS7_7,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS8_0,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS8_1,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS8_2,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS8_3,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS8_4,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS8_5,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS8_6,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS8_7,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS9_0,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS9_1,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS9_2,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS9_3,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS9_4,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS9_5,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS9_6,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS9_7,  CUMULUS_PORT_EEPROM_SFP },
+	{ CL_I2C_FPGA_BUS10_0, CUMULUS_PORT_EEPROM_CMIS, 49 },
+	{ CL_I2C_FPGA_BUS10_1, CUMULUS_PORT_EEPROM_CMIS, 52 },
+	{ CL_I2C_FPGA_BUS10_2, CUMULUS_PORT_EEPROM_QSFP, 53 },
+	{ CL_I2C_FPGA_BUS10_3, CUMULUS_PORT_EEPROM_QSFP, 54 },
+	{ CL_I2C_FPGA_BUS10_4, CUMULUS_PORT_EEPROM_QSFP, 55 },
+	{ CL_I2C_FPGA_BUS10_5, CUMULUS_PORT_EEPROM_QSFP, 56 },
+};
+
+/* QSFP28/QSFP-DD status registers, in fpga_port_eeproms[] order */
+static const u16 fpga_qsfp_status_regs[NUM_QSFP_PORTS] = {
+	0x4304, 0x4324, 0x4344, 0x4354, 0x4364, 0x4374,
+};
+
+/*
+ * Presence sampling callback, see cumulus-presence.c.  The present
+ * bits are active low, bit 0 for SFP and bit 4 for QSFP28/QSFP-DD.
+ */
+static int fpga_presence_read(void *data, unsigned long *present)
+{
+	struct fpga_priv *priv = data;
+	u32 stat;
+	int i;
+
+	for (i = 0; i < NUM_SFP_PORTS; i++) {
+		stat = readl(priv->pbar + 0x4004 + 16 * i);
+		if (!(stat & BIT(0)))
+			__set_bit(i, present);
+	}
+	for (i = 0; i < NUM_QSFP_PORTS; i++) {
+		stat = readl(priv->pbar + fpga_qsfp_status_regs[i]);
+		if (!(stat & BIT(4)))
+			__set_bit(NUM_SFP_PORTS + i, present);
+	}
+
+	return 0;
+}
+
+static void fpga_port_monitor_init(struct pci_dev *pdev,
+				   struct fpga_priv *priv)
+{
+	struct cumulus_presence_desc pres_desc = {
+		.name = DRIVER_NAME,
+		.num_ports = NUM_SFP_PORTS + NUM_QSFP_PORTS,
+		.read = fpga_presence_read,
+		.priv = priv,
+	};
+	struct cumulus_port_eeprom_desc pe_desc = {
+		.name = DRIVER_NAME,
+		.ports = fpga_port_eeproms,
+		.num_ports = ARRAY_SIZE(fpga_port_eeproms),
+	};
+
+	priv->presence = cumulus_presence_add(&pdev->dev, &pres_desc);
+	if (IS_ERR(priv->presence)) {
+		dev_warn(&pdev->dev, "presence sampling unavailable (%ld)\n",
+			 PTR_ERR(priv->presence));
+		priv->presence = NULL;
+		return;
+	}
+
+	pe_desc.presence = priv->presence;
+	priv->port_eeprom = cumulus_port_eeprom_add(&pdev->dev, &pe_desc);
+	if (IS_ERR(priv->port_eeprom)) {
+		dev_warn(&pdev->dev, "port EEPROM cache unavailable (%ld)\n",
+			 PTR_ERR(priv->port_eeprom));
+		priv->port_eeprom = NULL;
+	}
+}
+
+static void fpga_port_monitor_exit(struct fpga_priv *priv)
+{
+	cumulus_port_eeprom_del(priv->port_eeprom);
+	priv->port_eeprom = NULL;
+	cumulus_presence_del(priv->presence);
+	priv->presence = NULL;
+}
+
 static int fpga_dev_init(struct fpga_priv *priv)
 {
 	size_t size;
@@ -1217,6 +1356,33 @@ static void fpga_dev_release(struct fpga_priv *priv)
 #define NUM_FPGA_BUSSES	16
 static struct resource ocores_resources[NUM_FPGA_BUSSES + 1];
 static struct resource ctrl_resource;
+static struct platform_device *ocores_platdevs[ITABSIZE];
+
+/* The i2c channels, see cumulus_ocores_irq_pci_add() */
+static const struct cumulus_ocores_irq_desc fpga_i2c_irq_desc = {
+	.name = DRIVER_NAME,
+	.stride = DELL_Z9S52_I2C_CH_STRIDE,
+	.num_channels = NUM_FPGA_BUSSES,
+};
+
+/*
+ * Unregister the i2c-ocores devices, which also removes every client
+ * on their busses, then release the interrupt they used.
+ */
+static void fpga_ocores_exit(struct pci_dev *pdev, struct fpga_priv *priv)
+{
+	int i;
+
+	for (i = ARRAY_SIZE(ocores_platdevs); --i >= 0;) {
+		if (ocores_platdevs[i]) {
+			platform_device_unregister(ocores_platdevs[i]);
+			ocores_platdevs[i] = NULL;
+		}
+	}
+
+	cumulus_ocores_irq_del(priv->i2c_irq);
+	priv->i2c_irq = NULL;
+}
 
 static int
 fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
@@ -1227,9 +1393,11 @@ fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 	struct ocores_i2c_platform_dev_info *muxdev;
 	struct ocores_i2c_platform_data *oipd;
 	struct platform_device *platdev;
+	struct resource res[2];
 	unsigned long start, len;
 	int i;
 	int err;
+	int irq;
 
 	priv = devm_kzalloc(&pdev->dev, sizeof(*priv), GFP_KERNEL);
 	if (!priv)
@@ -1317,6 +1485,10 @@ fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 		ores->flags = IORESOURCE_MEM;
 	}
 
+	/* the channels keep polling if this fails */
+	priv->i2c_irq = cumulus_ocores_irq_pci_add(pdev,
+			start + DELL_Z9S52_I2C_PREPLO_REG, &fpga_i2c_irq_desc);
+
 	/*
 	 * The device slice loop.  Each of the devices in
 	 * ocores_i2c_device_infotab[] carves out its own name, resources,
@@ -1343,6 +1515,7 @@ fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 		if (!platdev) {
 			pr_err("platform_device_alloc(%d) failed", i);
 			err = -ENOMEM;
+			fpga_ocores_exit(pdev, priv);
 			sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
 			devm_iounmap(&pdev->dev, priv->pbar);
 			fpga_dev_release(priv);
@@ -1352,9 +1525,14 @@ fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 		}
 
 		ores = &ocores_resources[muxdev->bus];
-		err = platform_device_add_resources(platdev, ores, 1);
+		irq = cumulus_ocores_irq_get(priv->i2c_irq, muxdev->bus - 1);
+		res[0] = *ores;
+		res[1] = (struct resource)DEFINE_RES_IRQ(irq);
+		err = platform_device_add_resources(platdev, res,
+						    irq > 0 ? 2 : 1);
 		if (err) {
 			pr_err("platform_device_add_resources(%d) failed", i);
+			fpga_ocores_exit(pdev, priv);
 			sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
 			devm_iounmap(&pdev->dev, priv->pbar);
 			fpga_dev_release(priv);
@@ -1370,11 +1548,13 @@ fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 		oipd->clock_khz		= 100000;
 		oipd->devices		= info;
 		oipd->num_devices	= 1;
-		oipd->interrupt_mode	= OCI2C_POLL;
+		/* zero is interrupt mode, using the IRQ resource */
+		oipd->interrupt_mode	= irq > 0 ? 0 : OCI2C_POLL;
 
 		err = platform_device_add_data(platdev, oipd, sizeof(*oipd));
 		if (err) {
 			pr_err("platform_device_add_data(%d) failed", i);
+			fpga_ocores_exit(pdev, priv);
 			sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
 			devm_iounmap(&pdev->dev, priv->pbar);
 			fpga_dev_release(priv);
@@ -1386,6 +1566,7 @@ fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 		err = platform_device_add(platdev);
 		if (err) {
 			pr_err("platform_device_add() failed for ocores %d", i);
+			fpga_ocores_exit(pdev, priv);
 			sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
 			devm_iounmap(&pdev->dev, priv->pbar);
 			fpga_dev_release(priv);
@@ -1393,8 +1574,11 @@ fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 			devm_kfree(&pdev->dev, priv);
 			goto fail;
 		}
+		ocores_platdevs[i] = platdev;
 	}
 
+	fpga_port_monitor_init(pdev, priv);
+
 	pr_debug("fpga driver loaded\n");
 
 fail:
@@ -1406,6 +1590,8 @@ static void fpga_remove(struct pci_dev *pdev)
 	struct fpga_priv *priv;
 
 	priv = dev_get_drvdata(&pdev->dev);
+	fpga_port_monitor_exit(priv);
+	fpga_ocores_exit(pdev, priv);
 	sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
 	devm_iounmap(&pdev->dev, priv->pbar);
 	fpga_dev_release(priv);
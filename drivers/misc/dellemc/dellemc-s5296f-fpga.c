@@ -27,21 +27,28 @@
 #include <linux/i2c-mux.h>
 #include <linux/interrupt.h>
 #include <linux/stddef.h>
+#include <linux/workqueue.h>
 #include <linux/platform_device.h>
 #include <linux/platform_data/i2c-ocores.h>
 #include <linux/platform_data/at24.h>
 #include <linux/platform_data/sff-8436.h>
 #include <linux/platform_data/pca954x.h>
 #include <linux/cumulus-platform.h>
+#include <linux/cumulus-presence.h>
+#include <linux/cumulus-dom.h>
+#include <linux/cumulus-ports.h>
+#include <linux/cumulus-ocores-irq.h>
 
 #include "platform-defs.h"
 #include "platform-bitfield.h"
 #include "dellemc-z9xxx-s52xx-fpga.h"
 
 #define DRIVER_NAME		  "dellemc_s5296f_fpga"
-#define DRIVER_VERSION		  "2.0"
+#define DRIVER_VERSION		  "2.3"
 
 #define NUM_FPGA_BUSSES		  16
+#define NUM_SFP_PORTS		  96
+#define NUM_QSFP_PORTS		  8
 
 #define PCI_DEVICE_ID_XILINX_FPGA 0x7021
 #define FPGA_BLOCK_MAX		  32
@@ -201,10 +208,10 @@ enum {
  * For muxes, we specify the starting bus number for the block of ports, using
  * the magic mk_pca954*() macro.
  *
- * For eeproms, we specify the label, i2c address, size, and some flags.  All
- * this is done in the magic mk*_eeprom() macro.  The label is the string that
- * ends up in /sys/class/eeprom_dev/eepromN/label, which we use to identify
- * the eeprom at the user level.
+ * The port eeproms are built at probe time from fpga_port_ranges[], see
+ * cumulus-ports.c.  Each one is labeled "portN", the string that ends up in
+ * /sys/class/eeprom_dev/eepromN/label, which we use to identify the eeprom
+ * at the user level.
  *
  */
 
@@ -222,112 +229,6 @@ mk_pca9548(fpga_ch14_mux, FPGA_I2C_CH14_MUX_BUS0, 1);
 mk_pca9548(fpga_ch15_mux, FPGA_I2C_CH15_MUX_BUS0, 1);
 mk_pca9548(fpga_ch16_mux, FPGA_I2C_CH16_MUX_BUS0, 1);
 
-mk_port_eeprom(port1,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port2,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port3,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port4,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port5,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port6,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port7,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port8,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port9,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port10,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port11,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port12,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port13,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port14,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port15,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port16,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port17,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port18,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port19,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port20,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port21,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port22,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port23,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port24,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port25,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port26,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port27,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port28,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port29,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port30,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port31,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port32,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port33,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port34,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port35,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port36,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port37,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port38,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port39,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port40,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port41,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port42,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port43,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port44,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port45,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port46,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port47,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port48,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port49,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port50,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port51,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port52,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port53,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port54,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port55,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port56,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port57,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port58,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port59,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port60,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port61,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port62,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port63,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port64,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port65,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port66,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port67,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port68,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port69,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port70,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port71,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port72,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port73,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port74,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port75,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port76,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port77,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port78,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port79,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port80,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port81,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port82,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port83,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port84,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port85,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port86,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port87,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port88,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port89,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port90,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port91,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port92,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port93,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port94,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port95,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-mk_port_eeprom(port96,	50, 512, AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG);
-
-mk_qsfp_port_eeprom(port97,  50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port98,  50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port99,  50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port100, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port101, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port102, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port103, 50, 256, SFF_8436_FLAG_IRUGO);
-mk_qsfp_port_eeprom(port104, 50, 256, SFF_8436_FLAG_IRUGO);
-
 /*
  * i2c device tables
  *
@@ -342,10 +243,12 @@ mk_qsfp_port_eeprom(port104, 50, 256, SFF_8436_FLAG_IRUGO);
  * i2c busses.
  *
  * The fpga_i2c_devices[] table has all the remaining devices exposed on the
- * fpga i2c busses.  A separate structure, fpga_device_infotab[], is
- * built and used to communicate i2c device information to the fpga i2c driver
- * in "slices" so that it can manipulate the fpga registers as needed in order
- * to access those devices per the OpenCores i2c specification.
+ * fpga i2c busses, except for the port eeproms, which cumulus_ports_add()
+ * builds from fpga_port_ranges[].  A separate structure,
+ * fpga_device_infotab[], is built and used to communicate i2c device
+ * information to the fpga i2c driver in "slices" so that it can manipulate
+ * the fpga registers as needed in order to access those devices per the
+ * OpenCores i2c specification.
  *
  */
 
@@ -368,136 +271,47 @@ static struct platform_i2c_device_info fpga_i2c_busses[] = {
 	mk_i2cdev(FPGA_I2C_CH16, "", 0x01, NULL),
 };
 
+/*
+ * SCL frequency of each FPGA I2C channel in kHz, in fpga_i2c_busses[]
+ * order.  SFF-8472 only requires SFP modules to handle 100 kHz, so the
+ * SFP28 channels stay there along with the CPLD channels.  The QSFP28
+ * channel runs at the 400 kHz SFF-8636 allows.
+ */
+static const u32 fpga_i2c_bus_khz_default[NUM_FPGA_BUSSES] = {
+	100, 100, 100,				/* CH1-CH3:   CPLDs */
+	100, 100, 100, 100, 100, 100,		/* CH4-CH9:   SFP28 */
+	100, 100, 100, 100, 100, 100,		/* CH10-CH15: SFP28 */
+	400,					/* CH16:      QSFP28 */
+};
+
+static unsigned int bus_khz[NUM_FPGA_BUSSES];
+static int num_bus_khz;
+module_param_array(bus_khz, uint, &num_bus_khz, 0444);
+MODULE_PARM_DESC(bus_khz,
+		 "Comma separated I2C frequency in kHz of FPGA channels 1-16, 0 keeps the default");
+
+static u32 fpga_i2c_bus_khz(int index)
+{
+	if (index < num_bus_khz && bus_khz[index])
+		return bus_khz[index];
+
+	return fpga_i2c_bus_khz_default[index];
+}
+
 static struct platform_i2c_device_info fpga_i2c_devices[] = {
 	mk_i2cdev(FPGA_I2C_CH4, "pca9548", 0x74, &fpga_ch4_mux_platform_data),
-	mk_i2cdev(FPGA_I2C_CH4_MUX_BUS0, "24c04", 0x50, &port1_50_at24),
-	mk_i2cdev(FPGA_I2C_CH4_MUX_BUS1, "24c04", 0x50, &port2_50_at24),
-	mk_i2cdev(FPGA_I2C_CH4_MUX_BUS2, "24c04", 0x50, &port3_50_at24),
-	mk_i2cdev(FPGA_I2C_CH4_MUX_BUS3, "24c04", 0x50, &port4_50_at24),
-	mk_i2cdev(FPGA_I2C_CH4_MUX_BUS4, "24c04", 0x50, &port5_50_at24),
-	mk_i2cdev(FPGA_I2C_CH4_MUX_BUS5, "24c04", 0x50, &port6_50_at24),
-	mk_i2cdev(FPGA_I2C_CH4_MUX_BUS6, "24c04", 0x50, &port7_50_at24),
-	mk_i2cdev(FPGA_I2C_CH4_MUX_BUS7, "24c04", 0x50, &port8_50_at24),
-
 	mk_i2cdev(FPGA_I2C_CH5, "pca9548", 0x74, &fpga_ch5_mux_platform_data),
-	mk_i2cdev(FPGA_I2C_CH5_MUX_BUS0, "24c04", 0x50, &port9_50_at24),
-	mk_i2cdev(FPGA_I2C_CH5_MUX_BUS1, "24c04", 0x50, &port10_50_at24),
-	mk_i2cdev(FPGA_I2C_CH5_MUX_BUS2, "24c04", 0x50, &port11_50_at24),
-	mk_i2cdev(FPGA_I2C_CH5_MUX_BUS3, "24c04", 0x50, &port12_50_at24),
-	mk_i2cdev(FPGA_I2C_CH5_MUX_BUS4, "24c04", 0x50, &port13_50_at24),
-	mk_i2cdev(FPGA_I2C_CH5_MUX_BUS5, "24c04", 0x50, &port14_50_at24),
-	mk_i2cdev(FPGA_I2C_CH5_MUX_BUS6, "24c04", 0x50, &port15_50_at24),
-	mk_i2cdev(FPGA_I2C_CH5_MUX_BUS7, "24c04", 0x50, &port16_50_at24),
-
 	mk_i2cdev(FPGA_I2C_CH6, "pca9548", 0x74, &fpga_ch6_mux_platform_data),
-	mk_i2cdev(FPGA_I2C_CH6_MUX_BUS0, "24c04", 0x50, &port17_50_at24),
-	mk_i2cdev(FPGA_I2C_CH6_MUX_BUS1, "24c04", 0x50, &port18_50_at24),
-	mk_i2cdev(FPGA_I2C_CH6_MUX_BUS2, "24c04", 0x50, &port19_50_at24),
-	mk_i2cdev(FPGA_I2C_CH6_MUX_BUS3, "24c04", 0x50, &port20_50_at24),
-	mk_i2cdev(FPGA_I2C_CH6_MUX_BUS4, "24c04", 0x50, &port21_50_at24),
-	mk_i2cdev(FPGA_I2C_CH6_MUX_BUS5, "24c04", 0x50, &port22_50_at24),
-	mk_i2cdev(FPGA_I2C_CH6_MUX_BUS6, "24c04", 0x50, &port23_50_at24),
-	mk_i2cdev(FPGA_I2C_CH6_MUX_BUS7, "24c04", 0x50, &port24_50_at24),
-
 	mk_i2cdev(FPGA_I2C_CH7, "pca9548", 0x74, &fpga_ch7_mux_platform_data),
-	mk_i2cdev(FPGA_I2C_CH7_MUX_BUS0, "24c04", 0x50, &port25_50_at24),
-	mk_i2cdev(FPGA_I2C_CH7_MUX_BUS1, "24c04", 0x50, &port26_50_at24),
-	mk_i2cdev(FPGA_I2C_CH7_MUX_BUS2, "24c04", 0x50, &port27_50_at24),
-	mk_i2cdev(FPGA_I2C_CH7_MUX_BUS3, "24c04", 0x50, &port28_50_at24),
-	mk_i2cdev(FPGA_I2C_CH7_MUX_BUS4, "24c04", 0x50, &port29_50_at24),
-	mk_i2cdev(FPGA_I2C_CH7_MUX_BUS5, "24c04", 0x50, &port30_50_at24),
-	mk_i2cdev(FPGA_I2C_CH7_MUX_BUS6, "24c04", 0x50, &port31_50_at24),
-	mk_i2cdev(FPGA_I2C_CH7_MUX_BUS7, "24c04", 0x50, &port32_50_at24),
-
 	mk_i2cdev(FPGA_I2C_CH8, "pca9548", 0x74, &fpga_ch8_mux_platform_data),
-	mk_i2cdev(FPGA_I2C_CH8_MUX_BUS0, "24c04", 0x50, &port33_50_at24),
-	mk_i2cdev(FPGA_I2C_CH8_MUX_BUS1, "24c04", 0x50, &port34_50_at24),
-	mk_i2cdev(FPGA_I2C_CH8_MUX_BUS2, "24c04", 0x50, &port35_50_at24),
-	mk_i2cdev(FPGA_I2C_CH8_MUX_BUS3, "24c04", 0x50, &port36_50_at24),
-	mk_i2cdev(FPGA_I2C_CH8_MUX_BUS4, "24c04", 0x50, &port37_50_at24),
-	mk_i2cdev(FPGA_I2C_CH8_MUX_BUS5, "24c04", 0x50, &port38_50_at24),
-	mk_i2cdev(FPGA_I2C_CH8_MUX_BUS6, "24c04", 0x50, &port39_50_at24),
-	mk_i2cdev(FPGA_I2C_CH8_MUX_BUS7, "24c04", 0x50, &port40_50_at24),
-
 	mk_i2cdev(FPGA_I2C_CH9, "pca9548", 0x74, &fpga_ch9_mux_platform_data),
-	mk_i2cdev(FPGA_I2C_CH9_MUX_BUS0, "24c04", 0x50, &port41_50_at24),
-	mk_i2cdev(FPGA_I2C_CH9_MUX_BUS1, "24c04", 0x50, &port42_50_at24),
-	mk_i2cdev(FPGA_I2C_CH9_MUX_BUS2, "24c04", 0x50, &port43_50_at24),
-	mk_i2cdev(FPGA_I2C_CH9_MUX_BUS3, "24c04", 0x50, &port44_50_at24),
-	mk_i2cdev(FPGA_I2C_CH9_MUX_BUS4, "24c04", 0x50, &port45_50_at24),
-	mk_i2cdev(FPGA_I2C_CH9_MUX_BUS5, "24c04", 0x50, &port46_50_at24),
-	mk_i2cdev(FPGA_I2C_CH9_MUX_BUS6, "24c04", 0x50, &port47_50_at24),
-	mk_i2cdev(FPGA_I2C_CH9_MUX_BUS7, "24c04", 0x50, &port48_50_at24),
-
 	mk_i2cdev(FPGA_I2C_CH10, "pca9548", 0x74, &fpga_ch10_mux_platform_data),
-	mk_i2cdev(FPGA_I2C_CH10_MUX_BUS0, "24c04", 0x50, &port49_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX_BUS1, "24c04", 0x50, &port50_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX_BUS2, "24c04", 0x50, &port51_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX_BUS3, "24c04", 0x50, &port52_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX_BUS4, "24c04", 0x50, &port53_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX_BUS5, "24c04", 0x50, &port54_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX_BUS6, "24c04", 0x50, &port55_50_at24),
-	mk_i2cdev(FPGA_I2C_CH10_MUX_BUS7, "24c04", 0x50, &port56_50_at24),
-
 	mk_i2cdev(FPGA_I2C_CH11, "pca9548", 0x74, &fpga_ch11_mux_platform_data),
-	mk_i2cdev(FPGA_I2C_CH11_MUX_BUS0, "24c04", 0x50, &port57_50_at24),
-	mk_i2cdev(FPGA_I2C_CH11_MUX_BUS1, "24c04", 0x50, &port58_50_at24),
-	mk_i2cdev(FPGA_I2C_CH11_MUX_BUS2, "24c04", 0x50, &port59_50_at24),
-	mk_i2cdev(FPGA_I2C_CH11_MUX_BUS3, "24c04", 0x50, &port60_50_at24),
-	mk_i2cdev(FPGA_I2C_CH11_MUX_BUS4, "24c04", 0x50, &port61_50_at24),
-	mk_i2cdev(FPGA_I2C_CH11_MUX_BUS5, "24c04", 0x50, &port62_50_at24),
-	mk_i2cdev(FPGA_I2C_CH11_MUX_BUS6, "24c04", 0x50, &port63_50_at24),
-	mk_i2cdev(FPGA_I2C_CH11_MUX_BUS7, "24c04", 0x50, &port64_50_at24),
-
 	mk_i2cdev(FPGA_I2C_CH12, "pca9548", 0x74, &fpga_ch12_mux_platform_data),
-	mk_i2cdev(FPGA_I2C_CH12_MUX_BUS0, "24c04", 0x50, &port65_50_at24),
-	mk_i2cdev(FPGA_I2C_CH12_MUX_BUS1, "24c04", 0x50, &port66_50_at24),
-	mk_i2cdev(FPGA_I2C_CH12_MUX_BUS2, "24c04", 0x50, &port67_50_at24),
-	mk_i2cdev(FPGA_I2C_CH12_MUX_BUS3, "24c04", 0x50, &port68_50_at24),
-	mk_i2cdev(FPGA_I2C_CH12_MUX_BUS4, "24c04", 0x50, &port69_50_at24),
-	mk_i2cdev(FPGA_I2C_CH12_MUX_BUS5, "24c04", 0x50, &port70_50_at24),
-	mk_i2cdev(FPGA_I2C_CH12_MUX_BUS6, "24c04", 0x50, &port71_50_at24),
-	mk_i2cdev(FPGA_I2C_CH12_MUX_BUS7, "24c04", 0x50, &port72_50_at24),
-
 	mk_i2cdev(FPGA_I2C_CH13, "pca9548", 0x74, &fpga_ch13_mux_platform_data),
-	mk_i2cdev(FPGA_I2C_CH13_MUX_BUS0, "24c04", 0x50, &port73_50_at24),
-	mk_i2cdev(FPGA_I2C_CH13_MUX_BUS1, "24c04", 0x50, &port74_50_at24),
-	mk_i2cdev(FPGA_I2C_CH13_MUX_BUS2, "24c04", 0x50, &port75_50_at24),
-	mk_i2cdev(FPGA_I2C_CH13_MUX_BUS3, "24c04", 0x50, &port76_50_at24),
-	mk_i2cdev(FPGA_I2C_CH13_MUX_BUS4, "24c04", 0x50, &port77_50_at24),
-	mk_i2cdev(FPGA_I2C_CH13_MUX_BUS5, "24c04", 0x50, &port78_50_at24),
-	mk_i2cdev(FPGA_I2C_CH13_MUX_BUS6, "24c04", 0x50, &port79_50_at24),
-	mk_i2cdev(FPGA_I2C_CH13_MUX_BUS7, "24c04", 0x50, &port80_50_at24),
-
 	mk_i2cdev(FPGA_I2C_CH14, "pca9548", 0x74, &fpga_ch14_mux_platform_data),
-	mk_i2cdev(FPGA_I2C_CH14_MUX_BUS0, "24c04", 0x50, &port81_50_at24),
-	mk_i2cdev(FPGA_I2C_CH14_MUX_BUS1, "24c04", 0x50, &port82_50_at24),
-	mk_i2cdev(FPGA_I2C_CH14_MUX_BUS2, "24c04", 0x50, &port83_50_at24),
-	mk_i2cdev(FPGA_I2C_CH14_MUX_BUS3, "24c04", 0x50, &port84_50_at24),
-	mk_i2cdev(FPGA_I2C_CH14_MUX_BUS4, "24c04", 0x50, &port85_50_at24),
-	mk_i2cdev(FPGA_I2C_CH14_MUX_BUS5, "24c04", 0x50, &port86_50_at24),
-	mk_i2cdev(FPGA_I2C_CH14_MUX_BUS6, "24c04", 0x50, &port87_50_at24),
-	mk_i2cdev(FPGA_I2C_CH14_MUX_BUS7, "24c04", 0x50, &port88_50_at24),
-
 	mk_i2cdev(FPGA_I2C_CH15, "pca9548", 0x74, &fpga_ch15_mux_platform_data),
-	mk_i2cdev(FPGA_I2C_CH15_MUX_BUS0, "24c04", 0x50, &port89_50_at24),
-	mk_i2cdev(FPGA_I2C_CH15_MUX_BUS1, "24c04", 0x50, &port90_50_at24),
-	mk_i2cdev(FPGA_I2C_CH15_MUX_BUS2, "24c04", 0x50, &port91_50_at24),
-	mk_i2cdev(FPGA_I2C_CH15_MUX_BUS3, "24c04", 0x50, &port92_50_at24),
-	mk_i2cdev(FPGA_I2C_CH15_MUX_BUS4, "24c04", 0x50, &port93_50_at24),
-	mk_i2cdev(FPGA_I2C_CH15_MUX_BUS5, "24c04", 0x50, &port94_50_at24),
-	mk_i2cdev(FPGA_I2C_CH15_MUX_BUS6, "24c04", 0x50, &port95_50_at24),
-	mk_i2cdev(FPGA_I2C_CH15_MUX_BUS7, "24c04", 0x50, &port96_50_at24),
-
 	mk_i2cdev(FPGA_I2C_CH16, "pca9548", 0x74, &fpga_ch16_mux_platform_data),
-	mk_i2cdev(FPGA_I2C_CH16_MUX_BUS0, "sff8436", 0x50, &port97_50_sff8436),
-	mk_i2cdev(FPGA_I2C_CH16_MUX_BUS1, "sff8436", 0x50, &port98_50_sff8436),
-	mk_i2cdev(FPGA_I2C_CH16_MUX_BUS2, "sff8436", 0x50, &port99_50_sff8436),
-	mk_i2cdev(FPGA_I2C_CH16_MUX_BUS3, "sff8436", 0x50, &port100_50_sff8436),
-	mk_i2cdev(FPGA_I2C_CH16_MUX_BUS4, "sff8436", 0x50, &port101_50_sff8436),
-	mk_i2cdev(FPGA_I2C_CH16_MUX_BUS5, "sff8436", 0x50, &port102_50_sff8436),
-	mk_i2cdev(FPGA_I2C_CH16_MUX_BUS6, "sff8436", 0x50, &port103_50_sff8436),
-	mk_i2cdev(FPGA_I2C_CH16_MUX_BUS7, "sff8436", 0x50, &port104_50_sff8436),
 };
 
 /*
@@ -535,6 +349,9 @@ struct fpga_priv {
 	u8 __iomem		     *pbar;
 	struct pci_dev		     *pci_dev;
 	struct fpga_desc	     *hw;
+	struct cumulus_presence	     *presence;
+	struct cumulus_dom	     *dom;
+	struct cumulus_ocores_irq    *i2c_irq;
 };
 
 /* Accessor functions for reading and writing the FPGA registers */
@@ -654,46 +471,6 @@ static const char * const led_digit_values[] = {
 #define fpga_rg_rw(_name, _reg, _values, _flags) \
 	mk_bf_rw(fpga, _name, _reg, 0, 32, _values, _flags)
 
-#define fpga_sfp_port(_num) \
-	fpga_bt_rw(port##_num##_tx_enable, \
-	   DELL_Z9S52_PORT_XCVR_PORT_CTRL_REG + (16 * ((_num) - 1)), \
-	   DELL_Z9S52_PORT_XCVR_PORT_CTRL_TX_DIS, NULL, BF_COMPLEMENT); \
-	fpga_bt_ro(port##_num##_tx_fault, \
-	   DELL_Z9S52_PORT_XCVR_PORT_STS_REG + (16 * ((_num) - 1)), \
-	   DELL_Z9S52_PORT_XCVR_PORT_STS_TXFAULT, NULL, 0); \
-	fpga_bt_ro(port##_num##_rx_los, \
-	   DELL_Z9S52_PORT_XCVR_PORT_STS_REG + (16 * ((_num) - 1)), \
-	   DELL_Z9S52_PORT_XCVR_PORT_STS_RXLOS, NULL, 0); \
-	fpga_bt_ro(port##_num##_present, \
-	   DELL_Z9S52_PORT_XCVR_PORT_STS_REG + (16 * ((_num) - 1)), \
-	   DELL_Z9S52_PORT_XCVR_PORT_STS_MODABS, NULL, BF_COMPLEMENT)
-
-#define fpga_qsfp_port(_num) \
-	fpga_bt_rw(port##_num##_lpmode, \
-	   DELL_Z9S52_PORT_XCVR_PORT_CTRL_REG + (16 * ((_num) - 1)), \
-	   DELL_Z9S52_PORT_XCVR_PORT_CTRL_LPMOD, NULL, 0); \
-	fpga_bt_rw(port##_num##_modsel, \
-	   DELL_Z9S52_PORT_XCVR_PORT_CTRL_REG + (16 * ((_num) - 1)), \
-	   DELL_Z9S52_PORT_XCVR_PORT_CTRL_MODSEL, NULL, BF_COMPLEMENT); \
-	fpga_bt_rw(port##_num##_reset, \
-	   DELL_Z9S52_PORT_XCVR_PORT_CTRL_REG + (16 * ((_num) - 1)), \
-	   DELL_Z9S52_PORT_XCVR_PORT_CTRL_RST, NULL, BF_COMPLEMENT); \
-	fpga_bt_ro(port##_num##_present, \
-	   DELL_Z9S52_PORT_XCVR_PORT_STS_REG + (16 * ((_num) - 1)), \
-	   DELL_Z9S52_PORT_XCVR_PORT_STS_PRSNT, NULL, BF_COMPLEMENT)
-
-#define fpga_sfp_port_attrs(_num) \
-	&fpga_port##_num##_tx_enable.attr, \
-	&fpga_port##_num##_tx_fault.attr, \
-	&fpga_port##_num##_rx_los.attr, \
-	&fpga_port##_num##_present.attr
-
-#define fpga_qsfp_port_attrs(_num) \
-	&fpga_port##_num##_lpmode.attr, \
-	&fpga_port##_num##_modsel.attr, \
-	&fpga_port##_num##_reset.attr, \
-	&fpga_port##_num##_present.attr
-
 /* Define all the bitfields */
 fpga_bf_ro(major_revision, DELL_Z9S52_CTRL_FPGA_VNDR_VRSN_REG,
 	   DELL_Z9S52_CTRL_FPGA_VNDR_VRSN_MJR_REV, NULL, 0);
@@ -765,112 +542,79 @@ fpga_bt_rw(pwr_down, DELL_Z9S52_CTRL_BMC_PWR_CTRL_REG,
 fpga_bt_rw(eeprom_sel, DELL_Z9S52_CTRL_BMC_EEPRM_CTRL_REG,
 	   DELL_Z9S52_CTRL_BMC_EEPRM_CTRL_EEPRM_SEL, NULL, 0);
 
-/* plumb all of the front panel port signals */
-fpga_sfp_port(1);
-fpga_sfp_port(2);
-fpga_sfp_port(3);
-fpga_sfp_port(4);
-fpga_sfp_port(5);
-fpga_sfp_port(6);
-fpga_sfp_port(7);
-fpga_sfp_port(8);
-fpga_sfp_port(9);
-fpga_sfp_port(10);
-fpga_sfp_port(11);
-fpga_sfp_port(12);
-fpga_sfp_port(13);
-fpga_sfp_port(14);
-fpga_sfp_port(15);
-fpga_sfp_port(16);
-fpga_sfp_port(17);
-fpga_sfp_port(18);
-fpga_sfp_port(19);
-fpga_sfp_port(20);
-fpga_sfp_port(21);
-fpga_sfp_port(22);
-fpga_sfp_port(23);
-fpga_sfp_port(24);
-fpga_sfp_port(25);
-fpga_sfp_port(26);
-fpga_sfp_port(27);
-fpga_sfp_port(28);
-fpga_sfp_port(29);
-fpga_sfp_port(30);
-fpga_sfp_port(31);
-fpga_sfp_port(32);
-fpga_sfp_port(33);
-fpga_sfp_port(34);
-fpga_sfp_port(35);
-fpga_sfp_port(36);
-fpga_sfp_port(37);
-fpga_sfp_port(38);
-fpga_sfp_port(39);
-fpga_sfp_port(40);
-fpga_sfp_port(41);
-fpga_sfp_port(42);
-fpga_sfp_port(43);
-fpga_sfp_port(44);
-fpga_sfp_port(45);
-fpga_sfp_port(46);
-fpga_sfp_port(47);
-fpga_sfp_port(48);
-fpga_sfp_port(49);
-fpga_sfp_port(50);
-fpga_sfp_port(51);
-fpga_sfp_port(52);
-fpga_sfp_port(53);
-fpga_sfp_port(54);
-fpga_sfp_port(55);
-fpga_sfp_port(56);
-fpga_sfp_port(57);
-fpga_sfp_port(58);
-fpga_sfp_port(59);
-fpga_sfp_port(60);
-fpga_sfp_port(61);
-fpga_sfp_port(62);
-fpga_sfp_port(63);
-fpga_sfp_port(64);
-fpga_sfp_port(65);
-fpga_sfp_port(66);
-fpga_sfp_port(67);
-fpga_sfp_port(68);
-fpga_sfp_port(69);
-fpga_sfp_port(70);
-fpga_sfp_port(71);
-fpga_sfp_port(72);
-fpga_sfp_port(73);
-fpga_sfp_port(74);
-fpga_sfp_port(75);
-fpga_sfp_port(76);
-fpga_sfp_port(77);
-fpga_sfp_port(78);
-fpga_sfp_port(79);
-fpga_sfp_port(80);
-fpga_sfp_port(81);
-fpga_sfp_port(82);
-fpga_sfp_port(83);
-fpga_sfp_port(84);
-fpga_sfp_port(85);
-fpga_sfp_port(86);
-fpga_sfp_port(87);
-fpga_sfp_port(88);
-fpga_sfp_port(89);
-fpga_sfp_port(90);
-fpga_sfp_port(91);
-fpga_sfp_port(92);
-fpga_sfp_port(93);
-fpga_sfp_port(94);
-fpga_sfp_port(95);
-fpga_sfp_port(96);
-
-fpga_qsfp_port(97);
-fpga_qsfp_port(98);
-fpga_qsfp_port(99);
-fpga_qsfp_port(100);
-fpga_qsfp_port(101);
-fpga_qsfp_port(102);
-fpga_qsfp_port(103);
-fpga_qsfp_port(104);
+/*
+ * Front panel port signals and eeproms, built at probe time, see
+ * cumulus-ports.c.  Every port has a 16 byte register block, and
+ * its eeprom sits behind the PCA9548 of its channel, eight ports per
+ * channel starting with FPGA_I2C_CH4.
+ */
+#define FPGA_PORT_REG(_reg, _num)	((_reg) + 16 * ((_num) - 1))
+
+#define fpga_port_field(_name, _reg, _num, _field, _mode, _flags) \
+	{ \
+		.name = _name, \
+		.reg = FPGA_PORT_REG(_reg, _num), \
+		.shift = _field##_BIT, \
+		.width = 1, \
+		.flags = _flags, \
+		.mode = _mode, \
+	}
+
+static const struct cumulus_port_field fpga_sfp_fields[] = {
+	fpga_port_field("tx_enable", DELL_Z9S52_PORT_XCVR_PORT_CTRL_REG, 1,
+			DELL_Z9S52_PORT_XCVR_PORT_CTRL_TX_DIS, 0644,
+			BF_COMPLEMENT),
+	fpga_port_field("tx_fault", DELL_Z9S52_PORT_XCVR_PORT_STS_REG, 1,
+			DELL_Z9S52_PORT_XCVR_PORT_STS_TXFAULT, 0444, 0),
+	fpga_port_field("rx_los", DELL_Z9S52_PORT_XCVR_PORT_STS_REG, 1,
+			DELL_Z9S52_PORT_XCVR_PORT_STS_RXLOS, 0444, 0),
+	fpga_port_field("present", DELL_Z9S52_PORT_XCVR_PORT_STS_REG, 1,
+			DELL_Z9S52_PORT_XCVR_PORT_STS_MODABS, 0444,
+			BF_COMPLEMENT),
+};
+
+static const struct cumulus_port_field fpga_qsfp_fields[] = {
+	fpga_port_field("lpmode", DELL_Z9S52_PORT_XCVR_PORT_CTRL_REG,
+			NUM_SFP_PORTS + 1,
+			DELL_Z9S52_PORT_XCVR_PORT_CTRL_LPMOD, 0644, 0),
+	fpga_port_field("modsel", DELL_Z9S52_PORT_XCVR_PORT_CTRL_REG,
+			NUM_SFP_PORTS + 1,
+			DELL_Z9S52_PORT_XCVR_PORT_CTRL_MODSEL, 0644,
+			BF_COMPLEMENT),
+	fpga_port_field("reset", DELL_Z9S52_PORT_XCVR_PORT_CTRL_REG,
+			NUM_SFP_PORTS + 1,
+			DELL_Z9S52_PORT_XCVR_PORT_CTRL_RST, 0644,
+			BF_COMPLEMENT),
+	fpga_port_field("present", DELL_Z9S52_PORT_XCVR_PORT_STS_REG,
+			NUM_SFP_PORTS + 1,
+			DELL_Z9S52_PORT_XCVR_PORT_STS_PRSNT, 0444,
+			BF_COMPLEMENT),
+};
+
+static const struct cumulus_port_range fpga_port_ranges[] = {
+	{
+		.first = 1,
+		.count = NUM_SFP_PORTS,
+		.bus = FPGA_I2C_CH4_MUX_BUS0,
+		.addr = 0x50,
+		.type = CUMULUS_PORT_EEPROM_SFP,
+		.eeprom_flags = AT24_FLAG_IRUGO | AT24_FLAG_HOTPLUG,
+		.reg_stride = 16,
+		.fields = fpga_sfp_fields,
+		.num_fields = ARRAY_SIZE(fpga_sfp_fields),
+	},
+	{
+		.first = NUM_SFP_PORTS + 1,
+		.count = NUM_QSFP_PORTS,
+		.bus = FPGA_I2C_CH16_MUX_BUS0,
+		.addr = 0x50,
+		.type = CUMULUS_PORT_EEPROM_QSFP,
+		.eeprom_flags = SFF_8436_FLAG_IRUGO,
+		.reg_stride = 16,
+		.fields = fpga_qsfp_fields,
+		.num_fields = ARRAY_SIZE(fpga_qsfp_fields),
+	},
+};
 
 static struct attribute *fpga_attrs[] = {
 	&fpga_major_revision.attr,
@@ -909,113 +653,6 @@ static struct attribute *fpga_attrs[] = {
 	&fpga_cpu_ctrl.attr,
 	&fpga_pwr_down.attr,
 	&fpga_eeprom_sel.attr,
-
-	fpga_sfp_port_attrs(1),
-	fpga_sfp_port_attrs(2),
-	fpga_sfp_port_attrs(3),
-	fpga_sfp_port_attrs(4),
-	fpga_sfp_port_attrs(5),
-	fpga_sfp_port_attrs(6),
-	fpga_sfp_port_attrs(7),
-	fpga_sfp_port_attrs(8),
-	fpga_sfp_port_attrs(9),
-	fpga_sfp_port_attrs(10),
-	fpga_sfp_port_attrs(11),
-	fpga_sfp_port_attrs(12),
-	fpga_sfp_port_attrs(13),
-	fpga_sfp_port_attrs(14),
-	fpga_sfp_port_attrs(15),
-	fpga_sfp_port_attrs(16),
-	fpga_sfp_port_attrs(17),
-	fpga_sfp_port_attrs(18),
-	fpga_sfp_port_attrs(19),
-	fpga_sfp_port_attrs(20),
-	fpga_sfp_port_attrs(21),
-	fpga_sfp_port_attrs(22),
-	fpga_sfp_port_attrs(23),
-	fpga_sfp_port_attrs(24),
-	fpga_sfp_port_attrs(25),
-	fpga_sfp_port_attrs(26),
-	fpga_sfp_port_attrs(27),
-	fpga_sfp_port_attrs(28),
-	fpga_sfp_port_attrs(29),
-	fpga_sfp_port_attrs(30),
-	fpga_sfp_port_attrs(31),
-	fpga_sfp_port_attrs(32),
-	fpga_sfp_port_attrs(33),
-	fpga_sfp_port_attrs(34),
-	fpga_sfp_port_attrs(35),
-	fpga_sfp_port_attrs(36),
-	fpga_sfp_port_attrs(37),
-	fpga_sfp_port_attrs(38),
-	fpga_sfp_port_attrs(39),
-	fpga_sfp_port_attrs(40),
-	fpga_sfp_port_attrs(41),
-	fpga_sfp_port_attrs(42),
-	fpga_sfp_port_attrs(43),
-	fpga_sfp_port_attrs(44),
-	fpga_sfp_port_attrs(45),
-	fpga_sfp_port_attrs(46),
-	fpga_sfp_port_attrs(47),
-	fpga_sfp_port_attrs(48),
-	fpga_sfp_port_attrs(49),
-	fpga_sfp_port_attrs(50),
-	fpga_sfp_port_attrs(51),
-	fpga_sfp_port_attrs(52),
-	fpga_sfp_port_attrs(53),
-	fpga_sfp_port_attrs(54),
-	fpga_sfp_port_attrs(55),
-	fpga_sfp_port_attrs(56),
-	fpga_sfp_port_attrs(57),
-	fpga_sfp_port_attrs(58),
-	fpga_sfp_port_attrs(59),
-	fpga_sfp_port_attrs(60),
-	fpga_sfp_port_attrs(61),
-	fpga_sfp_port_attrs(62),
-	fpga_sfp_port_attrs(63),
-	fpga_sfp_port_attrs(64),
-	fpga_sfp_port_attrs(65),
-	fpga_sfp_port_attrs(66),
-	fpga_sfp_port_attrs(67),
-	fpga_sfp_port_attrs(68),
-	fpga_sfp_port_attrs(69),
-	fpga_sfp_port_attrs(70),
-	fpga_sfp_port_attrs(71),
-	fpga_sfp_port_attrs(72),
-	fpga_sfp_port_attrs(73),
-	fpga_sfp_port_attrs(74),
-	fpga_sfp_port_attrs(75),
-	fpga_sfp_port_attrs(76),
-	fpga_sfp_port_attrs(77),
-	fpga_sfp_port_attrs(78),
-	fpga_sfp_port_attrs(79),
-	fpga_sfp_port_attrs(80),
-	fpga_sfp_port_attrs(81),
-	fpga_sfp_port_attrs(82),
-	fpga_sfp_port_attrs(83),
-	fpga_sfp_port_attrs(84),
-	fpga_sfp_port_attrs(85),
-	fpga_sfp_port_attrs(86),
-	fpga_sfp_port_attrs(87),
-	fpga_sfp_port_attrs(88),
-	fpga_sfp_port_attrs(89),
-	fpga_sfp_port_attrs(90),
-	fpga_sfp_port_attrs(91),
-	fpga_sfp_port_attrs(92),
-	fpga_sfp_port_attrs(93),
-	fpga_sfp_port_attrs(94),
-	fpga_sfp_port_attrs(95),
-	fpga_sfp_port_attrs(96),
-
-	fpga_qsfp_port_attrs(97),
-	fpga_qsfp_port_attrs(98),
-	fpga_qsfp_port_attrs(99),
-	fpga_qsfp_port_attrs(100),
-	fpga_qsfp_port_attrs(101),
-	fpga_qsfp_port_attrs(102),
-	fpga_qsfp_port_attrs(103),
-	fpga_qsfp_port_attrs(104),
-
 	NULL,
 };
 
@@ -1023,6 +660,14 @@ static struct attribute_group  fpga_attr_group = {
 	.attrs = fpga_attrs,
 };
 
+static const struct cumulus_ports_desc fpga_ports_desc = {
+	.name = DRIVER_NAME,
+	.ranges = fpga_port_ranges,
+	.num_ranges = ARRAY_SIZE(fpga_port_ranges),
+	.read = fpga_read_reg,
+	.write = fpga_write_reg,
+};
+
 static int fpga_dev_init(struct fpga_priv *priv)
 {
 	size_t size;
@@ -1061,15 +706,193 @@ static struct resource ctrl_resource;
 
 static struct platform_device *platdev[NUM_FPGA_BUSSES];
 
+/* Port attributes, eeprom devices and port table from fpga_port_ranges[] */
+static struct cumulus_ports *fpga_ports;
+
+/*
+ * Presence sampling callback, see cumulus-presence.c.  SFP ports
+ * report MODABS and QSFP ports PRSNT, both active low.
+ */
+static int fpga_presence_read(void *data, unsigned long *present)
+{
+	struct fpga_priv *priv = data;
+	u32 stat;
+	int bit;
+	int i;
+
+	for (i = 0; i < NUM_SFP_PORTS + NUM_QSFP_PORTS; i++) {
+		stat = readl(priv->pbar + DELL_Z9S52_PORT_XCVR_PORT_STS_REG +
+			     16 * i);
+		bit = i < NUM_SFP_PORTS ?
+			DELL_Z9S52_PORT_XCVR_PORT_STS_MODABS_BIT :
+			DELL_Z9S52_PORT_XCVR_PORT_STS_PRSNT_BIT;
+		if (!(stat & BIT(bit)))
+			__set_bit(i, present);
+	}
+
+	return 0;
+}
+
+/*
+ * Optics monitoring: one presence bitmap for all ports, and a DOM
+ * poller that scans the 13 port FPGA i2c masters in parallel.  Both
+ * are optional, the driver works without them.
+ */
+static void fpga_port_monitor_init(struct pci_dev *pdev,
+				   struct fpga_priv *priv)
+{
+	struct cumulus_presence_desc pres_desc = {
+		.name = DRIVER_NAME,
+		.num_ports = NUM_SFP_PORTS + NUM_QSFP_PORTS,
+		.read = fpga_presence_read,
+		.priv = priv,
+	};
+	struct cumulus_dom_desc dom_desc = {
+		.name = DRIVER_NAME,
+		.ports = fpga_ports->eeproms,
+		.num_ports = fpga_ports->num_ports,
+	};
+
+	priv->presence = cumulus_presence_add(&pdev->dev, &pres_desc);
+	if (IS_ERR(priv->presence)) {
+		dev_warn(&pdev->dev, "presence sampling unavailable (%ld)\n",
+			 PTR_ERR(priv->presence));
+		priv->presence = NULL;
+		return;
+	}
+
+	dom_desc.presence = priv->presence;
+	priv->dom = cumulus_dom_add(&pdev->dev, &dom_desc);
+	if (IS_ERR(priv->dom)) {
+		dev_warn(&pdev->dev, "DOM poller unavailable (%ld)\n",
+			 PTR_ERR(priv->dom));
+		priv->dom = NULL;
+	}
+}
+
+static void fpga_port_monitor_exit(struct fpga_priv *priv)
+{
+	cumulus_dom_del(priv->dom);
+	priv->dom = NULL;
+	cumulus_presence_del(priv->presence);
+	priv->presence = NULL;
+}
+
+/* The i2c channels, see cumulus_ocores_irq_pci_add() */
+static const struct cumulus_ocores_irq_desc fpga_i2c_irq_desc = {
+	.name = DRIVER_NAME,
+	.stride = DELL_Z9S52_I2C_CH_STRIDE,
+	.num_channels = NUM_FPGA_BUSSES,
+};
+
+/*
+ * Each FPGA channel gets its PCA9548 and the port EEPROMs behind it
+ * from its own work item.  Creating a client waits for its adapter to
+ * show up, so the channels no longer queue up behind each other and
+ * probe does not wait for any of them.
+ */
+struct fpga_channel {
+	struct work_struct work;
+	int index;		/* channel - 1 */
+};
+
+static struct fpga_channel fpga_channels[NUM_FPGA_BUSSES];
+
+static int fpga_i2c_device_channel(int bus)
+{
+	if (bus >= FPGA_I2C_CH4_MUX_BUS0)
+		return FPGA_I2C_CH4 - FPGA_I2C_CH1 +
+			(bus - FPGA_I2C_CH4_MUX_BUS0) / 8;
+
+	return bus - FPGA_I2C_CH1;
+}
+
+static int fpga_channel_add(struct fpga_channel *chan,
+			    struct platform_i2c_device_info *devs, int num)
+{
+	struct i2c_board_info board_info;
+	struct i2c_client *client;
+	int bus;
+	int j;
+
+	for (j = 0; j < num; j++) {
+		bus = devs[j].bus;
+		if (fpga_i2c_device_channel(bus) != chan->index)
+			continue;
+
+		board_info = devs[j].board_info;
+		client = cumulus_i2c_add_client(bus, &board_info);
+		if (IS_ERR(client)) {
+			pr_err(DRIVER_NAME ": add FPGA I2C client failed for bus %d: %ld\n",
+			       bus, PTR_ERR(client));
+			return PTR_ERR(client);
+		}
+		devs[j].client = client;
+	}
+
+	return 0;
+}
+
+static void fpga_channel_clear(struct platform_i2c_device_info *devs, int num)
+{
+	struct i2c_client *c;
+	int i;
+
+	for (i = num; --i >= 0;) {
+		c = devs[i].client;
+		if (c) {
+			i2c_unregister_device(c);
+			devs[i].client = NULL;
+		}
+	}
+}
+
+/* The mux first, the port eeproms hang off it */
+static void fpga_channel_populate(struct work_struct *work)
+{
+	struct fpga_channel *chan =
+		container_of(work, struct fpga_channel, work);
+
+	if (fpga_channel_add(chan, fpga_i2c_devices,
+			     ARRAY_SIZE(fpga_i2c_devices)))
+		return;
+
+	fpga_channel_add(chan, fpga_ports->devices, fpga_ports->num_devices);
+}
+
+static void fpga_channels_populate(void)
+{
+	int i;
+
+	for (i = 0; i < NUM_FPGA_BUSSES; i++) {
+		fpga_channels[i].index = i;
+		INIT_WORK(&fpga_channels[i].work, fpga_channel_populate);
+		queue_work(system_unbound_wq, &fpga_channels[i].work);
+	}
+}
+
+/* Wait for the work items, then remove what they created */
+static void fpga_channels_depopulate(void)
+{
+	int i;
+
+	for (i = 0; i < NUM_FPGA_BUSSES; i++)
+		flush_work(&fpga_channels[i].work);
+
+	fpga_channel_clear(fpga_ports->devices, fpga_ports->num_devices);
+	fpga_channel_clear(fpga_i2c_devices, ARRAY_SIZE(fpga_i2c_devices));
+}
+
 static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *devid)
 {
 	struct fpga_priv *priv;
 	struct resource *cres;
 	struct ocores_i2c_platform_data *fipd;
+	struct resource res[2];
 	unsigned long start, len;
-	int i, j, ch, index;
+	int i, ch, index;
+	int irq;
 	int err;
-	struct i2c_client *client;
 
 	priv = devm_kzalloc(&pdev->dev, sizeof(*priv), GFP_KERNEL);
 	if (!priv) {
@@ -1124,6 +947,18 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *devid)
 		goto err_sysfs_create;
 	}
 
+	fpga_ports = cumulus_ports_add(&pdev->dev, &fpga_ports_desc);
+	if (IS_ERR(fpga_ports)) {
+		err = PTR_ERR(fpga_ports);
+		fpga_ports = NULL;
+		pr_err(DRIVER_NAME ": port setup failed for FPGA driver\n");
+		goto err_ports;
+	}
+
+	/* the channels keep polling if this fails */
+	priv->i2c_irq = cumulus_ocores_irq_pci_add(pdev,
+			start + DELL_Z9S52_I2C_PREPLO_REG, &fpga_i2c_irq_desc);
+
 	/*
 	 * The device slice loop.  Each of the devices in
 	 * fpga_device_infotab[] carves out its own name, resources,
@@ -1166,7 +1001,11 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *devid)
 			goto err_device_alloc;
 		}
 
-		err = platform_device_add_resources(platdev[index], cres, 1);
+		irq = cumulus_ocores_irq_get(priv->i2c_irq, index);
+		res[0] = *cres;
+		res[1] = (struct resource)DEFINE_RES_IRQ(irq);
+		err = platform_device_add_resources(platdev[index], res,
+						    irq > 0 ? 2 : 1);
 		if (err) {
 			pr_err(DRIVER_NAME ": failed to add resources for FPGA I2C ch%d\n",
 			       ch);
@@ -1177,10 +1016,12 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *devid)
 			&fpga_i2c_busses[index].board_info;
 
 		fipd = &fpga_i2c_data[index];
-		fipd->clock_khz		= 100000;
+		fipd->clock_khz		= 100000;	/* ocores input clock */
+		fipd->bus_khz		= fpga_i2c_bus_khz(index);
 		fipd->devices		= &fpga_device_infotab[index];
 		fipd->num_devices	= 1;
-		fipd->interrupt_mode	= OCI2C_POLL;
+		/* zero is interrupt mode, using the IRQ resource */
+		fipd->interrupt_mode	= irq > 0 ? 0 : OCI2C_POLL;
 
 		err = platform_device_add_data(platdev[index], fipd,
 					       sizeof(*fipd));
@@ -1199,36 +1040,17 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *devid)
 	}
 
 	/*
-	 * Allocate all the I2C devices on the FPGA I2C busses.	 The I2C
-	 * adapters should have been created already in the probe function.
+	 * Allocate all the I2C devices on the FPGA I2C busses, one work
+	 * item per channel.  Failures are logged by the work items and
+	 * leave the rest of the platform up.
 	 */
-	for (j = 0; j < ARRAY_SIZE(fpga_i2c_devices); j++) {
-		int bus;
-		struct i2c_board_info board_info;
+	fpga_channels_populate();
 
-		bus = fpga_i2c_devices[j].bus;
-		board_info = fpga_i2c_devices[j].board_info;
-		client = cumulus_i2c_add_client(bus, &board_info);
-		if (IS_ERR(client)) {
-			err = PTR_ERR(client);
-			pr_err(DRIVER_NAME ": add FPGA I2C client failed for bus %d: %d\n",
-			       bus, err);
-			goto err_devices;
-		}
-		fpga_i2c_devices[j].client = client;
-	}
+	fpga_port_monitor_init(pdev, priv);
 
 	pr_info(DRIVER_NAME ": FPGA driver loaded\n");
 	return 0;
 
-err_devices:
-	while (--j >= 0) {
-		if (fpga_i2c_devices[j].client) {
-			i2c_unregister_device(fpga_i2c_devices[j].client);
-			fpga_i2c_devices[j].client = NULL;
-		}
-	}
-
 err_device_add:
 err_add_data:
 err_add_resources:
@@ -1241,6 +1063,11 @@ err_device_alloc:
 		}
 	}
 
+	cumulus_ocores_irq_del(priv->i2c_irq);
+	priv->i2c_irq = NULL;
+	cumulus_ports_del(fpga_ports);
+	fpga_ports = NULL;
+err_ports:
 	sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
 err_sysfs_create:
 	devm_iounmap(&pdev->dev, priv->pbar);
@@ -1258,24 +1085,21 @@ error_return:
 static void fpga_remove(struct pci_dev *pdev)
 {
 	int i, index;
-	struct i2c_client *c;
 	struct fpga_priv *priv;
 
-	/* unregister the FPGA i2c clients */
-	for (i = ARRAY_SIZE(fpga_i2c_devices); --i >= 0;) {
-		c = fpga_i2c_devices[i].client;
-		if (c) {
-			i2c_unregister_device(c);
-			fpga_i2c_devices[i].client = NULL;
-		}
-	}
+	priv = dev_get_drvdata(&pdev->dev);
+	fpga_port_monitor_exit(priv);
+	fpga_channels_depopulate();
 
 	for (i = FPGA_I2C_CH1; i <= FPGA_I2C_CH16; i++) {
 		index = i - FPGA_I2C_CH1; /* array index */
 		platform_device_unregister(platdev[index]);
 		platdev[index] = NULL;
 	}
-	priv = dev_get_drvdata(&pdev->dev);
+	cumulus_ocores_irq_del(priv->i2c_irq);
+	priv->i2c_irq = NULL;
+	cumulus_ports_del(fpga_ports);
+	fpga_ports = NULL;
 	sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
 	devm_iounmap(&pdev->dev, priv->pbar);
 	fpga_dev_release(priv);
@@ -34,8 +34,10 @@
 #include <linux/pci.h>
 
 #include <linux/cumulus-platform.h>
+#include <linux/cumulus-ocores-irq.h>
 #include "platform-defs.h"
 #include "platform-bitfield.h"
+#include "dellemc-z9xxx-s52xx-fpga.h"
 #include "dellemc-z9264f-platform.h"
 
 #define DRIVER_NAME		  "dellemc_z9264f_platform"
@@ -50,6 +52,7 @@
 static struct resource ctrl_resource;
 static struct resource ocores_resources[FPGA_I2C_BUS_MAX];
 static struct ocores_i2c_platform_data ocores_i2c_data[FPGA_I2C_BUS_MAX];
+static struct platform_device *ocores_platdevs[FPGA_I2C_BUS_MAX];
 struct ocores_i2c_device_info ocores_i2c_device_infotab[FPGA_I2C_BUS_MAX];
 
 static const struct pci_device_id fpga_id[] = {
@@ -1111,6 +1114,35 @@ err_exit:
 	return ret;
 }
 
+/* I2C_CH1-I2C_CH16, of which only I2C_CH4-I2C_CH11 are registered */
+#define FPGA_I2C_NUM_CHANNELS	16
+
+/* The i2c channels, see cumulus_ocores_irq_pci_add() */
+static const struct cumulus_ocores_irq_desc fpga_i2c_irq_desc = {
+	.name = DRIVER_NAME,
+	.stride = DELL_Z9S52_I2C_CH_STRIDE,
+	.num_channels = FPGA_I2C_NUM_CHANNELS,
+};
+
+/*
+ * Unregister the i2c-ocores devices, which also removes every client
+ * on their busses, then release the interrupt they used.
+ */
+static void fpga_ocores_exit(struct pci_dev *pdev, struct fpga_priv *priv)
+{
+	int i;
+
+	for (i = ARRAY_SIZE(ocores_platdevs); --i >= 0;) {
+		if (ocores_platdevs[i]) {
+			platform_device_unregister(ocores_platdevs[i]);
+			ocores_platdevs[i] = NULL;
+		}
+	}
+
+	cumulus_ocores_irq_del(priv->i2c_irq);
+	priv->i2c_irq = NULL;
+}
+
 static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 {
 	struct fpga_priv *priv;
@@ -1119,8 +1151,10 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 	struct resource *ores;
 	struct i2c_board_info *binfo;
 	struct platform_device *platdev;
+	struct resource res[2];
 	unsigned long start, len;
 	int i, err = 0, fail = 0;
+	int irq;
 
 	priv = devm_kzalloc(&pdev->dev, sizeof(*priv), GFP_KERNEL);
 	if (!priv)
@@ -1203,6 +1237,10 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 		ocores_resources[i].flags = IORESOURCE_MEM;
 	}
 
+	/* the channels keep polling if this fails */
+	priv->i2c_irq = cumulus_ocores_irq_pci_add(pdev,
+			start + DELL_Z9S52_I2C_PREPLO_REG, &fpga_i2c_irq_desc);
+
 	info = ocores_i2c_device_infotab;
 	ores = ocores_resources;
 	for (i = 0; i < FPGA_I2C_BUS_MAX; i++, info++, ores++) {
@@ -1214,7 +1252,11 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 			goto exit;
 		}
 		ores = &ocores_resources[i];
-		err = platform_device_add_resources(platdev, ores, 1);
+		irq = cumulus_ocores_irq_get(priv->i2c_irq, i + 3);
+		res[0] = *ores;
+		res[1] = (struct resource)DEFINE_RES_IRQ(irq);
+		err = platform_device_add_resources(platdev, res,
+						    irq > 0 ? 2 : 1);
 		if (err) {
 			pr_err("platform_device_add_resources(%d) failed", i);
 			fail = 1;
@@ -1228,7 +1270,8 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 		oipd->clock_khz		= 100000;
 		oipd->devices		= info;
 		oipd->num_devices	= 1;
-		oipd->interrupt_mode	= OCI2C_POLL;
+		/* zero is interrupt mode, using the IRQ resource */
+		oipd->interrupt_mode	= irq > 0 ? 0 : OCI2C_POLL;
 
 		err = platform_device_add_data(platdev, oipd, sizeof(*oipd));
 		if (err) {
@@ -1243,12 +1286,14 @@ static int fpga_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 			fail = 1;
 			goto exit;
 		}
+		ocores_platdevs[i] = platdev;
 	}
 
 	pr_info("fpga driver loaded\n");
 
 exit:
 	if (fail) {
+		fpga_ocores_exit(pdev, priv);
 		sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
 		pci_disable_device(pdev);
 		devm_kfree(&pdev->dev, priv);
@@ -1261,6 +1306,7 @@ static void fpga_remove(struct pci_dev *pdev)
 	struct fpga_priv *priv;
 
 	priv = dev_get_drvdata(&pdev->dev);
+	fpga_ocores_exit(pdev, priv);
 	sysfs_remove_group(&pdev->dev.kobj, &fpga_attr_group);
 	devm_iounmap(&pdev->dev, priv->pbar);
 	fpga_dev_release(priv);
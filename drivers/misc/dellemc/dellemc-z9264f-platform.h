@@ -39,5 +39,6 @@ struct fpga_priv {
 	struct pci_dev *pci_dev;
 	struct fpga_desc *hw;			/* descriptor virt base addr */
 	dma_addr_t io_rng_dma;			/* descriptor HW base addr */
+	struct cumulus_ocores_irq *i2c_irq;	/* i2c channel interrupts */
 };
 #endif
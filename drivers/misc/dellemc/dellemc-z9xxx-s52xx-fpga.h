@@ -509,6 +509,7 @@
 #define DELL_Z9S52_I2C_RXR_REG                                          0x6003
 #define DELL_Z9S52_I2C_CR_REG                                           0x6004
 #define DELL_Z9S52_I2C_SR_REG                                           0x6004
+#define DELL_Z9S52_I2C_CH_STRIDE                                        0x0010
 
 //------------------------------------------------------------------------------
 //
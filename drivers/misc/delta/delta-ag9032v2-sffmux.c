@@ -20,12 +20,13 @@
 #include <linux/module.h>
 #include <linux/hwmon-sysfs.h>
 #include <linux/i2c-mux.h>
+#include <linux/cumulus-cpld-mux.h>
 
 #include "platform-defs.h"
 #include "delta-ag9032v2.h"
 
 #define DRIVER_NAME         AG9032V2_SFFMUX_NAME
-#define DRIVER_VERSION      "1.1"
+#define DRIVER_VERSION      "1.2"
 #define MUX_INVALID_CHANNEL 0xFF
 #define MUX_NUM_PORTS       32
 #define MUX_SELECT_REG      DELTA_AG9032V2_QSFP28_SFP_I2C_MUX_REG
@@ -33,43 +34,14 @@
 #define MUX_SELECT_LSB      DELTA_AG9032V2_PORT_I2C_SEL_LSB
 #define MUX_FIRST_BUS_NUM   CPLD_QSFP_MUX_BUS1
 
-struct port_mux_info {
-	int    prev_chan;
-	struct cpld_item *mastercpld_item;
-	struct i2c_mux_core *muxc;
+static const struct cumulus_cpld_mux_group mux_group = {
+	.reg = MUX_SELECT_REG,
+	.first_chan = 0,
+	.num_chans = MUX_NUM_PORTS,
+	.base_val = 0,
+	.idle_val = MUX_INVALID_CHANNEL,
 };
 
-/* mux select/deselect */
-
-static int mux_select_chan(struct i2c_mux_core *muxc, u32 chan)
-{
-	struct port_mux_info *data = i2c_mux_priv(muxc);
-	int ret;
-
-	if (data->prev_chan == chan)
-		return 0;
-	ret = i2c_smbus_write_byte_data(data->mastercpld_item->cpld_client,
-					MUX_SELECT_REG,
-					chan);
-	if (ret < 0) {
-		data->prev_chan = MUX_INVALID_CHANNEL;
-		return ret;
-	}
-
-	data->prev_chan = chan;
-	return 0;
-}
-
-static int deselect_mux(struct i2c_mux_core *muxc, u32 chan)
-{
-	struct port_mux_info *data = i2c_mux_priv(muxc);
-
-	data->prev_chan = MUX_INVALID_CHANNEL;
-	return i2c_smbus_write_byte_data(data->mastercpld_item->cpld_client,
-					 MUX_SELECT_REG,
-					 MUX_INVALID_CHANNEL);
-}
-
 /* mux probe */
 
 static int mux_probe(struct i2c_client *client)
@@ -77,59 +49,34 @@ static int mux_probe(struct i2c_client *client)
 	struct i2c_adapter *adap = to_i2c_adapter(client->dev.parent);
 	struct device *dev = &client->dev;
 	struct cpld_item *item = dev_get_platdata(dev);
+	struct cumulus_cpld_mux_desc desc = {
+		.name = client->name,
+		.num_chans = MUX_NUM_PORTS,
+		.first_bus = MUX_FIRST_BUS_NUM,
+		.groups = &mux_group,
+		.num_groups = 1,
+		.mux_flags = I2C_MUX_LOCKED,
+		.client = item->cpld_client,
+	};
 	struct i2c_mux_core *muxc;
-	struct port_mux_info *data;
-	int i;
-	int ret;
 
 	if (!i2c_check_functionality(adap, I2C_FUNC_SMBUS_BYTE_DATA))
 		return -ENODEV;
 
-	muxc = i2c_mux_alloc(adap, dev, MUX_NUM_PORTS, sizeof(*data),
-			     I2C_MUX_LOCKED, mux_select_chan, deselect_mux);
-	if (!muxc)
-		return -ENOMEM;
-	data = i2c_mux_priv(muxc);
-
-	i2c_set_clientdata(client, muxc);
-	data->mastercpld_item = item;
-
 	/*
-	 * Write the mux register at addr to verify that the mux is in fact
-	 * present. This also initializes the mux to deselected state.
+	 * Nothing else on the iSMT bus answers at the QSFP address, so
+	 * the last port is left selected between transfers.
 	 */
-	if (i2c_smbus_write_byte_data(data->mastercpld_item->cpld_client,
-				      MUX_SELECT_REG,
-				      MUX_INVALID_CHANNEL)) {
-		dev_warn(dev, "probe failed\n");
-		return -ENODEV;
-	}
-
-	data->prev_chan = MUX_INVALID_CHANNEL;
-
-	/* Now create an adapter for each channel */
-	for (i = 0; i < MUX_NUM_PORTS; i++) {
-		ret = i2c_mux_add_adapter(muxc, MUX_FIRST_BUS_NUM + i, i, 0);
-		if (ret)
-			goto fail_cleanup;
-	}
-
-	dev_info(dev, "registered %d multiplexed busses for I2C mux %s\n",
-		 i, client->name);
+	muxc = cumulus_cpld_mux_add(dev, adap, &desc);
+	if (IS_ERR(muxc))
+		return PTR_ERR(muxc);
 
 	return 0;
-
-fail_cleanup:
-	i2c_mux_del_adapters(muxc);
-	return ret;
 }
 
 static int mux_remove(struct i2c_client *client)
 {
-	struct i2c_mux_core *muxc = i2c_get_clientdata(client);
-
-	if (muxc)
-		i2c_mux_del_adapters(muxc);
+	cumulus_cpld_mux_del(i2c_get_clientdata(client));
 	return 0;
 }
 
@@ -32,12 +32,15 @@
 #include <linux/platform_device.h>
 #include <linux/io.h>
 #include <linux/hwmon-sysfs.h>
+#include <linux/gpio.h>
+#include <linux/gpio/consumer.h>
+#include <linux/cumulus-presence.h>
 
 #include "platform-defs.h"
 #include "quanta-ix8.h"
 
 #define DRIVER_NAME "quanta_ix8_cpld"
-#define DRIVER_VERSION "1.0"
+#define DRIVER_VERSION "1.2"
 
 /*************************************************/
 /* BEGIN CPLD Platform Driver                    */
@@ -239,45 +242,40 @@ static int cpld_port_reg_byte_write(struct i2c_client *client,
  *
  */
 
-static ssize_t port_show(struct device *dev,
-			 struct device_attribute *dattr,
-			 char *buf)
+/*
+ * port_status_read - Gather one status of every port of a CPLD.
+ *
+ * The status bits of four ports are interleaved in each register;
+ * collect the target status into *val, bit 0 being the first port,
+ * with active low statuses already inverted.
+ * Return the number of ports or -errno on failure.
+ */
+static int port_status_read(struct i2c_client *client,
+			    const struct port_status *target,
+			    u64 *val)
 {
-	struct i2c_client *client = to_i2c_client(dev);
 	int i, retval, num_bits;
 	u16 reg_val;
-	u64 val = 0, cpld_val;
-	u64 shift_val;
-	struct port_status *target = NULL;
-	struct sensor_device_attribute *sensor_dev_attr = NULL;
+	u64 cpld_val = 0;
 	int num_platform_status;
 	int sindex;
 
 	num_platform_status = ARRAY_SIZE(sfp28_status);
 
-	sensor_dev_attr = to_sensor_dev_attr(dattr);
-	/* find the target register */
-	target = &sfp28_status[sensor_dev_attr->index];
-	if (!target)
-		return -EINVAL;
-
 	/*
 	 * Read the number of registers
 	 */
 	for (i = 0; i < target->num_reg; i++) {
-		shift_val = 0;
 		retval = cpld_port_reg_word_read(client, target->reg[i],
 						 &reg_val);
 		if (retval < 0)
 			return retval;
-		shift_val = (uint16_t)reg_val;
-		val |= ((shift_val) << (i * target->num_bits));
+		cpld_val |= (u64)reg_val << (i * target->num_bits);
 	}
 
 	num_bits = target->num_reg * target->num_bits;
 	if (target->index != _INV_IDX) {
-		cpld_val = val;
-		val = 0;
+		*val = 0;
 		/*
 		 * Logic to find out the number of bits per status
 		 */
@@ -285,18 +283,88 @@ static ssize_t port_show(struct device *dev,
 		for (i = 0; i < num_bits ; i++) {
 			sindex = (num_platform_status * i) + target->index;
 			if (CPLD_TEST_BIT(cpld_val, sindex))
-				CPLD_SET_BIT(val, i);
+				CPLD_SET_BIT(*val, i);
 		}
+	} else {
+		*val = cpld_val;
 	}
 
 	if (target->active_low)
-		val = ~val;
+		*val = ~*val;
 
-	val = val & GENMASK_ULL(num_bits - 1, 0);
+	*val &= GENMASK_ULL(num_bits - 1, 0);
+
+	return num_bits;
+}
+
+static ssize_t port_show(struct device *dev,
+			 struct device_attribute *dattr,
+			 char *buf)
+{
+	struct i2c_client *client = to_i2c_client(dev);
+	struct sensor_device_attribute *sensor_dev_attr;
+	int retval;
+	u64 val;
+
+	sensor_dev_attr = to_sensor_dev_attr(dattr);
+	retval = port_status_read(client, &sfp28_status[sensor_dev_attr->index],
+				  &val);
+	if (retval < 0)
+		return retval;
 
 	return sprintf(buf, "0x%04llx\n", val);
 }
 
+/*
+ * cpld_presence_read - Presence sampling callback, see
+ * cumulus-presence.c.  One bitmap covers the 16 ports of a CPLD.
+ */
+static int cpld_presence_read(void *priv, unsigned long *present)
+{
+	u64 val;
+	int i, num_bits;
+
+	num_bits = port_status_read(priv, &sfp28_status[_SFP28_PRESENT_IDX],
+				    &val);
+	if (num_bits < 0)
+		return num_bits;
+
+	for (i = 0; i < num_bits; i++)
+		if (CPLD_TEST_BIT(val, i))
+			__set_bit(i, present);
+
+	return 0;
+}
+
+/*
+ * QSFP28 ports 49-56 are not behind a port CPLD, their module present
+ * pins are on the pca9698 expander, four pins per port starting at
+ * reset, present being the third.  Their bitmap hangs off the LED CPLD
+ * of ports 27-56, bit 0 being port 49.
+ */
+#define IX8_QSFP28_NUM_PORTS		8
+#define IX8_QSFP28_PRESENT_GPIO(i)	(IX8_MB_GPIO_21_BASE + (i) * 4 + 2)
+
+static int qsfp_presence_read(void *priv, unsigned long *present)
+{
+	struct gpio_desc *desc;
+	int i, val;
+
+	for (i = 0; i < IX8_QSFP28_NUM_PORTS; i++) {
+		/* the expander may not have probed yet */
+		desc = gpio_to_desc(IX8_QSFP28_PRESENT_GPIO(i));
+		if (!desc)
+			return -ENODEV;
+		val = gpiod_get_raw_value_cansleep(desc);
+		if (val < 0)
+			return val;
+		if (!val)
+			__set_bit(i, present);
+	}
+
+	return 0;
+}
+
 static ssize_t port_store(struct device *dev,
 			  struct device_attribute *dattr,
 			  const char *buf, size_t count)
@@ -525,6 +593,20 @@ static int cpld_probe(struct i2c_client *client,
 
 {
 	struct quanta_ix8_bde_platform_data *pdata;
+	struct cumulus_presence_desc pres_desc = {
+		.name = DRIVER_NAME,
+		.num_ports = 16,
+		.read = cpld_presence_read,
+		.priv = client,
+	};
+	struct cumulus_presence_desc qsfp_pres_desc = {
+		.name = DRIVER_NAME,
+		.num_ports = IX8_QSFP28_NUM_PORTS,
+		.read = qsfp_presence_read,
+	};
+	struct cumulus_presence *pres;
+	bool port_cpld = false;
+	bool qsfp_cpld = false;
 	int retval;
 	int cpld_idx;
 	struct kobject *kobj = &client->dev.kobj;
@@ -548,18 +630,22 @@ static int cpld_probe(struct i2c_client *client,
 	case IX8_IO_SFP28_1_16_CPLD_ID:
 		retval = sysfs_create_group(kobj,
 					    &sfp28_1_16_attr_group);
+		port_cpld = true;
 		break;
 	case IX8_IO_SFP28_17_32_CPLD_ID:
 		retval = sysfs_create_group(kobj,
 					    &sfp28_17_32_attr_group);
+		port_cpld = true;
 		break;
 	case IX8_IO_SFP28_33_48_CPLD_ID:
 		retval = sysfs_create_group(kobj,
 					    &sfp28_33_48_attr_group);
+		port_cpld = true;
 		break;
 	case IX8_LED_SFP28_QSFP28_27_56_CPLD_ID:
 		retval = sysfs_create_group(kobj,
 					    &port_27_56_led_decoder_attr_group);
+		qsfp_cpld = true;
 		break;
 	case IX8_LED_SFP28_1_26_CPLD_ID:
 		retval = sysfs_create_group(kobj,
@@ -578,6 +664,24 @@ static int cpld_probe(struct i2c_client *client,
 		goto err;
 	}
 
+	/*
+	 * Sample the module present bits of the port CPLDs in the
+	 * background, so the port daemon reads one bitmap per change
+	 * instead of polling sfp28_*_present.  The per-CPLD present
+	 * attributes keep working without it.  The QSFP28 ports, whose
+	 * present pins are GPIOs, get theirs on the LED CPLD.
+	 */
+	if (port_cpld || qsfp_cpld) {
+		pres = cumulus_presence_add(&client->dev, port_cpld ?
+					    &pres_desc : &qsfp_pres_desc);
+		if (IS_ERR(pres))
+			dev_warn(&client->dev,
+				 "presence sampling unavailable (%ld)\n",
+				 PTR_ERR(pres));
+		else
+			i2c_set_clientdata(client, pres);
+	}
+
 	/*
 	 * All clear from this point on
 	 */
@@ -602,6 +706,7 @@ static int cpld_remove(struct i2c_client *client)
 {
 	struct kobject *kobj = &client->dev.kobj;
 
+	cumulus_presence_del(i2c_get_clientdata(client));
 	sysfs_remove_group(kobj, &sfp28_1_16_attr_group);
 	sysfs_remove_group(kobj, &sfp28_17_32_attr_group);
 	sysfs_remove_group(kobj, &sfp28_33_48_attr_group);
@@ -0,0 +1,95 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Table driven CPLD register I2C mux.
+ *
+ * Copyright (C) 2020 Cumulus Networks, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * https://www.gnu.org/licenses/gpl-2.0-standalone.html
+ */
+
+#ifndef CUMULUS_CPLD_MUX_H__
+#define CUMULUS_CPLD_MUX_H__
+
+#include <linux/device.h>
+#include <linux/i2c.h>
+#include <linux/i2c-mux.h>
+
+/**
+ * struct cumulus_cpld_mux_group - one CPLD channel select register
+ * @reg:	select register, passed as is to the write accessor
+ * @first_chan:	first mux channel steered by this register
+ * @num_chans:	number of mux channels steered by this register
+ * @base_val:	select value of @first_chan when @remap is NULL
+ * @remap:	optional select value for each channel of the group
+ * @idle_val:	select value that disconnects every channel
+ */
+struct cumulus_cpld_mux_group {
+	u32 reg;
+	int first_chan;
+	int num_chans;
+	u32 base_val;
+	const u8 *remap;
+	u32 idle_val;
+};
+
+/*
+ * Deselect policy.  By default the last channel stays selected after
+ * a transfer and the select register is only written when a different
+ * channel is wanted.  That is only safe when nothing on the parent bus
+ * shares an address with a downstream device; otherwise set
+ * CPLD_MUX_DESELECT_IDLE to disconnect after every transfer.
+ */
+#define CPLD_MUX_DESELECT_IDLE	BIT(0)
+
+/**
+ * struct cumulus_cpld_mux_desc - CPLD register I2C mux description
+ * @name:		label for log messages
+ * @num_chans:		number of mux channels
+ * @first_bus:		adapter number of channel 0, or 0 for dynamic
+ * @groups:		select registers, covering every channel once
+ * @num_groups:		number of entries in @groups
+ * @flags:		CPLD_MUX_* flags
+ * @mux_flags:		i2c_mux_alloc() flags, e.g. I2C_MUX_LOCKED
+ * @client:		CPLD written by the default SMBus write accessor
+ * @write:		optional register write accessor, used instead of
+ *			i2c_smbus_write_byte_data() on @client
+ * @read_present:	optional: fill a bitmap of channels with a module
+ *			present.  Transfers to absent channels then fail
+ *			with -ENXIO without touching the select register.
+ * @priv:		cookie passed to @write and @read_present
+ *
+ * The description is copied, but @groups and the remap tables it
+ * points to must outlive the mux.
+ */
+struct cumulus_cpld_mux_desc {
+	const char *name;
+	int num_chans;
+	int first_bus;
+	const struct cumulus_cpld_mux_group *groups;
+	int num_groups;
+	u32 flags;
+	u32 mux_flags;
+	struct i2c_client *client;
+	int (*write)(void *priv, u32 reg, u32 val);
+	int (*read_present)(void *priv, unsigned long *present);
+	void *priv;
+};
+
+struct i2c_mux_core *
+cumulus_cpld_mux_add(struct device *dev, struct i2c_adapter *parent,
+		     const struct cumulus_cpld_mux_desc *desc);
+
+void cumulus_cpld_mux_del(struct i2c_mux_core *muxc);
+
+void *cumulus_cpld_mux_priv(struct i2c_mux_core *muxc);
+
+#endif /* CUMULUS_CPLD_MUX_H__ */
@@ -0,0 +1,75 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * CY8C3245R1 fan controller platform data.
+ *
+ * Copyright (C) 2020 Cumulus Networks, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * https://www.gnu.org/licenses/gpl-2.0-standalone.html
+ */
+
+#ifndef CUMULUS_CY8C3245R1_H__
+#define CUMULUS_CY8C3245R1_H__
+
+#include <linux/types.h>
+
+/*
+ * The driver registers a thermal cooling device named
+ * "cy8c3245r1-<bus>-<addr>", with the address in hex.  Its state is
+ * the PWM duty cycle, 0-255, and is only applied to the fans while
+ * pwm1_enable is 2.  Thermal zones of other drivers can bind to it by
+ * that name.
+ */
+#define CY8C3245R1_COOLING_MAX_STATE	255
+
+/**
+ * struct cy8c3245r1_trip - one step of a fan curve
+ * @temp:	trip temperature in millidegrees Celsius
+ * @hyst:	hysteresis in millidegrees Celsius
+ * @pwm:	duty cycle, 1-255, applied at and above @temp
+ */
+struct cy8c3245r1_trip {
+	int temp;
+	int hyst;
+	u8 pwm;
+};
+
+/**
+ * struct cy8c3245r1_zone - thermal zone on one of the chip's sensors
+ * @type:	thermal zone type, shorter than THERMAL_NAME_LENGTH
+ * @sensor:	temperature sensor, 0 is temp1
+ * @trips:	fan curve, at most THERMAL_MAX_TRIPS active trip points
+ * @num_trips:	number of entries in @trips
+ */
+struct cy8c3245r1_zone {
+	const char *type;
+	int sensor;
+	const struct cy8c3245r1_trip *trips;
+	int num_trips;
+};
+
+/**
+ * struct cy8c3245r1_platform_data - CY8C3245R1 platform data
+ * @zones:	thermal zones bound to the cooling device, may be NULL
+ * @num_zones:	number of entries in @zones
+ * @pwm_min:	duty cycle floor while the cooling device drives the fans
+ *
+ * With zones the device comes up with pwm1_enable set to 2 and the
+ * step_wise governor evaluates them on every sensor refresh, so the
+ * fans follow the curve within one auto_update_interval.
+ */
+struct cy8c3245r1_platform_data {
+	const struct cy8c3245r1_zone *zones;
+	int num_zones;
+	u8 pwm_min;
+};
+
+#endif /* CUMULUS_CY8C3245R1_H__ */
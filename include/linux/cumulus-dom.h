@@ -0,0 +1,96 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Parallel optics DOM poller.
+ *
+ * Copyright (C) 2020 Cumulus Networks, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * https://www.gnu.org/licenses/gpl-2.0-standalone.html
+ */
+
+#ifndef CUMULUS_DOM_H__
+#define CUMULUS_DOM_H__
+
+#include <linux/types.h>
+#include <linux/device.h>
+#include <linux/cumulus-presence.h>
+#include <linux/cumulus-port-eeprom.h>
+
+/*
+ * Binary layout of dom/records: one header followed by num_ports
+ * records, all little endian on the supported platforms.  Userspace
+ * must check magic and version and step by record_size.
+ */
+#define CUMULUS_DOM_MAGIC	0x444f4d31	/* "DOM1" */
+#define CUMULUS_DOM_VERSION	1
+
+/*
+ * Raw DOM bytes copied into each record:
+ *
+ * SFP:  A2h bytes 96-119, diagnostics, status/control and flags
+ * QSFP: lower page bytes 22-57, module and per-lane monitors.  The
+ *       clear-on-read interrupt flags are deliberately not read.
+ * CMIS: lower page bytes 14-25, module monitors.  Lane monitors live
+ *       in banked page 11h and are not part of the scan.
+ */
+#define CUMULUS_DOM_DATA_LEN	36
+
+struct cumulus_dom_header {
+	__u32 magic;
+	__u16 version;
+	__u16 record_size;
+	__u32 num_ports;
+	__u32 seq;		/* incremented by every scan */
+	__u64 scan_ns;		/* CLOCK_REALTIME at the end of the scan */
+	__u32 scan_us;		/* duration of the scan */
+	__u32 num_roots;	/* root buses scanned in parallel */
+} __packed;
+
+/* record flags */
+#define CUMULUS_DOM_PRESENT	BIT(0)
+#define CUMULUS_DOM_VALID	BIT(1)	/* data holds a fresh read */
+
+struct cumulus_dom_record {
+	__u64 timestamp_ns;	/* CLOCK_REALTIME of the read */
+	__u16 port;		/* front panel port, starting at 1 */
+	__u8 type;		/* enum cumulus_port_eeprom_type */
+	__u8 flags;
+	__s16 error;		/* -errno of a failed read, else 0;
+				 * -EAGAIN without PRESENT: presence unknown */
+	__u8 data_len;
+	__u8 reserved;
+	__u8 data[CUMULUS_DOM_DATA_LEN];
+} __packed;
+
+/**
+ * struct cumulus_dom_desc - DOM poller description
+ * @name:	label for log messages
+ * @ports:	port table, index N is bit N of the presence bitmap
+ * @num_ports:	number of entries in @ports
+ * @presence:	presence object, absent ports are skipped
+ *
+ * @ports must outlive the poller.
+ */
+struct cumulus_dom_desc {
+	const char *name;
+	const struct cumulus_port_eeprom_port *ports;
+	int num_ports;
+	struct cumulus_presence *presence;
+};
+
+struct cumulus_dom;
+
+struct cumulus_dom *cumulus_dom_add(struct device *dev,
+				    const struct cumulus_dom_desc *desc);
+
+void cumulus_dom_del(struct cumulus_dom *dom);
+
+#endif /* CUMULUS_DOM_H__ */
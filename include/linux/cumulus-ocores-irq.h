@@ -0,0 +1,59 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Shared interrupt demultiplexer for FPGA hosted i2c-ocores channels.
+ *
+ * Copyright (C) 2020 Cumulus Networks, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * https://www.gnu.org/licenses/gpl-2.0-standalone.html
+ */
+
+#ifndef CUMULUS_OCORES_IRQ_H__
+#define CUMULUS_OCORES_IRQ_H__
+
+#include <linux/device.h>
+
+struct pci_dev;
+struct cumulus_ocores_irq;
+
+/**
+ * struct cumulus_ocores_irq_desc - shared ocores interrupt description
+ * @name:	name of the parent interrupt handler
+ * @irq:	interrupt raised by every channel
+ * @regs:	register block of channel 0, mapped without requesting the
+ *		region since i2c-ocores requests it
+ * @stride:	distance between the register blocks of two channels
+ * @reg_shift:	ocores register shift, as in ocores_i2c_platform_data
+ * @num_channels: number of channels, at most BITS_PER_LONG
+ */
+struct cumulus_ocores_irq_desc {
+	const char *name;
+	int irq;
+	void __iomem *regs;
+	unsigned int stride;
+	unsigned int reg_shift;
+	unsigned int num_channels;
+};
+
+struct cumulus_ocores_irq *
+cumulus_ocores_irq_add(struct device *dev,
+		       const struct cumulus_ocores_irq_desc *desc);
+
+struct cumulus_ocores_irq *
+cumulus_ocores_irq_pci_add(struct pci_dev *pdev, resource_size_t start,
+			   const struct cumulus_ocores_irq_desc *desc);
+
+void cumulus_ocores_irq_del(struct cumulus_ocores_irq *oi);
+
+int cumulus_ocores_irq_get(struct cumulus_ocores_irq *oi,
+			   unsigned int channel);
+
+#endif /* CUMULUS_OCORES_IRQ_H__ */
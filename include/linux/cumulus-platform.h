@@ -25,9 +25,6 @@
 #include <linux/gpio/driver.h>
 #include "platform-bitfield.h"
 
-typedef int bf_read_func(struct device *dev, int reg, int nregs, u32 *val);
-typedef int bf_write_func(struct device *dev, int reg, int nregs, u32 val);
-
 int cumulus_i2c_find_adapter(const char *name);
 
 struct i2c_client *
@@ -37,34 +34,29 @@ ssize_t cumulus_gpio_map_show(struct device *dev,
 			      struct gpio_chip *chip,
 			      char *buf);
 
-ssize_t cumulus_bf_show32(struct device *dev,
-			  struct device_attribute *dattr,
-			  char *buf,
-			  struct bf *bif,
-			  bf_read_func *read);
-
-ssize_t cumulus_bf_store32(struct device *dev,
-			   struct device_attribute *dattr,
-			   const char *buf,
-			   size_t size,
-			   struct bf *bif,
-			   bf_read_func *read,
-			   bf_write_func *write);
-
 ssize_t cumulus_bf_show(struct device *dev,
 			struct device_attribute *dattr,
 			char *buf,
-			struct bf *bif,
+			const struct bf *bif,
 			bf_read_func *read);
 
 ssize_t cumulus_bf_store(struct device *dev,
 			 struct device_attribute *dattr,
 			 const char *buf,
 			 size_t size,
-			 struct bf *bif,
+			 const struct bf *bif,
 			 bf_read_func *read,
 			 bf_write_func *write);
 
+ssize_t cumulus_bf_attr_show(struct device *dev,
+			     struct device_attribute *dattr,
+			     char *buf);
+
+ssize_t cumulus_bf_attr_store(struct device *dev,
+			      struct device_attribute *dattr,
+			      const char *buf,
+			      size_t size);
+
 int cumulus_bf_i2c_read_reg(struct device *dev,
 			    int reg,
 			    int nregs,
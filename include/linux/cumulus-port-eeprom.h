@@ -0,0 +1,88 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Cached front panel port EEPROM access.
+ *
+ * Copyright (C) 2020 Cumulus Networks, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * https://www.gnu.org/licenses/gpl-2.0-standalone.html
+ */
+
+#ifndef CUMULUS_PORT_EEPROM_H__
+#define CUMULUS_PORT_EEPROM_H__
+
+#include <linux/device.h>
+#include <linux/i2c.h>
+#include <linux/cumulus-presence.h>
+
+/*
+ * Port types, which select the EEPROM layout:
+ *
+ * SFP:  512 bytes, A0h (0x50) followed by A2h (0x51), as mk_port_eeprom()
+ * QSFP: 256 bytes, lower page and upper page 00h at 0x50, as
+ *       mk_qsfp_port_eeprom()
+ * CMIS: lower page followed by every bank/page pair, see
+ *       CUMULUS_PORT_EEPROM_CMIS_OFFSET()
+ */
+enum cumulus_port_eeprom_type {
+	CUMULUS_PORT_EEPROM_SFP,
+	CUMULUS_PORT_EEPROM_QSFP,
+	CUMULUS_PORT_EEPROM_CMIS,
+};
+
+/*
+ * Offset of byte 128 of upper page @page of bank @bank in the linear
+ * CMIS file.  Pages 00h-0Fh are not banked and read the same in every
+ * bank.
+ */
+#define CUMULUS_PORT_EEPROM_CMIS_OFFSET(bank, page) \
+	(128 + ((bank) * 256 + (page)) * 128)
+
+/**
+ * struct cumulus_port_eeprom_port - one front panel port
+ * @bus:	i2c adapter number the module EEPROM answers on
+ * @type:	enum cumulus_port_eeprom_type
+ * @number:	front panel port number, 0 for the table index plus one
+ */
+struct cumulus_port_eeprom_port {
+	int bus;
+	u8 type;
+	u16 number;
+};
+
+/**
+ * struct cumulus_port_eeprom_desc - port EEPROM cache description
+ * @name:	label for log messages
+ * @ports:	port table, index N is bit N of the presence bitmap
+ * @num_ports:	number of entries in @ports
+ * @presence:	presence object whose edges invalidate the cache
+ *
+ * @ports must outlive the cache.
+ */
+struct cumulus_port_eeprom_desc {
+	const char *name;
+	const struct cumulus_port_eeprom_port *ports;
+	int num_ports;
+	struct cumulus_presence *presence;
+};
+
+struct cumulus_port_eeprom;
+
+struct cumulus_port_eeprom *
+cumulus_port_eeprom_add(struct device *dev,
+			const struct cumulus_port_eeprom_desc *desc);
+
+void cumulus_port_eeprom_del(struct cumulus_port_eeprom *pe);
+
+int cumulus_port_eeprom_raw_read(struct i2c_adapter *adap, u8 addr,
+				 unsigned int off, u8 *buf, size_t len);
+
+#endif /* CUMULUS_PORT_EEPROM_H__ */
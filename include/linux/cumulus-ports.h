@@ -0,0 +1,132 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Table driven front panel port attributes and EEPROM devices.
+ *
+ * Copyright (C) 2020 Cumulus Networks, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * https://www.gnu.org/licenses/gpl-2.0-standalone.html
+ */
+
+#ifndef CUMULUS_PORTS_H__
+#define CUMULUS_PORTS_H__
+
+#include <linux/device.h>
+#include <linux/sysfs.h>
+#include <linux/cumulus-platform.h>
+#include <linux/cumulus-port-eeprom.h>
+
+struct platform_i2c_device_info;
+
+/**
+ * struct cumulus_port_field - per port register field
+ * @name:	attribute suffix, port N gets "portN_<name>"
+ * @reg:	register of the first port of the range
+ * @shift:	bit offset in the register
+ * @width:	field width in bits
+ * @flags:	BF_COMPLEMENT, BF_DECIMAL, BF_SIGNED
+ * @values:	names of the values, NULL for numbers
+ * @num_values:	number of entries in @values, BF_NUM_VALUES() of it
+ * @mode:	0444 or 0644
+ *
+ * Same meaning as the mk_bf_ro() and mk_bf_rw() arguments.
+ */
+struct cumulus_port_field {
+	const char *name;
+	const char * const *values;
+	u32 reg;
+	u8 shift;
+	u8 width;
+	u8 flags;
+	u8 num_values;
+	umode_t mode;
+};
+
+/**
+ * struct cumulus_port_range - block of identical, consecutive ports
+ * @first:	front panel number of the first port
+ * @count:	number of ports
+ * @bus:	i2c bus of the first port's EEPROM, the next port is on
+ *		@bus + 1 and so on
+ * @bus_order:	EEPROM bus of each port as an offset from @bus, NULL for
+ *		the order above
+ * @addr:	EEPROM i2c address, 0 for no EEPROM device
+ * @type:	enum cumulus_port_eeprom_type, CMIS ports need @addr 0
+ * @size:	EEPROM size in bytes, 0 for 512 (SFP) or 256 (QSFP)
+ * @eeprom_flags: AT24_FLAG_* for SFP, SFF_8436_FLAG_* for QSFP
+ * @page_size:	EEPROM write page size, 0 for SFP_PAGE_SIZE or
+ *		QSFP_PAGE_SIZE
+ * @reg_stride:	register distance between two ports
+ * @fields:	attributes created for every port, may be NULL
+ * @num_fields:	number of entries in @fields
+ * @attr_prefix: prepended to the attribute names, may be NULL
+ * @attr_first:	port number of the first port in the attribute names,
+ *		0 for @first
+ *
+ * The EEPROM gets the label "portN" and the "24c04" or "sff8436"
+ * driver, as mk_port_eeprom() and mk_qsfp_port_eeprom() would.  The
+ * attributes are named "<attr_prefix>portN_<name>".
+ */
+struct cumulus_port_range {
+	u16 first;
+	u16 count;
+	int bus;
+	const u8 *bus_order;
+	u8 addr;
+	u8 type;
+	u16 size;
+	u32 eeprom_flags;
+	u8 page_size;
+	u16 reg_stride;
+	const struct cumulus_port_field *fields;
+	int num_fields;
+	const char *attr_prefix;
+	u16 attr_first;
+};
+
+/**
+ * struct cumulus_ports_desc - front panel description
+ * @name:	label for log messages
+ * @ranges:	port ranges, in port order
+ * @num_ranges:	number of entries in @ranges
+ * @read:	register accessor for the attributes
+ * @write:	register accessor for the writable attributes
+ */
+struct cumulus_ports_desc {
+	const char *name;
+	const struct cumulus_port_range *ranges;
+	int num_ranges;
+	bf_read_func *read;
+	bf_write_func *write;
+};
+
+/**
+ * struct cumulus_ports - generated tables, read-only for the caller
+ * @num_ports:	number of ports in all ranges
+ * @eeproms:	port table in port order for cumulus_dom_add() and
+ *		cumulus_port_eeprom_add()
+ * @devices:	EEPROM i2c devices in port order.  The caller creates
+ *		the clients and keeps them in @client.
+ * @num_devices: number of entries in @devices
+ */
+struct cumulus_ports {
+	int num_ports;
+	struct cumulus_port_eeprom_port *eeproms;
+	struct platform_i2c_device_info *devices;
+	int num_devices;
+};
+
+struct cumulus_ports *cumulus_ports_add(struct device *dev,
+					const struct cumulus_ports_desc *desc);
+
+void cumulus_ports_del(struct cumulus_ports *ports);
+
+#endif /* CUMULUS_PORTS_H__ */
@@ -0,0 +1,74 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Polled front panel port presence bitmap.
+ *
+ * Copyright (C) 2020 Cumulus Networks, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * https://www.gnu.org/licenses/gpl-2.0-standalone.html
+ */
+
+#ifndef CUMULUS_PRESENCE_H__
+#define CUMULUS_PRESENCE_H__
+
+#include <linux/device.h>
+#include <linux/notifier.h>
+
+struct cumulus_presence;
+
+/**
+ * struct cumulus_presence_desc - port presence source description
+ * @name:	label for log messages
+ * @num_ports:	number of ports, bit 0 of the bitmap is the first port
+ * @poll_ms:	sample period in ms, or 0 for the module default
+ * @read:	fill a zeroed bitmap with a bit set for every port that has
+ *		a module plugged in; may sleep
+ * @priv:	cookie passed to @read
+ */
+struct cumulus_presence_desc {
+	const char *name;
+	int num_ports;
+	unsigned int poll_ms;
+	int (*read)(void *priv, unsigned long *present);
+	void *priv;
+};
+
+/**
+ * struct cumulus_presence_event - presence change notifier payload
+ * @present:	bitmap after the change
+ * @changed:	ports that were inserted or removed
+ * @num_ports:	number of bits in @present and @changed
+ */
+struct cumulus_presence_event {
+	const unsigned long *present;
+	const unsigned long *changed;
+	int num_ports;
+};
+
+#define CUMULUS_PRESENCE_CHANGED	1
+
+struct cumulus_presence *
+cumulus_presence_add(struct device *dev,
+		     const struct cumulus_presence_desc *desc);
+
+void cumulus_presence_del(struct cumulus_presence *pres);
+
+bool cumulus_presence_valid(struct cumulus_presence *pres);
+
+bool cumulus_presence_test(struct cumulus_presence *pres, int port);
+
+int cumulus_presence_register_notifier(struct cumulus_presence *pres,
+				       struct notifier_block *nb);
+
+int cumulus_presence_unregister_notifier(struct cumulus_presence *pres,
+					 struct notifier_block *nb);
+
+#endif /* CUMULUS_PRESENCE_H__ */
@@ -0,0 +1,90 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Platform temperature sources as thermal zones.
+ *
+ * Copyright (C) 2020 Cumulus Networks, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * https://www.gnu.org/licenses/gpl-2.0-standalone.html
+ */
+
+#ifndef CUMULUS_THERMAL_H__
+#define CUMULUS_THERMAL_H__
+
+#include <linux/device.h>
+#include <linux/thermal.h>
+
+/**
+ * struct cumulus_thermal_sensor_ops - temperature source callbacks
+ * @get_temp:	read the temperature in millidegrees Celsius; may sleep
+ * @get_trend:	optional, report the trend for a trip point
+ *
+ * Same shape as struct thermal_zone_of_device_ops, so a source can
+ * back both an OF and a platform thermal zone.
+ */
+struct cumulus_thermal_sensor_ops {
+	int (*get_temp)(void *priv, int *temp);
+	int (*get_trend)(void *priv, int trip, enum thermal_trend *trend);
+};
+
+/**
+ * struct cumulus_thermal_trip - trip point
+ * @temp:	trip temperature in millidegrees Celsius
+ * @hyst:	hysteresis in millidegrees Celsius
+ * @type:	THERMAL_TRIP_ACTIVE, _PASSIVE, _HOT or _CRITICAL.  The
+ *		thermal core powers the system off when a critical trip
+ *		is crossed.
+ * @lower:	lowest cooling state bound to the trip
+ * @upper:	highest cooling state bound to the trip.  0 binds the full
+ *		range of the cooling device and leaves @lower unused.
+ */
+struct cumulus_thermal_trip {
+	int temp;
+	int hyst;
+	enum thermal_trip_type type;
+	unsigned long lower;
+	unsigned long upper;
+};
+
+/**
+ * struct cumulus_thermal_desc - thermal zone description
+ * @type:	thermal zone type, shorter than THERMAL_NAME_LENGTH
+ * @ops:	temperature source
+ * @priv:	cookie passed to @ops
+ * @trips:	trip points, copied, at most THERMAL_MAX_TRIPS
+ * @num_trips:	number of entries in @trips
+ * @cdev_type:	cooling devices of this type are bound to every trip,
+ *		NULL binds none
+ * @governor:	thermal governor, NULL for the thermal core default
+ * @poll_ms:	sample period in ms, 0 for the module default
+ */
+struct cumulus_thermal_desc {
+	const char *type;
+	const struct cumulus_thermal_sensor_ops *ops;
+	void *priv;
+	const struct cumulus_thermal_trip *trips;
+	int num_trips;
+	const char *cdev_type;
+	const char *governor;
+	unsigned int poll_ms;
+};
+
+struct cumulus_thermal;
+
+struct cumulus_thermal *
+cumulus_thermal_add(struct device *dev,
+		    const struct cumulus_thermal_desc *desc);
+
+void cumulus_thermal_del(struct cumulus_thermal *ct);
+
+void cumulus_thermal_update(struct cumulus_thermal *ct);
+
+#endif /* CUMULUS_THERMAL_H__ */